@@ -420,6 +420,9 @@ common_parse_opt (int key,
           exit (EXIT_FAILURE);
         }
       break;
+    case ARGP_SDR_CACHE_SHARED_KEY:
+      common_args->sdr_cache_shared = 1;
+      break;
     case ARGP_IGNORE_SDR_CACHE_KEY:
       common_args->ignore_sdr_cache = 1;
       break;
@@ -521,6 +524,7 @@ _init_common_cmd_args (struct common_cmd_args *common_args)
   common_args->sdr_cache_recreate = 0;
   common_args->sdr_cache_file = NULL;
   common_args->sdr_cache_directory = NULL;
+  common_args->sdr_cache_shared = 0;
   common_args->ignore_sdr_cache = 0;
 
   common_args->utc_to_localtime = 0;
@@ -75,6 +75,8 @@ enum argp_common_option_keys
     ARGP_FANOUT_KEY = 'F',
     ARGP_ELIMINATE_KEY = 'E',
     ARGP_ALWAYS_PREFIX_KEY = 149,
+    /* more sdr options */
+    ARGP_SDR_CACHE_SHARED_KEY = 150,
   };
 
 /*
@@ -168,7 +170,9 @@ enum argp_common_option_keys
   { "sdr-cache-file", ARGP_SDR_CACHE_FILE_KEY, "FILE", 0,                                                       \
       "Specify a specific file for the sensor data repository (SDR) cache to be stored or read from.", 23},     \
   { "sdr-cache-directory", ARGP_SDR_CACHE_DIRECTORY_KEY, "DIRECTORY", 0,                                        \
-      "Specify an alternate directory for sensor data repository (SDR) caches to be stored or read from.", 24}
+      "Specify an alternate directory for sensor data repository (SDR) caches to be stored or read from.", 24}, \
+  { "sdr-cache-shared", ARGP_SDR_CACHE_SHARED_KEY, 0, 0,                                                        \
+      "Share one sensor data repository (SDR) cache between hosts with identical SDRs.", 24}
 
 #define ARGP_COMMON_SDR_CACHE_OPTIONS_IGNORE                                                                    \
   { "ignore-sdr-cache", ARGP_IGNORE_SDR_CACHE_KEY, 0, 0,                                                        \
@@ -241,6 +245,7 @@ struct common_cmd_args
   int sdr_cache_recreate;
   char *sdr_cache_file;
   char *sdr_cache_directory;
+  int sdr_cache_shared;
   int ignore_sdr_cache;
 
   /* time options */
@@ -1318,7 +1318,8 @@ config_file_parse (const char *filename,
     authentication_type_count = 0, cipher_suite_id_count = 0,
     privilege_level_count = 0;
 
-  int quiet_cache_count = 0, sdr_cache_directory_count = 0;
+  int quiet_cache_count = 0, sdr_cache_directory_count = 0,
+    sdr_cache_shared_count = 0;
 
   int utc_to_localtime_count = 0, localtime_to_utc_count = 0,
     utc_offset_count = 0;
@@ -1643,6 +1644,17 @@ config_file_parse (const char *filename,
         &(common_args->sdr_cache_directory),
         0
       },
+      {
+        "sdr-cache-shared",
+        CONFFILE_OPTION_BOOL,
+        -1,
+        _config_file_bool,
+        1,
+        0,
+        &sdr_cache_shared_count,
+        &(common_args->sdr_cache_shared),
+        0
+      },
     };
 
   struct conffile_option time_options[] =
@@ -4510,6 +4522,17 @@ config_file_parse (const char *filename,
         &(ipmipower_data.ping_consec_count),
         0
       },
+      {
+        "ipmipower-hosts-per-socket",
+        CONFFILE_OPTION_INT,
+        -1,
+        _config_file_unsigned_int,
+        1,
+        0,
+        &(ipmipower_data.hosts_per_socket_count),
+        &(ipmipower_data.hosts_per_socket),
+        0
+      },
     };
 
   /*
@@ -4747,6 +4770,17 @@ config_file_parse (const char *filename,
         &(ipmiseld_data.cache_directory),
         0,
       },
+      {
+        "state-sync-interval",
+        CONFFILE_OPTION_INT,
+        -1,
+        _config_file_positive_unsigned_int,
+        1,
+        0,
+        &(ipmiseld_data.state_sync_interval_count),
+        &(ipmiseld_data.state_sync_interval),
+        0
+      },
       {
         "ignore-sdr",
         CONFFILE_OPTION_BOOL,
@@ -4873,6 +4907,8 @@ config_file_parse (const char *filename,
                  sdr_options,
                  options_len);
 
+  config_file_options_len += options_len;
+
   options_len = sizeof (time_options)/sizeof (struct conffile_option);
   if (!(support & CONFIG_FILE_TIME))
     _ignore_options (time_options, options_len);
@@ -275,6 +275,8 @@ struct config_file_data_ipmipower
   int ping_percent_count;
   unsigned int ping_consec_count;
   int ping_consec_count_count;
+  unsigned int hosts_per_socket;
+  int hosts_per_socket_count;
 };
 
 struct config_file_data_ipmiseld
@@ -323,6 +325,8 @@ struct config_file_data_ipmiseld
   int log_priority_str_count;
   char *cache_directory;
   int cache_directory_count;
+  unsigned int state_sync_interval;
+  int state_sync_interval_count;
   int ignore_sdr;
   int ignore_sdr_count;
   int re_download_sdr;
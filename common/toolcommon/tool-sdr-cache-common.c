@@ -43,6 +43,7 @@
 
 #define SDR_CACHE_DIR                     "sdr-cache"
 #define SDR_CACHE_FILENAME_PREFIX         "sdr-cache"
+#define SDR_CACHE_SHARED_DIR              "shared"
 #define FREEIPMI_CONFIG_DIRECTORY_MODE    0700
 
 #ifndef MAXHOSTNAMELEN
@@ -304,6 +305,63 @@ _sdr_cache_get_cache_directory (pstdout_state_t pstate,
   return (0);
 }
 
+/* prefix-localhost.hostname in the cache directory */
+static int
+_sdr_cache_get_host_filename (pstdout_state_t pstate,
+                              const char *hostname,
+                              const struct common_cmd_args *common_args,
+                              const char *prefix,
+                              char *buf,
+                              unsigned int buflen)
+{
+  char sdrcachebuf[MAXPATHLEN+1];
+  char hostnamebuf[MAXHOSTNAMELEN+1];
+  char *ptr;
+  int ret;
+
+  assert (common_args);
+  assert (prefix);
+  assert (buf);
+  assert (buflen);
+
+  memset (hostnamebuf, '\0', MAXHOSTNAMELEN+1);
+  if (gethostname (hostnamebuf, MAXHOSTNAMELEN) < 0)
+    snprintf (hostnamebuf, MAXHOSTNAMELEN, "localhost");
+
+  /* shorten hostname if necessary */
+  if ((ptr = strchr (hostnamebuf, '.')))
+    *ptr = '\0';
+
+  if (_sdr_cache_get_cache_directory (pstate,
+                                      common_args->sdr_cache_directory,
+                                      sdrcachebuf,
+                                      MAXPATHLEN) < 0)
+    return (-1);
+
+  if ((ret = snprintf (buf,
+                       buflen,
+                       "%s/%s-%s.%s",
+                       sdrcachebuf,
+                       prefix,
+                       hostnamebuf,
+                       hostname ? hostname : "localhost")) < 0)
+
+    {
+      PSTDOUT_PERROR (pstate, "snprintf");
+      return (-1);
+    }
+
+  if (ret >= buflen)
+    {
+      PSTDOUT_FPRINTF (pstate,
+                       stderr,
+                       "snprintf invalid bytes written\n");
+      return (-1);
+    }
+
+  return (0);
+}
+
 static int
 _sdr_cache_get_cache_filename (pstdout_state_t pstate,
                                const char *hostname,
@@ -312,7 +370,6 @@ _sdr_cache_get_cache_filename (pstdout_state_t pstate,
                                unsigned int buflen)
 {
   char sdrcachebuf[MAXPATHLEN+1];
-  char *ptr;
   int ret;
 
   assert (common_args);
@@ -321,42 +378,13 @@ _sdr_cache_get_cache_filename (pstdout_state_t pstate,
 
   if (!common_args->sdr_cache_file)
     {
-      char hostnamebuf[MAXHOSTNAMELEN+1];
-
-      memset (hostnamebuf, '\0', MAXHOSTNAMELEN+1);
-      if (gethostname (hostnamebuf, MAXHOSTNAMELEN) < 0)
-        snprintf (hostnamebuf, MAXHOSTNAMELEN, "localhost");
-
-      /* shorten hostname if necessary */
-      if ((ptr = strchr (hostnamebuf, '.')))
-        *ptr = '\0';
-
-      if (_sdr_cache_get_cache_directory (pstate,
-                                          common_args->sdr_cache_directory,
-                                          sdrcachebuf,
-                                          MAXPATHLEN) < 0)
+      if (_sdr_cache_get_host_filename (pstate,
+                                        hostname,
+                                        common_args,
+                                        SDR_CACHE_FILENAME_PREFIX,
+                                        buf,
+                                        buflen) < 0)
         return (-1);
-
-      if ((ret = snprintf (buf,
-                           buflen,
-                           "%s/%s-%s.%s",
-                           sdrcachebuf,
-                           SDR_CACHE_FILENAME_PREFIX,
-                           hostnamebuf,
-                           hostname ? hostname : "localhost")) < 0)
-
-        {
-          PSTDOUT_PERROR (pstate, "snprintf");
-          return (-1);
-        }
-
-      if (ret >= buflen)
-        {
-          PSTDOUT_FPRINTF (pstate,
-                           stderr,
-                           "snprintf invalid bytes written\n");
-          return (-1);
-        }
     }
   else
     {
@@ -523,11 +551,14 @@ _sdr_cache_create (ipmi_sdr_ctx_t ctx,
                    pstdout_state_t pstate,
                    ipmi_ctx_t ipmi_ctx,
                    const char *hostname,
-                   const struct common_cmd_args *common_args)
+                   const struct common_cmd_args *common_args,
+                   int out_of_date)
 {
   char cachefilenamebuf[MAXPATHLEN+1];
+  char shareddirectorybuf[MAXPATHLEN+1];
   int count = 0;
   int cache_create_flags = 0;
+  int ret;
   int rv = -1;
 
   assert (ctx);
@@ -562,12 +593,56 @@ _sdr_cache_create (ipmi_sdr_ctx_t ctx,
   if (common_args->workaround_flags_sdr & IPMI_PARSE_WORKAROUND_FLAGS_SDR_ASSUME_MAX_SDR_RECORD_COUNT)
     cache_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT;
 
-  if (ipmi_sdr_cache_create (ctx,
-                             ipmi_ctx,
-                             cachefilenamebuf,
-                             cache_create_flags,
-                             common_args->quiet_cache ? NULL : _sdr_cache_create_callback,
-                             common_args->quiet_cache ? NULL : (void *)&count) < 0)
+  if (hostname
+      && common_args->driver_type == IPMI_DEVICE_LAN_2_0)
+    cache_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED;
+
+  if (common_args->sdr_cache_shared)
+    {
+      /* Hosts with identical SDRs link to one cache in the shared
+       * subdirectory, so the SDR is only downloaded once.
+       */
+      memset (shareddirectorybuf, '\0', MAXPATHLEN+1);
+      if (_sdr_cache_get_cache_directory (pstate,
+                                          common_args->sdr_cache_directory,
+                                          shareddirectorybuf,
+                                          MAXPATHLEN) < 0)
+        goto cleanup;
+
+      if ((strlen (shareddirectorybuf) + strlen ("/" SDR_CACHE_SHARED_DIR)) > MAXPATHLEN)
+        {
+          PSTDOUT_FPRINTF (pstate,
+                           stderr,
+                           "internal overflow error\n");
+          goto cleanup;
+        }
+      strcat (shareddirectorybuf, "/" SDR_CACHE_SHARED_DIR);
+
+      ret = ipmi_sdr_cache_create_shared (ctx,
+                                          ipmi_ctx,
+                                          cachefilenamebuf,
+                                          shareddirectorybuf,
+                                          cache_create_flags,
+                                          common_args->quiet_cache ? NULL : _sdr_cache_create_callback,
+                                          common_args->quiet_cache ? NULL : (void *)&count);
+    }
+  else if (out_of_date)
+    /* Only download records that changed since the cache was made */
+    ret = ipmi_sdr_cache_update (ctx,
+                                 ipmi_ctx,
+                                 cachefilenamebuf,
+                                 cache_create_flags,
+                                 common_args->quiet_cache ? NULL : _sdr_cache_create_callback,
+                                 common_args->quiet_cache ? NULL : (void *)&count);
+  else
+    ret = ipmi_sdr_cache_create (ctx,
+                                 ipmi_ctx,
+                                 cachefilenamebuf,
+                                 cache_create_flags,
+                                 common_args->quiet_cache ? NULL : _sdr_cache_create_callback,
+                                 common_args->quiet_cache ? NULL : (void *)&count);
+
+  if (ret < 0)
     {
       /* unique output corner case */
       if (count && !common_args->quiet_cache)
@@ -575,7 +650,8 @@ _sdr_cache_create (ipmi_sdr_ctx_t ctx,
 
       PSTDOUT_FPRINTF (pstate,
                        stderr,
-                       "ipmi_sdr_cache_create: %s\n",
+                       "%s: %s\n",
+                       common_args->sdr_cache_shared ? "ipmi_sdr_cache_create_shared" : (out_of_date ? "ipmi_sdr_cache_update" : "ipmi_sdr_cache_create"),
                        ipmi_sdr_ctx_errormsg (ctx));
       goto cleanup;
     }
@@ -660,7 +736,8 @@ sdr_cache_create_and_load (ipmi_sdr_ctx_t sdr_ctx,
                              pstate,
                              ipmi_ctx,
                              hostname,
-                             common_args) < 0)
+                             common_args,
+                             ipmi_sdr_ctx_errnum (sdr_ctx) == IPMI_SDR_ERR_CACHE_OUT_OF_DATE) < 0)
         goto cleanup;
 
       if (ipmi_sdr_cache_open (sdr_ctx,
@@ -780,3 +857,27 @@ ipmi_sdr_cache_search_sensor_wrapper (ipmi_sdr_ctx_t sdr_ctx,
   return (rv);
 }
 
+
+int
+sdr_cache_get_host_filename (pstdout_state_t pstate,
+                             const char *hostname,
+                             const struct common_cmd_args *common_args,
+                             const char *prefix,
+                             char *buf,
+                             unsigned int buflen)
+{
+  assert (common_args);
+  assert (prefix);
+  assert (buf);
+  assert (buflen);
+
+  if (_sdr_cache_create_directory (pstate, common_args->sdr_cache_directory) < 0)
+    return (-1);
+
+  return (_sdr_cache_get_host_filename (pstate,
+                                        hostname,
+                                        common_args,
+                                        prefix,
+                                        buf,
+                                        buflen));
+}
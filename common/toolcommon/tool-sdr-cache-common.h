@@ -37,6 +37,17 @@ int sdr_cache_flush_cache (pstdout_state_t pstate,
                            const char *hostname,
                            const struct common_cmd_args *common_args);
 
+/* for other per host caches kept alongside the SDR cache, fills buf
+ * with the path of prefix-localhost.hostname in the SDR cache
+ * directory, creating the directory if necessary.
+ */
+int sdr_cache_get_host_filename (pstdout_state_t pstate,
+                                 const char *hostname,
+                                 const struct common_cmd_args *common_args,
+                                 const char *prefix,
+                                 char *buf,
+                                 unsigned int buflen);
+
 /* wrapper for ipmi_sdr_cache_search_sensor, handles some additional special workarounds */
 int ipmi_sdr_cache_search_sensor_wrapper (ipmi_sdr_ctx_t sdr_ctx,
                                           uint8_t sensor_number,
@@ -108,6 +108,8 @@ static struct argp_option cmdline_options[] =
       "List sensor types.", 48},
     { "tail", TAIL_KEY, "COUNT", 0,
       "Display approximately the last count SEL records.", 49},
+    { "sel-cache", SEL_CACHE_KEY, 0, 0,
+      "Keep a local copy of the SEL and read only new records from the BMC.", 49},
     { "clear", CLEAR_KEY, 0, 0,
       "Clear SEL.", 50},
     { "post-clear", POST_CLEAR_KEY, 0, 0,
@@ -560,6 +562,9 @@ cmdline_parse (int key, char *arg, struct argp_state *state)
       cmd_args->tail = 1;
       cmd_args->tail_count = value;
       break;
+    case SEL_CACHE_KEY:
+      cmd_args->sel_cache = 1;
+      break;
     case CLEAR_KEY:
       cmd_args->clear = 1;
       break;
@@ -789,6 +794,7 @@ ipmi_sel_argp_parse (int argc, char **argv, struct ipmi_sel_arguments *cmd_args)
 
   cmd_args->tail = 0;
   cmd_args->tail_count = 0;
+  cmd_args->sel_cache = 0;
   cmd_args->clear = 0;
   cmd_args->post_clear = 0;
   cmd_args->delete = 0;
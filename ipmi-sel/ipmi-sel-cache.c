@@ -0,0 +1,833 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <sys/types.h>
+#include <sys/stat.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif /* HAVE_FCNTL_H */
+#include <sys/param.h>          /* MAXPATHLEN */
+#include <assert.h>
+#include <errno.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "ipmi-sel_.h"
+#include "ipmi-sel-cache.h"
+
+#include "freeipmi-portability.h"
+#include "fd.h"
+#include "pstdout.h"
+#include "tool-sdr-cache-common.h"
+
+#ifndef MAXPATHLEN
+#define MAXPATHLEN 4096
+#endif /* MAXPATHLEN */
+
+/* Cache files live in the SDR cache directory, one per host.
+ *
+ * Format: header, records in SEL order, zero sum checksum of
+ * everything before it.  Values are stored little endian.
+ */
+
+#define IPMI_SEL_CACHE_FILENAME_PREFIX  "sel-cache"
+
+#define IPMI_SEL_CACHE_FILE_MAGIC       0x5E1CAC4E
+
+#define IPMI_SEL_CACHE_FILE_VERSION     0x00000001
+
+/* magic, version, entries, addition timestamp, erase timestamp, record count */
+#define IPMI_SEL_CACHE_HEADER_LENGTH    (4 + 4 + 2 + 4 + 4 + 4)
+
+#define IPMI_SEL_CACHE_RECORD_LENGTH    IPMI_SEL_RECORD_MAX_RECORD_LENGTH
+
+static unsigned int
+_unmarshall_uint32 (const uint8_t *databuf, uint32_t *value)
+{
+  assert (databuf);
+  assert (value);
+
+  (*value) = databuf[0];
+  (*value) |= (databuf[1] << 8);
+  (*value) |= (databuf[2] << 16);
+  (*value) |= (databuf[3] << 24);
+
+  return (sizeof (uint32_t));
+}
+
+static unsigned int
+_unmarshall_uint16 (const uint8_t *databuf, uint16_t *value)
+{
+  assert (databuf);
+  assert (value);
+
+  (*value) = databuf[0];
+  (*value) |= (databuf[1] << 8);
+
+  return (sizeof (uint16_t));
+}
+
+static unsigned int
+_marshall_uint32 (uint8_t *databuf, uint32_t value)
+{
+  assert (databuf);
+
+  databuf[0] = (value & 0x000000FF);
+  databuf[1] = (value & 0x0000FF00) >> 8;
+  databuf[2] = (value & 0x00FF0000) >> 16;
+  databuf[3] = (value & 0xFF000000) >> 24;
+
+  return (sizeof (uint32_t));
+}
+
+static unsigned int
+_marshall_uint16 (uint8_t *databuf, uint16_t value)
+{
+  assert (databuf);
+
+  databuf[0] = (value & 0x00FF);
+  databuf[1] = (value & 0xFF00) >> 8;
+
+  return (sizeof (uint16_t));
+}
+
+static int
+_sel_cache_reserve (ipmi_sel_state_data_t *state_data,
+                    struct ipmi_sel_cache *cache,
+                    unsigned int record_count)
+{
+  uint8_t *tmp;
+  unsigned int count;
+
+  assert (state_data);
+  assert (cache);
+
+  if (record_count <= cache->records_allocated)
+    return (0);
+
+  count = cache->records_allocated ? cache->records_allocated : 64;
+  while (count < record_count)
+    count *= 2;
+
+  if (!(tmp = (uint8_t *)realloc (cache->records, count * IPMI_SEL_CACHE_RECORD_LENGTH)))
+    {
+      pstdout_perror (state_data->pstate, "realloc");
+      return (-1);
+    }
+
+  cache->records = tmp;
+  cache->records_allocated = count;
+  return (0);
+}
+
+static int
+_sel_cache_append (ipmi_sel_state_data_t *state_data,
+                   struct ipmi_sel_cache *cache,
+                   const uint8_t *record)
+{
+  assert (state_data);
+  assert (cache);
+  assert (record);
+
+  if (_sel_cache_reserve (state_data, cache, cache->record_count + 1) < 0)
+    return (-1);
+
+  memcpy (cache->records + cache->record_count * IPMI_SEL_CACHE_RECORD_LENGTH,
+          record,
+          IPMI_SEL_CACHE_RECORD_LENGTH);
+  cache->record_count++;
+  return (0);
+}
+
+/* returns 1 if loaded, 0 if not available or invalid, -1 on error */
+static int
+_sel_cache_load (ipmi_sel_state_data_t *state_data,
+                 struct ipmi_sel_cache *cache,
+                 const char *filename)
+{
+  uint32_t file_magic;
+  uint32_t file_version;
+  uint32_t record_count;
+  uint8_t zerosumchecksum = 0;
+  uint8_t *databuf = NULL;
+  unsigned int databuf_offset = 0;
+  struct stat statbuf;
+  ssize_t len;
+  unsigned int i;
+  int fd = -1;
+  int rv = -1;
+
+  assert (state_data);
+  assert (cache);
+  assert (filename);
+
+  if ((fd = open (filename, O_RDONLY)) < 0)
+    {
+      if (errno == ENOENT)
+        return (0);
+
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "Cannot open SEL cache: %s: %s\n",
+                       filename,
+                       strerror (errno));
+      return (-1);
+    }
+
+  if (fstat (fd, &statbuf) < 0)
+    {
+      pstdout_perror (state_data->pstate, "fstat");
+      goto cleanup;
+    }
+
+  if (statbuf.st_size < (IPMI_SEL_CACHE_HEADER_LENGTH + 1)
+      || ((statbuf.st_size - IPMI_SEL_CACHE_HEADER_LENGTH - 1) % IPMI_SEL_CACHE_RECORD_LENGTH))
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  if (!(databuf = (uint8_t *)malloc (statbuf.st_size)))
+    {
+      pstdout_perror (state_data->pstate, "malloc");
+      goto cleanup;
+    }
+
+  if ((len = fd_read_n (fd, databuf, statbuf.st_size)) < 0)
+    {
+      pstdout_perror (state_data->pstate, "fd_read_n");
+      goto cleanup;
+    }
+
+  if (len != statbuf.st_size)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  for (i = 0; i < len; i++)
+    zerosumchecksum += databuf[i];
+
+  if (zerosumchecksum)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &file_magic);
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &file_version);
+
+  if (file_magic != IPMI_SEL_CACHE_FILE_MAGIC
+      || file_version != IPMI_SEL_CACHE_FILE_VERSION)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &cache->entries);
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &cache->most_recent_addition_timestamp);
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &cache->most_recent_erase_timestamp);
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &record_count);
+
+  if (record_count != (len - IPMI_SEL_CACHE_HEADER_LENGTH - 1) / IPMI_SEL_CACHE_RECORD_LENGTH)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  if (_sel_cache_reserve (state_data, cache, record_count) < 0)
+    goto cleanup;
+
+  memcpy (cache->records,
+          databuf + databuf_offset,
+          record_count * IPMI_SEL_CACHE_RECORD_LENGTH);
+  cache->record_count = record_count;
+
+  rv = 1;
+ cleanup:
+  free (databuf);
+  close (fd);
+  return (rv);
+}
+
+/* Written to a temporary file and renamed, so the cache is never seen
+ * partially written.
+ */
+static int
+_sel_cache_store (ipmi_sel_state_data_t *state_data,
+                  struct ipmi_sel_cache *cache,
+                  const char *filename)
+{
+  char tmpfilename[MAXPATHLEN+1];
+  uint8_t *databuf = NULL;
+  unsigned int databuf_offset = 0;
+  unsigned int databuflen;
+  uint8_t zerosumchecksum = 0;
+  unsigned int i;
+  int fd = -1;
+  int rv = -1;
+
+  assert (state_data);
+  assert (cache);
+  assert (filename);
+
+  memset (tmpfilename, '\0', MAXPATHLEN + 1);
+
+  databuflen = IPMI_SEL_CACHE_HEADER_LENGTH
+    + cache->record_count * IPMI_SEL_CACHE_RECORD_LENGTH
+    + 1;
+
+  if (!(databuf = (uint8_t *)malloc (databuflen)))
+    {
+      pstdout_perror (state_data->pstate, "malloc");
+      goto cleanup;
+    }
+
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, IPMI_SEL_CACHE_FILE_MAGIC);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, IPMI_SEL_CACHE_FILE_VERSION);
+  databuf_offset += _marshall_uint16 (databuf + databuf_offset, cache->entries);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, cache->most_recent_addition_timestamp);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, cache->most_recent_erase_timestamp);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, cache->record_count);
+
+  if (cache->record_count)
+    memcpy (databuf + databuf_offset,
+            cache->records,
+            cache->record_count * IPMI_SEL_CACHE_RECORD_LENGTH);
+  databuf_offset += cache->record_count * IPMI_SEL_CACHE_RECORD_LENGTH;
+
+  for (i = 0; i < databuf_offset; i++)
+    zerosumchecksum += databuf[i];
+  databuf[databuf_offset] = (~zerosumchecksum) + 1;
+
+  if (snprintf (tmpfilename, MAXPATHLEN + 1, "%s.XXXXXX", filename) > MAXPATHLEN)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "snprintf invalid bytes written\n");
+      goto cleanup;
+    }
+
+  if ((fd = mkstemp (tmpfilename)) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "Cannot create SEL cache: %s: %s\n",
+                       tmpfilename,
+                       strerror (errno));
+      goto cleanup;
+    }
+
+  if (fd_write_n (fd, databuf, databuflen) < 0)
+    {
+      pstdout_perror (state_data->pstate, "fd_write_n");
+      goto cleanup;
+    }
+
+  if (close (fd) < 0)
+    {
+      pstdout_perror (state_data->pstate, "close");
+      fd = -1;
+      goto cleanup;
+    }
+  fd = -1;
+
+  if (rename (tmpfilename, filename) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "Cannot write SEL cache: %s: %s\n",
+                       filename,
+                       strerror (errno));
+      goto cleanup;
+    }
+
+  rv = 0;
+ cleanup:
+  if (rv < 0 && fd >= 0)
+    close (fd);
+  if (rv < 0 && strlen (tmpfilename))
+    unlink (tmpfilename);
+  free (databuf);
+  return (rv);
+}
+
+/* Reads SEL records from record_id_start on into the cache.  If
+ * check_first is set, the first record read must be the last record
+ * already in the cache, it is not appended again.
+ *
+ * returns 1 if read, 0 if the check failed, -1 on error
+ */
+static int
+_sel_cache_read_sel (ipmi_sel_state_data_t *state_data,
+                     struct ipmi_sel_cache *cache,
+                     uint16_t record_id_start,
+                     uint16_t record_id_last,
+                     int check_first)
+{
+  uint8_t record[IPMI_SEL_CACHE_RECORD_LENGTH];
+  int count;
+  int len;
+
+  assert (state_data);
+  assert (cache);
+  assert (!check_first || cache->record_count);
+
+  if ((count = ipmi_sel_parse (state_data->sel_ctx,
+                               record_id_start,
+                               record_id_last,
+                               NULL,
+                               NULL)) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "ipmi_sel_parse: %s\n",
+                       ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+      return (-1);
+    }
+
+  if (!count)
+    return (check_first ? 0 : 1);
+
+  do
+    {
+      memset (record, '\0', IPMI_SEL_CACHE_RECORD_LENGTH);
+      if ((len = ipmi_sel_parse_read_record (state_data->sel_ctx,
+                                             record,
+                                             IPMI_SEL_CACHE_RECORD_LENGTH)) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sel_parse_read_record: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+          return (-1);
+        }
+
+      if (check_first)
+        {
+          if (memcmp (record,
+                      cache->records + (cache->record_count - 1) * IPMI_SEL_CACHE_RECORD_LENGTH,
+                      IPMI_SEL_CACHE_RECORD_LENGTH))
+            return (0);
+          check_first = 0;
+          continue;
+        }
+
+      if (_sel_cache_append (state_data, cache, record) < 0)
+        return (-1);
+
+    } while (ipmi_sel_parse_next (state_data->sel_ctx) == 1);
+
+  return (1);
+}
+
+static int
+_sel_cache_index_compare (const void *a, const void *b)
+{
+  const struct ipmi_sel_cache_index *ia = (const struct ipmi_sel_cache_index *)a;
+  const struct ipmi_sel_cache_index *ib = (const struct ipmi_sel_cache_index *)b;
+
+  if (ia->key != ib->key)
+    return (ia->key < ib->key ? -1 : 1);
+  if (ia->position != ib->position)
+    return (ia->position < ib->position ? -1 : 1);
+  return (0);
+}
+
+static int
+_sel_cache_index (ipmi_sel_state_data_t *state_data,
+                  struct ipmi_sel_cache *cache)
+{
+  unsigned int i;
+
+  assert (state_data);
+  assert (cache);
+
+  free (cache->record_id_index);
+  cache->record_id_index = NULL;
+  free (cache->timestamp_index);
+  cache->timestamp_index = NULL;
+  cache->timestamp_index_count = 0;
+
+  if (!cache->record_count)
+    return (0);
+
+  if (!(cache->record_id_index = (struct ipmi_sel_cache_index *)malloc (cache->record_count * sizeof (struct ipmi_sel_cache_index))))
+    {
+      pstdout_perror (state_data->pstate, "malloc");
+      return (-1);
+    }
+
+  if (!(cache->timestamp_index = (struct ipmi_sel_cache_index *)malloc (cache->record_count * sizeof (struct ipmi_sel_cache_index))))
+    {
+      pstdout_perror (state_data->pstate, "malloc");
+      return (-1);
+    }
+
+  for (i = 0; i < cache->record_count; i++)
+    {
+      const uint8_t *record = cache->records + i * IPMI_SEL_CACHE_RECORD_LENGTH;
+      uint16_t record_id;
+      uint32_t timestamp;
+
+      if (ipmi_sel_parse_read_record_id (state_data->sel_ctx,
+                                         record,
+                                         IPMI_SEL_CACHE_RECORD_LENGTH,
+                                         &record_id) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sel_parse_read_record_id: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+          return (-1);
+        }
+
+      cache->record_id_index[i].key = record_id;
+      cache->record_id_index[i].position = i;
+
+      if (ipmi_sel_parse_read_timestamp (state_data->sel_ctx,
+                                         record,
+                                         IPMI_SEL_CACHE_RECORD_LENGTH,
+                                         &timestamp) < 0)
+        {
+          /* not a timestamped record type */
+          if (ipmi_sel_ctx_errnum (state_data->sel_ctx) == IPMI_SEL_ERR_INVALID_SEL_ENTRY)
+            continue;
+
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sel_parse_read_timestamp: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+          return (-1);
+        }
+
+      cache->timestamp_index[cache->timestamp_index_count].key = timestamp;
+      cache->timestamp_index[cache->timestamp_index_count].position = i;
+      cache->timestamp_index_count++;
+    }
+
+  qsort (cache->record_id_index,
+         cache->record_count,
+         sizeof (struct ipmi_sel_cache_index),
+         _sel_cache_index_compare);
+
+  qsort (cache->timestamp_index,
+         cache->timestamp_index_count,
+         sizeof (struct ipmi_sel_cache_index),
+         _sel_cache_index_compare);
+
+  return (0);
+}
+
+int
+ipmi_sel_cache_sync (ipmi_sel_state_data_t *state_data,
+                     struct ipmi_sel_cache *cache)
+{
+  char filename[MAXPATHLEN+1];
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint16_t entries;
+  uint32_t most_recent_addition_timestamp;
+  uint32_t most_recent_erase_timestamp;
+  uint64_t val;
+  int updated = 0;
+  int ret;
+  int rv = -1;
+
+  assert (state_data);
+  assert (cache);
+
+  memset (cache, '\0', sizeof (struct ipmi_sel_cache));
+
+  memset (filename, '\0', MAXPATHLEN + 1);
+  if (sdr_cache_get_host_filename (state_data->pstate,
+                                   state_data->hostname,
+                                   &(state_data->prog_data->args->common_args),
+                                   IPMI_SEL_CACHE_FILENAME_PREFIX,
+                                   filename,
+                                   MAXPATHLEN) < 0)
+    goto cleanup;
+
+  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sel_info_rs)))
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "fiid_obj_create: %s\n",
+                       strerror (errno));
+      goto cleanup;
+    }
+
+  if (ipmi_cmd_get_sel_info (state_data->ipmi_ctx, obj_cmd_rs) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "ipmi_cmd_get_sel_info: %s\n",
+                       ipmi_ctx_errormsg (state_data->ipmi_ctx));
+      goto cleanup;
+    }
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "entries", &val) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "fiid_obj_get: 'entries': %s\n",
+                       fiid_obj_errormsg (obj_cmd_rs));
+      goto cleanup;
+    }
+  entries = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "most_recent_addition_timestamp", &val) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "fiid_obj_get: 'most_recent_addition_timestamp': %s\n",
+                       fiid_obj_errormsg (obj_cmd_rs));
+      goto cleanup;
+    }
+  most_recent_addition_timestamp = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs, "most_recent_erase_timestamp", &val) < 0)
+    {
+      pstdout_fprintf (state_data->pstate,
+                       stderr,
+                       "fiid_obj_get: 'most_recent_erase_timestamp': %s\n",
+                       fiid_obj_errormsg (obj_cmd_rs));
+      goto cleanup;
+    }
+  most_recent_erase_timestamp = val;
+
+  if ((ret = _sel_cache_load (state_data, cache, filename)) < 0)
+    goto cleanup;
+
+  if (ret
+      && cache->entries == entries
+      && cache->most_recent_addition_timestamp == most_recent_addition_timestamp
+      && cache->most_recent_erase_timestamp == most_recent_erase_timestamp)
+    goto index;
+
+  /* Records are only appended unless some were deleted, which changes
+   * the erase timestamp.  Otherwise read from the last record we
+   * have.
+   */
+  if (ret
+      && cache->most_recent_erase_timestamp == most_recent_erase_timestamp
+      && cache->record_count)
+    {
+      uint16_t last_record_id;
+
+      if (ipmi_sel_parse_read_record_id (state_data->sel_ctx,
+                                         cache->records + (cache->record_count - 1) * IPMI_SEL_CACHE_RECORD_LENGTH,
+                                         IPMI_SEL_CACHE_RECORD_LENGTH,
+                                         &last_record_id) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sel_parse_read_record_id: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+          goto cleanup;
+        }
+
+      /* Not IPMI_SEL_RECORD_ID_LAST, so ipmi_sel_parse() bounds its
+       * search for last_record_id by the SEL's real last record id.
+       */
+      if ((ret = _sel_cache_read_sel (state_data,
+                                      cache,
+                                      last_record_id,
+                                      IPMI_SEL_RECORD_ID_LAST - 1,
+                                      1)) < 0)
+        goto cleanup;
+
+      if (ret && cache->record_count == entries)
+        updated = 1;
+    }
+
+  if (!updated)
+    {
+      cache->record_count = 0;
+      if (_sel_cache_read_sel (state_data,
+                               cache,
+                               IPMI_SEL_RECORD_ID_FIRST,
+                               IPMI_SEL_RECORD_ID_LAST,
+                               0) < 0)
+        goto cleanup;
+    }
+
+  cache->entries = entries;
+  cache->most_recent_addition_timestamp = most_recent_addition_timestamp;
+  cache->most_recent_erase_timestamp = most_recent_erase_timestamp;
+
+  if (_sel_cache_store (state_data, cache, filename) < 0)
+    goto cleanup;
+
+ index:
+  if (_sel_cache_index (state_data, cache) < 0)
+    goto cleanup;
+
+  rv = 0;
+ cleanup:
+  fiid_obj_destroy (obj_cmd_rs);
+  return (rv);
+}
+
+static int
+_sel_cache_position_compare (const void *a, const void *b)
+{
+  unsigned int pa = *((const unsigned int *)a);
+  unsigned int pb = *((const unsigned int *)b);
+
+  if (pa != pb)
+    return (pa < pb ? -1 : 1);
+  return (0);
+}
+
+/* first index entry with key >= key */
+static unsigned int
+_sel_cache_index_lower_bound (const struct ipmi_sel_cache_index *index,
+                              unsigned int count,
+                              uint32_t key)
+{
+  unsigned int lo = 0;
+  unsigned int hi = count;
+
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (index[mid].key < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return (lo);
+}
+
+int
+ipmi_sel_cache_select (ipmi_sel_state_data_t *state_data,
+                       struct ipmi_sel_cache *cache,
+                       uint8_t **buf,
+                       unsigned int *buflen)
+{
+  struct ipmi_sel_arguments *args;
+  unsigned int *positions = NULL;
+  unsigned int count = 0;
+  unsigned int i;
+  int rv = -1;
+
+  assert (state_data);
+  assert (cache);
+  assert (buf);
+  assert (buflen);
+
+  args = state_data->prog_data->args;
+
+  if (!(positions = (unsigned int *)malloc ((cache->record_count + args->display_record_list_length + 1) * sizeof (unsigned int))))
+    {
+      pstdout_perror (state_data->pstate, "malloc");
+      goto cleanup;
+    }
+
+  if (args->display)
+    {
+      /* in the order listed, like ipmi_sel_parse_record_ids() */
+      for (i = 0; i < args->display_record_list_length; i++)
+        {
+          unsigned int j;
+
+          j = _sel_cache_index_lower_bound (cache->record_id_index,
+                                            cache->record_count,
+                                            args->display_record_list[i]);
+
+          if (j < cache->record_count
+              && cache->record_id_index[j].key == args->display_record_list[i])
+            positions[count++] = cache->record_id_index[j].position;
+        }
+    }
+  else if (args->display_range)
+    {
+      for (i = _sel_cache_index_lower_bound (cache->record_id_index,
+                                             cache->record_count,
+                                             args->display_range1);
+           i < cache->record_count && cache->record_id_index[i].key <= args->display_range2;
+           i++)
+        positions[count++] = cache->record_id_index[i].position;
+
+      qsort (positions, count, sizeof (unsigned int), _sel_cache_position_compare);
+    }
+  else if (args->tail)
+    {
+      i = (cache->record_count > args->tail_count) ? cache->record_count - args->tail_count : 0;
+      for (; i < cache->record_count; i++)
+        positions[count++] = i;
+    }
+  else if (args->date_range)
+    {
+      for (i = _sel_cache_index_lower_bound (cache->timestamp_index,
+                                             cache->timestamp_index_count,
+                                             args->date_range1);
+           i < cache->timestamp_index_count && cache->timestamp_index[i].key <= args->date_range2;
+           i++)
+        positions[count++] = cache->timestamp_index[i].position;
+
+      qsort (positions, count, sizeof (unsigned int), _sel_cache_position_compare);
+    }
+  else
+    {
+      for (i = 0; i < cache->record_count; i++)
+        positions[count++] = i;
+    }
+
+  if (!((*buf) = (uint8_t *)malloc (count * IPMI_SEL_CACHE_RECORD_LENGTH + 1)))
+    {
+      pstdout_perror (state_data->pstate, "malloc");
+      goto cleanup;
+    }
+
+  for (i = 0; i < count; i++)
+    memcpy ((*buf) + i * IPMI_SEL_CACHE_RECORD_LENGTH,
+            cache->records + positions[i] * IPMI_SEL_CACHE_RECORD_LENGTH,
+            IPMI_SEL_CACHE_RECORD_LENGTH);
+  (*buflen) = count * IPMI_SEL_CACHE_RECORD_LENGTH;
+
+  rv = 0;
+ cleanup:
+  free (positions);
+  return (rv);
+}
+
+void
+ipmi_sel_cache_cleanup (struct ipmi_sel_cache *cache)
+{
+  assert (cache);
+
+  free (cache->records);
+  free (cache->record_id_index);
+  free (cache->timestamp_index);
+  memset (cache, '\0', sizeof (struct ipmi_sel_cache));
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_SEL_CACHE_H
+#define IPMI_SEL_CACHE_H
+
+#include <stdint.h>
+
+#include "ipmi-sel_.h"
+
+struct ipmi_sel_cache_index
+{
+  uint32_t key;
+  unsigned int position;
+};
+
+/* Local copy of a host's SEL, records are stored in SEL order */
+struct ipmi_sel_cache
+{
+  /* SEL info the copy is current with */
+  uint16_t entries;
+  uint32_t most_recent_addition_timestamp;
+  uint32_t most_recent_erase_timestamp;
+
+  uint8_t *records;
+  unsigned int record_count;
+  unsigned int records_allocated;
+
+  /* positions of records sorted by record id and by timestamp,
+   * records w/o a timestamp are not in the timestamp index
+   */
+  struct ipmi_sel_cache_index *record_id_index;
+  struct ipmi_sel_cache_index *timestamp_index;
+  unsigned int timestamp_index_count;
+};
+
+/* Loads the host's SEL cache and brings it up to date with the SEL.
+ * If the SEL has not changed since the cache was stored, Get SEL Info
+ * is the only request sent to the BMC.
+ */
+int ipmi_sel_cache_sync (ipmi_sel_state_data_t *state_data,
+                         struct ipmi_sel_cache *cache);
+
+/* Copies the records selected by the display options (--display,
+ * --display-range, --tail, --date-range) into a buffer for
+ * ipmi_sel_parse_buffer().  Free *buf with free().
+ */
+int ipmi_sel_cache_select (ipmi_sel_state_data_t *state_data,
+                           struct ipmi_sel_cache *cache,
+                           uint8_t **buf,
+                           unsigned int *buflen);
+
+void ipmi_sel_cache_cleanup (struct ipmi_sel_cache *cache);
+
+#endif /* IPMI_SEL_CACHE_H */
@@ -40,6 +40,7 @@
 #include <freeipmi/freeipmi.h>
 
 #include "ipmi-sel_.h"
+#include "ipmi-sel-cache.h"
 #include "ipmi-sel-argp.h"
 
 #include "freeipmi-portability.h"
@@ -1556,6 +1557,9 @@ _display_sel_records (ipmi_sel_state_data_t *state_data)
 {
   struct ipmi_sel_arguments *args;
   fiid_obj_t obj_cmd_rs = NULL;
+  struct ipmi_sel_cache sel_cache;
+  uint8_t *sel_cache_buf = NULL;
+  unsigned int sel_cache_buflen = 0;
   int rv = -1;
   uint64_t val;
 
@@ -1563,6 +1567,8 @@ _display_sel_records (ipmi_sel_state_data_t *state_data)
 
   args = state_data->prog_data->args;
 
+  memset (&sel_cache, '\0', sizeof (struct ipmi_sel_cache));
+
   if (ipmi_sel_ctx_set_separator (state_data->sel_ctx, EVENT_OUTPUT_SEPARATOR) < 0)
     {
       pstdout_fprintf (state_data->pstate,
@@ -1584,6 +1590,18 @@ _display_sel_records (ipmi_sel_state_data_t *state_data)
         }
     }
 
+  if (args->sel_cache)
+    {
+      if (ipmi_sel_cache_sync (state_data, &sel_cache) < 0)
+        goto cleanup;
+
+      if (ipmi_sel_cache_select (state_data,
+                                 &sel_cache,
+                                 &sel_cache_buf,
+                                 &sel_cache_buflen) < 0)
+        goto cleanup;
+    }
+
   if (!args->common_args.ignore_sdr_cache)
     {
       if (calculate_column_widths (state_data->pstate,
@@ -1651,7 +1669,23 @@ _display_sel_records (ipmi_sel_state_data_t *state_data)
 
   /* Record IDs for SEL entries are calculated a bit differently */
 
-  if (state_data->prog_data->args->display)
+  if (args->sel_cache)
+    {
+      /* exact, all the records to display are already local */
+      if (ipmi_sel_parse_buffer (state_data->sel_ctx,
+                                 sel_cache_buf,
+                                 sel_cache_buflen,
+                                 _sel_record_id_callback,
+                                 state_data) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sel_parse_buffer: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+          goto cleanup;
+        }
+    }
+  else if (state_data->prog_data->args->display)
     {
       uint16_t max_record_id = 0;
       int i;
@@ -1770,7 +1804,22 @@ _display_sel_records (ipmi_sel_state_data_t *state_data)
         }
     }
 
-  if (state_data->prog_data->args->display)
+  if (args->sel_cache)
+    {
+      if (ipmi_sel_parse_buffer (state_data->sel_ctx,
+                                 sel_cache_buf,
+                                 sel_cache_buflen,
+                                 _sel_parse_callback,
+                                 state_data) < 0)
+        {
+          pstdout_fprintf (state_data->pstate,
+                           stderr,
+                           "ipmi_sel_parse_buffer: %s\n",
+                           ipmi_sel_ctx_errormsg (state_data->sel_ctx));
+          goto cleanup;
+        }
+    }
+  else if (state_data->prog_data->args->display)
     {
       if (ipmi_sel_parse_record_ids (state_data->sel_ctx,
                                      state_data->prog_data->args->display_record_list,
@@ -1948,6 +1997,8 @@ _display_sel_records (ipmi_sel_state_data_t *state_data)
   rv = 0;
  cleanup:
   fiid_obj_destroy (obj_cmd_rs);
+  free (sel_cache_buf);
+  ipmi_sel_cache_cleanup (&sel_cache);
   return (rv);
 }
 
@@ -2056,6 +2107,10 @@ _ipmi_sel (pstdout_state_t pstate,
   if (state_data.prog_data->args->assume_system_event_records)
     sel_flags |= IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS;
 
+  if (hostname
+      && state_data.prog_data->args->common_args.driver_type == IPMI_DEVICE_LAN_2_0)
+    sel_flags |= IPMI_SEL_FLAGS_PIPELINED;
+
   if (sel_flags)
     {
       /* Don't error out, if this fails we can still continue */
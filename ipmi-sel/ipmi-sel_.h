@@ -69,6 +69,7 @@ enum ipmi_sel_argp_option_keys
     COMMA_SEPARATED_OUTPUT_KEY = 182,
     NO_HEADER_OUTPUT_KEY = 183,
     NON_ABBREVIATED_UNITS_KEY = 184,
+    SEL_CACHE_KEY = 185,
   };
 
 struct ipmi_sel_arguments
@@ -101,6 +102,7 @@ struct ipmi_sel_arguments
   int list_sensor_types;
   int tail;
   uint16_t tail_count;
+  int sel_cache;
   int clear;
   int post_clear;
   int delete;
@@ -1234,6 +1234,27 @@ _display_sensors (ipmi_sensors_state_data_t *state_data)
         }
     }
 
+  /* Keep several Get Sensor Reading requests in flight instead of
+   * waiting a round trip per sensor.  Failure is not fatal, sensors
+   * not prefetched are read one at a time below.
+   */
+  if (state_data->hostname
+      && args->common_args.driver_type == IPMI_DEVICE_LAN_2_0
+      && output_record_ids_length > 1)
+    {
+      if (ipmi_sensor_read_prefetch (state_data->sensor_read_ctx,
+                                     state_data->sdr_ctx,
+                                     output_record_ids,
+                                     output_record_ids_length) < 0)
+        {
+          if (state_data->prog_data->args->common_args.debug)
+            pstdout_fprintf (state_data->pstate,
+                             stderr,
+                             "ipmi_sensor_read_prefetch: %s\n",
+                             ipmi_sensor_read_ctx_errormsg (state_data->sensor_read_ctx));
+        }
+    }
+
   for (i = 0; i < output_record_ids_length; i++)
     {
       uint8_t record_type;
@@ -1419,6 +1440,15 @@ _ipmi_sensors (pstdout_state_t pstate,
       goto cleanup;
     }
 
+  /* Every record is parsed many times over, decode them all once.
+   * Don't error out, if this fails we can still continue.
+   */
+  if (ipmi_sdr_ctx_set_flags (state_data.sdr_ctx, IPMI_SDR_FLAGS_DECODED_CACHE) < 0)
+    pstdout_fprintf (pstate,
+                     stderr,
+                     "ipmi_sdr_ctx_set_flags: %s\n",
+                     ipmi_sdr_ctx_errormsg (state_data.sdr_ctx));
+
   if (!(state_data.sensor_read_ctx = ipmi_sensor_read_ctx_create (state_data.ipmi_ctx)))
     {
       pstdout_perror (pstate, "ipmi_sensor_read_ctx_create()");
@@ -86,6 +86,9 @@
 #define IPMIDETECTD_NODES_PER_SOCKET 8
 #define IPMIDETECTD_SERVER_BACKLOG   5
 
+/* pings are queued and handed to the kernel in batches of this many */
+#define IPMIDETECTD_SENDQ_COUNT      64
+
 /* IPMI has a 6 bit sequence number */
 #define IPMI_RQ_SEQ_MAX  0x3F
 
@@ -114,6 +117,8 @@ List nodes = NULL;
 unsigned int nodes_count = 0;
 hash_t nodes_index = NULL;
 int server_fd = 0;
+ipmi_lan_sendq_t sendq = NULL;
+ipmi_lan_recvq_t recvq = NULL;
 
 extern int h_errno;
 
@@ -463,6 +468,9 @@ _ipmidetectd_send_pings (void)
   if (!(itr = list_iterator_create (nodes)))
     err_exit ("list_iterator_create: %s", strerror (errno));
 
+  /* Nodes are assigned to fds in list order, so pings for the same
+   * fd are queued back to back and go out in one batch.
+   */
   while ((info = list_next (itr)))
     {
       memset (buf, '\0', IPMIDETECTD_BUFLEN);
@@ -470,18 +478,21 @@ _ipmidetectd_send_pings (void)
       if ((len = _ipmi_ping_build (info, buf, IPMIDETECTD_BUFLEN)) < 0)
         err_exit ("_ipmi_ping_build: %s", strerror (errno));
 
-      if (ipmi_lan_sendto (info->fd,
-                           buf,
-                           len,
-                           0,
-                           info->destaddr,
-                           info->destaddr_len) < 0)
-        err_exit ("ipmi_lan_sendto: %s", strerror (errno));
+      if (ipmi_lan_sendq_add (sendq,
+                              info->fd,
+                              buf,
+                              len,
+                              info->destaddr,
+                              info->destaddr_len) < 0)
+        err_exit ("ipmi_lan_sendq_add: %s", strerror (errno));
 
       if (cmd_args.debug)
         fprintf (stderr, "Ping Request to %s\n", info->hostname);
     }
 
+  if (ipmi_lan_sendq_flush (sendq) < 0)
+    err_exit ("ipmi_lan_sendq_flush: %s", strerror (errno));
+
   list_iterator_destroy (itr);
 }
 
@@ -505,25 +516,61 @@ _setup_pfds (struct pollfd *pfds)
 }
 
 static void
-_receive_ping (int fd)
+_receive_ping_from (const struct sockaddr *from, socklen_t fromlen)
 {
   struct sockaddr_in6 from6;
-  struct sockaddr *from = (struct sockaddr *)&from6;
   struct ipmidetectd_info *info;
-  uint8_t buf[IPMIDETECTD_BUFLEN];
   char ipbuf[IPMIDETECTD_BUFLEN + 1];
-  int len;
-  socklen_t fromlen = sizeof (struct sockaddr_in6);
+
+  assert (from);
+
+  if (fromlen > sizeof (struct sockaddr_in6))
+    return;
+
+  /* memcpy hacks to avoid warnings, i.e.
+   * warning: dereferencing pointer 'X' does break strict-aliasing rules
+   */
+  memset (&from6, '\0', sizeof (struct sockaddr_in6));
+  memcpy (&from6, from, fromlen);
+
+  memset (ipbuf, '\0', IPMIDETECTD_BUFLEN + 1);
+  if (from6.sin6_family == AF_INET6)
+    {
+      if (!inet_ntop (AF_INET6, &from6.sin6_addr, ipbuf, IPMIDETECTD_BUFLEN))
+        err_exit ("inet_ntop: %s", strerror (errno));
+    }
+  else
+    {
+      struct sockaddr_in from4;
+
+      memcpy (&from4, from, fromlen);
+
+      if (!inet_ntop (AF_INET, &from4.sin_addr, ipbuf, IPMIDETECTD_BUFLEN))
+        err_exit ("inet_ntop: %s", strerror (errno));
+    }
+
+  if ((info = hash_find (nodes_index, ipbuf)))
+    {
+      if (gettimeofday (&(info->last_received), NULL) < 0)
+        err_exit ("gettimeofday: %s", strerror (errno));
+
+      if (cmd_args.debug)
+        fprintf (stderr, "Ping Reply from %s\n", info->hostname);
+    }
+}
+
+static void
+_receive_ping (int fd)
+{
+  int n, i;
 
   /* We're happy as long as we receive something.  We don't bother
    * checking sequence numbers or anything like that.
+   *
+   * Drain every reply waiting on the fd, up to one per node, in one
+   * read.
    */
-  len = ipmi_lan_recvfrom (fd,
-                           buf,
-                           IPMIDETECTD_BUFLEN,
-                           0,
-                           from,
-                           &fromlen);
+  n = ipmi_lan_recvq_read (recvq, fd);
 
   /* achu & hliebig:
    *
@@ -554,40 +601,24 @@ _receive_ping (int fd)
    * BMC (or IPMI disabled, etc.), just do the recvfrom again to
    * eventually get a timeout, which is the behavior we'd like.
    */
-  if (len < 0
+  if (n < 0
       && (errno == ECONNRESET
           || errno == ECONNREFUSED))
     return;
 
-  if (len < 0)
-    err_exit ("ipmi_lan_recvfrom: %s", strerror (errno));
+  if (n < 0)
+    err_exit ("ipmi_lan_recvq_read: %s", strerror (errno));
 
-  memset (ipbuf, '\0', IPMIDETECTD_BUFLEN + 1);
-  if (from6.sin6_family == AF_INET6)
-    {
-      if (!inet_ntop (AF_INET6, &from6.sin6_addr, ipbuf, IPMIDETECTD_BUFLEN))
-        err_exit ("inet_ntop: %s", strerror (errno));
-    }
-  else
+  for (i = 0; i < n; i++)
     {
-      /* memcpy hacks to avoid warnings, i.e.
-       * warning: dereferencing pointer 'X' does break strict-aliasing rules
-       */
-      struct sockaddr_in from4;
-
-      memcpy (&from4, from, fromlen);
-
-      if (!inet_ntop (AF_INET, &from4.sin_addr, ipbuf, IPMIDETECTD_BUFLEN))
-        err_exit ("inet_ntop: %s", strerror (errno));
-    }
+      const struct sockaddr *from;
+      socklen_t fromlen;
+      const void *buf;
 
-  if ((info = hash_find (nodes_index, ipbuf)))
-    {
-      if (gettimeofday (&(info->last_received), NULL) < 0)
-        err_exit ("gettimeofday: %s", strerror (errno));
+      if (ipmi_lan_recvq_packet (recvq, i, &buf, &from, &fromlen) < 0)
+        err_exit ("ipmi_lan_recvq_packet: %s", strerror (errno));
 
-      if (cmd_args.debug)
-        fprintf (stderr, "Ping Reply from %s\n", info->hostname);
+      _receive_ping_from (from, fromlen);
     }
 }
 
@@ -654,6 +685,12 @@ _ipmidetectd_loop (void)
 
   assert (nodes_count);
 
+  if (!(sendq = ipmi_lan_sendq_create (IPMIDETECTD_SENDQ_COUNT, IPMIDETECTD_BUFLEN)))
+    err_exit ("ipmi_lan_sendq_create: %s", strerror (errno));
+
+  if (!(recvq = ipmi_lan_recvq_create (IPMIDETECTD_NODES_PER_SOCKET, IPMIDETECTD_BUFLEN)))
+    err_exit ("ipmi_lan_recvq_create: %s", strerror (errno));
+
   /* +1 fd for the server fd */
   if (!(pfds = (struct pollfd *)malloc ((fds_count + 1)*sizeof (struct pollfd))))
     err_exit ("malloc: %s", strerror (errno));
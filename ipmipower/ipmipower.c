@@ -91,6 +91,12 @@ fi_hostlist_t output_hostrange[IPMIPOWER_MSG_TYPE_NUM_ENTRIES];
 /* Array of outputs for determining exit value */
 unsigned int output_counts[IPMIPOWER_MSG_TYPE_NUM_ENTRIES];
 
+/* Batched packet I/O on shared sockets (--hosts-per-socket) */
+#define IPMIPOWER_PACKET_QUEUE_COUNT 64
+
+static ipmi_lan_sendq_t sendq = NULL;
+static ipmi_lan_recvq_t recvq = NULL;
+
 static void
 _ipmipower_setup (void)
 {
@@ -208,15 +214,17 @@ _eliminate_nodes (void)
     }
 }
 
-static void
-_sendto (cbuf_t cbuf, int fd, struct sockaddr *destaddr, socklen_t destaddrlen)
+/* _cbuf_read_packet
+ * - Read the outgoing packet stored in a cbuf
+ */
+static int
+_cbuf_read_packet (cbuf_t cbuf, uint8_t *buf)
 {
-  int n, rv;
-  uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
+  int n;
 
   if ((n = cbuf_read (cbuf, buf, IPMIPOWER_PACKET_BUFLEN)) < 0)
     {
-      IPMIPOWER_ERROR (("cbuf_read: %s", fd, strerror (errno)));
+      IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
 
@@ -226,6 +234,24 @@ _sendto (cbuf_t cbuf, int fd, struct sockaddr *destaddr, socklen_t destaddrlen)
       exit (EXIT_FAILURE);
     }
 
+  /* cbuf should be empty now */
+  if (!cbuf_is_empty (cbuf))
+    {
+      IPMIPOWER_ERROR (("cbuf not empty"));
+      exit (EXIT_FAILURE);
+    }
+
+  return (n);
+}
+
+static void
+_sendto (cbuf_t cbuf, int fd, struct sockaddr *destaddr, socklen_t destaddrlen)
+{
+  int n, rv;
+  uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
+
+  n = _cbuf_read_packet (cbuf, buf);
+
   do
     {
       if (cmd_args.common_args.driver_type == IPMI_DEVICE_LAN)
@@ -259,19 +285,74 @@ _sendto (cbuf_t cbuf, int fd, struct sockaddr *destaddr, socklen_t destaddrlen)
       IPMIPOWER_ERROR (("ipmi_lan/rmcpplus_sendto: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
+}
 
-  /* cbuf should be empty now */
+/* _sendq_add
+ * - Queue an outgoing packet for a shared socket, sent by the
+ *   next ipmi_lan_sendq_flush()
+ *
+ * ipmi_lan_sendto and ipmi_rmcpplus_sendto are identical underneath,
+ * so there is no need to distinguish the packet types here.
+ */
+static void
+_sendq_add (cbuf_t cbuf, int fd, struct sockaddr *destaddr, socklen_t destaddrlen)
+{
+  uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
+  int n;
+
+  n = _cbuf_read_packet (cbuf, buf);
+
+  if (ipmi_lan_sendq_add (sendq, fd, buf, n, destaddr, destaddrlen) < 0)
+    {
+      IPMIPOWER_ERROR (("ipmi_lan_sendq_add: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+}
+
+/* _cbuf_write_packet
+ * - Store a received packet, replacing any older one
+ */
+static void
+_cbuf_write_packet (cbuf_t cbuf, uint8_t *buf, int rv)
+{
+  int n, dropped = 0;
+
+  /* cbuf should be empty, but if it isn't, empty it */
   if (!cbuf_is_empty (cbuf))
     {
-      IPMIPOWER_ERROR (("cbuf not empty"));
+      IPMIPOWER_DEBUG (("cbuf not empty, draining"));
+      do
+        {
+          uint8_t tempbuf[IPMIPOWER_PACKET_BUFLEN];
+
+          if (cbuf_read (cbuf, tempbuf, IPMIPOWER_PACKET_BUFLEN) < 0)
+            {
+              IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
+              exit (EXIT_FAILURE);
+            }
+        } while(!cbuf_is_empty (cbuf));
+    }
+
+  if ((n = cbuf_write (cbuf, buf, rv, &dropped)) < 0)
+    {
+      IPMIPOWER_ERROR (("cbuf_write: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
+
+  if (n != rv)
+    {
+      IPMIPOWER_ERROR (("cbuf_write: rv=%d n=%d", rv, n));
+      exit (EXIT_FAILURE);
+    }
+
+  if (dropped)
+    IPMIPOWER_DEBUG (("cbuf_write: read dropped %d bytes", dropped));
 }
 
 static void
 _recvfrom (cbuf_t cbuf, int fd, struct sockaddr *srcaddr, socklen_t srcaddrlen)
 {
-  int n, rv, dropped = 0;
+  int rv;
   uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
   struct sockaddr_in6 from6;
   struct sockaddr *from = (struct sockaddr *)&from6;
@@ -364,36 +445,82 @@ _recvfrom (cbuf_t cbuf, int fd, struct sockaddr *srcaddr, socklen_t srcaddrlen)
         return;
     }
 
-  /* cbuf should be empty, but if it isn't, empty it */
-  if (!cbuf_is_empty (cbuf))
+  _cbuf_write_packet (cbuf, buf, rv);
+}
+
+/* _shared_recvfrom
+ * - Read all packets pending on a shared socket and hand each to
+ *   the connections it may belong to
+ */
+static void
+_shared_recvfrom (int fd)
+{
+  while (1)
     {
-      IPMIPOWER_DEBUG (("cbuf not empty, draining"));
-      do
+      int n, i;
+
+      /* See comments in _recvfrom() regarding ipmi_lan_recvfrom */
+      if ((n = ipmi_lan_recvq_read (recvq, fd)) < 0)
         {
-          uint8_t tempbuf[IPMIPOWER_PACKET_BUFLEN];
+          /* See comments in _recvfrom() regarding ECONNRESET/ECONNREFUSED */
+          if (errno == ECONNRESET
+              || errno == ECONNREFUSED)
+            {
+              IPMIPOWER_DEBUG (("ipmi_lan_recvq_read: connection refused: %s", strerror (errno)));
+              continue;
+            }
 
-          if (cbuf_read (cbuf, tempbuf, IPMIPOWER_PACKET_BUFLEN) < 0)
+          IPMIPOWER_ERROR (("ipmi_lan_recvq_read: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      for (i = 0; i < n; i++)
+        {
+          const struct sockaddr *from;
+          socklen_t fromlen;
+          const void *pkt;
+          uint8_t buf[IPMIPOWER_PACKET_BUFLEN];
+          struct ipmipower_connection *ic;
+          int rv;
+
+          if ((rv = ipmi_lan_recvq_packet (recvq, i, &pkt, &from, &fromlen)) < 0)
             {
-              IPMIPOWER_ERROR (("cbuf_read: %s", strerror (errno)));
+              IPMIPOWER_ERROR (("ipmi_lan_recvq_packet: %s", strerror (errno)));
               exit (EXIT_FAILURE);
             }
-        } while(!cbuf_is_empty (cbuf));
-    }
 
-  if ((n = cbuf_write (cbuf, buf, rv, &dropped)) < 0)
-    {
-      IPMIPOWER_ERROR (("cbuf_write: %s", strerror (errno)));
-      exit (EXIT_FAILURE);
-    }
+          /* too short for an RMCP header */
+          if (rv < 4)
+            continue;
 
-  if (n != rv)
-    {
-      IPMIPOWER_ERROR (("cbuf_write: rv=%d n=%d", rv, n));
-      exit (EXIT_FAILURE);
-    }
+          if (!(ic = ipmipower_connection_shared_lookup (ics, ics_len, from, fromlen)))
+            {
+              IPMIPOWER_DEBUG (("packet from unknown host"));
+              continue;
+            }
 
-  if (dropped)
-    IPMIPOWER_DEBUG (("cbuf_write: read dropped %d bytes", dropped));
+          memcpy (buf, pkt, rv);
+
+          /* Hostnames resolving to the same address each get a copy, the
+           * session and sequence number checks discard the ones that are
+           * not theirs.
+           */
+          for (; ic; ic = ic->shared_next)
+            {
+              if ((buf[3] & 0x1F) == RMCP_HDR_MESSAGE_CLASS_ASF)
+                {
+                  if (cmd_args.ping_interval)
+                    _cbuf_write_packet (ic->ping_in, buf, rv);
+                }
+              else
+                _cbuf_write_packet (ic->ipmi_in, buf, rv);
+            }
+        }
+
+      /* a short read means the socket is drained */
+      if (n < IPMIPOWER_PACKET_QUEUE_COUNT)
+        return;
+    }
 }
 
 /* _poll_loop
@@ -413,11 +540,29 @@ _poll_loop (int non_interactive)
    */
   extra_fds = 1 + (non_interactive ? 0 : 1);
 
+  if (cmd_args.hosts_per_socket)
+    {
+      if (!(sendq = ipmi_lan_sendq_create (IPMIPOWER_PACKET_QUEUE_COUNT,
+                                           IPMIPOWER_PACKET_BUFLEN)))
+        {
+          IPMIPOWER_ERROR (("ipmi_lan_sendq_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
+      if (!(recvq = ipmi_lan_recvq_create (IPMIPOWER_PACKET_QUEUE_COUNT,
+                                           IPMIPOWER_PACKET_BUFLEN)))
+        {
+          IPMIPOWER_ERROR (("ipmi_lan_recvq_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+    }
+
   while (non_interactive || ipmipower_prompt_process_cmdline ())
     {
       int i, num, timeout;
       int powercmd_timeout = -1;
       int ping_timeout = -1;
+      int connection_fds;
 
       /* If there are no pending commands before this call,
        * powercmd_timeout will not be set, leaving it at -1
@@ -453,13 +598,20 @@ _poll_loop (int non_interactive)
        * going to create a more efficient O(n) poll loop.
        */
 
-      /* Has the number of hosts changed? */
-      if (nfds != (ics_len*2) + extra_fds)
+      if (cmd_args.hosts_per_socket)
+        connection_fds = ipmipower_connection_shared_fd_count (ics, ics_len);
+      else
         {
           /* The "*2" is for each host's two fds, one for ipmi
            * (ipmi_fd) and one for rmcp (ping_fd).
            */
-          nfds = (ics_len*2) + extra_fds;
+          connection_fds = ics_len*2;
+        }
+
+      /* Has the number of hosts changed? */
+      if (nfds != connection_fds + extra_fds)
+        {
+          nfds = connection_fds + extra_fds;
           free (pfds);
 
           if (!(pfds = (struct pollfd *)malloc (nfds * sizeof (struct pollfd))))
@@ -469,23 +621,56 @@ _poll_loop (int non_interactive)
             }
         }
 
-      for (i = 0; i < ics_len; i++)
+      if (cmd_args.hosts_per_socket)
         {
-          pfds[i*2].fd = ics[i].ipmi_fd;
-          pfds[i*2+1].fd = ics[i].ping_fd;
-          pfds[i*2].events = pfds[i*2+1].events = 0;
-          pfds[i*2].revents = pfds[i*2+1].revents = 0;
+          /* Shared sockets are almost always writable, so flush
+           * outgoing packets now instead of polling for POLLOUT on
+           * behalf of every host.  Hosts sharing a socket are
+           * adjacent in ics, so their packets are sent in batches.
+           */
+          for (i = 0; i < ics_len; i++)
+            {
+              if (!cbuf_is_empty (ics[i].ipmi_out))
+                _sendq_add (ics[i].ipmi_out, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
 
-          pfds[i*2].events |= POLLIN;
-          if (!cbuf_is_empty (ics[i].ipmi_out))
-            pfds[i*2].events |= POLLOUT;
+              if (cmd_args.ping_interval
+                  && !cbuf_is_empty (ics[i].ping_out))
+                _sendq_add (ics[i].ping_out, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+            }
 
-          if (!cmd_args.ping_interval)
-            continue;
+          if (ipmi_lan_sendq_flush (sendq) < 0)
+            {
+              IPMIPOWER_ERROR (("ipmi_lan_sendq_flush: %s", strerror (errno)));
+              exit (EXIT_FAILURE);
+            }
+
+          for (i = 0; i < connection_fds; i++)
+            {
+              pfds[i].fd = ipmipower_connection_shared_fd (ics, ics_len, i);
+              pfds[i].events = POLLIN;
+              pfds[i].revents = 0;
+            }
+        }
+      else
+        {
+          for (i = 0; i < ics_len; i++)
+            {
+              pfds[i*2].fd = ics[i].ipmi_fd;
+              pfds[i*2+1].fd = ics[i].ping_fd;
+              pfds[i*2].events = pfds[i*2+1].events = 0;
+              pfds[i*2].revents = pfds[i*2+1].revents = 0;
+
+              pfds[i*2].events |= POLLIN;
+              if (!cbuf_is_empty (ics[i].ipmi_out))
+                pfds[i*2].events |= POLLOUT;
 
-          pfds[i*2+1].events |= POLLIN;
-          if (!cbuf_is_empty (ics[i].ping_out))
-            pfds[i*2+1].events |= POLLOUT;
+              if (!cmd_args.ping_interval)
+                continue;
+
+              pfds[i*2+1].events |= POLLIN;
+              if (!cbuf_is_empty (ics[i].ping_out))
+                pfds[i*2+1].events |= POLLOUT;
+            }
         }
 
       if (!non_interactive)
@@ -503,38 +688,50 @@ _poll_loop (int non_interactive)
 
       ipmipower_poll (pfds, nfds, timeout);
 
-      for (i = 0; i < ics_len; i++)
+      if (cmd_args.hosts_per_socket)
         {
-          if (pfds[i*2].revents & POLLERR)
+          for (i = 0; i < connection_fds; i++)
             {
-              IPMIPOWER_DEBUG (("host = %s; IPMI POLLERR", ics[i].hostname));
-              /* See comments in _ipmi_recvfrom() regarding ECONNRESET/ECONNREFUSED */
-              _recvfrom (ics[i].ipmi_in, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+              /* See comments in _recvfrom() regarding ECONNRESET/ECONNREFUSED */
+              if (pfds[i].revents & (POLLIN | POLLERR))
+                _shared_recvfrom (pfds[i].fd);
             }
-          else
+        }
+      else
+        {
+          for (i = 0; i < ics_len; i++)
             {
-              if (pfds[i*2].revents & POLLIN)
-                _recvfrom (ics[i].ipmi_in, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+              if (pfds[i*2].revents & POLLERR)
+                {
+                  IPMIPOWER_DEBUG (("host = %s; IPMI POLLERR", ics[i].hostname));
+                  /* See comments in _ipmi_recvfrom() regarding ECONNRESET/ECONNREFUSED */
+                  _recvfrom (ics[i].ipmi_in, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+                }
+              else
+                {
+                  if (pfds[i*2].revents & POLLIN)
+                    _recvfrom (ics[i].ipmi_in, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
 
-              if (pfds[i*2].revents & POLLOUT)
-                _sendto (ics[i].ipmi_out, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
-            }
+                  if (pfds[i*2].revents & POLLOUT)
+                    _sendto (ics[i].ipmi_out, ics[i].ipmi_fd, ics[i].destaddr, ics[i].destaddrlen);
+                }
 
-          if (!cmd_args.ping_interval)
-            continue;
+              if (!cmd_args.ping_interval)
+                continue;
 
-          if (pfds[i*2+1].revents & POLLERR)
-            {
-              IPMIPOWER_DEBUG (("host = %s; PING_POLLERR", ics[i].hostname));
-              _recvfrom (ics[i].ping_in, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
-            }
-          else
-            {
-              if (pfds[i*2+1].revents & POLLIN)
-                _recvfrom (ics[i].ping_in, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+              if (pfds[i*2+1].revents & POLLERR)
+                {
+                  IPMIPOWER_DEBUG (("host = %s; PING_POLLERR", ics[i].hostname));
+                  _recvfrom (ics[i].ping_in, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+                }
+              else
+                {
+                  if (pfds[i*2+1].revents & POLLIN)
+                    _recvfrom (ics[i].ping_in, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
 
-              if (pfds[i*2+1].revents & POLLOUT)
-                _sendto (ics[i].ping_out, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+                  if (pfds[i*2+1].revents & POLLOUT)
+                    _sendto (ics[i].ping_out, ics[i].ping_fd, ics[i].destaddr, ics[i].destaddrlen);
+                }
             }
         }
 
@@ -575,6 +772,10 @@ _poll_loop (int non_interactive)
         }
     }
 
+  ipmi_lan_sendq_destroy (sendq);
+  ipmi_lan_recvq_destroy (recvq);
+  sendq = NULL;
+  recvq = NULL;
   free (pfds);
 }
 
@@ -372,6 +372,7 @@ struct ipmipower_powercmd {
   uint8_t confidentiality_key[IPMI_MAX_CONFIDENTIALITY_KEY_LENGTH];
   void *confidentiality_key_ptr;
   unsigned int confidentiality_key_len;
+  ipmi_rmcpplus_crypt_cache_t crypt_cache;
   uint8_t initial_message_tag;
   uint8_t message_tag_count;
   uint32_t session_sequence_number;
@@ -480,6 +481,13 @@ struct ipmipower_connection
 
   /* for eliminate option */
   int skip;
+
+  /* for hosts-per-socket, ipmi_fd and ping_fd are shared with other
+   * connections and packets are matched to us by source address
+   */
+  struct ipmipower_connection_shared *shared;
+  char shared_key[INET6_ADDRSTRLEN + 1];
+  struct ipmipower_connection *shared_next;
 };
 
 typedef struct ipmipower_powercmd *ipmipower_powercmd_t;
@@ -508,6 +516,7 @@ enum ipmipower_argp_option_keys
     PING_PACKET_COUNT_KEY = 174,
     PING_PERCENT_KEY = 175,
     PING_CONSEC_COUNT_KEY = 176,
+    HOSTS_PER_SOCKET_KEY = 177,
   };
 
 struct ipmipower_arguments
@@ -530,6 +539,7 @@ struct ipmipower_arguments
   unsigned int ping_packet_count;
   unsigned int ping_percent;
   unsigned int ping_consec_count;
+  unsigned int hosts_per_socket;
 };
 
 #endif /* IPMIPOWER_H */
@@ -116,9 +116,11 @@ static struct argp_option cmdline_options[] =
       "Specify the ping percent value.", 57},
     { "ping-consec-count", PING_CONSEC_COUNT_KEY, "COUNT", 0,
       "Specify the ping consecutive count.", 58},
+    { "hosts-per-socket", HOSTS_PER_SOCKET_KEY, "COUNT", 0,
+      "Share each UDP socket between up to COUNT hosts.", 59},
 #ifndef NDEBUG
     { "rmcpdump", RMCPDUMP_KEY, 0, 0,
-      "Turn on RMCP packet dump output.", 59},
+      "Turn on RMCP packet dump output.", 60},
 #endif
     { NULL, 0, NULL, 0, NULL, 0}
   };
@@ -285,6 +287,18 @@ cmdline_parse (int key,
         }
       cmd_args->ping_consec_count = tmp;
       break;
+    case HOSTS_PER_SOCKET_KEY:       /* --hosts-per-socket */
+      errno = 0;
+      tmp = strtol (arg, &endptr, 10);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp < 0)
+        {
+          fprintf (stderr, "hosts per socket invalid");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->hosts_per_socket = tmp;
+      break;
       /* removed legacy short options */
     default:
       return (common_parse_opt (key, arg, &(cmd_args->common_args)));
@@ -338,6 +352,8 @@ _ipmipower_config_file_parse (struct ipmipower_arguments *cmd_args)
     cmd_args->ping_percent = config_file_data.ping_percent;
   if (config_file_data.ping_consec_count_count)
     cmd_args->ping_consec_count = config_file_data.ping_consec_count;
+  if (config_file_data.hosts_per_socket_count)
+    cmd_args->hosts_per_socket = config_file_data.hosts_per_socket;
 }
 
 static void
@@ -407,6 +423,7 @@ ipmipower_argp_parse (int argc, char **argv, struct ipmipower_arguments *cmd_arg
   cmd_args->ping_packet_count = 10;
   cmd_args->ping_percent = 50;
   cmd_args->ping_consec_count = 5;
+  cmd_args->hosts_per_socket = 0;
 
   argp_parse (&cmdline_config_file_argp,
               argc,
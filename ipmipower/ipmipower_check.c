@@ -191,16 +191,17 @@ ipmipower_check_authentication_code (ipmipower_powercmd_t ip,
 
       password = cmd_args.common_args.password;
 
-      if ((rv = ipmi_rmcpplus_check_packet_session_authentication_code (integrity_algorithm,
-                                                                        buf,
-                                                                        buflen,
-                                                                        ip->integrity_key_ptr,
-                                                                        ip->integrity_key_len,
-                                                                        password,
-                                                                        (password) ? strlen (password) : 0,
-                                                                        ip->obj_rmcpplus_session_trlr_rs)) < 0)
+      if ((rv = ipmi_rmcpplus_check_packet_session_authentication_code_cached (ip->crypt_cache,
+                                                                               integrity_algorithm,
+                                                                               buf,
+                                                                               buflen,
+                                                                               ip->integrity_key_ptr,
+                                                                               ip->integrity_key_len,
+                                                                               password,
+                                                                               (password) ? strlen (password) : 0,
+                                                                               ip->obj_rmcpplus_session_trlr_rs)) < 0)
         {
-          IPMIPOWER_ERROR (("ipmi_rmcpplus_check_packet_session_authentication_code: %s", strerror (errno)));
+          IPMIPOWER_ERROR (("ipmi_rmcpplus_check_packet_session_authentication_code_cached: %s", strerror (errno)));
           exit (EXIT_FAILURE);
         }
     }
@@ -60,6 +60,7 @@
 #include "freeipmi-portability.h"
 #include "cbuf.h"
 #include "fi_hostlist.h"
+#include "hash.h"
 #include "network.h"
 
 extern cbuf_t ttyout;
@@ -69,6 +70,28 @@ extern struct ipmipower_arguments cmd_args;
 #define IPMIPOWER_MIN_CONNECTION_BUF 1024*2
 #define IPMIPOWER_MAX_CONNECTION_BUF 1024*4
 
+#define IPMIPOWER_SHARED_SOCKETS_INCREMENT 16
+
+/* With hosts-per-socket, all connections of one array share a pool
+ * of sockets.  A socket carries both IPMI and RMCP ping traffic for
+ * its hosts, packets received on it are matched back to connections
+ * by source address through the hosts hash.
+ */
+struct ipmipower_shared_socket
+{
+  int fd;
+  int family;
+  unsigned int hosts;
+};
+
+struct ipmipower_connection_shared
+{
+  struct ipmipower_shared_socket *sockets;
+  unsigned int sockets_len;
+  unsigned int sockets_size;
+  hash_t hosts_index;
+};
+
 /* _clean_fd
  * - Remove any extraneous packets sitting on the fd buf
  */
@@ -110,7 +133,9 @@ ipmipower_connection_clear (struct ipmipower_connection *ic)
 {
   assert (ic);
 
-  _clean_fd (ic->ipmi_fd);
+  /* other hosts' packets may be queued on a shared socket */
+  if (!ic->shared)
+    _clean_fd (ic->ipmi_fd);
   if (cbuf_drop (ic->ipmi_in, -1) < 0)
     {
       IPMIPOWER_ERROR (("cbuf_drop: %s", strerror (errno)));
@@ -124,6 +149,233 @@ ipmipower_connection_clear (struct ipmipower_connection *ic)
   return;
 }
 
+static struct ipmipower_connection_shared *
+_shared_create (unsigned int host_count)
+{
+  struct ipmipower_connection_shared *shared;
+
+  if (!(shared = (struct ipmipower_connection_shared *)malloc (sizeof (struct ipmipower_connection_shared))))
+    {
+      IPMIPOWER_ERROR (("malloc: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+  memset (shared, '\0', sizeof (struct ipmipower_connection_shared));
+
+  if (!(shared->hosts_index = hash_create (host_count,
+                                           (hash_key_f)hash_key_string,
+                                           (hash_cmp_f)strcmp,
+                                           NULL)))
+    {
+      IPMIPOWER_ERROR (("hash_create: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  return (shared);
+}
+
+static void
+_shared_destroy (struct ipmipower_connection_shared *shared)
+{
+  unsigned int i;
+
+  if (!shared)
+    return;
+
+  for (i = 0; i < shared->sockets_len; i++)
+    {
+      /* ignore potential error, cleanup path */
+      close (shared->sockets[i].fd);
+    }
+  free (shared->sockets);
+  hash_destroy (shared->hosts_index);
+  free (shared);
+}
+
+/* _shared_key
+ * - Get the string used to match packets from addr to a connection
+ */
+static int
+_shared_key (const struct sockaddr *addr, socklen_t addrlen, char *buf, socklen_t buflen)
+{
+  assert (addr);
+  assert (buf);
+  assert (buflen);
+
+  /* memcpy hacks to avoid warnings, i.e.
+   * warning: dereferencing pointer 'X' does break strict-aliasing rules
+   */
+  if (addr->sa_family == AF_INET6)
+    {
+      struct sockaddr_in6 addr6;
+
+      if (addrlen < sizeof (struct sockaddr_in6))
+        return (-1);
+
+      memcpy (&addr6, addr, sizeof (struct sockaddr_in6));
+      if (!inet_ntop (AF_INET6, &addr6.sin6_addr, buf, buflen))
+        return (-1);
+    }
+  else if (addr->sa_family == AF_INET)
+    {
+      struct sockaddr_in addr4;
+
+      if (addrlen < sizeof (struct sockaddr_in))
+        return (-1);
+
+      memcpy (&addr4, addr, sizeof (struct sockaddr_in));
+      if (!inet_ntop (AF_INET, &addr4.sin_addr, buf, buflen))
+        return (-1);
+    }
+  else
+    return (-1);
+
+  return (0);
+}
+
+/* _shared_socket_get
+ * - Get a pool socket with room for another host, create one if
+ *   necessary
+ * - Returns fd on success, -1 on error
+ */
+static int
+_shared_socket_get (struct ipmipower_connection_shared *shared,
+                    struct sockaddr *srcaddr,
+                    socklen_t srcaddrlen)
+{
+  struct ipmipower_shared_socket *ss;
+  unsigned int i;
+  int fd;
+
+  assert (shared);
+  assert (srcaddr);
+  assert (cmd_args.hosts_per_socket);
+
+  /* only the most recently created socket of a family can have room */
+  for (i = shared->sockets_len; i > 0; i--)
+    {
+      ss = &shared->sockets[i - 1];
+      if (ss->family != srcaddr->sa_family)
+        continue;
+
+      if (ss->hosts < cmd_args.hosts_per_socket)
+        {
+          ss->hosts++;
+          return (ss->fd);
+        }
+      break;
+    }
+
+  if ((fd = socket (srcaddr->sa_family, SOCK_DGRAM, 0)) < 0)
+    return (-1);
+
+  if (bind (fd, srcaddr, srcaddrlen) < 0)
+    {
+      /* ignore potential error, error path */
+      close (fd);
+      return (-1);
+    }
+
+  if (shared->sockets_len == shared->sockets_size)
+    {
+      struct ipmipower_shared_socket *tmp;
+
+      if (!(tmp = (struct ipmipower_shared_socket *)realloc (shared->sockets,
+                                                             (shared->sockets_size + IPMIPOWER_SHARED_SOCKETS_INCREMENT) * sizeof (struct ipmipower_shared_socket))))
+        {
+          IPMIPOWER_ERROR (("realloc: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+      shared->sockets = tmp;
+      shared->sockets_size += IPMIPOWER_SHARED_SOCKETS_INCREMENT;
+    }
+
+  ss = &shared->sockets[shared->sockets_len++];
+  ss->fd = fd;
+  ss->family = srcaddr->sa_family;
+  ss->hosts = 1;
+  return (fd);
+}
+
+/* _shared_host_add
+ * - Make connection findable by the source address of its packets
+ */
+static void
+_shared_host_add (struct ipmipower_connection *ic)
+{
+  struct ipmipower_connection *icnode;
+
+  assert (ic);
+  assert (ic->shared);
+  assert (ic->destaddr);
+
+  if (_shared_key (ic->destaddr,
+                   ic->destaddrlen,
+                   ic->shared_key,
+                   INET6_ADDRSTRLEN + 1) < 0)
+    {
+      IPMIPOWER_ERROR (("inet_ntop: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+
+  /* Several hostnames may resolve to the same address, chain them,
+   * the packet checks will sort out whose packet it is.
+   */
+  if ((icnode = hash_find (ic->shared->hosts_index, ic->shared_key)))
+    {
+      while (icnode->shared_next)
+        icnode = icnode->shared_next;
+      icnode->shared_next = ic;
+      return;
+    }
+
+  if (!hash_insert (ic->shared->hosts_index, ic->shared_key, ic))
+    {
+      IPMIPOWER_ERROR (("hash_insert: %s", strerror (errno)));
+      exit (EXIT_FAILURE);
+    }
+}
+
+/* _connection_addrs
+ * - Setup destination and source addresses from ai
+ * - Returns 0 on success, -1 if the address family is not supported
+ */
+static int
+_connection_addrs (struct ipmipower_connection *ic, struct addrinfo *ai)
+{
+  assert (ic);
+  assert (ai);
+
+  if (ai->ai_family == AF_INET)
+    {
+      memcpy (&(ic->destaddr4), ai->ai_addr, ai->ai_addrlen);
+      ic->destaddr = (struct sockaddr *)&(ic->destaddr4);
+      ic->destaddrlen = sizeof (struct sockaddr_in);
+
+      /* zero everywhere, secure ephemeral port */
+      memset (&(ic->srcaddr4), '\0', sizeof (struct sockaddr_in));
+      ic->srcaddr4.sin_family = AF_INET;
+
+      ic->srcaddr = (struct sockaddr *)&(ic->srcaddr4);
+      ic->srcaddrlen = sizeof (struct sockaddr_in);
+    }
+  else if (ai->ai_family == AF_INET6)
+    {
+      memcpy (&(ic->destaddr6), ai->ai_addr, ai->ai_addrlen);
+      ic->destaddr = (struct sockaddr *)&(ic->destaddr6);
+      ic->destaddrlen = sizeof (struct sockaddr_in6);
+
+      /* zero everywhere, secure ephemeral port */
+      memset (&(ic->srcaddr6), '\0', sizeof (struct sockaddr_in6));
+      ic->srcaddr6.sin6_family = AF_INET6;
+      ic->srcaddr = (struct sockaddr *)&(ic->srcaddr6);
+      ic->srcaddrlen = sizeof (struct sockaddr_in6);
+    }
+  else
+    return (-1);
+
+  return (0);
+}
+
 static int
 _connection_setup (struct ipmipower_connection *ic, const char *hostname)
 {
@@ -311,6 +563,32 @@ _connection_setup (struct ipmipower_connection *ic, const char *hostname)
   /* Try all of the different answers we got, until we succeed. */
   for (ai = ai_res; ai != NULL; ai = ai->ai_next)
     {
+      if (ic->shared)
+        {
+          int fd;
+
+          if (_connection_addrs (ic, ai) < 0)
+            continue;
+
+          if ((fd = _shared_socket_get (ic->shared,
+                                        ic->srcaddr,
+                                        ic->srcaddrlen)) < 0)
+            {
+              if (errno == EMFILE)
+                {
+                  IPMIPOWER_DEBUG (("file descriptor limit reached"));
+                  return (-1);
+                }
+              continue;
+            }
+
+          ic->ipmi_fd = fd;
+          ic->ping_fd = fd;
+          _shared_host_add (ic);
+          ic->skip = 0;
+          break;
+        }
+
       if ((ic->ipmi_fd = socket (ai->ai_family,
 				 ai->ai_socktype, ai->ai_protocol)) < 0)
 	{
@@ -331,32 +609,7 @@ _connection_setup (struct ipmipower_connection *ic, const char *hostname)
 	    }
 	}
 
-      if (ai->ai_family == AF_INET)
-        {
-          memcpy (&(ic->destaddr4), ai->ai_addr, ai->ai_addrlen);
-          ic->destaddr = (struct sockaddr *)&(ic->destaddr4);
-          ic->destaddrlen = sizeof (struct sockaddr_in);
-
-          /* zero everywhere, secure ephemeral port */
-          memset (&(ic->srcaddr4), '\0', sizeof (struct sockaddr_in));
-          ic->srcaddr4.sin_family = AF_INET;
-
-          ic->srcaddr = (struct sockaddr *)&(ic->srcaddr4);
-          ic->srcaddrlen = sizeof (struct sockaddr_in);
-        }
-      else if (ai->ai_family == AF_INET6)
-        {
-          memcpy (&(ic->destaddr6), ai->ai_addr, ai->ai_addrlen);
-          ic->destaddr = (struct sockaddr *)&(ic->destaddr6);
-          ic->destaddrlen = sizeof (struct sockaddr_in6);
-
-          /* zero everywhere, secure ephemeral port */
-          memset (&(ic->srcaddr6), '\0', sizeof (struct sockaddr_in6));
-          ic->srcaddr6.sin6_family = AF_INET6;
-          ic->srcaddr = (struct sockaddr *)&(ic->srcaddr6);
-          ic->srcaddrlen = sizeof (struct sockaddr_in6);
-        }
-      else
+      if (_connection_addrs (ic, ai) < 0)
         {
 	  close(ic->ipmi_fd);
 	  close(ic->ping_fd);
@@ -573,6 +826,7 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
   char *hstr = NULL;
   char *h2str = NULL;
   struct ipmipower_connection *ics = NULL;
+  struct ipmipower_connection_shared *shared = NULL;
   int host_count;
   int errflag = 0;
   int emfilecount = 0;
@@ -593,10 +847,14 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
 
   memset (ics, '\0', (sizeof (struct ipmipower_connection) * host_count));
 
+  if (cmd_args.hosts_per_socket)
+    shared = _shared_create (host_count);
+
   for (i = 0; i < host_count; i++)
     {
       ics[i].ipmi_fd = -1;
       ics[i].ping_fd = -1;
+      ics[i].shared = shared;
     }
 
   if (!(h = fi_hostlist_create (hostname)))
@@ -748,10 +1006,13 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
       int i;
       for (i = 0; i < index; i++)
         {
-          /* ignore potential error, error path */
-          close (ics[i].ipmi_fd);
-          /* ignore potential error, error path */
-          close (ics[i].ping_fd);
+          if (!shared)
+            {
+              /* ignore potential error, error path */
+              close (ics[i].ipmi_fd);
+              /* ignore potential error, error path */
+              close (ics[i].ping_fd);
+            }
           if (ics[i].ipmi_in)
             cbuf_destroy (ics[i].ipmi_in);
           if (ics[i].ipmi_out)
@@ -778,10 +1039,19 @@ ipmipower_connection_array_create (const char *hostname, unsigned int *len)
                 }
             }
         }
+      _shared_destroy (shared);
       free (ics);
       return (NULL);
     }
 
+  /* nothing to share with */
+  if (!index)
+    {
+      _shared_destroy (shared);
+      for (i = 0; i < host_count; i++)
+        ics[i].shared = NULL;
+    }
+
   *len = index;
   return (ics);
 }
@@ -797,10 +1067,13 @@ ipmipower_connection_array_destroy (struct ipmipower_connection *ics,
 
   for (i = 0; i < ics_len; i++)
     {
-      /* ignore potential error, cleanup path */
-      close (ics[i].ipmi_fd);
-      /* ignore potential error, cleanup path */
-      close (ics[i].ping_fd);
+      if (!ics[i].shared)
+        {
+          /* ignore potential error, cleanup path */
+          close (ics[i].ipmi_fd);
+          /* ignore potential error, cleanup path */
+          close (ics[i].ping_fd);
+        }
       cbuf_destroy (ics[i].ipmi_in);
       cbuf_destroy (ics[i].ipmi_out);
       cbuf_destroy (ics[i].ping_in);
@@ -823,6 +1096,9 @@ ipmipower_connection_array_destroy (struct ipmipower_connection *ics,
             }
         }
     }
+  /* all connections of an array share the same pool */
+  if (ics_len)
+    _shared_destroy (ics[0].shared);
   free (ics);
 }
 
@@ -844,3 +1120,73 @@ ipmipower_connection_hostname_index (struct ipmipower_connection *ics,
   IPMIPOWER_DEBUG (("host = %s not found", hostname));
   return (-1);
 }
+
+unsigned int
+ipmipower_connection_shared_fd_count (struct ipmipower_connection *ics,
+                                      unsigned int ics_len)
+{
+  if (!ics || !ics_len || !ics[0].shared)
+    return (0);
+
+  return (ics[0].shared->sockets_len);
+}
+
+int
+ipmipower_connection_shared_fd (struct ipmipower_connection *ics,
+                                unsigned int ics_len,
+                                unsigned int index)
+{
+  assert (ics && ics_len && ics[0].shared);
+  assert (index < ics[0].shared->sockets_len);
+
+  return (ics[0].shared->sockets[index].fd);
+}
+
+struct ipmipower_connection *
+ipmipower_connection_shared_lookup (struct ipmipower_connection *ics,
+                                    unsigned int ics_len,
+                                    const struct sockaddr *from,
+                                    socklen_t fromlen)
+{
+  char key[INET6_ADDRSTRLEN + 1];
+
+  assert (ics && ics_len && ics[0].shared);
+  assert (from);
+
+  if (_shared_key (from, fromlen, key, INET6_ADDRSTRLEN + 1) < 0)
+    return (NULL);
+
+  return (hash_find (ics[0].shared->hosts_index, key));
+}
+
+int
+ipmipower_connection_shared_fd_next (struct ipmipower_connection *ic)
+{
+  struct ipmipower_connection_shared *shared;
+  unsigned int i, j;
+
+  assert (ic);
+  assert (ic->shared);
+
+  shared = ic->shared;
+
+  for (i = 0; i < shared->sockets_len; i++)
+    {
+      if (shared->sockets[i].fd == ic->ipmi_fd)
+        break;
+    }
+
+  if (i == shared->sockets_len)
+    return (ic->ipmi_fd);
+
+  for (j = 1; j < shared->sockets_len; j++)
+    {
+      struct ipmipower_shared_socket *ss;
+
+      ss = &shared->sockets[(i + j) % shared->sockets_len];
+      if (ss->family == ic->srcaddr->sa_family)
+        return (ss->fd);
+    }
+
+  return (ic->ipmi_fd);
+}
@@ -55,4 +55,35 @@ int ipmipower_connection_hostname_index (struct ipmipower_connection *ics,
                                          unsigned int ics_len,
                                          const char *hostname);
 
+/* ipmipower_connection_shared_fd_count
+ * - Number of sockets shared by the connections of the array,
+ *   0 if hosts-per-socket is not used
+ */
+unsigned int ipmipower_connection_shared_fd_count (struct ipmipower_connection *ics,
+                                                   unsigned int ics_len);
+
+/* ipmipower_connection_shared_fd
+ * - Get index'th shared socket of the array
+ */
+int ipmipower_connection_shared_fd (struct ipmipower_connection *ics,
+                                    unsigned int ics_len,
+                                    unsigned int index);
+
+/* ipmipower_connection_shared_lookup
+ * - Find connection a packet received on a shared socket is from
+ * - Other connections to the same address are chained on shared_next
+ * - Returns pointer to connection, NULL if not found
+ */
+struct ipmipower_connection *ipmipower_connection_shared_lookup (struct ipmipower_connection *ics,
+                                                                 unsigned int ics_len,
+                                                                 const struct sockaddr *from,
+                                                                 socklen_t fromlen);
+
+/* ipmipower_connection_shared_fd_next
+ * - Get another shared socket to send from, for when a new source
+ *   port is needed
+ * - Returns current ipmi_fd if there is no other socket
+ */
+int ipmipower_connection_shared_fd_next (ipmipower_connection_t ic);
+
 #endif /* IPMIPOWER_CONNECTION_H */
@@ -391,49 +391,51 @@ ipmipower_packet_store (ipmipower_powercmd_t ip,
     {
       if (IPMIPOWER_PACKET_TYPE_IPMI_2_0_SETUP_RS (pkt))
         {
-          if ((rv = unassemble_ipmi_rmcpplus_pkt (IPMI_AUTHENTICATION_ALGORITHM_RAKP_NONE,
-                                                  IPMI_INTEGRITY_ALGORITHM_NONE,
-                                                  IPMI_CONFIDENTIALITY_ALGORITHM_NONE,
-                                                  NULL,
-                                                  0,
-                                                  NULL,
-                                                  0,
-                                                  buf,
-                                                  buflen,
-                                                  ip->obj_rmcp_hdr_rs,
-                                                  ip->obj_rmcpplus_session_hdr_rs,
-                                                  ip->obj_rmcpplus_payload_rs,
-                                                  ip->obj_lan_msg_hdr_rs,
-                                                  obj,
-                                                  ip->obj_lan_msg_trlr_rs,
-                                                  ip->obj_rmcpplus_session_trlr_rs,
-                                                  IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+          if ((rv = unassemble_ipmi_rmcpplus_pkt_cached (ip->crypt_cache,
+                                                         IPMI_AUTHENTICATION_ALGORITHM_RAKP_NONE,
+                                                         IPMI_INTEGRITY_ALGORITHM_NONE,
+                                                         IPMI_CONFIDENTIALITY_ALGORITHM_NONE,
+                                                         NULL,
+                                                         0,
+                                                         NULL,
+                                                         0,
+                                                         buf,
+                                                         buflen,
+                                                         ip->obj_rmcp_hdr_rs,
+                                                         ip->obj_rmcpplus_session_hdr_rs,
+                                                         ip->obj_rmcpplus_payload_rs,
+                                                         ip->obj_lan_msg_hdr_rs,
+                                                         obj,
+                                                         ip->obj_lan_msg_trlr_rs,
+                                                         ip->obj_rmcpplus_session_trlr_rs,
+                                                         IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
             {
-              IPMIPOWER_ERROR (("unassemble_ipmi_rmcpplus_pkt: %s", strerror (errno)));
+              IPMIPOWER_ERROR (("unassemble_ipmi_rmcpplus_pkt_cached: %s", strerror (errno)));
               exit (EXIT_FAILURE);
             }
         }
       else
         {
-          if ((rv = unassemble_ipmi_rmcpplus_pkt (ip->authentication_algorithm,
-                                                  ip->integrity_algorithm,
-                                                  ip->confidentiality_algorithm,
-                                                  ip->integrity_key_ptr,
-                                                  ip->integrity_key_len,
-                                                  ip->confidentiality_key_ptr,
-                                                  ip->confidentiality_key_len,
-                                                  buf,
-                                                  buflen,
-                                                  ip->obj_rmcp_hdr_rs,
-                                                  ip->obj_rmcpplus_session_hdr_rs,
-                                                  ip->obj_rmcpplus_payload_rs,
-                                                  ip->obj_lan_msg_hdr_rs,
-                                                  obj,
-                                                  ip->obj_lan_msg_trlr_rs,
-                                                  ip->obj_rmcpplus_session_trlr_rs,
-                                                  IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+          if ((rv = unassemble_ipmi_rmcpplus_pkt_cached (ip->crypt_cache,
+                                                         ip->authentication_algorithm,
+                                                         ip->integrity_algorithm,
+                                                         ip->confidentiality_algorithm,
+                                                         ip->integrity_key_ptr,
+                                                         ip->integrity_key_len,
+                                                         ip->confidentiality_key_ptr,
+                                                         ip->confidentiality_key_len,
+                                                         buf,
+                                                         buflen,
+                                                         ip->obj_rmcp_hdr_rs,
+                                                         ip->obj_rmcpplus_session_hdr_rs,
+                                                         ip->obj_rmcpplus_payload_rs,
+                                                         ip->obj_lan_msg_hdr_rs,
+                                                         obj,
+                                                         ip->obj_lan_msg_trlr_rs,
+                                                         ip->obj_rmcpplus_session_trlr_rs,
+                                                         IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
             {
-              IPMIPOWER_ERROR (("unassemble_ipmi_rmcpplus_pkt: %s", strerror (errno)));
+              IPMIPOWER_ERROR (("unassemble_ipmi_rmcpplus_pkt_cached: %s", strerror (errno)));
               exit (EXIT_FAILURE);
             }
         }
@@ -570,25 +572,26 @@ _ipmi_2_0_packet_create (ipmipower_powercmd_t ip,
       exit (EXIT_FAILURE);
     }
 
-  if ((len = assemble_ipmi_rmcpplus_pkt (authentication_algorithm,
-                                         integrity_algorithm,
-                                         confidentiality_algorithm,
-                                         integrity_key,
-                                         integrity_key_len,
-                                         confidentiality_key,
-                                         confidentiality_key_len,
-                                         authentication_code_data,
-                                         authentication_code_data_len,
-                                         ip->obj_rmcp_hdr_rq,
-                                         ip->obj_rmcpplus_session_hdr_rq,
-                                         ip->obj_lan_msg_hdr_rq,
-                                         obj_cmd_rq,
-                                         ip->obj_rmcpplus_session_trlr_rq,
-                                         buf,
-                                         buflen,
-                                         IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+  if ((len = assemble_ipmi_rmcpplus_pkt_cached (ip->crypt_cache,
+                                                authentication_algorithm,
+                                                integrity_algorithm,
+                                                confidentiality_algorithm,
+                                                integrity_key,
+                                                integrity_key_len,
+                                                confidentiality_key,
+                                                confidentiality_key_len,
+                                                authentication_code_data,
+                                                authentication_code_data_len,
+                                                ip->obj_rmcp_hdr_rq,
+                                                ip->obj_rmcpplus_session_hdr_rq,
+                                                ip->obj_lan_msg_hdr_rq,
+                                                obj_cmd_rq,
+                                                ip->obj_rmcpplus_session_trlr_rq,
+                                                buf,
+                                                buflen,
+                                                IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
     {
-      IPMIPOWER_ERROR (("assemble_ipmi_rmcpplus_pkt: %s", strerror (errno)));
+      IPMIPOWER_ERROR (("assemble_ipmi_rmcpplus_pkt_cached: %s", strerror (errno)));
       exit (EXIT_FAILURE);
     }
 
@@ -153,6 +153,8 @@ _destroy_ipmipower_powercmd (void *x)
   fiid_obj_destroy (ip->obj_close_session_rq);
   fiid_obj_destroy (ip->obj_close_session_rs);
 
+  ipmi_rmcpplus_crypt_cache_destroy (ip->crypt_cache);
+
   /* Close all sockets that were saved during the Get Session
    * Challenge phase of the IPMI protocol.
    */
@@ -290,6 +292,8 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
 
   /* IPMI 2.0 */
 
+  ip->crypt_cache = NULL;
+
   if (cmd_args.common_args.driver_type == IPMI_DEVICE_LAN_2_0)
     {
       if (ipmi_cipher_suite_id_to_algorithms (cmd_args.common_args.cipher_suite_id,
@@ -358,6 +362,12 @@ ipmipower_powercmd_queue (ipmipower_power_cmd_t cmd,
       ip->confidentiality_key_ptr = ip->confidentiality_key;
       ip->confidentiality_key_len = IPMI_MAX_CONFIDENTIALITY_KEY_LENGTH;
 
+      if (!(ip->crypt_cache = ipmi_rmcpplus_crypt_cache_create ()))
+        {
+          IPMIPOWER_ERROR (("ipmi_rmcpplus_crypt_cache_create: %s", strerror (errno)));
+          exit (EXIT_FAILURE);
+        }
+
       if (ipmi_get_random (&ip->initial_message_tag,
                            sizeof (ip->initial_message_tag)) < 0)
         {
@@ -1409,9 +1419,19 @@ _retry_packets (ipmipower_powercmd_t ip)
          * store the old file descriptrs (which are bound to the old
          * ports) on a list, and close all of them after we have gotten
          * past the Get Session Challenge phase of the protocol.
+         *
+         * With hosts-per-socket, we instead move on to another of the
+         * shared sockets.
          */
         int new_fd, *old_fd;
 
+        if (ip->ic->shared)
+          {
+            ip->ic->ipmi_fd = ipmipower_connection_shared_fd_next (ip->ic);
+            _send_packet (ip, IPMIPOWER_PACKET_TYPE_GET_SESSION_CHALLENGE_RQ);
+            break;
+          }
+
         if ((new_fd = socket (ip->ic->srcaddr->sa_family, SOCK_DGRAM, 0)) < 0)
           {
             if (errno != EMFILE)
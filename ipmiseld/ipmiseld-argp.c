@@ -116,10 +116,14 @@ static struct argp_option cmdline_options[] =
       "Specify syslog log priority.", 58},
     { "cache-directory", IPMISELD_CACHE_DIRECTORY_KEY, "DIRECTORY", 0,
       "Specify alternate cache directory.", 59},
+    { "state-sync-interval", IPMISELD_STATE_SYNC_INTERVAL_KEY, "SECONDS", 0,
+      "Specify interval to sync host state to the cache directory.", 59},
     { "ignore-sdr", IPMISELD_IGNORE_SDR_KEY, 0, 0,
       "Ignore SDR related processing.", 60},
     { "re-download-sdr", IPMISELD_RE_DOWNLOAD_SDR_KEY, 0, 0,
       "Re-download the SDR even if it is not out of date.", 61},
+    { "sdr-cache-shared", IPMISELD_SDR_CACHE_SHARED_KEY, 0, 0,
+      "Share one SDR cache between hosts with identical SDRs.", 61},
     { "clear-sel", IPMISELD_CLEAR_SEL_KEY, 0, 0,
       "Clear SEL on startup.", 62},
     { "threadpool-count", IPMISELD_THREADPOOL_COUNT_KEY, "NUM", 0,
@@ -285,12 +289,27 @@ cmdline_parse (int key, char *arg, struct argp_state *state)
           exit (EXIT_FAILURE);
         }
       break;
+    case IPMISELD_STATE_SYNC_INTERVAL_KEY:
+      errno = 0;
+      tmp = strtol (arg, &endptr, 0);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp <= 0)
+        {
+          fprintf (stderr, "invalid state sync interval\n");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->state_sync_interval = tmp;
+      break;
     case IPMISELD_IGNORE_SDR_KEY:
       cmd_args->ignore_sdr = 1;
       break;
     case IPMISELD_RE_DOWNLOAD_SDR_KEY:
       cmd_args->re_download_sdr = 1;
       break;
+    case IPMISELD_SDR_CACHE_SHARED_KEY:
+      cmd_args->sdr_cache_shared = 1;
+      break;
     case IPMISELD_CLEAR_SEL_KEY:
       cmd_args->clear_sel = 1;
       break;
@@ -356,7 +375,7 @@ _ipmiseld_config_file_parse (struct ipmiseld_arguments *cmd_args)
   if (config_file_parse (filename,
                          no_error_if_not_found,
                          &(cmd_args->common_args),
-                         CONFIG_FILE_INBAND | CONFIG_FILE_OUTOFBAND,
+                         CONFIG_FILE_INBAND | CONFIG_FILE_OUTOFBAND | CONFIG_FILE_SDR,
                          CONFIG_FILE_TOOL_IPMISELD,
                          &config_file_data) < 0)
     return;
@@ -427,10 +446,14 @@ _ipmiseld_config_file_parse (struct ipmiseld_arguments *cmd_args)
     cmd_args->log_priority_str = config_file_data.log_priority_str;
   if (config_file_data.cache_directory_count)
     cmd_args->cache_directory = config_file_data.cache_directory;
+  if (config_file_data.state_sync_interval_count)
+    cmd_args->state_sync_interval = config_file_data.state_sync_interval;
   if (config_file_data.ignore_sdr_count)
     cmd_args->ignore_sdr = config_file_data.ignore_sdr;
   if (config_file_data.re_download_sdr_count)
     cmd_args->re_download_sdr = config_file_data.re_download_sdr;
+  if (cmd_args->common_args.sdr_cache_shared)
+    cmd_args->sdr_cache_shared = cmd_args->common_args.sdr_cache_shared;
   if (config_file_data.clear_sel_count)
     cmd_args->clear_sel = config_file_data.clear_sel;
   if (config_file_data.threadpool_count_count)
@@ -527,8 +550,10 @@ ipmiseld_argp_parse (int argc, char **argv, struct ipmiseld_arguments *cmd_args)
   cmd_args->log_facility_str = NULL;
   cmd_args->log_priority_str = NULL;
   cmd_args->cache_directory = NULL;
+  cmd_args->state_sync_interval = IPMISELD_STATE_SYNC_INTERVAL_DEFAULT;
   cmd_args->ignore_sdr = 0;
   cmd_args->re_download_sdr = 0;
+  cmd_args->sdr_cache_shared = 0;
   cmd_args->clear_sel = 0;
   cmd_args->threadpool_count = IPMISELD_THREADPOOL_COUNT;
   cmd_args->test_run = 0;
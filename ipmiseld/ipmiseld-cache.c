@@ -41,6 +41,7 @@
 #include <fcntl.h>
 #endif /* HAVE_FCNTL_H */
 #include <sys/param.h>          /* MAXPATHLEN */
+#include <pthread.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -52,6 +53,8 @@
 #include "freeipmi-portability.h"
 #include "error.h"
 #include "fd.h"
+#include "hash.h"
+#include "list.h"
 
 #ifndef MAXPATHLEN
 #define MAXPATHLEN 4096
@@ -61,6 +64,8 @@
 
 #define IPMISELD_SDR_CACHE_FILENAME       "ipmiseldsdrcache"
 
+#define IPMISELD_SDR_CACHE_SHARED_DIR     "shared"
+
 /*
  * Data Cache Format
  *
@@ -86,24 +91,103 @@
 
 #define IPMISELD_DATA_CACHE_FILE_VERSION  0x00000001
 
-#define IPMISELD_DATA_CACHE_LENGTH        (4 + 4 + 2 + 4 + 2 + 2 + 4 + 4 + 1 + 1 + 1 + 1)
+#define IPMISELD_HOST_STATE_LENGTH        (2 + 4 + 2 + 2 + 4 + 4 + 1 + 1 + 1)
+
+#define IPMISELD_DATA_CACHE_LENGTH        (4 + 4 + IPMISELD_HOST_STATE_LENGTH + 1)
+
+/*
+ * State Store Format
+ *
+ * All numbers stored little endian
+ *
+ * Header
+ *
+ * uint32_t file_magic
+ * uint32_t file_version
+ * uint8_t zerosumchecksum;
+ *
+ * Followed by records, appended as host state changes
+ *
+ * uint8_t hostname_len
+ * char hostname[hostname_len] (not NUL terminated)
+ * host state, same fields as the data cache above, from
+ *   last_record_id through overflow_flag
+ * uint8_t zerosumchecksum;
+ *
+ * The last record for a hostname is the current state.
+ */
+
+#define IPMISELD_STATE_FILENAME           "ipmiseldstate"
+
+#define IPMISELD_STATE_FILE_MAGIC         0x4A1B5707
+
+#define IPMISELD_STATE_FILE_VERSION       0x00000001
+
+#define IPMISELD_STATE_HEADER_LENGTH      (4 + 4 + 1)
+
+#define IPMISELD_STATE_HOSTNAME_MAX       255
+
+#define IPMISELD_STATE_RECORD_LENGTH_MAX  (1 + IPMISELD_STATE_HOSTNAME_MAX + IPMISELD_HOST_STATE_LENGTH + 1)
+
+/* rewrite the store when it holds more than this many records ... */
+#define IPMISELD_STATE_COMPACT_MIN        1024
+
+/* ... and more than this many records per host */
+#define IPMISELD_STATE_COMPACT_FACTOR     2
 
 static int
 _ipmiseld_sdr_cache_create (ipmiseld_host_data_t *host_data,
-                            char *filename)
+                            char *filename,
+                            const char *sdr_cache_dir,
+                            int out_of_date)
 {
+  char shared_dir[MAXPATHLEN+1];
+  int cache_create_flags = IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT;
+  int ret;
+
   assert (host_data);
   assert (host_data->host_poll);
   assert (host_data->host_poll->sdr_ctx);
   assert (host_data->host_poll->ipmi_ctx);
   assert (filename && strlen (filename));
+  assert (sdr_cache_dir);
 
-  if (ipmi_sdr_cache_create (host_data->host_poll->sdr_ctx,
-                             host_data->host_poll->ipmi_ctx,
-                             filename,
-                             IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT,
-                             NULL,
-                             NULL) < 0)
+  if (host_data->hostname
+      && host_data->prog_data->args->common_args.driver_type == IPMI_DEVICE_LAN_2_0)
+    cache_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED;
+
+  if (host_data->prog_data->args->sdr_cache_shared)
+    {
+      snprintf (shared_dir,
+                MAXPATHLEN,
+                "%s/%s",
+                sdr_cache_dir,
+                IPMISELD_SDR_CACHE_SHARED_DIR);
+
+      ret = ipmi_sdr_cache_create_shared (host_data->host_poll->sdr_ctx,
+                                          host_data->host_poll->ipmi_ctx,
+                                          filename,
+                                          shared_dir,
+                                          cache_create_flags,
+                                          NULL,
+                                          NULL);
+    }
+  else if (out_of_date)
+    ret = ipmi_sdr_cache_update (host_data->host_poll->sdr_ctx,
+                                 host_data->host_poll->ipmi_ctx,
+                                 filename,
+                                 cache_create_flags,
+                                 NULL,
+                                 NULL);
+  else
+    ret = ipmi_sdr_cache_create (host_data->host_poll->sdr_ctx,
+                                 host_data->host_poll->ipmi_ctx,
+                                 filename,
+                                 cache_create_flags,
+                                 NULL,
+                                 NULL);
+
+  if (ret < 0)
     {
       if (ipmi_sdr_ctx_errnum (host_data->host_poll->sdr_ctx) == IPMI_SDR_ERR_FILENAME_INVALID
           || ipmi_sdr_ctx_errnum (host_data->host_poll->sdr_ctx) == IPMI_SDR_ERR_FILESYSTEM
@@ -181,6 +265,20 @@ ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
       if (host_data->prog_data->args->common_args.debug)
         IPMISELD_HOST_DEBUG (("SDR cache - deleting"));
 
+      /* Remove the shared cache this host links to as well, otherwise
+       * it would simply be linked to again instead of re-downloaded.
+       */
+      if (host_data->prog_data->args->sdr_cache_shared)
+        {
+          char shared_filename[MAXPATHLEN+1];
+          ssize_t len;
+
+          memset (shared_filename, '\0', MAXPATHLEN + 1);
+          if ((len = readlink (filename, shared_filename, MAXPATHLEN)) > 0)
+            /* ignore potential error, re-downloaded below regardless */
+            unlink (shared_filename);
+        }
+
       if (ipmi_sdr_cache_delete (host_data->host_poll->sdr_ctx, filename) < 0)
         {
           ipmiseld_err_output (host_data,
@@ -200,7 +298,16 @@ ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
           if (host_data->prog_data->args->common_args.debug)
             IPMISELD_HOST_DEBUG (("SDR cache not available - creating"));
 
-          if (_ipmiseld_sdr_cache_create (host_data, filename) < 0)
+          if (_ipmiseld_sdr_cache_create (host_data, filename, sdr_cache_dir, 0) < 0)
+            goto cleanup;
+        }
+      else if (ipmi_sdr_ctx_errnum (host_data->host_poll->sdr_ctx) == IPMI_SDR_ERR_CACHE_OUT_OF_DATE
+               && !host_data->prog_data->args->sdr_cache_shared)
+        {
+          if (host_data->prog_data->args->common_args.debug)
+            IPMISELD_HOST_DEBUG (("SDR cache out of date - updating cache"));
+
+          if (_ipmiseld_sdr_cache_create (host_data, filename, sdr_cache_dir, 1) < 0)
             goto cleanup;
         }
       else if (ipmi_sdr_ctx_errnum (host_data->host_poll->sdr_ctx) == IPMI_SDR_ERR_CACHE_INVALID
@@ -217,7 +324,7 @@ ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
               goto cleanup;
             }
 
-          if (_ipmiseld_sdr_cache_create (host_data, filename) < 0)
+          if (_ipmiseld_sdr_cache_create (host_data, filename, sdr_cache_dir, 0) < 0)
             goto cleanup;
         }
       else
@@ -249,33 +356,41 @@ ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data)
   return (-1);
 }
 
+static const char *
+_data_cache_dir (ipmiseld_prog_data_t *prog_data)
+{
+  assert (prog_data);
+
+  if (prog_data->args->cache_directory)
+    return (prog_data->args->cache_directory);
+  return (IPMISELD_CACHE_DIRECTORY);
+}
+
+static const char *
+_data_cache_hostname (ipmiseld_host_data_t *host_data)
+{
+  assert (host_data);
+
+  if (host_data->hostname)
+    return (host_data->hostname);
+  return (IPMISELD_CACHE_INBAND);
+}
+
 static void
 _data_cache_filename (ipmiseld_host_data_t *host_data,
                       char *filename_buf,
                       unsigned int filename_buflen)
 {
-  char *sdr_cache_dir;
-  char *hostname;
-
   assert (host_data);
   assert (filename_buf);
   assert (filename_buflen);
 
-  if (host_data->prog_data->args->cache_directory)
-    sdr_cache_dir = host_data->prog_data->args->cache_directory;
-  else
-    sdr_cache_dir = IPMISELD_CACHE_DIRECTORY;
-
-  hostname = host_data->hostname;
-  if (!hostname)
-    hostname = IPMISELD_CACHE_INBAND;
-
   snprintf (filename_buf,
             filename_buflen,
             "%s/%s.%s",
-            sdr_cache_dir,
+            _data_cache_dir (host_data->prog_data),
             IPMISELD_DATA_CACHE_FILENAME,
-            hostname);
+            _data_cache_hostname (host_data));
 }
 
 static unsigned int
@@ -317,11 +432,108 @@ _unmarshall_uint8 (uint8_t *databuf, uint8_t *value)
   return (sizeof (uint8_t));
 }
 
+static unsigned int
+_marshall_uint32 (uint8_t *databuf, uint32_t value)
+{
+  assert (databuf);
+
+  /* store little endian */
+  databuf[0] = (value & 0x000000FF);
+  databuf[1] = (value & 0x0000FF00) >> 8;
+  databuf[2] = (value & 0x00FF0000) >> 16;
+  databuf[3] = (value & 0xFF000000) >> 24;
+
+  return (sizeof (uint32_t));
+}
+
+static unsigned int
+_marshall_uint16 (uint8_t *databuf, uint16_t value)
+{
+  assert (databuf);
+
+  /* store little endian */
+  databuf[0] = (value & 0x00FF);
+  databuf[1] = (value & 0xFF00) >> 8;
+
+  return (sizeof (uint16_t));
+}
+
+static unsigned int
+_marshall_uint8 (uint8_t *databuf, uint8_t value)
+{
+  assert (databuf);
+
+  databuf[0] = value;
+
+  return (sizeof (uint8_t));
+}
+
+static uint8_t
+_zerosumchecksum (const uint8_t *databuf, unsigned int databuflen)
+{
+  uint8_t zerosumchecksum = 0;
+  unsigned int i;
+
+  assert (databuf);
+
+  for (i = 0; i < databuflen; i++)
+    zerosumchecksum += databuf[i];
+
+  return (0xFF - zerosumchecksum + 1);
+}
+
+/* host state fields common to the data cache file and state store */
+static unsigned int
+_marshall_host_state (uint8_t *databuf, ipmiseld_host_state_t *host_state)
+{
+  unsigned int databuf_offset = 0;
+
+  assert (databuf);
+  assert (host_state);
+
+  databuf_offset += _marshall_uint16 (databuf + databuf_offset, host_state->last_record_id.record_id);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, host_state->last_percent_full);
+  databuf_offset += _marshall_uint16 (databuf + databuf_offset, host_state->sel_info.entries);
+  databuf_offset += _marshall_uint16 (databuf + databuf_offset, host_state->sel_info.free_space);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, host_state->sel_info.most_recent_addition_timestamp);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, host_state->sel_info.most_recent_erase_timestamp);
+  databuf_offset += _marshall_uint8 (databuf + databuf_offset, host_state->sel_info.delete_sel_command_supported);
+  databuf_offset += _marshall_uint8 (databuf + databuf_offset, host_state->sel_info.reserve_sel_command_supported);
+  databuf_offset += _marshall_uint8 (databuf + databuf_offset, host_state->sel_info.overflow_flag);
+
+  assert (databuf_offset == IPMISELD_HOST_STATE_LENGTH);
+  return (databuf_offset);
+}
+
+static unsigned int
+_unmarshall_host_state (uint8_t *databuf, ipmiseld_host_state_t *host_state)
+{
+  unsigned int databuf_offset = 0;
+
+  assert (databuf);
+  assert (host_state);
+
+  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &host_state->last_record_id.record_id);
+  host_state->last_record_id.loaded = 1;
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &host_state->last_percent_full);
+  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &host_state->sel_info.entries);
+  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &host_state->sel_info.free_space);
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &host_state->sel_info.most_recent_addition_timestamp);
+  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &host_state->sel_info.most_recent_erase_timestamp);
+  databuf_offset += _unmarshall_uint8 (databuf + databuf_offset, &host_state->sel_info.delete_sel_command_supported);
+  databuf_offset += _unmarshall_uint8 (databuf + databuf_offset, &host_state->sel_info.reserve_sel_command_supported);
+  databuf_offset += _unmarshall_uint8 (databuf + databuf_offset, &host_state->sel_info.overflow_flag);
+  host_state->initialized = 1;
+
+  assert (databuf_offset == IPMISELD_HOST_STATE_LENGTH);
+  return (databuf_offset);
+}
+
 /* returns 1 on data found/loaded, 0 if not found, -1 on error loading
  *  (permission, corrupted, etc.)
  */
-int
-ipmiseld_data_cache_load (ipmiseld_host_data_t *host_data)
+static int
+_data_cache_file_load (ipmiseld_host_data_t *host_data)
 {
   uint32_t file_magic;
   uint32_t file_version;
@@ -405,17 +617,7 @@ ipmiseld_data_cache_load (ipmiseld_host_data_t *host_data)
       goto cleanup;
     }
 
-  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &host_data->last_host_state.last_record_id.record_id);
-  host_data->last_host_state.last_record_id.loaded = 1;
-  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &host_data->last_host_state.last_percent_full);
-  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &host_data->last_host_state.sel_info.entries);
-  databuf_offset += _unmarshall_uint16 (databuf + databuf_offset, &host_data->last_host_state.sel_info.free_space);
-  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &host_data->last_host_state.sel_info.most_recent_addition_timestamp);
-  databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &host_data->last_host_state.sel_info.most_recent_erase_timestamp);
-  databuf_offset += _unmarshall_uint8 (databuf + databuf_offset, &host_data->last_host_state.sel_info.delete_sel_command_supported);
-  databuf_offset += _unmarshall_uint8 (databuf + databuf_offset, &host_data->last_host_state.sel_info.reserve_sel_command_supported);
-  databuf_offset += _unmarshall_uint8 (databuf + databuf_offset, &host_data->last_host_state.sel_info.overflow_flag);
-  host_data->last_host_state.initialized = 1;
+  databuf_offset += _unmarshall_host_state (databuf + databuf_offset, &host_data->last_host_state);
 
   rv = 1;
  cleanup:
@@ -423,52 +625,14 @@ ipmiseld_data_cache_load (ipmiseld_host_data_t *host_data)
   return (rv);
 }
 
-static unsigned int
-_marshall_uint32 (uint8_t *databuf, uint32_t value)
-{
-  assert (databuf);
-
-  /* store little endian */
-  databuf[0] = (value & 0x000000FF);
-  databuf[1] = (value & 0x0000FF00) >> 8;
-  databuf[2] = (value & 0x00FF0000) >> 16;
-  databuf[3] = (value & 0xFF000000) >> 24;
-
-  return (sizeof (uint32_t));
-}
-
-static unsigned int
-_marshall_uint16 (uint8_t *databuf, uint16_t value)
-{
-  assert (databuf);
-
-  /* store little endian */
-  databuf[0] = (value & 0x00FF);
-  databuf[1] = (value & 0xFF00) >> 8;
-
-  return (sizeof (uint16_t));
-}
-
-static unsigned int
-_marshall_uint8 (uint8_t *databuf, uint8_t value)
-{
-  assert (databuf);
-
-  databuf[0] = value;
-
-  return (sizeof (uint8_t));
-}
-
-int
-ipmiseld_data_cache_store (ipmiseld_host_data_t *host_data)
+static int
+_data_cache_file_store (ipmiseld_host_data_t *host_data)
 {
   uint32_t file_magic = IPMISELD_DATA_CACHE_FILE_MAGIC;
   uint32_t file_version = IPMISELD_DATA_CACHE_FILE_VERSION;
   char filename[MAXPATHLEN+1];
   uint8_t databuf[IPMISELD_DATA_CACHE_LENGTH];
   unsigned int databuf_offset = 0;
-  uint8_t zerosumchecksum = 0;
-  unsigned int i;
   int n;
   int open_flags;
   int file_found = 0;
@@ -515,20 +679,8 @@ ipmiseld_data_cache_store (ipmiseld_host_data_t *host_data)
 
   databuf_offset += _marshall_uint32 (databuf + databuf_offset, file_magic);
   databuf_offset += _marshall_uint32 (databuf + databuf_offset, file_version);
-  databuf_offset += _marshall_uint16 (databuf + databuf_offset, host_data->last_host_state.last_record_id.record_id);
-  databuf_offset += _marshall_uint32 (databuf + databuf_offset, host_data->last_host_state.last_percent_full);
-  databuf_offset += _marshall_uint16 (databuf + databuf_offset, host_data->last_host_state.sel_info.entries);
-  databuf_offset += _marshall_uint16 (databuf + databuf_offset, host_data->last_host_state.sel_info.free_space);
-  databuf_offset += _marshall_uint32 (databuf + databuf_offset, host_data->last_host_state.sel_info.most_recent_addition_timestamp);
-  databuf_offset += _marshall_uint32 (databuf + databuf_offset, host_data->last_host_state.sel_info.most_recent_erase_timestamp);
-  databuf_offset += _marshall_uint8 (databuf + databuf_offset, host_data->last_host_state.sel_info.delete_sel_command_supported);
-  databuf_offset += _marshall_uint8 (databuf + databuf_offset, host_data->last_host_state.sel_info.reserve_sel_command_supported);
-  databuf_offset += _marshall_uint8 (databuf + databuf_offset, host_data->last_host_state.sel_info.overflow_flag);
-
-  for (i = 0; i < databuf_offset; i++)
-    zerosumchecksum += databuf[i];
-
-  databuf_offset += _marshall_uint8 (databuf + databuf_offset, 0xFF - zerosumchecksum + 1);
+  databuf_offset += _marshall_host_state (databuf + databuf_offset, &host_data->last_host_state);
+  databuf_offset += _marshall_uint8 (databuf + databuf_offset, _zerosumchecksum (databuf, databuf_offset));
 
   assert (databuf_offset == IPMISELD_DATA_CACHE_LENGTH);
 
@@ -565,3 +717,687 @@ ipmiseld_data_cache_store (ipmiseld_host_data_t *host_data)
     }
   return (rv);
 }
+
+/*
+ * State store
+ *
+ * One store for all hosts, the latest record for a host is its state.
+ * Updates are kept in memory and appended in one write + fsync every
+ * state sync interval.  The store is rewritten with only the latest
+ * records once it is mostly stale records.
+ */
+
+struct ipmiseld_state_entry
+{
+  char *hostname;
+  uint8_t record[IPMISELD_STATE_RECORD_LENGTH_MAX];
+  unsigned int record_len;
+  int dirty;
+};
+
+static hash_t state_store_hash = NULL;
+static List state_store_dirty = NULL;
+static pthread_mutex_t state_store_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* only touched by the main thread */
+static int state_store_fd = -1;
+static char state_store_filename[MAXPATHLEN+1];
+static unsigned int state_store_records = 0;
+static int state_store_compact_needed = 0;
+
+static void
+_state_entry_destroy (void *x)
+{
+  struct ipmiseld_state_entry *entry;
+
+  assert (x);
+
+  entry = (struct ipmiseld_state_entry *)x;
+  free (entry->hostname);
+  free (entry);
+}
+
+static struct ipmiseld_state_entry *
+_state_entry_get (const char *hostname)
+{
+  struct ipmiseld_state_entry *entry;
+
+  assert (hostname);
+  assert (state_store_hash);
+
+  if ((entry = hash_find (state_store_hash, hostname)))
+    return (entry);
+
+  if (!(entry = (struct ipmiseld_state_entry *)malloc (sizeof (struct ipmiseld_state_entry))))
+    {
+      err_output ("malloc: %s", strerror (errno));
+      return (NULL);
+    }
+  memset (entry, '\0', sizeof (struct ipmiseld_state_entry));
+
+  if (!(entry->hostname = strdup (hostname)))
+    {
+      err_output ("strdup: %s", strerror (errno));
+      free (entry);
+      return (NULL);
+    }
+
+  if (!hash_insert (state_store_hash, entry->hostname, entry))
+    {
+      err_output ("hash_insert: %s", strerror (errno));
+      _state_entry_destroy (entry);
+      return (NULL);
+    }
+
+  return (entry);
+}
+
+/* returns record length, 0 if no valid record at databuf */
+static unsigned int
+_state_record_check (uint8_t *databuf, unsigned int databuflen)
+{
+  unsigned int hostname_len;
+  unsigned int record_len;
+  uint8_t zerosumchecksum = 0;
+  unsigned int i;
+
+  assert (databuf);
+
+  if (!databuflen)
+    return (0);
+
+  hostname_len = databuf[0];
+  if (!hostname_len)
+    return (0);
+
+  record_len = 1 + hostname_len + IPMISELD_HOST_STATE_LENGTH + 1;
+  if (record_len > databuflen)
+    return (0);
+
+  for (i = 0; i < record_len; i++)
+    zerosumchecksum += databuf[i];
+
+  if (zerosumchecksum)
+    return (0);
+
+  return (record_len);
+}
+
+static int
+_state_store_write_header (int fd)
+{
+  uint8_t databuf[IPMISELD_STATE_HEADER_LENGTH];
+  unsigned int databuf_offset = 0;
+
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, IPMISELD_STATE_FILE_MAGIC);
+  databuf_offset += _marshall_uint32 (databuf + databuf_offset, IPMISELD_STATE_FILE_VERSION);
+  databuf_offset += _marshall_uint8 (databuf + databuf_offset, _zerosumchecksum (databuf, databuf_offset));
+
+  assert (databuf_offset == IPMISELD_STATE_HEADER_LENGTH);
+
+  if (fd_write_n (fd, databuf, databuf_offset) != databuf_offset)
+    {
+      err_output ("fd_write_n: %s", strerror (errno));
+      return (-1);
+    }
+
+  return (0);
+}
+
+static int
+_state_store_reset (int fd)
+{
+  assert (fd >= 0);
+
+  if (ftruncate (fd, 0) < 0)
+    {
+      err_output ("ftruncate: %s", strerror (errno));
+      return (-1);
+    }
+
+  if (lseek (fd, 0, SEEK_SET) < 0)
+    {
+      err_output ("lseek: %s", strerror (errno));
+      return (-1);
+    }
+
+  return (_state_store_write_header (fd));
+}
+
+/* Reads the store into state_store_hash.  Anything after the last
+ * valid record (e.g. a write torn by a crash) is truncated.
+ */
+static int
+_state_store_load (int fd)
+{
+  uint8_t *databuf = NULL;
+  unsigned int databuflen;
+  unsigned int databuf_offset = 0;
+  uint8_t zerosumchecksum = 0;
+  uint32_t file_magic = 0;
+  uint32_t file_version = 0;
+  struct stat statbuf;
+  unsigned int i;
+  ssize_t len;
+  int rv = -1;
+
+  assert (fd >= 0);
+
+  if (fstat (fd, &statbuf) < 0)
+    {
+      err_output ("fstat: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  /* new store */
+  if (!statbuf.st_size)
+    {
+      rv = _state_store_reset (fd);
+      goto cleanup;
+    }
+
+  if (!(databuf = (uint8_t *)malloc (statbuf.st_size)))
+    {
+      err_output ("malloc: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if ((len = fd_read_n (fd, databuf, statbuf.st_size)) < 0)
+    {
+      err_output ("fd_read_n: %s", strerror (errno));
+      goto cleanup;
+    }
+  databuflen = len;
+
+  if (databuflen >= IPMISELD_STATE_HEADER_LENGTH)
+    {
+      for (i = 0; i < IPMISELD_STATE_HEADER_LENGTH; i++)
+        zerosumchecksum += databuf[i];
+
+      databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &file_magic);
+      databuf_offset += _unmarshall_uint32 (databuf + databuf_offset, &file_version);
+      databuf_offset += sizeof (uint8_t);
+    }
+
+  if (databuflen < IPMISELD_STATE_HEADER_LENGTH
+      || zerosumchecksum
+      || file_magic != IPMISELD_STATE_FILE_MAGIC
+      || file_version != IPMISELD_STATE_FILE_VERSION)
+    {
+      err_output ("state store '%s' corrupted or out of date, discarding",
+                  state_store_filename);
+      rv = _state_store_reset (fd);
+      goto cleanup;
+    }
+
+  while (databuf_offset < databuflen)
+    {
+      struct ipmiseld_state_entry *entry;
+      char hostname[IPMISELD_STATE_HOSTNAME_MAX + 1];
+      unsigned int record_len;
+
+      if (!(record_len = _state_record_check (databuf + databuf_offset,
+                                              databuflen - databuf_offset)))
+        {
+          err_output ("state store '%s' corrupted at offset %u, truncating",
+                      state_store_filename,
+                      databuf_offset);
+          if (ftruncate (fd, databuf_offset) < 0)
+            {
+              err_output ("ftruncate: %s", strerror (errno));
+              goto cleanup;
+            }
+          break;
+        }
+
+      memcpy (hostname, databuf + databuf_offset + 1, databuf[databuf_offset]);
+      hostname[databuf[databuf_offset]] = '\0';
+
+      if (!(entry = _state_entry_get (hostname)))
+        goto cleanup;
+
+      memcpy (entry->record, databuf + databuf_offset, record_len);
+      entry->record_len = record_len;
+
+      state_store_records++;
+      databuf_offset += record_len;
+    }
+
+  rv = 0;
+ cleanup:
+  free (databuf);
+  return (rv);
+}
+
+int
+ipmiseld_data_cache_init (ipmiseld_prog_data_t *prog_data)
+{
+  int fd = -1;
+  int rv = -1;
+
+  assert (prog_data);
+  assert (!state_store_hash);
+
+  memset (state_store_filename, '\0', MAXPATHLEN + 1);
+
+  if (snprintf (state_store_filename,
+                MAXPATHLEN,
+                "%s/%s",
+                _data_cache_dir (prog_data),
+                IPMISELD_STATE_FILENAME) >= MAXPATHLEN)
+    {
+      err_output ("state store filename too long");
+      goto cleanup;
+    }
+
+  if (!(state_store_hash = hash_create (0,
+                                        (hash_key_f)hash_key_string,
+                                        (hash_cmp_f)strcmp,
+                                        _state_entry_destroy)))
+    {
+      err_output ("hash_create: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if (!(state_store_dirty = list_create (NULL)))
+    {
+      err_output ("list_create: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if ((fd = open (state_store_filename, O_RDWR | O_CREAT, 0644)) < 0)
+    {
+      err_output ("Error opening '%s': %s", state_store_filename, strerror (errno));
+      goto cleanup;
+    }
+
+  if (_state_store_load (fd) < 0)
+    goto cleanup;
+
+  if (lseek (fd, 0, SEEK_END) < 0)
+    {
+      err_output ("lseek: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  state_store_fd = fd;
+  rv = 0;
+ cleanup:
+  if (rv < 0)
+    {
+      if (fd >= 0)
+        close (fd);
+      ipmiseld_data_cache_finish (prog_data);
+    }
+  return (rv);
+}
+
+struct ipmiseld_state_snapshot
+{
+  uint8_t *databuf;
+  unsigned int databuf_offset;
+};
+
+static int
+_state_store_snapshot_entry (void *data, const void *key, void *arg)
+{
+  struct ipmiseld_state_entry *entry;
+  struct ipmiseld_state_snapshot *snapshot;
+
+  assert (data);
+  assert (arg);
+
+  entry = (struct ipmiseld_state_entry *)data;
+  snapshot = (struct ipmiseld_state_snapshot *)arg;
+
+  if (!entry->record_len)
+    return (0);
+
+  memcpy (snapshot->databuf + snapshot->databuf_offset,
+          entry->record,
+          entry->record_len);
+  snapshot->databuf_offset += entry->record_len;
+  return (1);
+}
+
+/* Rewrite the store w/ only the latest record of each host.  If
+ * clear_dirty, dirty entries are cleared, the rewrite holds their
+ * latest records.
+ */
+static int
+_state_store_compact (int clear_dirty)
+{
+  struct ipmiseld_state_entry *entry;
+  struct ipmiseld_state_snapshot snapshot;
+  char tmpfilename[MAXPATHLEN+1];
+  int records;
+  int fd = -1;
+  int rv = -1;
+
+  memset (&snapshot, '\0', sizeof (struct ipmiseld_state_snapshot));
+  memset (tmpfilename, '\0', MAXPATHLEN + 1);
+
+  pthread_mutex_lock (&state_store_lock);
+
+  if (!(snapshot.databuf = (uint8_t *)malloc (hash_count (state_store_hash) * IPMISELD_STATE_RECORD_LENGTH_MAX)))
+    {
+      pthread_mutex_unlock (&state_store_lock);
+      err_output ("malloc: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  records = hash_for_each (state_store_hash, _state_store_snapshot_entry, &snapshot);
+
+  if (clear_dirty)
+    {
+      while ((entry = list_dequeue (state_store_dirty)))
+        entry->dirty = 0;
+    }
+
+  pthread_mutex_unlock (&state_store_lock);
+
+  if (snprintf (tmpfilename,
+                MAXPATHLEN,
+                "%s.XXXXXX",
+                state_store_filename) >= MAXPATHLEN)
+    {
+      err_output ("state store filename too long");
+      goto cleanup;
+    }
+
+  if ((fd = mkstemp (tmpfilename)) < 0)
+    {
+      err_output ("mkstemp: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if (fchmod (fd, 0644) < 0)
+    {
+      err_output ("fchmod: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if (_state_store_write_header (fd) < 0)
+    goto cleanup;
+
+  if (fd_write_n (fd, snapshot.databuf, snapshot.databuf_offset) != snapshot.databuf_offset)
+    {
+      err_output ("fd_write_n: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if (fsync (fd) < 0)
+    {
+      err_output ("fsync: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if (rename (tmpfilename, state_store_filename) < 0)
+    {
+      err_output ("rename: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  close (state_store_fd);
+  state_store_fd = fd;
+  state_store_records = records;
+  fd = -1;
+  rv = 0;
+ cleanup:
+  if (fd >= 0)
+    {
+      close (fd);
+      unlink (tmpfilename);
+    }
+  free (snapshot.databuf);
+  return (rv);
+}
+
+/* Undo a failed append so later appends don't land after a torn
+ * record, which would be discarded with everything after it on the
+ * next start.  The entries are dirtied again to be retried.  offset
+ * < 0 if nothing was written.
+ */
+static void
+_state_store_append_undo (off_t offset,
+                          struct ipmiseld_state_entry **entries,
+                          unsigned int count)
+{
+  unsigned int i;
+
+  if (offset >= 0
+      && (ftruncate (state_store_fd, offset) < 0
+          || lseek (state_store_fd, offset, SEEK_SET) < 0))
+    {
+      err_output ("state store '%s' could not be truncated: %s",
+                  state_store_filename,
+                  strerror (errno));
+      state_store_compact_needed = 1;
+    }
+
+  /* an entry stored again meanwhile is already dirty w/ newer data */
+  pthread_mutex_lock (&state_store_lock);
+  for (i = 0; i < count; i++)
+    {
+      if (entries[i]->dirty)
+        continue;
+
+      if (!list_append (state_store_dirty, entries[i]))
+        {
+          err_output ("list_append: %s", strerror (errno));
+          state_store_compact_needed = 1;
+          continue;
+        }
+      entries[i]->dirty = 1;
+    }
+  pthread_mutex_unlock (&state_store_lock);
+}
+
+int
+ipmiseld_data_cache_sync (ipmiseld_prog_data_t *prog_data)
+{
+  struct ipmiseld_state_entry **entries = NULL;
+  struct ipmiseld_state_entry *entry;
+  uint8_t *databuf = NULL;
+  unsigned int databuf_offset = 0;
+  unsigned int count;
+  unsigned int i = 0;
+  off_t offset;
+  int rv = -1;
+
+  assert (prog_data);
+
+  if (state_store_fd < 0)
+    return (0);
+
+  /* a rewrite holds the latest record of every host, including any
+   * that could not be appended
+   */
+  if (state_store_compact_needed)
+    {
+      if (_state_store_compact (1) < 0)
+        return (-1);
+
+      state_store_compact_needed = 0;
+      return (0);
+    }
+
+  /* Marshalled records are copied out under the lock, the write and
+   * fsync aren't done under it so hosts being polled aren't held up.
+   */
+  pthread_mutex_lock (&state_store_lock);
+
+  if (!(count = list_count (state_store_dirty)))
+    {
+      pthread_mutex_unlock (&state_store_lock);
+      return (0);
+    }
+
+  if (!(databuf = (uint8_t *)malloc (count * IPMISELD_STATE_RECORD_LENGTH_MAX)))
+    {
+      pthread_mutex_unlock (&state_store_lock);
+      err_output ("malloc: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  if (!(entries = (struct ipmiseld_state_entry **)malloc (count * sizeof (struct ipmiseld_state_entry *))))
+    {
+      pthread_mutex_unlock (&state_store_lock);
+      err_output ("malloc: %s", strerror (errno));
+      goto cleanup;
+    }
+
+  while ((entry = list_dequeue (state_store_dirty)))
+    {
+      memcpy (databuf + databuf_offset, entry->record, entry->record_len);
+      databuf_offset += entry->record_len;
+      entry->dirty = 0;
+      entries[i++] = entry;
+    }
+
+  pthread_mutex_unlock (&state_store_lock);
+
+  assert (i == count);
+
+  if ((offset = lseek (state_store_fd, 0, SEEK_END)) < 0)
+    {
+      err_output ("lseek: %s", strerror (errno));
+      _state_store_append_undo (-1, entries, count);
+      goto cleanup;
+    }
+
+  if (fd_write_n (state_store_fd, databuf, databuf_offset) != databuf_offset)
+    {
+      err_output ("fd_write_n: %s", strerror (errno));
+      _state_store_append_undo (offset, entries, count);
+      goto cleanup;
+    }
+
+  if (fsync (state_store_fd) < 0)
+    {
+      err_output ("fsync: %s", strerror (errno));
+      _state_store_append_undo (offset, entries, count);
+      goto cleanup;
+    }
+
+  state_store_records += count;
+
+  if (state_store_records > IPMISELD_STATE_COMPACT_MIN
+      && state_store_records > IPMISELD_STATE_COMPACT_FACTOR * hash_count (state_store_hash))
+    {
+      if (_state_store_compact (0) < 0)
+        goto cleanup;
+    }
+
+  rv = 0;
+ cleanup:
+  free (entries);
+  free (databuf);
+  return (rv);
+}
+
+void
+ipmiseld_data_cache_finish (ipmiseld_prog_data_t *prog_data)
+{
+  assert (prog_data);
+
+  if (state_store_fd >= 0)
+    {
+      ipmiseld_data_cache_sync (prog_data);
+      close (state_store_fd);
+      state_store_fd = -1;
+    }
+
+  if (state_store_dirty)
+    {
+      list_destroy (state_store_dirty);
+      state_store_dirty = NULL;
+    }
+
+  if (state_store_hash)
+    {
+      hash_destroy (state_store_hash);
+      state_store_hash = NULL;
+    }
+
+  state_store_records = 0;
+}
+
+/* returns 1 on data found/loaded, 0 if not found, -1 on error loading
+ *  (permission, corrupted, etc.)
+ */
+int
+ipmiseld_data_cache_load (ipmiseld_host_data_t *host_data)
+{
+  struct ipmiseld_state_entry *entry;
+
+  assert (host_data);
+
+  if (state_store_hash)
+    {
+      pthread_mutex_lock (&state_store_lock);
+
+      if ((entry = hash_find (state_store_hash, _data_cache_hostname (host_data)))
+          && entry->record_len)
+        {
+          _unmarshall_host_state (entry->record + 1 + entry->record[0],
+                                  &host_data->last_host_state);
+          pthread_mutex_unlock (&state_store_lock);
+          return (1);
+        }
+
+      pthread_mutex_unlock (&state_store_lock);
+    }
+
+  /* not in the state store yet, a per host data cache from before
+   * there was one may still have the host's state
+   */
+  return (_data_cache_file_load (host_data));
+}
+
+int
+ipmiseld_data_cache_store (ipmiseld_host_data_t *host_data)
+{
+  struct ipmiseld_state_entry *entry;
+  const char *hostname;
+  unsigned int hostname_len;
+  unsigned int databuf_offset = 0;
+
+  assert (host_data);
+
+  hostname = _data_cache_hostname (host_data);
+  hostname_len = strlen (hostname);
+
+  if (!state_store_hash
+      || hostname_len > IPMISELD_STATE_HOSTNAME_MAX)
+    return (_data_cache_file_store (host_data));
+
+  pthread_mutex_lock (&state_store_lock);
+
+  if (!(entry = _state_entry_get (hostname)))
+    {
+      pthread_mutex_unlock (&state_store_lock);
+      return (-1);
+    }
+
+  databuf_offset += _marshall_uint8 (entry->record + databuf_offset, hostname_len);
+  memcpy (entry->record + databuf_offset, hostname, hostname_len);
+  databuf_offset += hostname_len;
+  databuf_offset += _marshall_host_state (entry->record + databuf_offset, &host_data->last_host_state);
+  databuf_offset += _marshall_uint8 (entry->record + databuf_offset, _zerosumchecksum (entry->record, databuf_offset));
+  entry->record_len = databuf_offset;
+
+  if (!entry->dirty)
+    {
+      if (!list_append (state_store_dirty, entry))
+        {
+          pthread_mutex_unlock (&state_store_lock);
+          ipmiseld_err_output (host_data, "list_append: %s", strerror (errno));
+          return (-1);
+        }
+      entry->dirty = 1;
+    }
+
+  pthread_mutex_unlock (&state_store_lock);
+  return (0);
+}
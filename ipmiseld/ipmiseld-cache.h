@@ -30,6 +30,19 @@
 
 int ipmiseld_sdr_cache_create_and_load (ipmiseld_host_data_t *host_data);
 
+/* Opens the state store all hosts' data is kept in.  If it cannot be
+ * opened, data is loaded/stored in per host data cache files.
+ */
+int ipmiseld_data_cache_init (ipmiseld_prog_data_t *prog_data);
+
+/* Appends data stored since the last sync to the state store.  Data
+ * that could not be appended is retried on the next sync.  Only
+ * called from the main thread.
+ */
+int ipmiseld_data_cache_sync (ipmiseld_prog_data_t *prog_data);
+
+void ipmiseld_data_cache_finish (ipmiseld_prog_data_t *prog_data);
+
 /* returns 1 on data found/loaded, 0 if not found, -1 on error loading
  *  (permission, corrupted, etc.)
  */
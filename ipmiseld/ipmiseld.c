@@ -76,8 +76,21 @@
 
 #define IPMISELD_RETRY_ATTEMPT_MAX      3
 
+/* in milliseconds, the signal handler can't signal
+ * host_data_heap_cond, so wake up atleast this often to check
+ * exit_flag
+ */
+#define IPMISELD_SCHEDULER_WAIT_MAX     1000
+
+/* poll times and host_data_heap_cond use the monotonic clock */
+#if defined (HAVE_CLOCK_GETTIME) && defined (HAVE_PTHREAD_CONDATTR_SETCLOCK) && defined (CLOCK_MONOTONIC)
+#define IPMISELD_CLOCK_MONOTONIC        1
+#endif /* defined (HAVE_CLOCK_GETTIME) && defined (HAVE_PTHREAD_CONDATTR_SETCLOCK) && defined (CLOCK_MONOTONIC) */
+
 static Heap host_data_heap = NULL;
 static pthread_mutex_t host_data_heap_lock = PTHREAD_MUTEX_INITIALIZER;
+/* signaled when a host is put back on the heap */
+static pthread_cond_t host_data_heap_cond = PTHREAD_COND_INITIALIZER;
 
 static int exit_flag = 1;
 
@@ -1322,6 +1335,10 @@ _ipmiseld_poll (void *arg)
   if (host_data->prog_data->args->common_args.section_specific_workaround_flags & IPMI_PARSE_SECTION_SPECIFIC_WORKAROUND_FLAGS_ASSUME_SYSTEM_EVENT)
     sel_flags |= IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS;
 
+  if (host_data->hostname
+      && host_data->prog_data->args->common_args.driver_type == IPMI_DEVICE_LAN_2_0)
+    sel_flags |= IPMI_SEL_FLAGS_PIPELINED;
+
   if (sel_flags)
     {
       /* Don't error out, if this fails we can still continue */
@@ -1453,11 +1470,32 @@ _ipmiseld_poll (void *arg)
   return (exit_code);
 }
 
+/* milliseconds on the clock host_data_heap_cond waits on, monotonic
+ * where possible so a step of the system clock does not stall or
+ * bunch up polls
+ */
+static uint64_t
+_ipmiseld_time_ms (void)
+{
+#ifdef IPMISELD_CLOCK_MONOTONIC
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+#else /* !IPMISELD_CLOCK_MONOTONIC */
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return ((uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
+#endif /* !IPMISELD_CLOCK_MONOTONIC */
+}
+
 static int
 _ipmiseld_poll_postprocess (void *arg)
 {
   ipmiseld_host_data_t *host_data;
-  struct timeval tv;
+  uint64_t poll_interval;
+  uint64_t now;
   int rv = -1;
 
   assert (arg);
@@ -1466,8 +1504,16 @@ _ipmiseld_poll_postprocess (void *arg)
 
   assert (!host_data->host_poll);
 
-  gettimeofday (&tv, NULL);
-  host_data->next_poll_time = tv.tv_sec + host_data->prog_data->args->poll_interval;
+  now = _ipmiseld_time_ms ();
+  poll_interval = (uint64_t)host_data->prog_data->args->poll_interval * 1000;
+
+  /* Keep the host in the slot it was given at startup, so polls stay
+   * spread over the interval.  If the poll ran past its next slot,
+   * start over from now.
+   */
+  host_data->next_poll_time += poll_interval;
+  if (host_data->next_poll_time <= now)
+    host_data->next_poll_time = now + poll_interval;
 
   pthread_mutex_lock (&host_data_heap_lock);
 
@@ -1478,6 +1524,7 @@ _ipmiseld_poll_postprocess (void *arg)
       goto cleanup;
     }
 
+  pthread_cond_signal (&host_data_heap_cond);
   pthread_mutex_unlock (&host_data_heap_lock);
   rv = 0;
  cleanup:
@@ -1503,7 +1550,9 @@ _free_host_data (void *x)
 }
 
 static ipmiseld_host_data_t *
-_alloc_host_data (ipmiseld_prog_data_t *prog_data, const char *hostname)
+_alloc_host_data (ipmiseld_prog_data_t *prog_data,
+                  const char *hostname,
+                  uint64_t first_poll_time)
 {
   ipmiseld_host_data_t *host_data;
 
@@ -1531,7 +1580,7 @@ _alloc_host_data (ipmiseld_prog_data_t *prog_data, const char *hostname)
   host_data->host_poll = NULL;
   host_data->re_download_sdr_done = 0;
   host_data->clear_sel_done = 0;
-  host_data->next_poll_time = 0; /* 0 will first immediate check first time through */
+  host_data->next_poll_time = first_poll_time;
   host_data->last_ipmi_errnum = 0;
   host_data->last_ipmi_errnum_count = 0;
 
@@ -1556,6 +1605,34 @@ hostdata_timecmp (void *x, void *y)
   return (0);
 }
 
+/* Spread first polls evenly over the poll interval, each at a random
+ * point in its slot, so hosts are polled at a steady rate rather than
+ * all at once every interval.  The first host is polled immediately.
+ */
+static uint64_t
+_ipmiseld_first_poll_time (ipmiseld_prog_data_t *prog_data,
+                           uint64_t start,
+                           unsigned int host_index,
+                           unsigned int hosts_count)
+{
+  uint64_t poll_interval;
+  uint64_t slot;
+
+  assert (prog_data);
+  assert (hosts_count);
+  assert (host_index < hosts_count);
+
+  if (!host_index)
+    return (start);
+
+  poll_interval = (uint64_t)prog_data->args->poll_interval * 1000;
+  slot = poll_interval / hosts_count;
+
+  return (start
+          + host_index * slot
+          + (slot ? (uint64_t)((double)slot * (rand ()/(RAND_MAX + 1.0))) : 0));
+}
+
 static int
 _ipmiseld (ipmiseld_prog_data_t *prog_data)
 {
@@ -1564,6 +1641,8 @@ _ipmiseld (ipmiseld_prog_data_t *prog_data)
   fi_hostlist_iterator_t hitr = NULL;
   ipmiseld_host_data_t *host_data;
   char *host = NULL;
+  unsigned int host_index = 0;
+  uint64_t start;
   int rv = -1;
   int ret;
 
@@ -1605,9 +1684,43 @@ _ipmiseld (ipmiseld_prog_data_t *prog_data)
       goto cleanup;
     }
 
+#ifdef IPMISELD_CLOCK_MONOTONIC
+  {
+    pthread_condattr_t attr;
+
+    if ((ret = pthread_condattr_init (&attr)))
+      {
+        err_output ("pthread_condattr_init: %s", strerror (ret));
+        goto cleanup;
+      }
+
+    if ((ret = pthread_condattr_setclock (&attr, CLOCK_MONOTONIC)))
+      {
+        err_output ("pthread_condattr_setclock: %s", strerror (ret));
+        pthread_condattr_destroy (&attr);
+        goto cleanup;
+      }
+
+    ret = pthread_cond_init (&host_data_heap_cond, &attr);
+    pthread_condattr_destroy (&attr);
+  }
+#else /* !IPMISELD_CLOCK_MONOTONIC */
+  ret = pthread_cond_init (&host_data_heap_cond, NULL);
+#endif /* !IPMISELD_CLOCK_MONOTONIC */
+  if (ret)
+    {
+      err_output ("pthread_cond_init: %s", strerror (ret));
+      goto cleanup;
+    }
+
+  srand (time (NULL));
+  start = _ipmiseld_time_ms ();
+
   if (hosts_count == 1)
     {
-      if (!(host_data = _alloc_host_data (prog_data, prog_data->args->common_args.hostname)))
+      if (!(host_data = _alloc_host_data (prog_data,
+                                          prog_data->args->common_args.hostname,
+                                          start)))
         goto cleanup;
 
       if (!heap_insert (host_data_heap, host_data))
@@ -1632,7 +1745,12 @@ _ipmiseld (ipmiseld_prog_data_t *prog_data)
 
       while ((host = fi_hostlist_next (hitr)))
         {
-          if (!(host_data = _alloc_host_data (prog_data, host)))
+          if (!(host_data = _alloc_host_data (prog_data,
+                                              host,
+                                              _ipmiseld_first_poll_time (prog_data,
+                                                                         start,
+                                                                         host_index++,
+                                                                         hosts_count))))
             goto cleanup;
 
           if (!heap_insert (host_data_heap, host_data))
@@ -1646,6 +1764,10 @@ _ipmiseld (ipmiseld_prog_data_t *prog_data)
       host = NULL;
     }
 
+  /* on error, host state is kept in per host data cache files */
+  if (ipmiseld_data_cache_init (prog_data) < 0)
+    err_output ("state store unavailable, using per host data cache files");
+
   if (ipmiseld_threadpool_init (prog_data,
                                 _ipmiseld_poll,
                                 _ipmiseld_poll_postprocess) < 0)
@@ -1666,49 +1788,76 @@ _ipmiseld (ipmiseld_prog_data_t *prog_data)
     }
   else
     {
+      uint64_t sync_interval;
+      uint64_t next_sync_time;
+
+      pthread_mutex_lock (&host_data_heap_lock);
+
+      sync_interval = (uint64_t)prog_data->args->state_sync_interval * 1000;
+      next_sync_time = _ipmiseld_time_ms () + sync_interval;
+
       while (exit_flag)
         {
-          pthread_mutex_lock (&host_data_heap_lock);
+          uint64_t now;
 
-          host_data = heap_pop (host_data_heap);
-
-          pthread_mutex_unlock (&host_data_heap_lock);
+          now = _ipmiseld_time_ms ();
 
-          /* empty heap, small chance of this happening, but
-           * everything is processing and previous sleeps didn't sleep
-           * long enough.  So we just need to wait until something
-           * else finishes.
-           *
-           * There's no way to know the exact right amount of time, so
-           * we're going to make an estimate.  What we'll do is
-           * estimate 1/5th the time of a IPMI session timeout.  So in
-           * the event the previous poll fully timed out, we will
-           * interrupt and go through this loop only 5 times.
+          /* Sync host state on its own deadline, so it is synced even
+           * if some host is always due.
            */
-          if (!host_data)
+          if (now >= next_sync_time)
             {
-              unsigned int waittime;
-
-              if (prog_data->args->common_args.session_timeout)
-                waittime = prog_data->args->common_args.session_timeout;
-              else
-                waittime = IPMI_SESSION_TIMEOUT_DEFAULT;
-
-              /* session timeout is in milliseconds */
-              waittime /= 1000;
+              pthread_mutex_unlock (&host_data_heap_lock);
+              ipmiseld_data_cache_sync (prog_data);
+              pthread_mutex_lock (&host_data_heap_lock);
 
-              /* now take a 5th of it  */
-              waittime /= 5;
+              now = _ipmiseld_time_ms ();
+              next_sync_time = now + sync_interval;
+            }
 
-              if (!waittime)
-                waittime = 1;
+          host_data = heap_peek (host_data_heap);
 
-              daemon_sleep (waittime);
+          /* Nothing due, wait until the next host is due or until a
+           * poll finishes and its host goes back on the heap, which
+           * may be due earlier.  An empty heap means every host is
+           * being polled.
+           */
+          if (!host_data || host_data->next_poll_time > now)
+            {
+              struct timespec ts;
+              uint64_t wakeup;
+
+              wakeup = now + IPMISELD_SCHEDULER_WAIT_MAX;
+              if (host_data && host_data->next_poll_time < wakeup)
+                wakeup = host_data->next_poll_time;
+              if (next_sync_time < wakeup)
+                wakeup = next_sync_time;
+
+              ts.tv_sec = wakeup / 1000;
+              ts.tv_nsec = (wakeup % 1000) * 1000000;
+
+              if ((ret = pthread_cond_timedwait (&host_data_heap_cond,
+                                                 &host_data_heap_lock,
+                                                 &ts))
+                  && ret != ETIMEDOUT
+                  && ret != EINTR)
+                {
+                  pthread_mutex_unlock (&host_data_heap_lock);
+                  err_output ("pthread_cond_timedwait: %s", strerror (ret));
+                  goto cleanup;
+                }
               continue;
             }
 
+          host_data = heap_pop (host_data_heap);
+
+          pthread_mutex_unlock (&host_data_heap_lock);
+
           if (ipmiseld_threadpool_queue (host_data) < 0)
             {
+              /* try again next interval */
+              host_data->next_poll_time = now + (uint64_t)prog_data->args->poll_interval * 1000;
+
               pthread_mutex_lock (&host_data_heap_lock);
 
               if (!heap_insert (host_data_heap, host_data))
@@ -1718,34 +1867,15 @@ _ipmiseld (ipmiseld_prog_data_t *prog_data)
             }
 
           pthread_mutex_lock (&host_data_heap_lock);
-
-          host_data = heap_peek (host_data_heap);
-
-          pthread_mutex_unlock (&host_data_heap_lock);
-
-          /* empty heap, everything must be processing, so we'll sleep
-           * for the poll interval, b/c no one should be scheduled
-           * until after this time has passed anyways.
-           */
-          if (!host_data)
-            daemon_sleep (prog_data->args->poll_interval + 1);
-          else
-            {
-              struct timeval tv;
-
-              gettimeofday (&tv, NULL);
-
-              /* If next_poll_time == 0, no sleep, its the first time through */
-              if (host_data->next_poll_time
-                  && (host_data->next_poll_time > tv.tv_sec))
-                daemon_sleep ((host_data->next_poll_time - tv.tv_sec) + 1);
-            }
         }
+
+      pthread_mutex_unlock (&host_data_heap_lock);
     }
 
   rv = 0;
  cleanup:
   ipmiseld_threadpool_destroy ();
+  ipmiseld_data_cache_finish (prog_data);
   heap_destroy (host_data_heap);
   fi_hostlist_iterator_destroy (hitr);
   fi_hostlist_destroy (hlist);
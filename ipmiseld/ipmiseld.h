@@ -65,6 +65,8 @@
 
 #define IPMISELD_POLL_INTERVAL_DEFAULT                                  300
 
+#define IPMISELD_STATE_SYNC_INTERVAL_DEFAULT                            30
+
 #define IPMISELD_THREADPOOL_COUNT                                       8
 
 #define IPMISELD_ERROR_OUTPUT_LIMIT                                     20
@@ -97,6 +99,8 @@ enum ipmiseld_argp_option_keys
     IPMISELD_THREADPOOL_COUNT_KEY = 180,
     IPMISELD_TEST_RUN_KEY = 181,
     IPMISELD_FOREGROUND_KEY = 182,
+    IPMISELD_SDR_CACHE_SHARED_KEY = 183,
+    IPMISELD_STATE_SYNC_INTERVAL_KEY = 184,
   };
 
 struct ipmiseld_arguments
@@ -124,8 +128,10 @@ struct ipmiseld_arguments
   char *log_facility_str;
   char *log_priority_str;
   char *cache_directory;
+  unsigned int state_sync_interval;
   int ignore_sdr;
   int re_download_sdr;
+  int sdr_cache_shared;
   int clear_sel;
   unsigned int threadpool_count;
   int test_run;
@@ -184,7 +190,7 @@ typedef struct ipmiseld_host_data
   ipmiseld_host_poll_t *host_poll;
   int re_download_sdr_done;
   int clear_sel_done;
-  time_t next_poll_time;
+  uint64_t next_poll_time;      /* milliseconds since the epoch */
   int last_ipmi_errnum;
   unsigned int last_ipmi_errnum_count;
 } ipmiseld_host_data_t;
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#if HAVE_ARGP_H
+#include <argp.h>
+#else /* !HAVE_ARGP_H */
+#include "freeipmi-argp.h"
+#endif /* !HAVE_ARGP_H */
+#include <assert.h>
+#include <errno.h>
+
+#include "ipmisessiond.h"
+#include "ipmisessiond-argp.h"
+
+#include "freeipmi-portability.h"
+#include "error.h"
+
+const char *argp_program_version =
+  "ipmisessiond - " PACKAGE_VERSION "\n"
+  "Copyright (C) 2003-2015 FreeIPMI Core Team\n"
+  "This program is free software; you may redistribute it under the terms of\n"
+  "the GNU General Public License.  This program has absolutely no warranty.";
+
+const char *argp_program_bug_address =
+  "<" PACKAGE_BUGREPORT ">";
+
+static char cmdline_doc[] =
+  "ipmisessiond - IPMI session broker daemon";
+
+static char cmdline_args_doc[] = "";
+
+static struct argp_option cmdline_options[] =
+  {
+    { "socket", IPMISESSIOND_SOCKET_KEY, "PATH", 0,
+      "Specify alternate socket path.", 1},
+    { "idle-timeout", IPMISESSIOND_IDLE_TIMEOUT_KEY, "SECONDS", 0,
+      "Specify how long an unused session is kept open.", 2},
+    { "keepalive-interval", IPMISESSIOND_KEEPALIVE_INTERVAL_KEY, "SECONDS", 0,
+      "Specify how often idle sessions are refreshed.", 3},
+    { "debug", IPMISESSIOND_DEBUG_KEY, 0, 0,
+      "Turn on debugging and run daemon in foreground", 4},
+    { NULL, 0, NULL, 0, NULL, 0}
+  };
+
+static error_t cmdline_parse (int key, char *arg, struct argp_state *state);
+
+static struct argp cmdline_argp = { cmdline_options,
+                                    cmdline_parse,
+                                    cmdline_args_doc,
+                                    cmdline_doc };
+
+static error_t
+cmdline_parse (int key, char *arg, struct argp_state *state)
+{
+  struct ipmisessiond_arguments *cmd_args;
+  char *endptr;
+  long tmp;
+
+  assert (state);
+
+  cmd_args = state->input;
+
+  switch (key)
+    {
+    case IPMISESSIOND_SOCKET_KEY:
+      free (cmd_args->socket);
+      if (!(cmd_args->socket = strdup (arg)))
+        err_exit ("strdup: %s", strerror (errno));
+      break;
+    case IPMISESSIOND_IDLE_TIMEOUT_KEY:
+      errno = 0;
+      tmp = strtol (arg, &endptr, 0);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp <= 0)
+        {
+          fprintf (stderr, "invalid idle timeout\n");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->idle_timeout = tmp;
+      break;
+    case IPMISESSIOND_KEEPALIVE_INTERVAL_KEY:
+      errno = 0;
+      tmp = strtol (arg, &endptr, 0);
+      if (errno
+          || endptr[0] != '\0'
+          || tmp <= 0)
+        {
+          fprintf (stderr, "invalid keepalive interval\n");
+          exit (EXIT_FAILURE);
+        }
+      cmd_args->keepalive_interval = tmp;
+      break;
+    case IPMISESSIOND_DEBUG_KEY:
+      cmd_args->debug++;
+      break;
+    case ARGP_KEY_ARG:
+      /* Too many arguments. */
+      argp_usage (state);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return (ARGP_ERR_UNKNOWN);
+    }
+
+  return (0);
+}
+
+void
+ipmisessiond_argp_parse (int argc, char **argv, struct ipmisessiond_arguments *cmd_args)
+{
+  assert (argc >= 0);
+  assert (argv);
+  assert (cmd_args);
+
+  cmd_args->debug = 0;
+  cmd_args->socket = NULL;
+  cmd_args->idle_timeout = IPMISESSIOND_IDLE_TIMEOUT_DEFAULT;
+  cmd_args->keepalive_interval = IPMISESSIOND_KEEPALIVE_INTERVAL_DEFAULT;
+
+  argp_parse (&cmdline_argp,
+              argc,
+              argv,
+              ARGP_IN_ORDER,
+              NULL,
+              cmd_args);
+}
@@ -0,0 +1,1120 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#if TIME_WITH_SYS_TIME
+#include <sys/time.h>
+#include <time.h>
+#else  /* !TIME_WITH_SYS_TIME */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#else /* !HAVE_SYS_TIME_H */
+#include <time.h>
+#endif  /* !HAVE_SYS_TIME_H */
+#endif /* !TIME_WITH_SYS_TIME */
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/poll.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <syslog.h>
+#include <signal.h>
+#include <pthread.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <freeipmi/freeipmi.h>
+
+#include "ipmisessiond.h"
+#include "ipmisessiond-argp.h"
+
+#include "ipmi-session-broker-protocol.h"
+
+#include "freeipmi-portability.h"
+#include "error.h"
+#include "fd.h"
+#include "list.h"
+#include "secure.h"
+
+#include "tool-daemon-common.h"
+#include "tool-util-common.h"
+
+#define IPMISESSIOND_PIDFILE         IPMISESSIOND_LOCALSTATEDIR "/run/ipmisessiond.pid"
+
+#define IPMISESSIOND_SERVER_BACKLOG  16
+
+/* how long a client may take to hand us a complete request, or to
+ * take a complete response
+ */
+#define IPMISESSIOND_CLIENT_TIMEOUT  5
+
+#define IPMISESSIOND_POLL_TIMEOUT_MS 1000
+
+/* Every session has its own thread talking to the BMC, so a slow or
+ * unresponsive BMC only holds up the clients of that session.  The
+ * main loop only does nonblocking I/O with clients and hands their
+ * requests to the session threads.
+ */
+struct ipmisessiond_session
+{
+  struct ipmi_session_broker_open_rq params;
+  /* session thread only */
+  ipmi_ctx_t ipmi_ctx;
+  pthread_t thread;
+  pthread_cond_t cond;
+  /* protected by ipmisessiond_lock */
+  struct ipmisessiond_client *queue_head;
+  struct ipmisessiond_client *queue_tail;
+  int keepalive;
+  int opened;
+  int exited;
+  time_t last_activity;
+  /* written by the main loop only, under ipmisessiond_lock */
+  int exiting;
+  /* main loop only */
+  int joined;
+  unsigned int refcount;
+  time_t last_used;
+};
+
+#define IPMISESSIOND_CLIENT_READ  0
+#define IPMISESSIOND_CLIENT_BUSY  1
+#define IPMISESSIOND_CLIENT_WRITE 2
+
+struct ipmisessiond_client
+{
+  int fd;
+  struct ipmisessiond_session *session;
+  int state;
+  union {
+    struct ipmi_session_broker_hdr hdr;
+    struct ipmi_session_broker_open_rq open;
+    struct ipmi_session_broker_cmd_rq cmd;
+  } rq;
+  size_t rq_len;
+  struct ipmi_session_broker_rs rs;
+  size_t rs_len;
+  /* start of a partial read or write */
+  time_t io_start;
+  /* set by the session thread, protected by ipmisessiond_lock */
+  int replied;
+  struct ipmisessiond_client *queue_next;
+  int done;
+};
+
+struct ipmisessiond_arguments cmd_args;
+
+static List sessions = NULL;
+static List clients = NULL;
+static int server_fd = -1;
+static const char *socket_path = NULL;
+
+/* session threads wake up the main loop through this pipe */
+static int wakeup_fds[2] = { -1, -1 };
+
+static pthread_mutex_t ipmisessiond_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int exit_flag = 1;
+
+static void
+_wakeup (void)
+{
+  uint8_t b = 0;
+
+  /* a full pipe wakes the main loop up just the same */
+  if (write (wakeup_fds[1], &b, 1) < 0
+      && errno != EAGAIN
+      && errno != EWOULDBLOCK
+      && errno != EINTR)
+    err_output ("write: %s", strerror (errno));
+}
+
+static void
+_wakeup_drain (void)
+{
+  uint8_t buf[64];
+
+  while (read (wakeup_fds[0], buf, sizeof (buf)) > 0)
+    ;
+}
+
+static void
+_session_close (struct ipmisessiond_session *s)
+{
+  assert (s);
+
+  if (s->ipmi_ctx)
+    {
+      ipmi_ctx_close (s->ipmi_ctx);
+      ipmi_ctx_destroy (s->ipmi_ctx);
+      s->ipmi_ctx = NULL;
+    }
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  s->opened = 0;
+  pthread_mutex_unlock (&ipmisessiond_lock);
+}
+
+static void
+_session_activity (struct ipmisessiond_session *s)
+{
+  assert (s);
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  s->last_activity = time (NULL);
+  pthread_mutex_unlock (&ipmisessiond_lock);
+}
+
+/* returns ipmi errnum */
+static uint32_t
+_session_open (struct ipmisessiond_session *s)
+{
+  uint32_t errnum;
+
+  assert (s);
+  assert (!s->ipmi_ctx);
+
+  if (!(s->ipmi_ctx = ipmi_ctx_create ()))
+    {
+      err_output ("ipmi_ctx_create: %s", strerror (errno));
+      return (IPMI_ERR_OUT_OF_MEMORY);
+    }
+
+  /* must not hand the session back to ourselves */
+  if (ipmi_ctx_open_outofband_2_0 (s->ipmi_ctx,
+                                   s->params.hostname,
+                                   strlen (s->params.username) ? s->params.username : NULL,
+                                   strlen (s->params.password) ? s->params.password : NULL,
+                                   s->params.k_g_len ? s->params.k_g : NULL,
+                                   s->params.k_g_len,
+                                   s->params.privilege_level,
+                                   s->params.cipher_suite_id,
+                                   s->params.session_timeout,
+                                   s->params.retransmission_timeout,
+                                   s->params.workaround_flags,
+                                   s->params.flags | IPMI_FLAGS_NO_SESSION_BROKER) < 0)
+    {
+      errnum = ipmi_ctx_errnum (s->ipmi_ctx);
+      if (cmd_args.debug)
+        fprintf (stderr,
+                 "%s: ipmi_ctx_open_outofband_2_0: %s\n",
+                 s->params.hostname,
+                 ipmi_ctx_errormsg (s->ipmi_ctx));
+      ipmi_ctx_destroy (s->ipmi_ctx);
+      s->ipmi_ctx = NULL;
+      return (errnum);
+    }
+
+  if (cmd_args.debug)
+    fprintf (stderr, "%s: session opened\n", s->params.hostname);
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  s->opened = 1;
+  s->last_activity = time (NULL);
+  pthread_mutex_unlock (&ipmisessiond_lock);
+  return (IPMI_ERR_SUCCESS);
+}
+
+static int
+_session_cmd_raw (struct ipmisessiond_session *s,
+                  struct ipmi_session_broker_cmd_rq *rq,
+                  struct ipmi_session_broker_rs *rs)
+{
+  int len;
+
+  assert (s);
+  assert (s->ipmi_ctx);
+  assert (rq);
+  assert (rs);
+
+  if (rq->target_is_set)
+    len = ipmi_cmd_raw_ipmb (s->ipmi_ctx,
+                             rq->channel_number,
+                             rq->rs_addr,
+                             rq->lun,
+                             rq->net_fn,
+                             rq->rq,
+                             rq->rq_len,
+                             rs->rs,
+                             IPMI_SESSION_BROKER_PKT_LEN);
+  else
+    len = ipmi_cmd_raw (s->ipmi_ctx,
+                        rq->lun,
+                        rq->net_fn,
+                        rq->rq,
+                        rq->rq_len,
+                        rs->rs,
+                        IPMI_SESSION_BROKER_PKT_LEN);
+
+  if (len >= 0)
+    {
+      rs->rs_len = len;
+      _session_activity (s);
+    }
+
+  return (len);
+}
+
+static void
+_session_cmd (struct ipmisessiond_session *s,
+              struct ipmi_session_broker_cmd_rq *rq,
+              struct ipmi_session_broker_rs *rs)
+{
+  assert (s);
+  assert (rq);
+  assert (rs);
+
+  if (!rq->rq_len
+      || rq->rq_len > IPMI_SESSION_BROKER_PKT_LEN)
+    {
+      rs->errnum = IPMI_ERR_PARAMETERS;
+      return;
+    }
+
+  /* The session is shared, a client may not close it or change its
+   * privilege level under the other clients.
+   */
+  if (!rq->target_is_set
+      && rq->net_fn == IPMI_NET_FN_APP_RQ
+      && (rq->rq[0] == IPMI_CMD_CLOSE_SESSION
+          || rq->rq[0] == IPMI_CMD_SET_SESSION_PRIVILEGE_LEVEL))
+    {
+      rs->errnum = IPMI_ERR_COMMAND_INVALID_FOR_SELECTED_INTERFACE;
+      return;
+    }
+
+  /* only a session known to be gone is reopened, see below */
+  if (!s->ipmi_ctx
+      && (rs->errnum = _session_open (s)) != IPMI_ERR_SUCCESS)
+    return;
+
+  if (_session_cmd_raw (s, rq, rs) >= 0)
+    {
+      rs->errnum = IPMI_ERR_SUCCESS;
+      return;
+    }
+
+  rs->errnum = ipmi_ctx_errnum (s->ipmi_ctx);
+
+  /* The BMC may have dropped the session behind our back.  The
+   * command is not retried, it may have been executed and may not be
+   * safe to repeat (e.g. Chassis Control).  The timeout is returned
+   * to the client and the next command opens a fresh session.
+   */
+  if (rs->errnum == IPMI_ERR_SESSION_TIMEOUT)
+    _session_close (s);
+}
+
+static void
+_session_keepalive (struct ipmisessiond_session *s)
+{
+  uint8_t buf_rq[1];
+  uint8_t buf_rs[IPMI_SESSION_BROKER_PKT_LEN];
+
+  assert (s);
+
+  /* closed by a failed command since the keepalive was asked for */
+  if (!s->ipmi_ctx)
+    return;
+
+  /* any command resets the BMC's session inactivity timer */
+  buf_rq[0] = IPMI_CMD_GET_DEVICE_ID;
+
+  if (ipmi_cmd_raw (s->ipmi_ctx,
+                    IPMI_BMC_IPMB_LUN_BMC,
+                    IPMI_NET_FN_APP_RQ,
+                    buf_rq,
+                    1,
+                    buf_rs,
+                    IPMI_SESSION_BROKER_PKT_LEN) < 0)
+    {
+      /* reopened on the next command */
+      if (cmd_args.debug)
+        fprintf (stderr,
+                 "%s: keepalive failed: %s\n",
+                 s->params.hostname,
+                 ipmi_ctx_errormsg (s->ipmi_ctx));
+      _session_close (s);
+      return;
+    }
+
+  _session_activity (s);
+}
+
+static void *
+_session_thread (void *arg)
+{
+  struct ipmisessiond_session *s = arg;
+  struct ipmisessiond_client *c;
+
+  assert (s);
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  while (!s->exiting)
+    {
+      if ((c = s->queue_head))
+        {
+          if (!(s->queue_head = c->queue_next))
+            s->queue_tail = NULL;
+          c->queue_next = NULL;
+          pthread_mutex_unlock (&ipmisessiond_lock);
+
+          if (c->rq.hdr.msg_type == IPMI_SESSION_BROKER_MSG_OPEN)
+            {
+              if (!s->ipmi_ctx)
+                c->rs.errnum = _session_open (s);
+              else
+                c->rs.errnum = IPMI_ERR_SUCCESS;
+            }
+          else
+            _session_cmd (s, &c->rq.cmd, &c->rs);
+
+          pthread_mutex_lock (&ipmisessiond_lock);
+          c->replied = 1;
+          _wakeup ();
+          continue;
+        }
+
+      if (s->keepalive)
+        {
+          s->keepalive = 0;
+          pthread_mutex_unlock (&ipmisessiond_lock);
+          _session_keepalive (s);
+          pthread_mutex_lock (&ipmisessiond_lock);
+          continue;
+        }
+
+      pthread_cond_wait (&s->cond, &ipmisessiond_lock);
+    }
+  pthread_mutex_unlock (&ipmisessiond_lock);
+
+  _session_close (s);
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  s->exited = 1;
+  pthread_mutex_unlock (&ipmisessiond_lock);
+  _wakeup ();
+  return (NULL);
+}
+
+static struct ipmisessiond_session *
+_session_create (struct ipmi_session_broker_open_rq *params)
+{
+  struct ipmisessiond_session *s;
+  sigset_t set, oset;
+  int ret;
+
+  assert (params);
+
+  if (!(s = (struct ipmisessiond_session *)malloc (sizeof (struct ipmisessiond_session))))
+    {
+      err_output ("malloc: %s", strerror (errno));
+      return (NULL);
+    }
+  memset (s, '\0', sizeof (struct ipmisessiond_session));
+  memcpy (&s->params, params, sizeof (struct ipmi_session_broker_open_rq));
+
+  if ((ret = pthread_cond_init (&s->cond, NULL)))
+    {
+      err_output ("pthread_cond_init: %s", strerror (ret));
+      goto cleanup;
+    }
+
+  /* signals are for the main loop */
+  sigfillset (&set);
+  pthread_sigmask (SIG_SETMASK, &set, &oset);
+  ret = pthread_create (&s->thread, NULL, _session_thread, s);
+  pthread_sigmask (SIG_SETMASK, &oset, NULL);
+
+  if (ret)
+    {
+      err_output ("pthread_create: %s", strerror (ret));
+      pthread_cond_destroy (&s->cond);
+      goto cleanup;
+    }
+
+  return (s);
+
+ cleanup:
+  secure_memset (&s->params, '\0', sizeof (struct ipmi_session_broker_open_rq));
+  free (s);
+  return (NULL);
+}
+
+/* The session thread closes the session and exits in the
+ * background, the session is freed once it has.
+ */
+static void
+_session_exit (struct ipmisessiond_session *s)
+{
+  assert (s);
+
+  if (s->exiting)
+    return;
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  s->exiting = 1;
+  pthread_cond_signal (&s->cond);
+  pthread_mutex_unlock (&ipmisessiond_lock);
+}
+
+static void
+_session_join (struct ipmisessiond_session *s)
+{
+  assert (s);
+
+  if (s->joined)
+    return;
+
+  _session_exit (s);
+  pthread_join (s->thread, NULL);
+  s->joined = 1;
+}
+
+static void
+_session_destroy (void *x)
+{
+  struct ipmisessiond_session *s = x;
+
+  assert (s);
+
+  _session_join (s);
+  pthread_cond_destroy (&s->cond);
+  secure_memset (&s->params, '\0', sizeof (struct ipmi_session_broker_open_rq));
+  free (s);
+}
+
+static void
+_session_queue (struct ipmisessiond_session *s, struct ipmisessiond_client *c)
+{
+  assert (s);
+  assert (!s->exiting);
+  assert (c);
+
+  s->last_used = time (NULL);
+
+  c->state = IPMISESSIOND_CLIENT_BUSY;
+  c->replied = 0;
+  c->queue_next = NULL;
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  if (s->queue_tail)
+    s->queue_tail->queue_next = c;
+  else
+    s->queue_head = c;
+  s->queue_tail = c;
+  pthread_cond_signal (&s->cond);
+  pthread_mutex_unlock (&ipmisessiond_lock);
+}
+
+static void
+_client_destroy (void *x)
+{
+  struct ipmisessiond_client *c = x;
+
+  /* busy clients are only destroyed once session threads are gone */
+  assert (c);
+
+  if (c->session)
+    {
+      assert (c->session->refcount);
+      c->session->refcount--;
+    }
+  /* ignore potential error, destroy path */
+  close (c->fd);
+  secure_memset (&c->rq, '\0', sizeof (c->rq));
+  free (c);
+}
+
+static int
+_client_done (void *x, void *key)
+{
+  struct ipmisessiond_client *c = x;
+
+  assert (c);
+
+  return (c->done);
+}
+
+static int
+_session_params_match (void *x, void *key)
+{
+  struct ipmisessiond_session *s = x;
+  struct ipmi_session_broker_open_rq *params = key;
+
+  assert (s);
+  assert (params);
+
+  return (!s->exiting
+          && !strcmp (s->params.hostname, params->hostname)
+          && !strcmp (s->params.username, params->username)
+          && !strcmp (s->params.password, params->password)
+          && s->params.k_g_len == params->k_g_len
+          && !memcmp (s->params.k_g, params->k_g, params->k_g_len)
+          && s->params.privilege_level == params->privilege_level
+          && s->params.cipher_suite_id == params->cipher_suite_id
+          && s->params.session_timeout == params->session_timeout
+          && s->params.retransmission_timeout == params->retransmission_timeout
+          && s->params.workaround_flags == params->workaround_flags
+          && s->params.flags == params->flags);
+}
+
+static int
+_session_exited (void *x, void *key)
+{
+  struct ipmisessiond_session *s = x;
+  int exited;
+
+  assert (s);
+
+  pthread_mutex_lock (&ipmisessiond_lock);
+  exited = s->exited;
+  pthread_mutex_unlock (&ipmisessiond_lock);
+  return (exited);
+}
+
+static void
+_sessions_maintain (time_t now)
+{
+  struct ipmisessiond_session *s;
+  ListIterator itr;
+
+  list_delete_all (sessions, _session_exited, NULL);
+
+  if (!(itr = list_iterator_create (sessions)))
+    err_exit ("list_iterator_create: %s", strerror (errno));
+
+  while ((s = list_next (itr)))
+    {
+      if (s->exiting)
+        continue;
+
+      if (!s->refcount
+          && (now - s->last_used) >= cmd_args.idle_timeout)
+        {
+          if (cmd_args.debug)
+            fprintf (stderr, "%s: session idle, closing\n", s->params.hostname);
+          _session_exit (s);
+          continue;
+        }
+
+      /* busy sessions need no keepalive */
+      pthread_mutex_lock (&ipmisessiond_lock);
+      if (s->opened
+          && !s->queue_head
+          && (now - s->last_activity) >= cmd_args.keepalive_interval)
+        {
+          s->keepalive = 1;
+          pthread_cond_signal (&s->cond);
+        }
+      pthread_mutex_unlock (&ipmisessiond_lock);
+    }
+
+  list_iterator_destroy (itr);
+}
+
+/* Returns 1 if the request was handed to a session thread, 0 if the
+ * response is ready.
+ */
+static int
+_client_open (struct ipmisessiond_client *c)
+{
+  struct ipmi_session_broker_open_rq *rq;
+  struct ipmisessiond_session *s;
+
+  assert (c);
+
+  rq = &c->rq.open;
+
+  if (c->session)
+    {
+      c->rs.errnum = IPMI_ERR_DEVICE_ALREADY_OPEN;
+      return (0);
+    }
+
+  rq->hostname[IPMI_SESSION_BROKER_HOSTNAME_LEN] = '\0';
+  rq->username[IPMI_SESSION_BROKER_USERNAME_LEN] = '\0';
+  rq->password[IPMI_SESSION_BROKER_PASSWORD_LEN] = '\0';
+  if (rq->k_g_len > IPMI_SESSION_BROKER_K_G_LEN)
+    {
+      c->rs.errnum = IPMI_ERR_PARAMETERS;
+      return (0);
+    }
+
+  if (!(s = list_find_first (sessions, _session_params_match, rq)))
+    {
+      if (!(s = _session_create (rq)))
+        {
+          c->rs.errnum = IPMI_ERR_SYSTEM_ERROR;
+          return (0);
+        }
+
+      if (!list_append (sessions, s))
+        err_exit ("list_append: %s", strerror (errno));
+    }
+
+  /* the session thread opens the session if need be */
+  s->refcount++;
+  c->session = s;
+  _session_queue (s, c);
+  return (1);
+}
+
+static void
+_client_write (struct ipmisessiond_client *c)
+{
+  ssize_t n;
+
+  assert (c);
+  assert (c->state == IPMISESSIOND_CLIENT_WRITE);
+
+  while (c->rs_len < sizeof (struct ipmi_session_broker_rs))
+    {
+      if ((n = write (c->fd,
+                      (uint8_t *)&c->rs + c->rs_len,
+                      sizeof (struct ipmi_session_broker_rs) - c->rs_len)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return;
+          c->done = 1;
+          return;
+        }
+      c->rs_len += n;
+    }
+
+  c->state = IPMISESSIOND_CLIENT_READ;
+  c->rs_len = 0;
+}
+
+static void
+_client_reply (struct ipmisessiond_client *c)
+{
+  assert (c);
+
+  c->state = IPMISESSIOND_CLIENT_WRITE;
+  c->rs_len = 0;
+  c->io_start = time (NULL);
+  _client_write (c);
+}
+
+/* A session thread finished the client's request */
+static void
+_client_replied (struct ipmisessiond_client *c)
+{
+  struct ipmisessiond_session *s;
+
+  assert (c);
+  assert (c->state == IPMISESSIOND_CLIENT_BUSY);
+
+  if (c->rq.hdr.msg_type == IPMI_SESSION_BROKER_MSG_OPEN)
+    {
+      secure_memset (&c->rq.open, '\0', sizeof (struct ipmi_session_broker_open_rq));
+
+      if (c->rs.errnum != IPMI_ERR_SUCCESS)
+        {
+          s = c->session;
+          c->session = NULL;
+          assert (s->refcount);
+          /* a session that could not be opened is not kept */
+          if (!--s->refcount)
+            _session_exit (s);
+        }
+    }
+
+  _client_reply (c);
+}
+
+static void
+_client_request (struct ipmisessiond_client *c)
+{
+  assert (c);
+
+  memset (&c->rs, '\0', sizeof (struct ipmi_session_broker_rs));
+  c->rs.hdr.version = IPMI_SESSION_BROKER_PROTOCOL_VERSION;
+  c->rs.hdr.msg_type = c->rq.hdr.msg_type;
+  c->rs.hdr.seq = c->rq.hdr.seq;
+
+  if (c->rq.hdr.msg_type == IPMI_SESSION_BROKER_MSG_OPEN)
+    {
+      if (_client_open (c))
+        return;
+      secure_memset (&c->rq.open, '\0', sizeof (struct ipmi_session_broker_open_rq));
+    }
+  else
+    {
+      if (c->session)
+        {
+          _session_queue (c->session, c);
+          return;
+        }
+      c->rs.errnum = IPMI_ERR_DEVICE_NOT_OPEN;
+    }
+
+  _client_reply (c);
+}
+
+/* Length of the request being read, known once its header is in,
+ * 0 if the request is invalid.
+ */
+static size_t
+_client_rq_len (struct ipmisessiond_client *c)
+{
+  assert (c);
+
+  if (c->rq_len < sizeof (struct ipmi_session_broker_hdr))
+    return (sizeof (struct ipmi_session_broker_hdr));
+
+  if (c->rq.hdr.version != IPMI_SESSION_BROKER_PROTOCOL_VERSION)
+    return (0);
+
+  if (c->rq.hdr.msg_type == IPMI_SESSION_BROKER_MSG_OPEN)
+    return (sizeof (struct ipmi_session_broker_open_rq));
+  else if (c->rq.hdr.msg_type == IPMI_SESSION_BROKER_MSG_CMD)
+    return (sizeof (struct ipmi_session_broker_cmd_rq));
+
+  return (0);
+}
+
+static void
+_client_read (struct ipmisessiond_client *c)
+{
+  size_t len;
+  ssize_t n;
+
+  assert (c);
+  assert (c->state == IPMISESSIOND_CLIENT_READ);
+
+  while ((len = _client_rq_len (c)) && c->rq_len < len)
+    {
+      if ((n = read (c->fd,
+                     (uint8_t *)&c->rq + c->rq_len,
+                     len - c->rq_len)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return;
+          c->done = 1;
+          return;
+        }
+
+      /* client went away */
+      if (!n)
+        {
+          c->done = 1;
+          return;
+        }
+
+      if (!c->rq_len)
+        c->io_start = time (NULL);
+      c->rq_len += n;
+    }
+
+  if (!len)
+    {
+      c->done = 1;
+      return;
+    }
+
+  c->rq_len = 0;
+  _client_request (c);
+}
+
+static void
+_client_service (struct ipmisessiond_client *c, short revents, time_t now)
+{
+  int replied;
+
+  assert (c);
+
+  if (c->state == IPMISESSIOND_CLIENT_BUSY)
+    {
+      pthread_mutex_lock (&ipmisessiond_lock);
+      replied = c->replied;
+      pthread_mutex_unlock (&ipmisessiond_lock);
+
+      if (replied)
+        _client_replied (c);
+      return;
+    }
+
+  if (c->state == IPMISESSIOND_CLIENT_READ
+      && (revents & (POLLIN | POLLHUP | POLLERR)))
+    _client_read (c);
+  else if (c->state == IPMISESSIOND_CLIENT_WRITE
+           && (revents & (POLLOUT | POLLHUP | POLLERR)))
+    _client_write (c);
+
+  /* a stalled client must not hold on to its connection forever */
+  if (!c->done
+      && ((c->state == IPMISESSIOND_CLIENT_READ && c->rq_len)
+          || c->state == IPMISESSIOND_CLIENT_WRITE)
+      && (now - c->io_start) >= IPMISESSIOND_CLIENT_TIMEOUT)
+    c->done = 1;
+}
+
+static void
+_client_accept (void)
+{
+  struct ipmisessiond_client *c;
+  int fd;
+
+  if ((fd = accept (server_fd, NULL, NULL)) < 0)
+    {
+      if (errno != EINTR && errno != EAGAIN && errno != ECONNABORTED)
+        err_output ("accept: %s", strerror (errno));
+      return;
+    }
+
+  if (fd_set_nonblocking (fd) < 0
+      || fd_set_close_on_exec (fd) < 0)
+    {
+      err_output ("fcntl: %s", strerror (errno));
+      close (fd);
+      return;
+    }
+
+  if (!(c = (struct ipmisessiond_client *)malloc (sizeof (struct ipmisessiond_client))))
+    {
+      err_output ("malloc: %s", strerror (errno));
+      close (fd);
+      return;
+    }
+  memset (c, '\0', sizeof (struct ipmisessiond_client));
+  c->fd = fd;
+  c->state = IPMISESSIOND_CLIENT_READ;
+
+  if (!list_append (clients, c))
+    err_exit ("list_append: %s", strerror (errno));
+}
+
+static void
+_server_setup (void)
+{
+  struct sockaddr_un addr;
+  struct stat st;
+
+  if (strlen (socket_path) >= sizeof (addr.sun_path))
+    err_exit ("socket path too long: %s", socket_path);
+
+  /* remove a socket left over by a previous instance */
+  if (!lstat (socket_path, &st))
+    {
+      if (!S_ISSOCK (st.st_mode))
+        err_exit ("%s exists and is not a socket", socket_path);
+      if (unlink (socket_path) < 0)
+        err_exit ("unlink: %s", strerror (errno));
+    }
+
+  if ((server_fd = socket (AF_UNIX, SOCK_STREAM, 0)) < 0)
+    err_exit ("socket: %s", strerror (errno));
+
+  if (fd_set_close_on_exec (server_fd) < 0)
+    err_exit ("fd_set_close_on_exec: %s", strerror (errno));
+
+  memset (&addr, '\0', sizeof (struct sockaddr_un));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, socket_path);
+
+  /* credentials pass through the socket, only the owner may connect */
+  umask (077);
+
+  if (bind (server_fd, (struct sockaddr *)&addr, sizeof (struct sockaddr_un)) < 0)
+    err_exit ("bind: %s", strerror (errno));
+
+  if (listen (server_fd, IPMISESSIOND_SERVER_BACKLOG) < 0)
+    err_exit ("listen: %s", strerror (errno));
+
+  /* Avoid sigpipe exiting during client writes */
+  if (signal (SIGPIPE, SIG_IGN) == SIG_ERR)
+    err_exit ("signal: %s", strerror (errno));
+}
+
+static void
+_signal_handler_callback (int sig)
+{
+  exit_flag = 0;
+}
+
+static void
+_ipmisessiond_loop (void)
+{
+  struct ipmisessiond_session *s;
+  struct pollfd *pfds = NULL;
+  unsigned int pfds_len = 0;
+  ListIterator itr;
+
+  if (!(sessions = list_create (_session_destroy)))
+    err_exit ("list_create: %s", strerror (errno));
+
+  if (!(clients = list_create (_client_destroy)))
+    err_exit ("list_create: %s", strerror (errno));
+
+  _server_setup ();
+
+  if (pipe (wakeup_fds) < 0)
+    err_exit ("pipe: %s", strerror (errno));
+
+  if (fd_set_nonblocking (wakeup_fds[0]) < 0
+      || fd_set_nonblocking (wakeup_fds[1]) < 0
+      || fd_set_close_on_exec (wakeup_fds[0]) < 0
+      || fd_set_close_on_exec (wakeup_fds[1]) < 0)
+    err_exit ("fcntl: %s", strerror (errno));
+
+  while (exit_flag)
+    {
+      struct ipmisessiond_client *c;
+      unsigned int count;
+      unsigned int i;
+      time_t now;
+      int num;
+
+      /* +2 fds for the server and wakeup fds */
+      count = list_count (clients) + 2;
+      if (count > pfds_len)
+        {
+          free (pfds);
+          if (!(pfds = (struct pollfd *)malloc (count * sizeof (struct pollfd))))
+            err_exit ("malloc: %s", strerror (errno));
+          pfds_len = count;
+        }
+
+      pfds[0].fd = server_fd;
+      pfds[0].events = POLLIN;
+      pfds[0].revents = 0;
+
+      pfds[1].fd = wakeup_fds[0];
+      pfds[1].events = POLLIN;
+      pfds[1].revents = 0;
+
+      if (!(itr = list_iterator_create (clients)))
+        err_exit ("list_iterator_create: %s", strerror (errno));
+
+      /* clients waiting on a session thread are not polled */
+      for (i = 2; (c = list_next (itr)); i++)
+        {
+          pfds[i].fd = c->fd;
+          if (c->state == IPMISESSIOND_CLIENT_READ)
+            pfds[i].events = POLLIN;
+          else if (c->state == IPMISESSIOND_CLIENT_WRITE)
+            pfds[i].events = POLLOUT;
+          else
+            pfds[i].events = 0;
+          pfds[i].revents = 0;
+        }
+
+      if ((num = poll (pfds, count, IPMISESSIOND_POLL_TIMEOUT_MS)) < 0)
+        {
+          if (errno != EINTR)
+            err_exit ("poll: %s", strerror (errno));
+          list_iterator_destroy (itr);
+          continue;
+        }
+
+      now = time (NULL);
+
+      /* drain before looking at clients, so no reply is missed */
+      if (pfds[1].revents & POLLIN)
+        _wakeup_drain ();
+
+      list_iterator_reset (itr);
+
+      for (i = 2; (c = list_next (itr)); i++)
+        _client_service (c, pfds[i].revents, now);
+
+      list_delete_all (clients, _client_done, NULL);
+
+      if (pfds[0].revents & POLLIN)
+        _client_accept ();
+
+      list_iterator_destroy (itr);
+
+      _sessions_maintain (now);
+    }
+
+  /* session threads may still be working on client requests */
+  if (!(itr = list_iterator_create (sessions)))
+    err_exit ("list_iterator_create: %s", strerror (errno));
+  while ((s = list_next (itr)))
+    _session_exit (s);
+  list_iterator_reset (itr);
+  while ((s = list_next (itr)))
+    _session_join (s);
+  list_iterator_destroy (itr);
+
+  free (pfds);
+  list_destroy (clients);
+  list_destroy (sessions);
+  /* ignore potential error, exiting */
+  close (wakeup_fds[0]);
+  close (wakeup_fds[1]);
+  close (server_fd);
+  unlink (socket_path);
+}
+
+int
+main (int argc, char **argv)
+{
+  err_init (argv[0]);
+  err_set_flags (ERROR_STDERR);
+
+  ipmi_disable_coredump ();
+
+  ipmisessiond_argp_parse (argc, argv, &cmd_args);
+
+  if (cmd_args.socket)
+    socket_path = cmd_args.socket;
+  else
+    socket_path = IPMISESSIOND_SOCKET;
+
+  if (!cmd_args.debug)
+    {
+      daemonize_common (IPMISESSIOND_PIDFILE);
+      err_set_flags (ERROR_SYSLOG);
+    }
+  else
+    err_set_flags (ERROR_STDERR);
+
+  daemon_signal_handler_setup (_signal_handler_callback);
+
+  /* Call after daemonization, since daemonization closes currently
+   * open fds
+   */
+  if (argv[0][0] == '/')
+    argv[0] = strrchr(argv[0], '/') + 1;
+  openlog (argv[0], LOG_ODELAY | LOG_PID, LOG_DAEMON);
+
+  _ipmisessiond_loop ();
+
+  return (0);
+}
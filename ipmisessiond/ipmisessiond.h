@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMISESSIOND_H
+#define IPMISESSIOND_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#define IPMISESSIOND_IDLE_TIMEOUT_DEFAULT       300
+
+#define IPMISESSIOND_KEEPALIVE_INTERVAL_DEFAULT 30
+
+enum ipmisessiond_argp_option_keys
+  {
+    IPMISESSIOND_DEBUG_KEY = 'd',
+    IPMISESSIOND_SOCKET_KEY = 's',
+    IPMISESSIOND_IDLE_TIMEOUT_KEY = 'i',
+    IPMISESSIOND_KEEPALIVE_INTERVAL_KEY = 'k',
+  };
+
+struct ipmisessiond_arguments
+{
+  int debug;
+  char *socket;
+  unsigned int idle_timeout;
+  unsigned int keepalive_interval;
+};
+
+#endif /* IPMISESSIOND_H */
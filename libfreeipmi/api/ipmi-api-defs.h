@@ -48,10 +48,13 @@
 #include "freeipmi/driver/ipmi-openipmi-driver.h"
 #include "freeipmi/driver/ipmi-ssif-driver.h"
 #include "freeipmi/driver/ipmi-sunbmc-driver.h"
+#include "freeipmi/interface/ipmi-rmcpplus-interface.h"
 #include "freeipmi/locate/ipmi-locate.h"
 
 #include "freeipmi/api/ipmi-api.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
+
 #define IPMI_MAX_SIK_KEY_LENGTH                           64
 #define IPMI_MAX_INTEGRITY_KEY_LENGTH                     64
 #define IPMI_MAX_CONFIDENTIALITY_KEY_LENGTH               64
@@ -94,6 +97,9 @@ struct ipmi_ctx
 
   ipmi_errnum_type_t errnum;
 
+  /* reused request/response objects, see obj_pool_get() */
+  struct obj_pool obj_pool;
+
   union
   {
     struct
@@ -121,6 +127,15 @@ struct ipmi_ctx
     {
       int sockfd;
 
+      /* set if ipmisessiond owns the session */
+      int brokered;
+      /* connection to ipmisessiond, -1 if none or dropped */
+      int broker_fd;
+      uint32_t broker_seq;
+
+      /* set while registered with an ipmi_multi_ctx */
+      void *multi_entry;
+
       char hostname[MAXHOSTNAMELEN+1];
 
       struct sockaddr *remote_host;
@@ -182,6 +197,8 @@ struct ipmi_ctx
       uint8_t confidentiality_key[IPMI_MAX_CONFIDENTIALITY_KEY_LENGTH];
       void *confidentiality_key_ptr;
       unsigned int confidentiality_key_len;
+      /* keyed crypt handles, kept for the life of the session */
+      ipmi_rmcpplus_crypt_cache_t crypt_cache;
 
       struct
       {
@@ -80,7 +80,9 @@
 #include "ipmi-lan-interface-api.h"
 #include "ipmi-lan-session-common.h"
 #include "ipmi-kcs-driver-api.h"
+#include "ipmi-multi-api-util.h"
 #include "ipmi-openipmi-driver-api.h"
+#include "ipmi-session-broker-api.h"
 #include "ipmi-sunbmc-driver-api.h"
 #include "ipmi-ssif-driver-api.h"
 
@@ -146,6 +148,7 @@ _ipmi_ctx_init (struct ipmi_ctx *ctx)
   memset (ctx, '\0', sizeof (struct ipmi_ctx));
   ctx->magic = IPMI_CTX_MAGIC;
   ctx->type = IPMI_DEVICE_UNKNOWN;
+  ctx->io.outofband.broker_fd = -1;
 }
 
 ipmi_ctx_t
@@ -219,7 +222,8 @@ ipmi_ctx_set_flags (ipmi_ctx_t ctx, unsigned int flags)
                              | IPMI_FLAGS_DEBUG_DUMP
                              | IPMI_FLAGS_NO_VALID_CHECK
                              | IPMI_FLAGS_NO_LEGAL_CHECK
-                             | IPMI_FLAGS_IGNORE_AUTHENTICATION_CODE);
+                             | IPMI_FLAGS_IGNORE_AUTHENTICATION_CODE
+                             | IPMI_FLAGS_NO_SESSION_BROKER);
 
   if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
     {
@@ -238,7 +242,7 @@ ipmi_ctx_set_flags (ipmi_ctx_t ctx, unsigned int flags)
    */
   if (ctx->type != IPMI_DEVICE_UNKNOWN)
     {
-      flags_mask = IPMI_FLAGS_NOSESSION;
+      flags_mask = (IPMI_FLAGS_NOSESSION | IPMI_FLAGS_NO_SESSION_BROKER);
 
       if ((ctx->flags & flags_mask) != (flags & flags_mask))
         {
@@ -252,6 +256,26 @@ ipmi_ctx_set_flags (ipmi_ctx_t ctx, unsigned int flags)
   return (0);
 }
 
+int
+ipmi_ctx_get_allocations_avoided (ipmi_ctx_t ctx, uint64_t *allocations_avoided)
+{
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!allocations_avoided)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  (*allocations_avoided) = ctx->obj_pool.allocations_avoided;
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
 static void
 _ipmi_outofband_free (ipmi_ctx_t ctx)
 {
@@ -284,6 +308,9 @@ _ipmi_outofband_free (ipmi_ctx_t ctx)
   ctx->io.outofband.rs.obj_lan_msg_trlr = NULL;
   fiid_obj_destroy (ctx->io.outofband.rs.obj_rmcpplus_session_trlr);
   ctx->io.outofband.rs.obj_rmcpplus_session_trlr = NULL;
+
+  ipmi_rmcpplus_crypt_cache_destroy (ctx->io.outofband.crypt_cache);
+  ctx->io.outofband.crypt_cache = NULL;
 }
 
 static void
@@ -633,7 +660,9 @@ ipmi_ctx_open_outofband_2_0 (ipmi_ctx_t ctx,
                                         | IPMI_WORKAROUND_FLAGS_OUTOFBAND_2_0_NO_CHECKSUM_CHECK);
   unsigned int flags_mask = (IPMI_FLAGS_DEBUG_DUMP
                              | IPMI_FLAGS_NO_VALID_CHECK
-                             | IPMI_FLAGS_NO_LEGAL_CHECK);
+                             | IPMI_FLAGS_NO_LEGAL_CHECK
+                             | IPMI_FLAGS_NO_SESSION_BROKER);
+  int ret;
 
   if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
     {
@@ -810,6 +839,21 @@ ipmi_ctx_open_outofband_2_0 (ipmi_ctx_t ctx,
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
+  if (!(ctx->io.outofband.crypt_cache = ipmi_rmcpplus_crypt_cache_create ()))
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  /* errnum set in api_session_broker_open */
+  if ((ret = api_session_broker_open (ctx, hostname, k_g, k_g_len)) < 0)
+    goto cleanup;
+
+  if (ret)
+    {
+      ctx->errnum = IPMI_ERR_SUCCESS;
+      return (0);
+    }
 
   if (_setup_socket (ctx) < 0)
     goto cleanup;
@@ -1888,6 +1932,103 @@ ipmi_cmd_ipmb (ipmi_ctx_t ctx,
   return (rv);
 }
 
+int
+ipmi_cmd_multi (ipmi_ctx_t ctx,
+                uint8_t lun,
+                uint8_t net_fn,
+                fiid_obj_t *obj_cmd_rq,
+                fiid_obj_t *obj_cmd_rs,
+                unsigned int count)
+{
+  fiid_field_t *tmpl_cmd_rs = NULL;
+  unsigned int i;
+  int rv = -1;
+
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_ctx_errormsg (ctx), ipmi_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!obj_cmd_rq
+      || !obj_cmd_rs
+      || !count
+      || count > IPMI_CMD_MULTI_MAX)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  /* Only IPMI 2.0 sessions talking directly to the BMC can have
+   * more than one request outstanding, everything else goes one at
+   * a time.
+   */
+  if (ctx->type != IPMI_DEVICE_LAN_2_0
+      || ctx->io.outofband.brokered
+      || (ctx->flags & IPMI_FLAGS_NOSESSION)
+      || (ctx->target.channel_number_is_set
+          && ctx->target.rs_addr_is_set)
+      || count == 1)
+    {
+      for (i = 0; i < count; i++)
+        {
+          if (ipmi_cmd (ctx, lun, net_fn, obj_cmd_rq[i], obj_cmd_rs[i]) < 0)
+            return (-1);
+        }
+      return (0);
+    }
+
+  if (!fiid_obj_valid (obj_cmd_rs[0]))
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!(tmpl_cmd_rs = fiid_obj_template (obj_cmd_rs[0])))
+    {
+      API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rs[0]);
+      goto cleanup;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      if (!fiid_obj_valid (obj_cmd_rq[i])
+          || !fiid_obj_valid (obj_cmd_rs[i]))
+        {
+          API_SET_ERRNUM (ctx, IPMI_ERR_PARAMETERS);
+          goto cleanup;
+        }
+
+      if (FIID_OBJ_PACKET_VALID (obj_cmd_rq[i]) < 0)
+        {
+          API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq[i]);
+          goto cleanup;
+        }
+
+      if (FIID_OBJ_TEMPLATE_COMPARE (obj_cmd_rs[i], tmpl_cmd_rs) < 0)
+        {
+          API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rs[i]);
+          goto cleanup;
+        }
+    }
+
+  ctx->target.lun = lun;
+  ctx->target.net_fn = net_fn;
+
+  /* errnum set in api_lan_2_0_cmd_multi on error */
+  if (api_lan_2_0_cmd_multi (ctx,
+                             obj_cmd_rq,
+                             obj_cmd_rs,
+                             count) < 0)
+    goto cleanup;
+
+  ctx->errnum = IPMI_ERR_SUCCESS;
+  rv = 0;
+ cleanup:
+  fiid_template_free (tmpl_cmd_rs);
+  return (rv);
+}
+
 int
 ipmi_cmd_raw (ipmi_ctx_t ctx,
               uint8_t lun,
@@ -2192,6 +2333,24 @@ _ipmi_outofband_2_0_close (ipmi_ctx_t ctx)
           && ctx->magic == IPMI_CTX_MAGIC
           && ctx->type == IPMI_DEVICE_LAN_2_0);
 
+  /* the daemon keeps the session, only drop our connection to it */
+  if (ctx->io.outofband.brokered)
+    {
+      api_session_broker_close (ctx);
+      _ipmi_outofband_free (ctx);
+      return;
+    }
+
+  /* A socket shared through an ipmi_multi_ctx must not be closed
+   * below, get one of our own back first.
+   */
+  if (ctx->io.outofband.multi_entry)
+    api_multi_ctx_detach (ctx);
+
+  /* not even our own socket could be had */
+  if (!ctx->io.outofband.sockfd)
+    goto cleanup;
+
   /* No need to set errnum - if the anything in close session
    * fails, session will eventually timeout anyways
    */
@@ -2280,6 +2439,8 @@ ipmi_ctx_destroy (ipmi_ctx_t ctx)
   if (ctx->type != IPMI_DEVICE_UNKNOWN)
     ipmi_ctx_close (ctx);
 
+  obj_pool_destroy (&ctx->obj_pool);
+
   /* secure_memset b/c ctx contains ipmi password */
   secure_memset (ctx, '\0', sizeof (struct ipmi_ctx));
   free (ctx);
@@ -135,7 +135,7 @@ ipmi_cmd_read_fru_data (ipmi_ctx_t ctx,
       return (-1);
     }
 
-  if (!(obj_cmd_rq = fiid_obj_create (tmpl_cmd_read_fru_data_rq)))
+  if (!(obj_cmd_rq = obj_pool_get (&ctx->obj_pool, tmpl_cmd_read_fru_data_rq)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -162,7 +162,7 @@ ipmi_cmd_read_fru_data (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_cmd_rq);
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rq);
   return (rv);
 }
 
@@ -418,17 +418,17 @@ _api_kcs_ipmb_send (ipmi_ctx_t ctx,
           && fiid_obj_valid (obj_cmd_rq)
           && fiid_obj_packet_valid (obj_cmd_rq) == 1);
 
-  if (!(obj_ipmb_msg_hdr_rq = fiid_obj_create (tmpl_ipmb_msg_hdr_rq)))
+  if (!(obj_ipmb_msg_hdr_rq = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg_hdr_rq)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
-  if (!(obj_ipmb_msg_rq = fiid_obj_create (tmpl_ipmb_msg)))
+  if (!(obj_ipmb_msg_rq = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
-  if (!(obj_send_cmd_rs = fiid_obj_create (tmpl_cmd_send_message_rs)))
+  if (!(obj_send_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_send_message_rs)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -494,9 +494,9 @@ _api_kcs_ipmb_send (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_ipmb_msg_hdr_rq);
-  fiid_obj_destroy (obj_ipmb_msg_rq);
-  fiid_obj_destroy (obj_send_cmd_rs);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_hdr_rq);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_rq);
+  obj_pool_put (&ctx->obj_pool, obj_send_cmd_rs);
   return (rv);
 }
 
@@ -523,12 +523,12 @@ _api_kcs_ipmb_recv (ipmi_ctx_t ctx,
   if (ctx->flags & IPMI_FLAGS_NO_LEGAL_CHECK)
     intf_flags |= IPMI_INTERFACE_FLAGS_NO_LEGAL_CHECK;
 
-  if (!(obj_ipmb_msg_rs = fiid_obj_create (tmpl_ipmb_msg)))
+  if (!(obj_ipmb_msg_rs = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
-  if (!(obj_get_cmd_rs = fiid_obj_create (tmpl_cmd_get_message_rs)))
+  if (!(obj_get_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_message_rs)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -582,8 +582,8 @@ _api_kcs_ipmb_recv (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_ipmb_msg_rs);
-  fiid_obj_destroy (obj_get_cmd_rs);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_rs);
+  obj_pool_put (&ctx->obj_pool, obj_get_cmd_rs);
   return (rv);
 }
 
@@ -605,12 +605,12 @@ api_kcs_cmd_ipmb (ipmi_ctx_t ctx,
           && fiid_obj_packet_valid (obj_cmd_rq) == 1
           && fiid_obj_valid (obj_cmd_rs));
 
-  if (!(obj_ipmb_msg_hdr_rs = fiid_obj_create (tmpl_ipmb_msg_hdr_rs)))
+  if (!(obj_ipmb_msg_hdr_rs = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg_hdr_rs)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
-  if (!(obj_ipmb_msg_trlr = fiid_obj_create (tmpl_ipmb_msg_trlr)))
+  if (!(obj_ipmb_msg_trlr = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg_trlr)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -696,8 +696,8 @@ api_kcs_cmd_ipmb (ipmi_ctx_t ctx,
   rv = 0;
  cleanup:
   ctx->io.inband.rq_seq = ((ctx->io.inband.rq_seq) + 1) % (IPMI_IPMB_REQUESTER_SEQUENCE_NUMBER_MAX + 1);
-  fiid_obj_destroy (obj_ipmb_msg_hdr_rs);
-  fiid_obj_destroy (obj_ipmb_msg_trlr);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_hdr_rs);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_trlr);
   fiid_template_free (ctx->tmpl_ipmb_cmd_rq);
   ctx->tmpl_ipmb_cmd_rq = NULL;
   fiid_template_free (ctx->tmpl_ipmb_cmd_rs);
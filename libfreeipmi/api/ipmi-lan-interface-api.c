@@ -41,6 +41,7 @@
 #include "ipmi-api-trace.h"
 #include "ipmi-api-util.h"
 #include "ipmi-lan-session-common.h"
+#include "ipmi-session-broker-api.h"
 
 #include "libcommon/ipmi-fiid-util.h"
 
@@ -258,11 +259,14 @@ api_lan_2_0_cmd (ipmi_ctx_t ctx,
   assert (ctx
           && ctx->magic == IPMI_CTX_MAGIC
           && ctx->type == IPMI_DEVICE_LAN_2_0
-          && ctx->io.outofband.sockfd
+          && (ctx->io.outofband.sockfd || ctx->io.outofband.brokered)
           && fiid_obj_valid (obj_cmd_rq)
           && fiid_obj_packet_valid (obj_cmd_rq) == 1
           && fiid_obj_valid (obj_cmd_rs));
 
+  if (ctx->io.outofband.brokered)
+    return (api_session_broker_cmd (ctx, obj_cmd_rq, obj_cmd_rs));
+
   api_lan_2_0_cmd_get_session_parameters (ctx,
                                           &payload_authenticated,
                                           &payload_encrypted);
@@ -291,6 +295,28 @@ api_lan_2_0_cmd (ipmi_ctx_t ctx,
                                    obj_cmd_rs));
 }
 
+int
+api_lan_2_0_cmd_multi (ipmi_ctx_t ctx,
+                       fiid_obj_t *obj_cmd_rq,
+                       fiid_obj_t *obj_cmd_rs,
+                       unsigned int count)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.sockfd
+          && obj_cmd_rq
+          && obj_cmd_rs
+          && count);
+
+  return (api_lan_2_0_cmd_wrapper_multi (ctx,
+                                         ctx->target.lun,
+                                         ctx->target.net_fn,
+                                         obj_cmd_rq,
+                                         obj_cmd_rs,
+                                         count));
+}
+
 int
 api_lan_2_0_cmd_ipmb (ipmi_ctx_t ctx,
                       fiid_obj_t obj_cmd_rq,
@@ -299,11 +325,15 @@ api_lan_2_0_cmd_ipmb (ipmi_ctx_t ctx,
   assert (ctx
           && ctx->magic == IPMI_CTX_MAGIC
           && ctx->type == IPMI_DEVICE_LAN_2_0
-          && ctx->io.outofband.sockfd
+          && (ctx->io.outofband.sockfd || ctx->io.outofband.brokered)
           && fiid_obj_valid (obj_cmd_rq)
           && fiid_obj_packet_valid (obj_cmd_rq) == 1
           && fiid_obj_valid (obj_cmd_rs));
 
+  /* the daemon does the bridging, target travels with the request */
+  if (ctx->io.outofband.brokered)
+    return (api_session_broker_cmd (ctx, obj_cmd_rq, obj_cmd_rs));
+
   return (api_lan_2_0_cmd_wrapper_ipmb (ctx,
                                         obj_cmd_rq,
                                         obj_cmd_rs));
@@ -323,7 +353,7 @@ api_lan_2_0_cmd_raw (ipmi_ctx_t ctx,
   assert (ctx
           && ctx->magic == IPMI_CTX_MAGIC
           && ctx->type == IPMI_DEVICE_LAN_2_0
-          && ctx->io.outofband.sockfd
+          && (ctx->io.outofband.sockfd || ctx->io.outofband.brokered)
           && buf_rq
           && buf_rq_len
           && buf_rs
@@ -382,7 +412,7 @@ api_lan_2_0_cmd_raw_ipmb (ipmi_ctx_t ctx,
   assert (ctx
           && ctx->magic == IPMI_CTX_MAGIC
           && ctx->type == IPMI_DEVICE_LAN_2_0
-          && ctx->io.outofband.sockfd
+          && (ctx->io.outofband.sockfd || ctx->io.outofband.brokered)
           && buf_rq
           && buf_rq_len
           && buf_rs
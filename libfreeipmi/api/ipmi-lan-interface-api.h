@@ -47,6 +47,11 @@ int api_lan_2_0_cmd (ipmi_ctx_t ctx,
                      fiid_obj_t obj_cmd_rq,
                      fiid_obj_t obj_cmd_rs);
 
+int api_lan_2_0_cmd_multi (ipmi_ctx_t ctx,
+                           fiid_obj_t *obj_cmd_rq,
+                           fiid_obj_t *obj_cmd_rs,
+                           unsigned int count);
+
 int api_lan_2_0_cmd_ipmb (ipmi_ctx_t ctx,
                           fiid_obj_t obj_cmd_rq,
                           fiid_obj_t obj_cmd_rs);
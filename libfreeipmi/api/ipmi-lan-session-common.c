@@ -86,6 +86,27 @@ struct socket_to_close {
 
 #define IPMI_PKT_PAD 1024
 
+int
+api_lan_gettime (struct timeval *tv)
+{
+  assert (tv);
+
+#if defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_MONOTONIC)
+  {
+    struct timespec ts;
+
+    if (clock_gettime (CLOCK_MONOTONIC, &ts) < 0)
+      return (-1);
+
+    tv->tv_sec = ts.tv_sec;
+    tv->tv_usec = ts.tv_nsec / 1000;
+    return (0);
+  }
+#else /* !(defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_MONOTONIC)) */
+  return (gettimeofday (tv, NULL));
+#endif /* !(defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_MONOTONIC)) */
+}
+
 void
 api_lan_cmd_get_session_parameters (ipmi_ctx_t ctx,
                                     uint8_t *authentication_type,
@@ -148,7 +169,7 @@ _session_timed_out (ipmi_ctx_t ctx)
   session_timeout_len.tv_usec = (ctx->io.outofband.session_timeout - (session_timeout_len.tv_sec * 1000)) * 1000;
   timeradd (&(ctx->io.outofband.last_received), &session_timeout_len, &session_timeout);
 
-  if (gettimeofday (&current, NULL) < 0)
+  if (api_lan_gettime (&current) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       return (-1);
@@ -181,7 +202,7 @@ _calculate_timeout (ipmi_ctx_t ctx,
           && recv_starttime
           && timeout);
 
-  if (gettimeofday (&current, NULL) < 0)
+  if (api_lan_gettime (&current) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       return (-1);
@@ -582,7 +603,7 @@ _api_lan_cmd_send (ipmi_ctx_t ctx,
       goto cleanup;
     }
 
-  if (gettimeofday (&ctx->io.outofband.last_send, NULL) < 0)
+  if (api_lan_gettime (&ctx->io.outofband.last_send) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -612,7 +633,7 @@ _api_lan_cmd_recv (ipmi_ctx_t ctx,
           && pkt
           && pkt_len);
 
-  if (gettimeofday (&recv_starttime, NULL) < 0)
+  if (api_lan_gettime (&recv_starttime) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       return (-1);
@@ -928,7 +949,7 @@ api_lan_cmd_wrapper (ipmi_ctx_t ctx,
   if (!ctx->io.outofband.last_received.tv_sec
       && !ctx->io.outofband.last_received.tv_usec)
     {
-      if (gettimeofday (&ctx->io.outofband.last_received, NULL) < 0)
+      if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           return (-1);
@@ -1118,7 +1139,7 @@ api_lan_cmd_wrapper (ipmi_ctx_t ctx,
       if (!ret)
         continue;
 
-      if (gettimeofday (&(ctx->io.outofband.last_received), NULL) < 0)
+      if (api_lan_gettime (&(ctx->io.outofband.last_received)) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           return (-1);
@@ -1166,17 +1187,17 @@ _ipmi_cmd_send_ipmb (ipmi_ctx_t ctx,
 
   (*obj_rs_errnum) = IPMI_ERR_SUCCESS;
 
-  if (!(obj_ipmb_msg_hdr_rq = fiid_obj_create (tmpl_ipmb_msg_hdr_rq)))
+  if (!(obj_ipmb_msg_hdr_rq = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg_hdr_rq)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
-  if (!(obj_ipmb_msg_rq = fiid_obj_create (tmpl_ipmb_msg)))
+  if (!(obj_ipmb_msg_rq = obj_pool_get (&ctx->obj_pool, tmpl_ipmb_msg)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
     }
-  if (!(obj_send_cmd_rs = fiid_obj_create (tmpl_cmd_send_message_rs)))
+  if (!(obj_send_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_send_message_rs)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -1256,7 +1277,7 @@ _ipmi_cmd_send_ipmb (ipmi_ctx_t ctx,
 
  out_of_order_workaround:
   /* "pretend" a request was just sent */
-  if (gettimeofday (&ctx->io.outofband.last_send, NULL) < 0)
+  if (api_lan_gettime (&ctx->io.outofband.last_send) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -1270,9 +1291,9 @@ _ipmi_cmd_send_ipmb (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_ipmb_msg_hdr_rq);
-  fiid_obj_destroy (obj_ipmb_msg_rq);
-  fiid_obj_destroy (obj_send_cmd_rs);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_hdr_rq);
+  obj_pool_put (&ctx->obj_pool, obj_ipmb_msg_rq);
+  obj_pool_put (&ctx->obj_pool, obj_send_cmd_rs);
   return (rv);
 }
 
@@ -1512,7 +1533,7 @@ api_lan_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
       if (!ret)
         continue;
 
-      if (gettimeofday (&(ctx->io.outofband.last_received), NULL) < 0)
+      if (api_lan_gettime (&(ctx->io.outofband.last_received)) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           goto cleanup;
@@ -2346,23 +2367,24 @@ _api_lan_2_0_cmd_send (ipmi_ctx_t ctx,
       goto cleanup;
     }
 
-  if ((send_len = assemble_ipmi_rmcpplus_pkt (authentication_algorithm,
-                                              integrity_algorithm,
-                                              confidentiality_algorithm,
-                                              integrity_key,
-                                              integrity_key_len,
-                                              confidentiality_key,
-                                              confidentiality_key_len,
-                                              password,
-                                              password_len,
-                                              ctx->io.outofband.rq.obj_rmcp_hdr,
-                                              ctx->io.outofband.rq.obj_rmcpplus_session_hdr,
-                                              ctx->io.outofband.rq.obj_lan_msg_hdr,
-                                              obj_cmd_rq,
-                                              ctx->io.outofband.rq.obj_rmcpplus_session_trlr,
-                                              pkt,
-                                              pkt_len,
-                                              IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+  if ((send_len = assemble_ipmi_rmcpplus_pkt_cached (ctx->io.outofband.crypt_cache,
+                                                     authentication_algorithm,
+                                                     integrity_algorithm,
+                                                     confidentiality_algorithm,
+                                                     integrity_key,
+                                                     integrity_key_len,
+                                                     confidentiality_key,
+                                                     confidentiality_key_len,
+                                                     password,
+                                                     password_len,
+                                                     ctx->io.outofband.rq.obj_rmcp_hdr,
+                                                     ctx->io.outofband.rq.obj_rmcpplus_session_hdr,
+                                                     ctx->io.outofband.rq.obj_lan_msg_hdr,
+                                                     obj_cmd_rq,
+                                                     ctx->io.outofband.rq.obj_rmcpplus_session_trlr,
+                                                     pkt,
+                                                     pkt_len,
+                                                     IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -2400,7 +2422,7 @@ _api_lan_2_0_cmd_send (ipmi_ctx_t ctx,
       goto cleanup;
     }
 
-  if (gettimeofday (&ctx->io.outofband.last_send, NULL) < 0)
+  if (api_lan_gettime (&ctx->io.outofband.last_send) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -2438,7 +2460,7 @@ _api_lan_2_0_cmd_recv (ipmi_ctx_t ctx,
           && pkt
           && pkt_len);
 
-  if (gettimeofday (&recv_starttime, NULL) < 0)
+  if (api_lan_gettime (&recv_starttime) < 0)
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       return (-1);
@@ -2595,14 +2617,15 @@ _api_lan_2_0_cmd_wrapper_verify_packet (ipmi_ctx_t ctx,
             }
         }
 
-      if ((ret = ipmi_rmcpplus_check_packet_session_authentication_code (integrity_algorithm,
-                                                                         pkt,
-                                                                         pkt_len,
-                                                                         integrity_key,
-                                                                         integrity_key_len,
-                                                                         password,
-                                                                         password_len,
-                                                                         ctx->io.outofband.rs.obj_rmcpplus_session_trlr)) < 0)
+      if ((ret = ipmi_rmcpplus_check_packet_session_authentication_code_cached (ctx->io.outofband.crypt_cache,
+                                                                                integrity_algorithm,
+                                                                                pkt,
+                                                                                pkt_len,
+                                                                                integrity_key,
+                                                                                integrity_key_len,
+                                                                                password,
+                                                                                password_len,
+                                                                                ctx->io.outofband.rs.obj_rmcpplus_session_trlr)) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           goto cleanup;
@@ -2919,7 +2942,7 @@ api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
   if (!ctx->io.outofband.last_received.tv_sec
       && !ctx->io.outofband.last_received.tv_usec)
     {
-      if (gettimeofday (&ctx->io.outofband.last_received, NULL) < 0)
+      if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           return (-1);
@@ -3078,23 +3101,24 @@ api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
                               group_extension,
                               obj_cmd_rs);
 
-      if ((ret = unassemble_ipmi_rmcpplus_pkt (authentication_algorithm,
-                                               integrity_algorithm,
-                                               confidentiality_algorithm,
-                                               integrity_key,
-                                               integrity_key_len,
-                                               confidentiality_key,
-                                               confidentiality_key_len,
-                                               pkt,
-                                               recv_len,
-                                               ctx->io.outofband.rs.obj_rmcp_hdr,
-                                               ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
-                                               ctx->io.outofband.rs.obj_rmcpplus_payload,
-                                               ctx->io.outofband.rs.obj_lan_msg_hdr,
-                                               obj_cmd_rs,
-                                               ctx->io.outofband.rs.obj_lan_msg_trlr,
-                                               ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
-                                               intf_flags)) < 0)
+      if ((ret = unassemble_ipmi_rmcpplus_pkt_cached (ctx->io.outofband.crypt_cache,
+                                                      authentication_algorithm,
+                                                      integrity_algorithm,
+                                                      confidentiality_algorithm,
+                                                      integrity_key,
+                                                      integrity_key_len,
+                                                      confidentiality_key,
+                                                      confidentiality_key_len,
+                                                      pkt,
+                                                      recv_len,
+                                                      ctx->io.outofband.rs.obj_rmcp_hdr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_payload,
+                                                      ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                                      obj_cmd_rs,
+                                                      ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
+                                                      intf_flags)) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           return (-1);
@@ -3122,7 +3146,7 @@ api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
       if (!ret)
         continue;
 
-      if (gettimeofday (&ctx->io.outofband.last_received, NULL) < 0)
+      if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           goto cleanup;
@@ -3147,6 +3171,659 @@ api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
   return (rv);
 }
 
+/* Send every request in 'obj_cmd_rq' that has not yet been answered,
+ * each with a new session and requester sequence number.
+ */
+static int
+_api_lan_2_0_cmd_multi_send (ipmi_ctx_t ctx,
+                             uint8_t lun,
+                             uint8_t net_fn,
+                             uint8_t payload_authenticated,
+                             uint8_t payload_encrypted,
+                             const char *password,
+                             unsigned int password_len,
+                             fiid_obj_t *obj_cmd_rq,
+                             unsigned int count,
+                             const int *done,
+                             uint8_t *rq_seq,
+                             const uint8_t *cmd,
+                             const uint8_t *group_extension)
+{
+  unsigned int i;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && obj_cmd_rq
+          && count
+          && done
+          && rq_seq
+          && cmd
+          && group_extension);
+
+  for (i = 0; i < count; i++)
+    {
+      if (done[i])
+        continue;
+
+      rq_seq[i] = ctx->io.outofband.rq_seq;
+
+      if (_api_lan_2_0_cmd_send (ctx,
+                                 lun,
+                                 net_fn,
+                                 IPMI_PAYLOAD_TYPE_IPMI,
+                                 payload_authenticated,
+                                 payload_encrypted,
+                                 ctx->io.outofband.session_sequence_number,
+                                 ctx->io.outofband.managed_system_session_id,
+                                 rq_seq[i],
+                                 ctx->io.outofband.authentication_algorithm,
+                                 ctx->io.outofband.integrity_algorithm,
+                                 ctx->io.outofband.confidentiality_algorithm,
+                                 ctx->io.outofband.integrity_key_ptr,
+                                 ctx->io.outofband.integrity_key_len,
+                                 ctx->io.outofband.confidentiality_key_ptr,
+                                 ctx->io.outofband.confidentiality_key_len,
+                                 password,
+                                 password_len,
+                                 cmd[i], /* for debug dumping */
+                                 group_extension[i], /* for debug dumping */
+                                 obj_cmd_rq[i]) < 0)
+        return (-1);
+
+      /* In IPMI 2.0, session sequence numbers of 0 are special */
+      ctx->io.outofband.session_sequence_number++;
+      if (!ctx->io.outofband.session_sequence_number)
+        ctx->io.outofband.session_sequence_number++;
+      ctx->io.outofband.rq_seq = (ctx->io.outofband.rq_seq + 1) % (IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX + 1);
+    }
+
+  return (0);
+}
+
+int
+api_lan_2_0_cmd_wrapper_multi (ipmi_ctx_t ctx,
+                               uint8_t lun,
+                               uint8_t net_fn,
+                               fiid_obj_t *obj_cmd_rq,
+                               fiid_obj_t *obj_cmd_rs,
+                               unsigned int count)
+{
+  uint8_t payload_authenticated;
+  uint8_t payload_encrypted;
+  const char *password;
+  unsigned int password_len;
+  uint8_t rq_seq[IPMI_CMD_MULTI_MAX];
+  uint8_t cmd[IPMI_CMD_MULTI_MAX];             /* used for debugging */
+  uint8_t group_extension[IPMI_CMD_MULTI_MAX]; /* used for debugging */
+  int done[IPMI_CMD_MULTI_MAX];
+  uint8_t buf[IPMI_MAX_PKT_LEN];
+  uint8_t pkt[IPMI_MAX_PKT_LEN];
+  unsigned int outstanding = count;
+  unsigned int retransmission_count = 0;
+  unsigned int intf_flags = IPMI_INTERFACE_FLAGS_DEFAULT;
+  unsigned int i, j;
+  int recv_len, buf_len, ret;
+  uint64_t val;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.sockfd
+          && IPMI_BMC_LUN_VALID (lun)
+          && IPMI_NET_FN_VALID (net_fn)
+          && obj_cmd_rq
+          && obj_cmd_rs
+          && count
+          && count <= IPMI_CMD_MULTI_MAX);
+
+  memset (cmd, '\0', sizeof (cmd));
+  memset (group_extension, '\0', sizeof (group_extension));
+  memset (done, '\0', sizeof (done));
+
+  api_lan_2_0_cmd_get_session_parameters (ctx,
+                                          &payload_authenticated,
+                                          &payload_encrypted);
+
+  password = strlen (ctx->io.outofband.password) ? ctx->io.outofband.password : NULL;
+  password_len = strlen (ctx->io.outofband.password);
+
+  if (ctx->flags & IPMI_FLAGS_NO_LEGAL_CHECK)
+    intf_flags |= IPMI_INTERFACE_FLAGS_NO_LEGAL_CHECK;
+
+  if (!ctx->io.outofband.last_received.tv_sec
+      && !ctx->io.outofband.last_received.tv_usec)
+    {
+      if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      done[i] = 0;
+      cmd[i] = 0;
+      group_extension[i] = 0;
+
+      if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+        {
+          /* ignore error, continue on */
+          if (FIID_OBJ_GET (obj_cmd_rq[i],
+                            "cmd",
+                            &val) < 0)
+            API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq[i]);
+          else
+            cmd[i] = val;
+
+          if (IPMI_NET_FN_GROUP_EXTENSION (net_fn))
+            {
+              /* ignore error, continue on */
+              if (FIID_OBJ_GET (obj_cmd_rq[i],
+                                "group_extension_identification",
+                                &val) < 0)
+                API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq[i]);
+              else
+                group_extension[i] = val;
+            }
+        }
+    }
+
+  if (_api_lan_2_0_cmd_multi_send (ctx,
+                                   lun,
+                                   net_fn,
+                                   payload_authenticated,
+                                   payload_encrypted,
+                                   password,
+                                   password_len,
+                                   obj_cmd_rq,
+                                   count,
+                                   done,
+                                   rq_seq,
+                                   cmd,
+                                   group_extension) < 0)
+    return (-1);
+
+  while (outstanding)
+    {
+      if ((ret = _session_timed_out (ctx)) < 0)
+        return (-1);
+
+      if (ret)
+        {
+          API_SET_ERRNUM (ctx, IPMI_ERR_SESSION_TIMEOUT);
+          return (-1);
+        }
+
+      if ((recv_len = _api_lan_2_0_cmd_recv (ctx,
+                                             ctx->io.outofband.authentication_algorithm,
+                                             ctx->io.outofband.integrity_algorithm,
+                                             ctx->io.outofband.confidentiality_algorithm,
+                                             ctx->io.outofband.integrity_key_ptr,
+                                             ctx->io.outofband.integrity_key_len,
+                                             ctx->io.outofband.confidentiality_key_ptr,
+                                             ctx->io.outofband.confidentiality_key_len,
+                                             pkt,
+                                             IPMI_MAX_PKT_LEN,
+                                             retransmission_count)) < 0)
+        return (-1);
+
+      if (!recv_len)
+        {
+          retransmission_count++;
+
+          if (_api_lan_2_0_cmd_multi_send (ctx,
+                                           lun,
+                                           net_fn,
+                                           payload_authenticated,
+                                           payload_encrypted,
+                                           password,
+                                           password_len,
+                                           obj_cmd_rq,
+                                           count,
+                                           done,
+                                           rq_seq,
+                                           cmd,
+                                           group_extension) < 0)
+            return (-1);
+
+          continue;
+        }
+
+      /* The requester sequence number is only known after the packet
+       * is unassembled, so unassemble into the first outstanding
+       * response and move it if it belongs to another request.
+       */
+      for (i = 0; i < count; i++)
+        {
+          if (!done[i])
+            break;
+        }
+      assert (i < count);
+
+      if ((ret = unassemble_ipmi_rmcpplus_pkt_cached (ctx->io.outofband.crypt_cache,
+                                                      ctx->io.outofband.authentication_algorithm,
+                                                      ctx->io.outofband.integrity_algorithm,
+                                                      ctx->io.outofband.confidentiality_algorithm,
+                                                      ctx->io.outofband.integrity_key_ptr,
+                                                      ctx->io.outofband.integrity_key_len,
+                                                      ctx->io.outofband.confidentiality_key_ptr,
+                                                      ctx->io.outofband.confidentiality_key_len,
+                                                      pkt,
+                                                      recv_len,
+                                                      ctx->io.outofband.rs.obj_rmcp_hdr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_payload,
+                                                      ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                                      obj_cmd_rs[i],
+                                                      ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
+                                                      intf_flags)) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      if (!ret)
+        continue;
+
+      if (FIID_OBJ_GET (ctx->io.outofband.rs.obj_lan_msg_hdr,
+                        "rq_seq",
+                        &val) < 0)
+        {
+          API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, ctx->io.outofband.rs.obj_lan_msg_hdr);
+          return (-1);
+        }
+
+      for (j = 0; j < count; j++)
+        {
+          if (!done[j] && rq_seq[j] == val)
+            break;
+        }
+
+      /* response to an earlier transmission or to someone else */
+      if (j == count)
+        continue;
+
+      if (j != i)
+        {
+          if ((buf_len = fiid_obj_get_all (obj_cmd_rs[i], buf, IPMI_MAX_PKT_LEN)) < 0)
+            {
+              API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rs[i]);
+              return (-1);
+            }
+
+          if (fiid_obj_set_all (obj_cmd_rs[j], buf, buf_len) < 0)
+            {
+              API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rs[j]);
+              return (-1);
+            }
+        }
+
+      if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+        _api_lan_2_0_dump_rs (ctx,
+                              ctx->io.outofband.authentication_algorithm,
+                              ctx->io.outofband.integrity_algorithm,
+                              ctx->io.outofband.confidentiality_algorithm,
+                              ctx->io.outofband.integrity_key_ptr,
+                              ctx->io.outofband.integrity_key_len,
+                              ctx->io.outofband.confidentiality_key_ptr,
+                              ctx->io.outofband.confidentiality_key_len,
+                              pkt,
+                              recv_len,
+                              cmd[j],
+                              net_fn,
+                              group_extension[j],
+                              obj_cmd_rs[j]);
+
+      if ((ret = _api_lan_2_0_cmd_wrapper_verify_packet (ctx,
+                                                         IPMI_PAYLOAD_TYPE_IPMI,
+                                                         NULL,
+                                                         &(ctx->io.outofband.session_sequence_number),
+                                                         ctx->io.outofband.managed_system_session_id,
+                                                         &rq_seq[j],
+                                                         ctx->io.outofband.integrity_algorithm,
+                                                         ctx->io.outofband.integrity_key_ptr,
+                                                         ctx->io.outofband.integrity_key_len,
+                                                         password,
+                                                         password_len,
+                                                         obj_cmd_rs[j],
+                                                         pkt,
+                                                         recv_len)) < 0)
+        return (-1);
+
+      if (!ret)
+        continue;
+
+      if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      done[j] = 1;
+      outstanding--;
+    }
+
+  return (0);
+}
+
+static void
+_api_lan_2_0_cmd_async_debug_info (ipmi_ctx_t ctx,
+                                   uint8_t net_fn,
+                                   fiid_obj_t obj_cmd_rq,
+                                   uint8_t *cmd,
+                                   uint8_t *group_extension)
+{
+  uint64_t val;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && fiid_obj_valid (obj_cmd_rq)
+          && cmd
+          && group_extension);
+
+  (*cmd) = 0;
+  (*group_extension) = 0;
+
+  if (!(ctx->flags & IPMI_FLAGS_DEBUG_DUMP))
+    return;
+
+  /* ignore error, continue on */
+  if (FIID_OBJ_GET (obj_cmd_rq,
+                    "cmd",
+                    &val) < 0)
+    API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+  else
+    (*cmd) = val;
+
+  if (IPMI_NET_FN_GROUP_EXTENSION (net_fn))
+    {
+      /* ignore error, continue on */
+      if (FIID_OBJ_GET (obj_cmd_rq,
+                        "group_extension_identification",
+                        &val) < 0)
+        API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+      else
+        (*group_extension) = val;
+    }
+}
+
+int
+api_lan_2_0_cmd_async_send (ipmi_ctx_t ctx,
+                            uint8_t lun,
+                            uint8_t net_fn,
+                            fiid_obj_t obj_cmd_rq,
+                            uint8_t *rq_seq)
+{
+  uint8_t payload_authenticated;
+  uint8_t payload_encrypted;
+  uint8_t cmd;
+  uint8_t group_extension;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.sockfd
+          && IPMI_BMC_LUN_VALID (lun)
+          && IPMI_NET_FN_VALID (net_fn)
+          && fiid_obj_valid (obj_cmd_rq)
+          && fiid_obj_packet_valid (obj_cmd_rq) == 1
+          && rq_seq);
+
+  api_lan_2_0_cmd_get_session_parameters (ctx,
+                                          &payload_authenticated,
+                                          &payload_encrypted);
+
+  _api_lan_2_0_cmd_async_debug_info (ctx,
+                                     net_fn,
+                                     obj_cmd_rq,
+                                     &cmd,
+                                     &group_extension);
+
+  if (!ctx->io.outofband.last_received.tv_sec
+      && !ctx->io.outofband.last_received.tv_usec)
+    {
+      if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
+        {
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+
+  (*rq_seq) = ctx->io.outofband.rq_seq;
+
+  if (_api_lan_2_0_cmd_send (ctx,
+                             lun,
+                             net_fn,
+                             IPMI_PAYLOAD_TYPE_IPMI,
+                             payload_authenticated,
+                             payload_encrypted,
+                             ctx->io.outofband.session_sequence_number,
+                             ctx->io.outofband.managed_system_session_id,
+                             (*rq_seq),
+                             ctx->io.outofband.authentication_algorithm,
+                             ctx->io.outofband.integrity_algorithm,
+                             ctx->io.outofband.confidentiality_algorithm,
+                             ctx->io.outofband.integrity_key_ptr,
+                             ctx->io.outofband.integrity_key_len,
+                             ctx->io.outofband.confidentiality_key_ptr,
+                             ctx->io.outofband.confidentiality_key_len,
+                             strlen (ctx->io.outofband.password) ? ctx->io.outofband.password : NULL,
+                             strlen (ctx->io.outofband.password),
+                             cmd,
+                             group_extension,
+                             obj_cmd_rq) < 0)
+    return (-1);
+
+  /* In IPMI 2.0, session sequence numbers of 0 are special */
+  ctx->io.outofband.session_sequence_number++;
+  if (!ctx->io.outofband.session_sequence_number)
+    ctx->io.outofband.session_sequence_number++;
+  ctx->io.outofband.rq_seq = (ctx->io.outofband.rq_seq + 1) % (IPMI_LAN_REQUESTER_SEQUENCE_NUMBER_MAX + 1);
+
+  return (0);
+}
+
+int
+api_lan_2_0_cmd_async_recv_pkt (ipmi_ctx_t ctx,
+                                uint8_t net_fn,
+                                uint8_t rq_seq,
+                                fiid_obj_t obj_cmd_rq,
+                                fiid_obj_t obj_cmd_rs,
+                                const void *pkt,
+                                unsigned int pkt_len)
+{
+  const char *password;
+  unsigned int password_len;
+  unsigned int intf_flags = IPMI_INTERFACE_FLAGS_DEFAULT;
+  uint8_t cmd;
+  uint8_t group_extension;
+  int ret;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && IPMI_NET_FN_VALID (net_fn)
+          && fiid_obj_valid (obj_cmd_rq)
+          && fiid_obj_valid (obj_cmd_rs)
+          && pkt
+          && pkt_len);
+
+  password = strlen (ctx->io.outofband.password) ? ctx->io.outofband.password : NULL;
+  password_len = strlen (ctx->io.outofband.password);
+
+  if (ctx->flags & IPMI_FLAGS_NO_LEGAL_CHECK)
+    intf_flags |= IPMI_INTERFACE_FLAGS_NO_LEGAL_CHECK;
+
+  _api_lan_2_0_cmd_async_debug_info (ctx,
+                                     net_fn,
+                                     obj_cmd_rq,
+                                     &cmd,
+                                     &group_extension);
+
+  if ((ret = unassemble_ipmi_rmcpplus_pkt_cached (ctx->io.outofband.crypt_cache,
+                                                  ctx->io.outofband.authentication_algorithm,
+                                                  ctx->io.outofband.integrity_algorithm,
+                                                  ctx->io.outofband.confidentiality_algorithm,
+                                                  ctx->io.outofband.integrity_key_ptr,
+                                                  ctx->io.outofband.integrity_key_len,
+                                                  ctx->io.outofband.confidentiality_key_ptr,
+                                                  ctx->io.outofband.confidentiality_key_len,
+                                                  pkt,
+                                                  pkt_len,
+                                                  ctx->io.outofband.rs.obj_rmcp_hdr,
+                                                  ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
+                                                  ctx->io.outofband.rs.obj_rmcpplus_payload,
+                                                  ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                                  obj_cmd_rs,
+                                                  ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                                  ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
+                                                  intf_flags)) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (!ret)
+    return (0);
+
+  if (ctx->flags & IPMI_FLAGS_DEBUG_DUMP)
+    _api_lan_2_0_dump_rs (ctx,
+                          ctx->io.outofband.authentication_algorithm,
+                          ctx->io.outofband.integrity_algorithm,
+                          ctx->io.outofband.confidentiality_algorithm,
+                          ctx->io.outofband.integrity_key_ptr,
+                          ctx->io.outofband.integrity_key_len,
+                          ctx->io.outofband.confidentiality_key_ptr,
+                          ctx->io.outofband.confidentiality_key_len,
+                          pkt,
+                          pkt_len,
+                          cmd,
+                          net_fn,
+                          group_extension,
+                          obj_cmd_rs);
+
+  /* responses to earlier transmissions fail the rq_seq check */
+  if ((ret = _api_lan_2_0_cmd_wrapper_verify_packet (ctx,
+                                                     IPMI_PAYLOAD_TYPE_IPMI,
+                                                     NULL,
+                                                     &(ctx->io.outofband.session_sequence_number),
+                                                     ctx->io.outofband.managed_system_session_id,
+                                                     &rq_seq,
+                                                     ctx->io.outofband.integrity_algorithm,
+                                                     ctx->io.outofband.integrity_key_ptr,
+                                                     ctx->io.outofband.integrity_key_len,
+                                                     password,
+                                                     password_len,
+                                                     obj_cmd_rs,
+                                                     pkt,
+                                                     pkt_len)) < 0)
+    return (-1);
+
+  if (!ret)
+    return (0);
+
+  if (api_lan_gettime (&ctx->io.outofband.last_received) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  return (1);
+}
+
+int
+api_lan_2_0_cmd_async_recv (ipmi_ctx_t ctx,
+                            uint8_t net_fn,
+                            uint8_t rq_seq,
+                            fiid_obj_t obj_cmd_rq,
+                            fiid_obj_t obj_cmd_rs)
+{
+  uint8_t pkt[IPMI_MAX_PKT_LEN];
+  int recv_len, ret;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.sockfd
+          && IPMI_NET_FN_VALID (net_fn)
+          && fiid_obj_valid (obj_cmd_rq)
+          && fiid_obj_valid (obj_cmd_rs));
+
+  /* drain the socket until our response shows up or it is empty */
+  while (1)
+    {
+      do
+        {
+          recv_len = ipmi_lan_recvfrom (ctx->io.outofband.sockfd,
+                                        pkt,
+                                        IPMI_MAX_PKT_LEN,
+                                        MSG_DONTWAIT,
+                                        NULL,
+                                        NULL);
+        } while (recv_len < 0 && errno == EINTR);
+
+      /* See _api_lan_2_0_cmd_recv() for why ECONNRESET and
+       * ECONNREFUSED are ignored.
+       */
+      if (recv_len < 0)
+        {
+          if (errno == EAGAIN
+              || errno == EWOULDBLOCK
+              || errno == ECONNRESET
+              || errno == ECONNREFUSED)
+            return (0);
+
+          API_ERRNO_TO_API_ERRNUM (ctx, errno);
+          return (-1);
+        }
+
+      if (!recv_len)
+        return (0);
+
+      if ((ret = api_lan_2_0_cmd_async_recv_pkt (ctx,
+                                                 net_fn,
+                                                 rq_seq,
+                                                 obj_cmd_rq,
+                                                 obj_cmd_rs,
+                                                 pkt,
+                                                 recv_len)) != 0)
+        return (ret);
+    }
+
+  /* NOT REACHED */
+  return (0);
+}
+
+void
+api_lan_2_0_cmd_async_deadlines (ipmi_ctx_t ctx,
+                                 unsigned int retransmission_count,
+                                 struct timeval *retransmission_deadline,
+                                 struct timeval *session_deadline)
+{
+  struct timeval len;
+  unsigned int retransmission_timeout;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && retransmission_deadline
+          && session_deadline);
+
+  /* same backoff as _calculate_timeout() */
+  retransmission_timeout = ((retransmission_count / IPMI_LAN_BACKOFF_COUNT) + 1) * ctx->io.outofband.retransmission_timeout;
+
+  len.tv_sec = retransmission_timeout / 1000;
+  len.tv_usec = (retransmission_timeout % 1000) * 1000;
+  timeradd (&ctx->io.outofband.last_send, &len, retransmission_deadline);
+
+  len.tv_sec = ctx->io.outofband.session_timeout / 1000;
+  len.tv_usec = (ctx->io.outofband.session_timeout % 1000) * 1000;
+  timeradd (&ctx->io.outofband.last_received, &len, session_deadline);
+}
+
 int
 api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
                               fiid_obj_t obj_cmd_rq,
@@ -3287,23 +3964,24 @@ api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
                               group_extension,
                               obj_cmd_rs);
 
-      if ((ret = unassemble_ipmi_rmcpplus_pkt (ctx->io.outofband.authentication_algorithm,
-                                               ctx->io.outofband.integrity_algorithm,
-                                               ctx->io.outofband.confidentiality_algorithm,
-                                               ctx->io.outofband.integrity_key_ptr,
-                                               ctx->io.outofband.integrity_key_len,
-                                               ctx->io.outofband.confidentiality_key_ptr,
-                                               ctx->io.outofband.confidentiality_key_len,
-                                               pkt,
-                                               recv_len,
-                                               ctx->io.outofband.rs.obj_rmcp_hdr,
-                                               ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
-                                               ctx->io.outofband.rs.obj_rmcpplus_payload,
-                                               ctx->io.outofband.rs.obj_lan_msg_hdr,
-                                               obj_cmd_rs,
-                                               ctx->io.outofband.rs.obj_lan_msg_trlr,
-                                               ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
-                                               intf_flags)) < 0)
+      if ((ret = unassemble_ipmi_rmcpplus_pkt_cached (ctx->io.outofband.crypt_cache,
+                                                      ctx->io.outofband.authentication_algorithm,
+                                                      ctx->io.outofband.integrity_algorithm,
+                                                      ctx->io.outofband.confidentiality_algorithm,
+                                                      ctx->io.outofband.integrity_key_ptr,
+                                                      ctx->io.outofband.integrity_key_len,
+                                                      ctx->io.outofband.confidentiality_key_ptr,
+                                                      ctx->io.outofband.confidentiality_key_len,
+                                                      pkt,
+                                                      recv_len,
+                                                      ctx->io.outofband.rs.obj_rmcp_hdr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_session_hdr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_payload,
+                                                      ctx->io.outofband.rs.obj_lan_msg_hdr,
+                                                      obj_cmd_rs,
+                                                      ctx->io.outofband.rs.obj_lan_msg_trlr,
+                                                      ctx->io.outofband.rs.obj_rmcpplus_session_trlr,
+                                                      intf_flags)) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           return (-1);
@@ -3335,7 +4013,7 @@ api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
       if (!ret)
         continue;
 
-      if (gettimeofday (&(ctx->io.outofband.last_received), NULL) < 0)
+      if (api_lan_gettime (&(ctx->io.outofband.last_received)) < 0)
         {
           API_ERRNO_TO_API_ERRNUM (ctx, errno);
           goto cleanup;
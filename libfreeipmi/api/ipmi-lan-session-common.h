@@ -20,6 +20,16 @@
 #define IPMI_LAN_SESSION_COMMON_H
 
 #include <stdint.h>
+#if TIME_WITH_SYS_TIME
+#include <sys/time.h>
+#include <time.h>
+#else /* !TIME_WITH_SYS_TIME */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#else /* !HAVE_SYS_TIME_H */
+#include <time.h>
+#endif /* !HAVE_SYS_TIME_H */
+#endif  /* !TIME_WITH_SYS_TIME */
 #include <freeipmi/api/ipmi-api.h>
 #include <freeipmi/fiid/fiid.h>
 
@@ -27,6 +37,13 @@
 #define IPMI_INTERNAL_WORKAROUND_FLAGS_CHECK_UNEXPECTED_AUTHCODE     0x00000002
 #define IPMI_INTERNAL_WORKAROUND_FLAGS_CLOSE_SESSION_SKIP_RETRANSMIT 0x00000004
 
+/* Clock for retransmission and session timeouts, last_send and
+ * last_received.  Monotonic where available, so a step of the system
+ * clock neither times out every session nor stalls them.  Returns -1
+ * with errno set on error.
+ */
+int api_lan_gettime (struct timeval *tv);
+
 void api_lan_cmd_get_session_parameters (ipmi_ctx_t ctx,
                                          uint8_t *authentication_type,
                                          unsigned int *internal_workaround_flags);
@@ -80,6 +97,49 @@ int api_lan_2_0_cmd_wrapper (ipmi_ctx_t ctx,
                              fiid_obj_t obj_cmd_rq,
                              fiid_obj_t obj_cmd_rs);
 
+/* all responses must use the same template */
+int api_lan_2_0_cmd_wrapper_multi (ipmi_ctx_t ctx,
+                                   uint8_t lun,
+                                   uint8_t net_fn,
+                                   fiid_obj_t *obj_cmd_rq,
+                                   fiid_obj_t *obj_cmd_rs,
+                                   unsigned int count);
+
+/* Non-blocking pieces of api_lan_2_0_cmd_wrapper(), driven by the
+ * ipmi_multi_ctx engine.  The caller keeps one request outstanding
+ * and decides when to retransmit.
+ *
+ * async_recv returns 1 if the response to 'rq_seq' was read into
+ * obj_cmd_rs, 0 if the socket was drained without finding it, -1 on
+ * error.  async_recv_pkt does the same for a single packet already
+ * read off a socket shared with other sessions, returning 0 if it is
+ * not the response.
+ */
+int api_lan_2_0_cmd_async_send (ipmi_ctx_t ctx,
+                                uint8_t lun,
+                                uint8_t net_fn,
+                                fiid_obj_t obj_cmd_rq,
+                                uint8_t *rq_seq);
+
+int api_lan_2_0_cmd_async_recv (ipmi_ctx_t ctx,
+                                uint8_t net_fn,
+                                uint8_t rq_seq,
+                                fiid_obj_t obj_cmd_rq,
+                                fiid_obj_t obj_cmd_rs);
+
+int api_lan_2_0_cmd_async_recv_pkt (ipmi_ctx_t ctx,
+                                    uint8_t net_fn,
+                                    uint8_t rq_seq,
+                                    fiid_obj_t obj_cmd_rq,
+                                    fiid_obj_t obj_cmd_rs,
+                                    const void *pkt,
+                                    unsigned int pkt_len);
+
+void api_lan_2_0_cmd_async_deadlines (ipmi_ctx_t ctx,
+                                      unsigned int retransmission_count,
+                                      struct timeval *retransmission_deadline,
+                                      struct timeval *session_deadline);
+
 int api_lan_2_0_cmd_wrapper_ipmb (ipmi_ctx_t ctx,
                                   fiid_obj_t obj_cmd_rq,
                                   fiid_obj_t obj_cmd_rs);
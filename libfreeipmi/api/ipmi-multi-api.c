@@ -0,0 +1,1417 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#if TIME_WITH_SYS_TIME
+#include <sys/time.h>
+#include <time.h>
+#else /* !TIME_WITH_SYS_TIME */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#else /* !HAVE_SYS_TIME_H */
+#include <time.h>
+#endif /* !HAVE_SYS_TIME_H */
+#endif  /* !TIME_WITH_SYS_TIME */
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#else /* !HAVE_SYS_EPOLL_H */
+#include <sys/poll.h>
+#endif /* !HAVE_SYS_EPOLL_H */
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/api/ipmi-api.h"
+#include "freeipmi/api/ipmi-multi-api.h"
+#include "freeipmi/fiid/fiid.h"
+#include "freeipmi/interface/ipmi-lan-interface.h"
+#include "freeipmi/spec/ipmi-authentication-type-spec.h"
+#include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
+
+#include "ipmi-api-defs.h"
+#include "ipmi-api-trace.h"
+#include "ipmi-api-util.h"
+#include "ipmi-lan-session-common.h"
+#include "ipmi-multi-api-util.h"
+
+#include "freeipmi-portability.h"
+#include "hash.h"
+
+#define IPMI_MULTI_CTX_MAGIC 0xbb34c0de
+
+/* most events handled per epoll_wait() call */
+#define IPMI_MULTI_EVENTS_MAX 64
+
+/* most packets read off a shared socket per wakeup */
+#define IPMI_MULTI_RECV_MAX 64
+
+#define IPMI_MULTI_SESSIONS_HASH_SIZE 1024
+
+/* initial size of the deadline heap */
+#define IPMI_MULTI_HEAP_SIZE 64
+
+/* RMCP header, authentication type and payload type come before the
+ * session id in an IPMI 2.0 session header.
+ */
+#define IPMI_MULTI_SESSION_ID_OFFSET 6
+
+#define MULTI_SET_ERRNUM(__mctx, __errnum)                                  \
+  do {                                                                      \
+    (__mctx)->errnum = (__errnum);                                          \
+    TRACE_MSG_OUT (ipmi_multi_ctx_errormsg ((__mctx)), __errnum);           \
+  } while (0)
+
+struct ipmi_multi_cmd
+{
+  uint8_t lun;
+  uint8_t net_fn;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+  Ipmi_Multi_Cmd_Callback callback;
+  void *callback_data;
+  struct ipmi_multi_cmd *next;
+};
+
+/* A socket is either a context's own or shared by up to
+ * contexts_per_socket contexts.  Responses on a shared socket are
+ * matched to contexts by the session id the BMC echoes back.
+ */
+struct ipmi_multi_socket
+{
+  int fd;
+  int family;
+  int shared;
+  unsigned int users;
+  /* registered contexts with a request outstanding */
+  unsigned int watchers;
+  /* owner of an unshared socket */
+  struct ipmi_multi_entry *entry;
+  struct ipmi_multi_socket *next;
+};
+
+struct ipmi_multi_entry
+{
+  struct ipmi_multi_ctx *mctx;
+  ipmi_ctx_t ctx;
+  struct ipmi_multi_socket *sock;
+  struct ipmi_multi_socket own_sock;
+  uint32_t session_id;
+  /* queued commands, the head is the one sent when in_flight */
+  struct ipmi_multi_cmd *head;
+  struct ipmi_multi_cmd *tail;
+  int in_flight;
+  uint8_t rq_seq;
+  unsigned int retransmission_count;
+  /* earliest retransmission or session deadline, while in_flight */
+  struct timeval deadline;
+  unsigned int heap_index;
+  /* on the ready list, i.e. has a command to send */
+  int ready;
+  struct ipmi_multi_entry *ready_prev;
+  struct ipmi_multi_entry *ready_next;
+  struct ipmi_multi_entry *prev;
+  struct ipmi_multi_entry *next;
+};
+
+struct ipmi_multi_ctx
+{
+  uint32_t magic;
+  ipmi_errnum_type_t errnum;
+#ifdef HAVE_SYS_EPOLL_H
+  int epfd;
+#else /* !HAVE_SYS_EPOLL_H */
+  struct pollfd *pfds;
+  struct ipmi_multi_socket **pfds_sockets;
+  unsigned int pfds_len;
+#endif /* !HAVE_SYS_EPOLL_H */
+  struct ipmi_multi_entry *entries;
+  unsigned int entries_count;
+  /* in flight contexts, a binary min-heap ordered by deadline */
+  struct ipmi_multi_entry **heap;
+  unsigned int heap_len;
+  unsigned int heap_size;
+  /* contexts with commands queued but none in flight */
+  struct ipmi_multi_entry *ready_head;
+  struct ipmi_multi_entry *ready_tail;
+  unsigned int pending;
+  unsigned int contexts_per_socket;
+  struct ipmi_multi_socket *sockets;
+  unsigned int sockets_count;
+  hash_t sessions;
+};
+
+ipmi_multi_ctx_t
+ipmi_multi_ctx_create (void)
+{
+  struct ipmi_multi_ctx *mctx = NULL;
+
+  if (!(mctx = (struct ipmi_multi_ctx *)malloc (sizeof (struct ipmi_multi_ctx))))
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+  memset (mctx, '\0', sizeof (struct ipmi_multi_ctx));
+  mctx->magic = IPMI_MULTI_CTX_MAGIC;
+  mctx->errnum = IPMI_ERR_SUCCESS;
+
+#ifdef HAVE_SYS_EPOLL_H
+  if ((mctx->epfd = epoll_create (IPMI_MULTI_EVENTS_MAX)) < 0)
+    {
+      ERRNO_TRACE (errno);
+      free (mctx);
+      return (NULL);
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  return (mctx);
+}
+
+int
+ipmi_multi_ctx_errnum (ipmi_multi_ctx_t mctx)
+{
+  if (!mctx)
+    return (IPMI_ERR_CTX_NULL);
+  else if (mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    return (IPMI_ERR_CTX_INVALID);
+  else
+    return (mctx->errnum);
+}
+
+char *
+ipmi_multi_ctx_errormsg (ipmi_multi_ctx_t mctx)
+{
+  return (ipmi_ctx_strerror (ipmi_multi_ctx_errnum (mctx)));
+}
+
+static unsigned int
+_multi_session_id_key (const void *key)
+{
+  assert (key);
+
+  return (*((const uint32_t *)key));
+}
+
+static int
+_multi_session_id_cmp (const void *key1, const void *key2)
+{
+  assert (key1
+          && key2);
+
+  return (*((const uint32_t *)key1) != *((const uint32_t *)key2));
+}
+
+int
+ipmi_multi_ctx_set_contexts_per_socket (ipmi_multi_ctx_t mctx, unsigned int count)
+{
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_multi_ctx_errormsg (mctx), ipmi_multi_ctx_errnum (mctx));
+      return (-1);
+    }
+
+  /* contexts already registered keep the sockets they have */
+  if (mctx->entries_count)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (count && !mctx->sessions)
+    {
+      if (!(mctx->sessions = hash_create (IPMI_MULTI_SESSIONS_HASH_SIZE,
+                                          _multi_session_id_key,
+                                          _multi_session_id_cmp,
+                                          NULL)))
+        {
+          MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+          return (-1);
+        }
+    }
+
+  mctx->contexts_per_socket = count;
+  mctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+static int
+_multi_socket_epoll (struct ipmi_multi_ctx *mctx,
+                     struct ipmi_multi_socket *sock,
+                     int op,
+                     int watch)
+{
+  struct epoll_event ev;
+
+  assert (mctx
+          && sock);
+
+  memset (&ev, '\0', sizeof (struct epoll_event));
+  ev.events = watch ? EPOLLIN : 0;
+  ev.data.ptr = sock;
+
+  if (epoll_ctl (mctx->epfd, op, sock->fd, &ev) < 0)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+      return (-1);
+    }
+
+  return (0);
+}
+#endif /* HAVE_SYS_EPOLL_H */
+
+static void
+_multi_heap_set (struct ipmi_multi_ctx *mctx,
+                 unsigned int index,
+                 struct ipmi_multi_entry *entry)
+{
+  assert (mctx
+          && index < mctx->heap_len
+          && entry);
+
+  mctx->heap[index] = entry;
+  entry->heap_index = index;
+}
+
+static void
+_multi_heap_up (struct ipmi_multi_ctx *mctx, unsigned int index)
+{
+  struct ipmi_multi_entry *entry;
+  unsigned int parent;
+
+  assert (mctx
+          && index < mctx->heap_len);
+
+  entry = mctx->heap[index];
+  while (index)
+    {
+      parent = (index - 1) / 2;
+      if (!timercmp (&entry->deadline, &mctx->heap[parent]->deadline, <))
+        break;
+      _multi_heap_set (mctx, index, mctx->heap[parent]);
+      index = parent;
+    }
+  _multi_heap_set (mctx, index, entry);
+}
+
+static void
+_multi_heap_down (struct ipmi_multi_ctx *mctx, unsigned int index)
+{
+  struct ipmi_multi_entry *entry;
+  unsigned int child;
+
+  assert (mctx
+          && index < mctx->heap_len);
+
+  entry = mctx->heap[index];
+  while ((child = (index * 2) + 1) < mctx->heap_len)
+    {
+      if (child + 1 < mctx->heap_len
+          && timercmp (&mctx->heap[child + 1]->deadline, &mctx->heap[child]->deadline, <))
+        child++;
+      if (!timercmp (&mctx->heap[child]->deadline, &entry->deadline, <))
+        break;
+      _multi_heap_set (mctx, index, mctx->heap[child]);
+      index = child;
+    }
+  _multi_heap_set (mctx, index, entry);
+}
+
+/* Room for every registered context is made in ipmi_multi_ctx_add(),
+ * so this cannot fail.
+ */
+static void
+_multi_heap_insert (struct ipmi_multi_ctx *mctx, struct ipmi_multi_entry *entry)
+{
+  assert (mctx
+          && mctx->heap_len < mctx->heap_size
+          && entry);
+
+  mctx->heap_len++;
+  _multi_heap_set (mctx, mctx->heap_len - 1, entry);
+  _multi_heap_up (mctx, mctx->heap_len - 1);
+}
+
+static void
+_multi_heap_remove (struct ipmi_multi_ctx *mctx, struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_entry *last;
+  unsigned int index;
+
+  assert (mctx
+          && entry
+          && entry->heap_index < mctx->heap_len
+          && mctx->heap[entry->heap_index] == entry);
+
+  index = entry->heap_index;
+  last = mctx->heap[--mctx->heap_len];
+  if (last == entry)
+    return;
+
+  _multi_heap_set (mctx, index, last);
+  _multi_heap_up (mctx, index);
+  _multi_heap_down (mctx, last->heap_index);
+}
+
+/* Recalculate the deadline of an in flight context after a send */
+static void
+_multi_heap_update (struct ipmi_multi_entry *entry)
+{
+  struct timeval retransmission_deadline;
+  struct timeval session_deadline;
+
+  assert (entry
+          && entry->in_flight);
+
+  api_lan_2_0_cmd_async_deadlines (entry->ctx,
+                                   entry->retransmission_count,
+                                   &retransmission_deadline,
+                                   &session_deadline);
+
+  if (timercmp (&session_deadline, &retransmission_deadline, <))
+    entry->deadline = session_deadline;
+  else
+    entry->deadline = retransmission_deadline;
+
+  _multi_heap_up (entry->mctx, entry->heap_index);
+  _multi_heap_down (entry->mctx, entry->heap_index);
+}
+
+static void
+_multi_entry_ready (struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_ctx *mctx;
+
+  assert (entry);
+
+  if (entry->ready)
+    return;
+
+  mctx = entry->mctx;
+  entry->ready_next = NULL;
+  if ((entry->ready_prev = mctx->ready_tail))
+    mctx->ready_tail->ready_next = entry;
+  else
+    mctx->ready_head = entry;
+  mctx->ready_tail = entry;
+  entry->ready = 1;
+}
+
+static void
+_multi_entry_unready (struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_ctx *mctx;
+
+  assert (entry);
+
+  if (!entry->ready)
+    return;
+
+  mctx = entry->mctx;
+  if (entry->ready_prev)
+    entry->ready_prev->ready_next = entry->ready_next;
+  else
+    mctx->ready_head = entry->ready_next;
+  if (entry->ready_next)
+    entry->ready_next->ready_prev = entry->ready_prev;
+  else
+    mctx->ready_tail = entry->ready_prev;
+  entry->ready_prev = NULL;
+  entry->ready_next = NULL;
+  entry->ready = 0;
+}
+
+/* Only read a socket while a request is outstanding on it, so stale
+ * responses arriving on an idle context do not wake us up over and
+ * over.  They are drained with the next response.
+ */
+static int
+_multi_entry_watch (struct ipmi_multi_entry *entry, int watch)
+{
+  struct ipmi_multi_socket *sock;
+
+  assert (entry
+          && entry->sock
+          && entry->in_flight != watch);
+
+  sock = entry->sock;
+
+#ifdef HAVE_SYS_EPOLL_H
+  if ((watch && !sock->watchers)
+      || (!watch && sock->watchers == 1))
+    {
+      if (_multi_socket_epoll (entry->mctx, sock, EPOLL_CTL_MOD, watch) < 0)
+        return (-1);
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  if (watch)
+    sock->watchers++;
+  else
+    sock->watchers--;
+
+  entry->in_flight = watch;
+
+  if (watch)
+    {
+      _multi_heap_insert (entry->mctx, entry);
+      _multi_heap_update (entry);
+    }
+  else
+    _multi_heap_remove (entry->mctx, entry);
+
+  return (0);
+}
+
+static void
+_multi_cmd_complete (struct ipmi_multi_entry *entry, int rv)
+{
+  struct ipmi_multi_cmd *cmd;
+
+  assert (entry
+          && entry->head);
+
+  cmd = entry->head;
+  if (!(entry->head = cmd->next))
+    entry->tail = NULL;
+  entry->mctx->pending--;
+
+  if (!rv)
+    entry->ctx->errnum = IPMI_ERR_SUCCESS;
+
+  cmd->callback (entry->ctx, rv, cmd->obj_cmd_rs, cmd->callback_data);
+  free (cmd);
+
+  /* the next command is sent on the next pass */
+  if (entry->head && !entry->in_flight)
+    _multi_entry_ready (entry);
+}
+
+static void
+_multi_cmd_list_destroy (struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_cmd *cmd;
+
+  assert (entry);
+
+  while ((cmd = entry->head))
+    {
+      entry->head = cmd->next;
+      entry->mctx->pending--;
+      free (cmd);
+    }
+  entry->tail = NULL;
+}
+
+/* Get a pool socket with room for another context, creating one if
+ * necessary.
+ */
+static struct ipmi_multi_socket *
+_multi_shared_socket_get (struct ipmi_multi_ctx *mctx, ipmi_ctx_t ctx)
+{
+  struct ipmi_multi_socket *sock;
+
+  assert (mctx
+          && mctx->contexts_per_socket
+          && ctx
+          && ctx->io.outofband.srcaddr);
+
+  for (sock = mctx->sockets; sock; sock = sock->next)
+    {
+      if (sock->family == ctx->io.outofband.srcaddr->sa_family
+          && sock->users < mctx->contexts_per_socket)
+        {
+          sock->users++;
+          return (sock);
+        }
+    }
+
+  if (!(sock = (struct ipmi_multi_socket *)malloc (sizeof (struct ipmi_multi_socket))))
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+      return (NULL);
+    }
+  memset (sock, '\0', sizeof (struct ipmi_multi_socket));
+  sock->family = ctx->io.outofband.srcaddr->sa_family;
+  sock->shared = 1;
+
+  /* same ephemeral wildcard address the context bound to */
+  if ((sock->fd = socket (sock->family, SOCK_DGRAM, 0)) < 0)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+      free (sock);
+      return (NULL);
+    }
+
+  if (bind (sock->fd,
+            ctx->io.outofband.srcaddr,
+            ctx->io.outofband.srcaddr_len) < 0)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+      goto cleanup;
+    }
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (_multi_socket_epoll (mctx, sock, EPOLL_CTL_ADD, 0) < 0)
+    goto cleanup;
+#endif /* HAVE_SYS_EPOLL_H */
+
+  sock->users = 1;
+  sock->next = mctx->sockets;
+  mctx->sockets = sock;
+  mctx->sockets_count++;
+  return (sock);
+
+ cleanup:
+  /* ignore potential error, cleanup path */
+  close (sock->fd);
+  free (sock);
+  return (NULL);
+}
+
+static void
+_multi_shared_socket_put (struct ipmi_multi_ctx *mctx, struct ipmi_multi_socket *sock)
+{
+  struct ipmi_multi_socket **sockp;
+
+  assert (mctx
+          && sock
+          && sock->shared
+          && sock->users);
+
+  if (--sock->users)
+    return;
+
+  for (sockp = &mctx->sockets; *sockp != sock; sockp = &(*sockp)->next)
+    assert (*sockp);
+  *sockp = sock->next;
+  mctx->sockets_count--;
+
+#ifdef HAVE_SYS_EPOLL_H
+  /* ignore potential error, destroy path */
+  epoll_ctl (mctx->epfd, EPOLL_CTL_DEL, sock->fd, NULL);
+#endif /* HAVE_SYS_EPOLL_H */
+  /* ignore potential error, destroy path */
+  close (sock->fd);
+  free (sock);
+}
+
+/* Move a context onto a shared socket.  Returns 1 if shared, 0 if
+ * the context should keep its own socket, -1 on error.
+ */
+static int
+_multi_entry_share (struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_ctx *mctx;
+  struct ipmi_multi_socket *sock;
+  ipmi_ctx_t ctx;
+
+  assert (entry);
+
+  mctx = entry->mctx;
+  ctx = entry->ctx;
+
+  assert (mctx->contexts_per_socket
+          && mctx->sessions);
+
+  entry->session_id = ctx->io.outofband.remote_console_session_id;
+
+  /* Session ids are random, but a clash would make responses
+   * ambiguous.  Such a context simply keeps its own socket.
+   */
+  if (hash_find (mctx->sessions, &entry->session_id))
+    return (0);
+
+  if (!(sock = _multi_shared_socket_get (mctx, ctx)))
+    return (-1);
+
+  if (!hash_insert (mctx->sessions, &entry->session_id, entry))
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+      _multi_shared_socket_put (mctx, sock);
+      return (-1);
+    }
+
+  /* ignore potential error, the context no longer needs it */
+  close (ctx->io.outofband.sockfd);
+  ctx->io.outofband.sockfd = sock->fd;
+  entry->sock = sock;
+  return (1);
+}
+
+/* Give a context leaving a shared socket a socket of its own again.
+ * If that fails the context is left without one and can only be
+ * closed.
+ */
+static void
+_multi_entry_unshare (struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_ctx *mctx;
+  ipmi_ctx_t ctx;
+  int fd;
+
+  assert (entry
+          && entry->sock
+          && entry->sock->shared);
+
+  mctx = entry->mctx;
+  ctx = entry->ctx;
+
+  hash_remove (mctx->sessions, &entry->session_id);
+  _multi_shared_socket_put (mctx, entry->sock);
+  entry->sock = NULL;
+  ctx->io.outofband.sockfd = 0;
+
+  if ((fd = socket (ctx->io.outofband.srcaddr->sa_family, SOCK_DGRAM, 0)) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      return;
+    }
+
+  if (bind (fd,
+            ctx->io.outofband.srcaddr,
+            ctx->io.outofband.srcaddr_len) < 0)
+    {
+      API_ERRNO_TO_API_ERRNUM (ctx, errno);
+      /* ignore potential error, error path */
+      close (fd);
+      return;
+    }
+
+  ctx->io.outofband.sockfd = fd;
+}
+
+int
+ipmi_multi_ctx_add (ipmi_multi_ctx_t mctx, ipmi_ctx_t ctx)
+{
+  struct ipmi_multi_entry *entry = NULL;
+  int ret;
+
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_multi_ctx_errormsg (mctx), ipmi_multi_ctx_errnum (mctx));
+      return (-1);
+    }
+
+  if (!ctx || ctx->magic != IPMI_CTX_MAGIC)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (ctx->type == IPMI_DEVICE_UNKNOWN)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_DEVICE_NOT_OPEN);
+      return (-1);
+    }
+
+  if (ctx->type != IPMI_DEVICE_LAN_2_0
+      || !ctx->io.outofband.sockfd
+      || ctx->io.outofband.brokered
+      || (ctx->flags & IPMI_FLAGS_NOSESSION))
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_COMMAND_INVALID_FOR_SELECTED_INTERFACE);
+      return (-1);
+    }
+
+  if (ctx->io.outofband.multi_entry)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!(entry = (struct ipmi_multi_entry *)malloc (sizeof (struct ipmi_multi_entry))))
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+  memset (entry, '\0', sizeof (struct ipmi_multi_entry));
+  entry->mctx = mctx;
+  entry->ctx = ctx;
+
+  /* every registered context may be in flight at once */
+  if (mctx->heap_size <= mctx->entries_count)
+    {
+      struct ipmi_multi_entry **heap;
+      unsigned int heap_size;
+
+      heap_size = mctx->heap_size ? mctx->heap_size * 2 : IPMI_MULTI_HEAP_SIZE;
+      if (!(heap = (struct ipmi_multi_entry **)realloc (mctx->heap, sizeof (struct ipmi_multi_entry *) * heap_size)))
+        {
+          MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+          free (entry);
+          return (-1);
+        }
+      mctx->heap = heap;
+      mctx->heap_size = heap_size;
+    }
+
+  if (mctx->contexts_per_socket)
+    {
+      if ((ret = _multi_entry_share (entry)) < 0)
+        {
+          free (entry);
+          return (-1);
+        }
+    }
+  else
+    ret = 0;
+
+  if (!ret)
+    {
+      entry->own_sock.fd = ctx->io.outofband.sockfd;
+      entry->own_sock.family = ctx->io.outofband.srcaddr->sa_family;
+      entry->own_sock.users = 1;
+      entry->own_sock.entry = entry;
+      entry->sock = &entry->own_sock;
+
+#ifdef HAVE_SYS_EPOLL_H
+      if (_multi_socket_epoll (mctx, entry->sock, EPOLL_CTL_ADD, 0) < 0)
+        {
+          free (entry);
+          return (-1);
+        }
+#endif /* HAVE_SYS_EPOLL_H */
+    }
+
+  if ((entry->next = mctx->entries))
+    mctx->entries->prev = entry;
+  mctx->entries = entry;
+  mctx->entries_count++;
+
+  ctx->io.outofband.multi_entry = entry;
+  mctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
+static void
+_multi_entry_destroy (struct ipmi_multi_entry *entry)
+{
+  struct ipmi_multi_ctx *mctx;
+
+  assert (entry);
+
+  mctx = entry->mctx;
+
+  if (entry->sock->shared)
+    {
+      /* others may still be waiting on the socket */
+      if (entry->in_flight && !--entry->sock->watchers)
+        {
+#ifdef HAVE_SYS_EPOLL_H
+          /* ignore potential error, destroy path */
+          _multi_socket_epoll (mctx, entry->sock, EPOLL_CTL_MOD, 0);
+#endif /* HAVE_SYS_EPOLL_H */
+        }
+      _multi_entry_unshare (entry);
+    }
+  else
+    {
+#ifdef HAVE_SYS_EPOLL_H
+      /* ignore potential error, destroy path */
+      epoll_ctl (mctx->epfd, EPOLL_CTL_DEL, entry->sock->fd, NULL);
+#endif /* HAVE_SYS_EPOLL_H */
+    }
+
+  if (entry->in_flight)
+    _multi_heap_remove (mctx, entry);
+  _multi_entry_unready (entry);
+
+  _multi_cmd_list_destroy (entry);
+
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    mctx->entries = entry->next;
+  if (entry->next)
+    entry->next->prev = entry->prev;
+  mctx->entries_count--;
+
+  entry->ctx->io.outofband.multi_entry = NULL;
+  free (entry);
+}
+
+void
+api_multi_ctx_detach (ipmi_ctx_t ctx)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.multi_entry);
+
+  _multi_entry_destroy (ctx->io.outofband.multi_entry);
+}
+
+int
+ipmi_multi_ctx_remove (ipmi_multi_ctx_t mctx, ipmi_ctx_t ctx)
+{
+  struct ipmi_multi_entry *entry;
+
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_multi_ctx_errormsg (mctx), ipmi_multi_ctx_errnum (mctx));
+      return (-1);
+    }
+
+  if (!ctx
+      || ctx->magic != IPMI_CTX_MAGIC
+      || ctx->type != IPMI_DEVICE_LAN_2_0
+      || !(entry = ctx->io.outofband.multi_entry)
+      || entry->mctx != mctx)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_NOT_FOUND);
+      return (-1);
+    }
+
+  _multi_entry_destroy (entry);
+  mctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_multi_cmd_submit (ipmi_multi_ctx_t mctx,
+                       ipmi_ctx_t ctx,
+                       uint8_t lun,
+                       uint8_t net_fn,
+                       fiid_obj_t obj_cmd_rq,
+                       fiid_obj_t obj_cmd_rs,
+                       Ipmi_Multi_Cmd_Callback callback,
+                       void *callback_data)
+{
+  struct ipmi_multi_entry *entry;
+  struct ipmi_multi_cmd *cmd;
+
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_multi_ctx_errormsg (mctx), ipmi_multi_ctx_errnum (mctx));
+      return (-1);
+    }
+
+  if (!ctx
+      || ctx->magic != IPMI_CTX_MAGIC
+      || ctx->type != IPMI_DEVICE_LAN_2_0
+      || !(entry = ctx->io.outofband.multi_entry)
+      || entry->mctx != mctx)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_NOT_FOUND);
+      return (-1);
+    }
+
+  if (!IPMI_BMC_LUN_VALID (lun)
+      || !IPMI_NET_FN_RQ_VALID (net_fn)
+      || !fiid_obj_valid (obj_cmd_rq)
+      || !fiid_obj_valid (obj_cmd_rs)
+      || !callback)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (fiid_obj_packet_valid (obj_cmd_rq) != 1)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (ctx->target.channel_number_is_set
+      && ctx->target.rs_addr_is_set)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_COMMAND_INVALID_FOR_SELECTED_INTERFACE);
+      return (-1);
+    }
+
+  if (!(cmd = (struct ipmi_multi_cmd *)malloc (sizeof (struct ipmi_multi_cmd))))
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+  cmd->lun = lun;
+  cmd->net_fn = net_fn;
+  cmd->obj_cmd_rq = obj_cmd_rq;
+  cmd->obj_cmd_rs = obj_cmd_rs;
+  cmd->callback = callback;
+  cmd->callback_data = callback_data;
+  cmd->next = NULL;
+
+  if (entry->tail)
+    entry->tail->next = cmd;
+  else
+    entry->head = cmd;
+  entry->tail = cmd;
+  mctx->pending++;
+
+  if (!entry->in_flight)
+    _multi_entry_ready (entry);
+
+  mctx->errnum = IPMI_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_multi_ctx_pending (ipmi_multi_ctx_t mctx)
+{
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_multi_ctx_errormsg (mctx), ipmi_multi_ctx_errnum (mctx));
+      return (-1);
+    }
+
+  mctx->errnum = IPMI_ERR_SUCCESS;
+  return (mctx->pending);
+}
+
+/* Send queued requests, retransmit and time out outstanding ones.
+ * Only contexts on the ready list or due in the deadline heap are
+ * looked at.  Returns number of commands completed, -1 on error.
+ * 'next' is set to the earliest time something needs to be done
+ * again.
+ */
+static int
+_multi_ctx_timers (ipmi_multi_ctx_t mctx,
+                   const struct timeval *now,
+                   struct timeval *next,
+                   int *next_set)
+{
+  struct ipmi_multi_entry *entry;
+  struct timeval retransmission_deadline;
+  struct timeval session_deadline;
+  int completed = 0;
+
+  assert (mctx
+          && now
+          && next
+          && next_set);
+
+  (*next_set) = 0;
+
+  /* a failed send readies the context again if more is queued */
+  while ((entry = mctx->ready_head))
+    {
+      _multi_entry_unready (entry);
+
+      if (!entry->head || entry->in_flight)
+        continue;
+
+      entry->retransmission_count = 0;
+      if (api_lan_2_0_cmd_async_send (entry->ctx,
+                                      entry->head->lun,
+                                      entry->head->net_fn,
+                                      entry->head->obj_cmd_rq,
+                                      &entry->rq_seq) < 0)
+        {
+          _multi_cmd_complete (entry, -1);
+          completed++;
+          continue;
+        }
+
+      /* sent, but its response could never be seen */
+      if (_multi_entry_watch (entry, 1) < 0)
+        {
+          API_SET_ERRNUM (entry->ctx, IPMI_ERR_SYSTEM_ERROR);
+          _multi_cmd_complete (entry, -1);
+          completed++;
+        }
+    }
+
+  while (mctx->heap_len
+         && !timercmp (now, &mctx->heap[0]->deadline, <))
+    {
+      entry = mctx->heap[0];
+
+      api_lan_2_0_cmd_async_deadlines (entry->ctx,
+                                       entry->retransmission_count,
+                                       &retransmission_deadline,
+                                       &session_deadline);
+
+      if (!timercmp (now, &session_deadline, <))
+        {
+          if (_multi_entry_watch (entry, 0) < 0)
+            return (-1);
+          API_SET_ERRNUM (entry->ctx, IPMI_ERR_SESSION_TIMEOUT);
+          _multi_cmd_complete (entry, -1);
+          completed++;
+          continue;
+        }
+
+      if (!timercmp (now, &retransmission_deadline, <))
+        {
+          entry->retransmission_count++;
+          if (api_lan_2_0_cmd_async_send (entry->ctx,
+                                          entry->head->lun,
+                                          entry->head->net_fn,
+                                          entry->head->obj_cmd_rq,
+                                          &entry->rq_seq) < 0)
+            {
+              if (_multi_entry_watch (entry, 0) < 0)
+                return (-1);
+              _multi_cmd_complete (entry, -1);
+              completed++;
+              continue;
+            }
+        }
+
+      /* also moves a context whose deadline has since gone later */
+      _multi_heap_update (entry);
+    }
+
+  if (mctx->heap_len)
+    {
+      (*next) = mctx->heap[0]->deadline;
+      (*next_set) = 1;
+    }
+
+  return (completed);
+}
+
+/* Returns 1 if a command completed, 0 if not, -1 on error */
+static int
+_multi_entry_readable (struct ipmi_multi_entry *entry)
+{
+  int ret;
+
+  assert (entry);
+
+  if (!entry->in_flight)
+    return (0);
+
+  if ((ret = api_lan_2_0_cmd_async_recv (entry->ctx,
+                                         entry->head->net_fn,
+                                         entry->rq_seq,
+                                         entry->head->obj_cmd_rq,
+                                         entry->head->obj_cmd_rs)) == 0)
+    return (0);
+
+  if (_multi_entry_watch (entry, 0) < 0)
+    return (-1);
+
+  _multi_cmd_complete (entry, ret < 0 ? -1 : 0);
+  return (1);
+}
+
+/* Returns number of commands completed, -1 on error */
+static int
+_multi_socket_readable (struct ipmi_multi_ctx *mctx, struct ipmi_multi_socket *sock)
+{
+  uint8_t pkt[IPMI_MAX_PKT_LEN];
+  struct ipmi_multi_entry *entry;
+  uint32_t session_id;
+  int completed = 0;
+  int i, recv_len, ret;
+
+  assert (mctx
+          && sock);
+
+  if (!sock->shared)
+    return (_multi_entry_readable (sock->entry));
+
+  for (i = 0; i < IPMI_MULTI_RECV_MAX; i++)
+    {
+      do
+        {
+          recv_len = ipmi_lan_recvfrom (sock->fd,
+                                        pkt,
+                                        IPMI_MAX_PKT_LEN,
+                                        MSG_DONTWAIT,
+                                        NULL,
+                                        NULL);
+        } while (recv_len < 0 && errno == EINTR);
+
+      /* See _api_lan_2_0_cmd_recv() for why ECONNRESET and
+       * ECONNREFUSED are ignored.
+       */
+      if (recv_len < 0)
+        {
+          if (errno == ECONNRESET
+              || errno == ECONNREFUSED)
+            continue;
+
+          if (errno == EAGAIN
+              || errno == EWOULDBLOCK)
+            break;
+
+          MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+          return (-1);
+        }
+
+      if (recv_len < IPMI_MULTI_SESSION_ID_OFFSET + 4
+          || pkt[4] != IPMI_AUTHENTICATION_TYPE_RMCPPLUS)
+        continue;
+
+      /* session id is little endian on the wire */
+      session_id = pkt[IPMI_MULTI_SESSION_ID_OFFSET];
+      session_id |= (uint32_t)pkt[IPMI_MULTI_SESSION_ID_OFFSET + 1] << 8;
+      session_id |= (uint32_t)pkt[IPMI_MULTI_SESSION_ID_OFFSET + 2] << 16;
+      session_id |= (uint32_t)pkt[IPMI_MULTI_SESSION_ID_OFFSET + 3] << 24;
+
+      /* stale responses for idle or removed contexts are dropped */
+      if (!(entry = hash_find (mctx->sessions, &session_id))
+          || entry->sock != sock
+          || !entry->in_flight)
+        continue;
+
+      if (!(ret = api_lan_2_0_cmd_async_recv_pkt (entry->ctx,
+                                                  entry->head->net_fn,
+                                                  entry->rq_seq,
+                                                  entry->head->obj_cmd_rq,
+                                                  entry->head->obj_cmd_rs,
+                                                  pkt,
+                                                  recv_len)))
+        continue;
+
+      if (_multi_entry_watch (entry, 0) < 0)
+        return (-1);
+
+      _multi_cmd_complete (entry, ret < 0 ? -1 : 0);
+      completed++;
+    }
+
+  return (completed);
+}
+
+static int
+_multi_ctx_wait (ipmi_multi_ctx_t mctx, int timeoutms)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  struct epoll_event events[IPMI_MULTI_EVENTS_MAX];
+  int completed = 0;
+  int i, n, ret;
+
+  assert (mctx);
+
+  if ((n = epoll_wait (mctx->epfd, events, IPMI_MULTI_EVENTS_MAX, timeoutms)) < 0)
+    {
+      if (errno == EINTR)
+        return (0);
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+      return (-1);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      if ((ret = _multi_socket_readable (mctx, events[i].data.ptr)) < 0)
+        return (-1);
+      completed += ret;
+    }
+
+  return (completed);
+#else /* !HAVE_SYS_EPOLL_H */
+  struct ipmi_multi_entry *entry;
+  struct ipmi_multi_socket *sock;
+  unsigned int pfds_len;
+  unsigned int nfds = 0;
+  unsigned int i;
+  int completed = 0;
+  int n, ret;
+
+  assert (mctx);
+
+  pfds_len = mctx->entries_count + mctx->sockets_count;
+  if (mctx->pfds_len < pfds_len)
+    {
+      struct pollfd *pfds;
+      struct ipmi_multi_socket **pfds_sockets;
+
+      if (!(pfds = (struct pollfd *)realloc (mctx->pfds, sizeof (struct pollfd) * pfds_len)))
+        {
+          MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+          return (-1);
+        }
+      mctx->pfds = pfds;
+
+      if (!(pfds_sockets = (struct ipmi_multi_socket **)realloc (mctx->pfds_sockets, sizeof (struct ipmi_multi_socket *) * pfds_len)))
+        {
+          MULTI_SET_ERRNUM (mctx, IPMI_ERR_OUT_OF_MEMORY);
+          return (-1);
+        }
+      mctx->pfds_sockets = pfds_sockets;
+      mctx->pfds_len = pfds_len;
+    }
+
+  for (i = 0; i < mctx->heap_len; i++)
+    {
+      entry = mctx->heap[i];
+      if (entry->sock->shared)
+        continue;
+      mctx->pfds[nfds].fd = entry->sock->fd;
+      mctx->pfds[nfds].events = POLLIN;
+      mctx->pfds[nfds].revents = 0;
+      mctx->pfds_sockets[nfds] = entry->sock;
+      nfds++;
+    }
+
+  for (sock = mctx->sockets; sock; sock = sock->next)
+    {
+      if (!sock->watchers)
+        continue;
+      mctx->pfds[nfds].fd = sock->fd;
+      mctx->pfds[nfds].events = POLLIN;
+      mctx->pfds[nfds].revents = 0;
+      mctx->pfds_sockets[nfds] = sock;
+      nfds++;
+    }
+
+  if ((n = poll (mctx->pfds, nfds, timeoutms)) < 0)
+    {
+      if (errno == EINTR)
+        return (0);
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+      return (-1);
+    }
+
+  for (i = 0; i < nfds && n; i++)
+    {
+      if (!mctx->pfds[i].revents)
+        continue;
+      n--;
+      if ((ret = _multi_socket_readable (mctx, mctx->pfds_sockets[i])) < 0)
+        return (-1);
+      completed += ret;
+    }
+
+  return (completed);
+#endif /* !HAVE_SYS_EPOLL_H */
+}
+
+static int
+_timeval_ms_until (const struct timeval *now, const struct timeval *then)
+{
+  struct timeval diff;
+
+  assert (now
+          && then);
+
+  if (!timercmp (now, then, <))
+    return (0);
+
+  timersub (then, now, &diff);
+
+  if (diff.tv_sec >= INT_MAX / 1000)
+    return (INT_MAX);
+
+  /* round up, so we do not wake up just before the deadline */
+  return ((diff.tv_sec * 1000) + ((diff.tv_usec + 999) / 1000));
+}
+
+int
+ipmi_multi_ctx_run (ipmi_multi_ctx_t mctx, int timeout)
+{
+  struct timeval now;
+  struct timeval end;
+  struct timeval next;
+  int next_set;
+  int completed = 0;
+  int timeoutms;
+  int ret;
+
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_multi_ctx_errormsg (mctx), ipmi_multi_ctx_errnum (mctx));
+      return (-1);
+    }
+
+  if (api_lan_gettime (&now) < 0)
+    {
+      MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+      return (-1);
+    }
+
+  if (timeout >= 0)
+    {
+      struct timeval len;
+
+      len.tv_sec = timeout / 1000;
+      len.tv_usec = (timeout % 1000) * 1000;
+      timeradd (&now, &len, &end);
+    }
+
+  while (mctx->pending)
+    {
+      if ((ret = _multi_ctx_timers (mctx, &now, &next, &next_set)) < 0)
+        return (-1);
+      completed += ret;
+
+      if (completed)
+        break;
+
+      /* anything still pending is outstanding on the wire */
+      assert (next_set);
+
+      timeoutms = _timeval_ms_until (&now, &next);
+      if (timeout >= 0 && timercmp (&end, &next, <))
+        timeoutms = _timeval_ms_until (&now, &end);
+
+      if ((ret = _multi_ctx_wait (mctx, timeoutms)) < 0)
+        return (-1);
+      completed += ret;
+
+      if (completed)
+        break;
+
+      if (api_lan_gettime (&now) < 0)
+        {
+          MULTI_SET_ERRNUM (mctx, IPMI_ERR_SYSTEM_ERROR);
+          return (-1);
+        }
+
+      if (timeout >= 0 && !timercmp (&now, &end, <))
+        break;
+    }
+
+  mctx->errnum = IPMI_ERR_SUCCESS;
+  return (completed);
+}
+
+void
+ipmi_multi_ctx_destroy (ipmi_multi_ctx_t mctx)
+{
+  if (!mctx || mctx->magic != IPMI_MULTI_CTX_MAGIC)
+    return;
+
+  while (mctx->entries)
+    _multi_entry_destroy (mctx->entries);
+
+#ifdef HAVE_SYS_EPOLL_H
+  /* ignore potential error, destroy path */
+  close (mctx->epfd);
+#else /* !HAVE_SYS_EPOLL_H */
+  free (mctx->pfds);
+  free (mctx->pfds_sockets);
+#endif /* !HAVE_SYS_EPOLL_H */
+  free (mctx->heap);
+
+  /* pool sockets went away with their last context */
+  assert (!mctx->sockets);
+  if (mctx->sessions)
+    hash_destroy (mctx->sessions);
+
+  mctx->magic = ~IPMI_MULTI_CTX_MAGIC;
+  free (mctx);
+}
@@ -233,7 +233,7 @@ ipmi_cmd_get_sel_entry (ipmi_ctx_t ctx,
       return (-1);
     }
 
-  if (!(obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sel_entry_rq)))
+  if (!(obj_cmd_rq = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sel_entry_rq)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -261,7 +261,7 @@ ipmi_cmd_get_sel_entry (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_cmd_rq);
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rq);
   return (rv);
 }
 
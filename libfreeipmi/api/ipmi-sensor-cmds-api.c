@@ -1086,7 +1086,7 @@ ipmi_cmd_get_sensor_reading (ipmi_ctx_t ctx,
       return (-1);
     }
 
-  if (!(obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)))
+  if (!(obj_cmd_rq = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sensor_reading_rq)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -1111,7 +1111,7 @@ ipmi_cmd_get_sensor_reading (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_cmd_rq);
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rq);
   return (rv);
 }
 
@@ -1145,7 +1145,7 @@ ipmi_cmd_get_sensor_reading_ipmb (ipmi_ctx_t ctx,
       return (-1);
     }
 
-  if (!(obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)))
+  if (!(obj_cmd_rq = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sensor_reading_rq)))
     {
       API_ERRNO_TO_API_ERRNUM (ctx, errno);
       goto cleanup;
@@ -1172,7 +1172,7 @@ ipmi_cmd_get_sensor_reading_ipmb (ipmi_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_cmd_rq);
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rq);
   return (rv);
 }
 
@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#if TIME_WITH_SYS_TIME
+#include <sys/time.h>
+#include <time.h>
+#else /* !TIME_WITH_SYS_TIME */
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#else /* !HAVE_SYS_TIME_H */
+#include <time.h>
+#endif /* !HAVE_SYS_TIME_H */
+#endif  /* !TIME_WITH_SYS_TIME */
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/api/ipmi-api.h"
+#include "freeipmi/fiid/fiid.h"
+
+#include "ipmi-api-defs.h"
+#include "ipmi-api-trace.h"
+#include "ipmi-api-util.h"
+#include "ipmi-session-broker-api.h"
+#include "ipmi-session-broker-protocol.h"
+
+#include "freeipmi-portability.h"
+#include "fd.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif /* MSG_NOSIGNAL */
+
+static int
+_session_broker_write (int fd, const void *buf, size_t len)
+{
+  const uint8_t *p = buf;
+  size_t left = len;
+  ssize_t n;
+
+  assert (buf);
+  assert (len);
+
+  /* MSG_NOSIGNAL, a daemon going away should not kill the tool */
+  while (left)
+    {
+      if ((n = send (fd, p, left, MSG_NOSIGNAL)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return (-1);
+        }
+      left -= n;
+      p += n;
+    }
+
+  return (0);
+}
+
+static int
+_session_broker_read (int fd, void *buf, size_t len)
+{
+  ssize_t n;
+
+  assert (buf);
+  assert (len);
+
+  if ((n = fd_read_n (fd, buf, len)) < 0)
+    return (-1);
+
+  if ((size_t)n != len)
+    {
+      errno = ECONNRESET;
+      return (-1);
+    }
+
+  return (0);
+}
+
+/* After a timeout or a short read the response may still be on its
+ * way, drop the connection rather than risk reading it as the answer
+ * to the next request.
+ */
+static void
+_session_broker_drop (ipmi_ctx_t ctx)
+{
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->io.outofband.brokered
+          && ctx->io.outofband.broker_fd >= 0);
+
+  /* ignore potential error, error path */
+  close (ctx->io.outofband.broker_fd);
+  ctx->io.outofband.broker_fd = -1;
+}
+
+static void
+_session_broker_set_errnum (ipmi_ctx_t ctx, uint32_t errnum)
+{
+  assert (ctx && ctx->magic == IPMI_CTX_MAGIC);
+
+  if (errnum >= IPMI_ERR_ERRNUMRANGE)
+    API_SET_ERRNUM (ctx, IPMI_ERR_INTERNAL_ERROR);
+  else
+    API_SET_ERRNUM (ctx, errnum);
+}
+
+int
+api_session_broker_open (ipmi_ctx_t ctx,
+                         const char *hostname,
+                         const unsigned char *k_g,
+                         unsigned int k_g_len)
+{
+  struct ipmi_session_broker_open_rq rq;
+  struct ipmi_session_broker_rs rs;
+  struct sockaddr_un addr;
+  struct stat st;
+  struct timeval tv;
+  int fd = -1;
+  int rv = 0;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && hostname
+          && !ctx->io.outofband.brokered
+          && ctx->io.outofband.broker_fd < 0);
+
+  /* packets can only be dumped if we talk to the BMC ourselves */
+  if (ctx->flags & (IPMI_FLAGS_DEBUG_DUMP | IPMI_FLAGS_NO_SESSION_BROKER))
+    return (0);
+
+  if (strlen (hostname) > IPMI_SESSION_BROKER_HOSTNAME_LEN
+      || (k_g && k_g_len > IPMI_SESSION_BROKER_K_G_LEN)
+      || strlen (IPMI_SESSION_BROKER_SOCKET) >= sizeof (addr.sun_path))
+    return (0);
+
+  /* Credentials are handed to whoever listens on the socket, so only
+   * trust one created by root or by ourselves.
+   */
+  if (stat (IPMI_SESSION_BROKER_SOCKET, &st) < 0
+      || !S_ISSOCK (st.st_mode)
+      || (st.st_uid && st.st_uid != geteuid ()))
+    return (0);
+
+  if ((fd = socket (AF_UNIX, SOCK_STREAM, 0)) < 0)
+    return (0);
+
+  memset (&addr, '\0', sizeof (struct sockaddr_un));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, IPMI_SESSION_BROKER_SOCKET);
+
+  /* no daemon listening on a stale socket, do it ourselves */
+  if (connect (fd, (struct sockaddr *)&addr, sizeof (struct sockaddr_un)) < 0)
+    goto cleanup;
+
+  /* The daemon may have to re-establish the session before
+   * answering, give it twice the session timeout.
+   */
+  tv.tv_sec = (ctx->io.outofband.session_timeout * 2) / 1000;
+  tv.tv_usec = ((ctx->io.outofband.session_timeout * 2) % 1000) * 1000;
+  if (setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof (struct timeval)) < 0)
+    goto cleanup;
+
+  memset (&rq, '\0', sizeof (struct ipmi_session_broker_open_rq));
+  rq.hdr.version = IPMI_SESSION_BROKER_PROTOCOL_VERSION;
+  rq.hdr.msg_type = IPMI_SESSION_BROKER_MSG_OPEN;
+  rq.hdr.seq = 0;
+  strcpy (rq.hostname, hostname);
+  strcpy (rq.username, ctx->io.outofband.username);
+  strcpy (rq.password, ctx->io.outofband.password);
+  if (k_g && k_g_len)
+    {
+      memcpy (rq.k_g, k_g, k_g_len);
+      rq.k_g_len = k_g_len;
+    }
+  rq.privilege_level = ctx->io.outofband.privilege_level;
+  rq.cipher_suite_id = ctx->io.outofband.cipher_suite_id;
+  rq.session_timeout = ctx->io.outofband.session_timeout;
+  rq.retransmission_timeout = ctx->io.outofband.retransmission_timeout;
+  rq.workaround_flags = ctx->workaround_flags_outofband_2_0;
+  rq.flags = ctx->flags & (IPMI_FLAGS_NO_VALID_CHECK | IPMI_FLAGS_NO_LEGAL_CHECK);
+
+  /* any failure talking to the daemon, fall back to a direct session */
+  if (_session_broker_write (fd, &rq, sizeof (struct ipmi_session_broker_open_rq)) < 0)
+    goto cleanup;
+
+  if (_session_broker_read (fd, &rs, sizeof (struct ipmi_session_broker_rs)) < 0)
+    goto cleanup;
+
+  if (rs.hdr.version != IPMI_SESSION_BROKER_PROTOCOL_VERSION
+      || rs.hdr.msg_type != IPMI_SESSION_BROKER_MSG_OPEN
+      || rs.hdr.seq != rq.hdr.seq)
+    goto cleanup;
+
+  if (rs.errnum != IPMI_ERR_SUCCESS)
+    {
+      _session_broker_set_errnum (ctx, rs.errnum);
+      rv = -1;
+      goto cleanup;
+    }
+
+  ctx->io.outofband.brokered = 1;
+  ctx->io.outofband.broker_fd = fd;
+  ctx->io.outofband.broker_seq = 0;
+  fd = -1;
+  rv = 1;
+
+ cleanup:
+  memset (rq.password, '\0', IPMI_SESSION_BROKER_PASSWORD_LEN + 1);
+  memset (rq.k_g, '\0', IPMI_SESSION_BROKER_K_G_LEN);
+  /* ignore potential error, cleanup path */
+  if (fd >= 0)
+    close (fd);
+  return (rv);
+}
+
+int
+api_session_broker_cmd (ipmi_ctx_t ctx,
+                        fiid_obj_t obj_cmd_rq,
+                        fiid_obj_t obj_cmd_rs)
+{
+  struct ipmi_session_broker_cmd_rq rq;
+  struct ipmi_session_broker_rs rs;
+  int len;
+
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.brokered
+          && fiid_obj_valid (obj_cmd_rq)
+          && fiid_obj_packet_valid (obj_cmd_rq) == 1
+          && fiid_obj_valid (obj_cmd_rs));
+
+  /* like a session timeout, the context has to be reopened */
+  if (ctx->io.outofband.broker_fd < 0)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_SESSION_TIMEOUT);
+      return (-1);
+    }
+
+  memset (&rq, '\0', sizeof (struct ipmi_session_broker_cmd_rq));
+  rq.hdr.version = IPMI_SESSION_BROKER_PROTOCOL_VERSION;
+  rq.hdr.msg_type = IPMI_SESSION_BROKER_MSG_CMD;
+  rq.hdr.seq = ++ctx->io.outofband.broker_seq;
+  rq.lun = ctx->target.lun;
+  rq.net_fn = ctx->target.net_fn;
+  if (ctx->target.channel_number_is_set
+      && ctx->target.rs_addr_is_set)
+    {
+      rq.target_is_set = 1;
+      rq.channel_number = ctx->target.channel_number;
+      rq.rs_addr = ctx->target.rs_addr;
+    }
+
+  if ((len = fiid_obj_get_all (obj_cmd_rq,
+                               rq.rq,
+                               IPMI_SESSION_BROKER_PKT_LEN)) < 0)
+    {
+      API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rq);
+      return (-1);
+    }
+  rq.rq_len = len;
+
+  if (_session_broker_write (ctx->io.outofband.broker_fd,
+                             &rq,
+                             sizeof (struct ipmi_session_broker_cmd_rq)) < 0
+      || _session_broker_read (ctx->io.outofband.broker_fd,
+                               &rs,
+                               sizeof (struct ipmi_session_broker_rs)) < 0)
+    {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        API_SET_ERRNUM (ctx, IPMI_ERR_SESSION_TIMEOUT);
+      else
+        API_SET_ERRNUM (ctx, IPMI_ERR_SYSTEM_ERROR);
+      _session_broker_drop (ctx);
+      return (-1);
+    }
+
+  if (rs.hdr.version != IPMI_SESSION_BROKER_PROTOCOL_VERSION
+      || rs.hdr.msg_type != IPMI_SESSION_BROKER_MSG_CMD
+      || rs.hdr.seq != rq.hdr.seq
+      || rs.rs_len > IPMI_SESSION_BROKER_PKT_LEN)
+    {
+      API_SET_ERRNUM (ctx, IPMI_ERR_SYSTEM_ERROR);
+      _session_broker_drop (ctx);
+      return (-1);
+    }
+
+  if (rs.errnum != IPMI_ERR_SUCCESS)
+    {
+      _session_broker_set_errnum (ctx, rs.errnum);
+      return (-1);
+    }
+
+  if (fiid_obj_clear (obj_cmd_rs) < 0)
+    {
+      API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rs);
+      return (-1);
+    }
+
+  if (fiid_obj_set_all (obj_cmd_rs,
+                        rs.rs,
+                        rs.rs_len) < 0)
+    {
+      API_FIID_OBJECT_ERROR_TO_API_ERRNUM (ctx, obj_cmd_rs);
+      return (-1);
+    }
+
+  return (0);
+}
+
+void
+api_session_broker_close (ipmi_ctx_t ctx)
+{
+  /* Function Note: No need to set errnum - just return */
+  assert (ctx
+          && ctx->magic == IPMI_CTX_MAGIC
+          && ctx->type == IPMI_DEVICE_LAN_2_0
+          && ctx->io.outofband.brokered);
+
+  /* The session stays with the daemon, we just drop our reference */
+  /* ignore potential error, destroy path */
+  if (ctx->io.outofband.broker_fd >= 0)
+    close (ctx->io.outofband.broker_fd);
+  ctx->io.outofband.broker_fd = -1;
+  ctx->io.outofband.brokered = 0;
+}
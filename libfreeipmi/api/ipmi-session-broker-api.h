@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_SESSION_BROKER_API_H
+#define IPMI_SESSION_BROKER_API_H
+
+#include <stdint.h>
+#include <freeipmi/api/ipmi-api.h>
+#include <freeipmi/fiid/fiid.h>
+
+/* Returns 1 if the session is handled by ipmisessiond, 0 if no
+ * broker is available and the caller should open the session itself,
+ * -1 on error.
+ */
+int api_session_broker_open (ipmi_ctx_t ctx,
+                             const char *hostname,
+                             const unsigned char *k_g,
+                             unsigned int k_g_len);
+
+int api_session_broker_cmd (ipmi_ctx_t ctx,
+                            fiid_obj_t obj_cmd_rq,
+                            fiid_obj_t obj_cmd_rs);
+
+void api_session_broker_close (ipmi_ctx_t ctx);
+
+#endif /* IPMI_SESSION_BROKER_API_H */
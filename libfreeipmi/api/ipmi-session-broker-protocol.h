@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_SESSION_BROKER_PROTOCOL_H
+#define IPMI_SESSION_BROKER_PROTOCOL_H
+
+#include <stdint.h>
+
+/* Protocol spoken between libfreeipmi and ipmisessiond over a local
+ * UNIX stream socket.  Both ends always live on the same machine and
+ * are built from the same tree, so messages are fixed size structures
+ * in host byte order.  Bump the version whenever a structure changes.
+ *
+ * A client sends one OPEN request, after which the connection is
+ * bound to a session kept by the daemon.  Any number of CMD requests
+ * may follow, each answered by exactly one response carrying the
+ * request's sequence number.  Closing the connection releases the
+ * client's reference on the session, the session itself is kept open
+ * by the daemon until it goes idle.
+ *
+ * A client that gives up waiting for a response closes the
+ * connection, so a late response is never read as the answer to a
+ * later request.
+ */
+
+#define IPMI_SESSION_BROKER_PROTOCOL_VERSION 2
+
+#define IPMI_SESSION_BROKER_MSG_OPEN         1
+#define IPMI_SESSION_BROKER_MSG_CMD          2
+
+#define IPMI_SESSION_BROKER_HOSTNAME_LEN     256
+#define IPMI_SESSION_BROKER_USERNAME_LEN     32
+#define IPMI_SESSION_BROKER_PASSWORD_LEN     32
+#define IPMI_SESSION_BROKER_K_G_LEN          32
+#define IPMI_SESSION_BROKER_PKT_LEN          1024
+
+struct ipmi_session_broker_hdr
+{
+  uint32_t version;
+  uint32_t msg_type;
+  /* chosen by the client, echoed in the response */
+  uint32_t seq;
+};
+
+struct ipmi_session_broker_open_rq
+{
+  struct ipmi_session_broker_hdr hdr;
+  char hostname[IPMI_SESSION_BROKER_HOSTNAME_LEN + 1];
+  char username[IPMI_SESSION_BROKER_USERNAME_LEN + 1];
+  char password[IPMI_SESSION_BROKER_PASSWORD_LEN + 1];
+  uint8_t k_g[IPMI_SESSION_BROKER_K_G_LEN];
+  uint32_t k_g_len;
+  uint8_t privilege_level;
+  uint8_t cipher_suite_id;
+  uint32_t session_timeout;
+  uint32_t retransmission_timeout;
+  uint32_t workaround_flags;
+  uint32_t flags;
+};
+
+struct ipmi_session_broker_cmd_rq
+{
+  struct ipmi_session_broker_hdr hdr;
+  uint8_t lun;
+  uint8_t net_fn;
+  uint8_t target_is_set;
+  uint8_t channel_number;
+  uint8_t rs_addr;
+  uint32_t rq_len;
+  uint8_t rq[IPMI_SESSION_BROKER_PKT_LEN];
+};
+
+/* Response to both OPEN and CMD requests.  errnum is an
+ * ipmi_errnum_type_t, rs/rs_len are only used by CMD.
+ */
+struct ipmi_session_broker_rs
+{
+  struct ipmi_session_broker_hdr hdr;
+  uint32_t errnum;
+  uint32_t rs_len;
+  uint8_t rs[IPMI_SESSION_BROKER_PKT_LEN];
+};
+
+#endif /* IPMI_SESSION_BROKER_PROTOCOL_H */
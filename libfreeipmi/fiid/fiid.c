@@ -27,42 +27,117 @@
 #include <stdarg.h>
 #endif /* STDC_HEADERS */
 #include <limits.h>
+#include <stdint.h>
 #include <assert.h>
 #include <errno.h>
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include "freeipmi/fiid/fiid.h"
 
 #include "libcommon/ipmi-bit-ops.h"
 
 #include "freeipmi-portability.h"
-#include "hash.h"
 #include "secure.h"
 
 #define FIID_OBJ_MAGIC 0xf00fd00d
 #define FIID_ITERATOR_MAGIC 0xd00df00f
 
+/* Number of registry buckets holding compiled template layouts.
+ * Must be a power of 2.
+ */
+#define FIID_TEMPLATE_LAYOUT_BUCKETS 256
+
+/* Number of buckets holding interned field keys.  Must be a power of
+ * 2.
+ */
+#define FIID_FIELD_HANDLE_BUCKETS 1024
+
+/* Number of slots in the template address cache.  Must be a power of
+ * 2.  Slots only hint at a layout, so collisions merely cost a
+ * registry lookup.
+ */
+#define FIID_TEMPLATE_CACHE_SLOTS 1024
+
+/* The template address cache is read without locking, publishing
+ * requires atomic pointer loads and stores.  Without them every
+ * lookup takes the registry path.
+ */
+#if defined (__GNUC__) && defined (__ATOMIC_ACQUIRE)
+#define FIID_TEMPLATE_CACHE 1
+#define FIID_TEMPLATE_CACHE_LOAD(__ptr) __atomic_load_n ((__ptr), __ATOMIC_ACQUIRE)
+#define FIID_TEMPLATE_CACHE_STORE(__ptr, __val) __atomic_store_n ((__ptr), (__val), __ATOMIC_RELEASE)
+#endif /* defined (__GNUC__) && defined (__ATOMIC_ACQUIRE) */
+
+/* Maximum bytes a field of at most 64 bits may span */
+#define FIID_OBJ_SET_MAX_BYTES 10
+
+#define FIID_HASH_FNV_OFFSET 2166136261U
+#define FIID_HASH_FNV_PRIME  16777619U
+
+/* Number of seeds tried per index table size when looking for a
+ * collision free (i.e. perfect) key index before growing the table.
+ */
+#define FIID_TEMPLATE_LAYOUT_SEED_TRIES 64
+
+/* Maximum factor of index table size to field count before giving up
+ * on a perfect index and settling for linear probing.
+ */
+#define FIID_TEMPLATE_LAYOUT_INDEX_MAX_FACTOR 16
+
+/* Field keys are interned process wide, a field handle is simply a
+ * pointer to the interned key.
+ */
+struct fiid_field_handle
+{
+  char *key;
+  uint32_t hashval;
+  struct fiid_field_handle *next;
+};
+
 struct fiid_field_data
 {
   unsigned int max_field_len;
-  char key[FIID_FIELD_MAX_KEY_LEN + 1];
-  unsigned int set_field_len;
+  char *key;
+  struct fiid_field_handle *handle;
   unsigned int flags;
   unsigned int index;           /* for lookup */
   unsigned int start;           /* for lookup */
   unsigned int end;             /* for lookup */
 };
 
+/* A template "compiled" into its field layout and key index.  Layouts
+ * are built once per distinct template, are never modified after
+ * being published in the registry, and live for the lifetime of the
+ * process.  Therefore they may be shared by any number of objects in
+ * any number of threads without locking.
+ */
+struct fiid_template_layout
+{
+  uint32_t hashval;             /* hash of template contents */
+  unsigned int data_len;
+  struct fiid_field_data *field_data;
+  unsigned int field_data_len;
+  unsigned int *index_table;    /* field index + 1, 0 if empty */
+  unsigned int index_mask;
+  uint32_t index_seed;
+  int makes_packet_sufficient;
+  int secure_memset_on_clear;
+  struct fiid_template_layout *next;
+};
+
 struct fiid_obj
 {
   uint32_t magic;
   fiid_err_t errnum;
   uint8_t *data;
   unsigned int data_len;
-  struct fiid_field_data *field_data;
+  const struct fiid_template_layout *layout;
+  const struct fiid_field_data *field_data;
+  unsigned int *set_field_len;
   unsigned int field_data_len;
-  hash_t lookup;
-  int makes_packet_sufficient;  /* flag for internal use */
-  int secure_memset_on_clear;   /* flag for internal use */
+  int read_only;                /* data borrowed from caller, see fiid_obj_create_view */
 };
 
 struct fiid_iterator
@@ -74,6 +149,23 @@ struct fiid_iterator
   struct fiid_obj *obj;
 };
 
+/* fiid_template_layouts_mutex protects both layout and handle
+ * registration, lookups within a layout need no locking.
+ */
+static struct fiid_template_layout *fiid_template_layouts[FIID_TEMPLATE_LAYOUT_BUCKETS];
+static struct fiid_field_handle *fiid_field_handles[FIID_FIELD_HANDLE_BUCKETS];
+static pthread_mutex_t fiid_template_layouts_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Layouts most recently looked up by template address, written with
+ * fiid_template_layouts_mutex held, read without locking.  A cached
+ * layout is only used after its contents are verified against the
+ * template, as the address may since have been freed and reused, or
+ * the template modified in place.
+ */
+#ifdef FIID_TEMPLATE_CACHE
+static const struct fiid_template_layout *fiid_template_cache[FIID_TEMPLATE_CACHE_SLOTS];
+#endif /* FIID_TEMPLATE_CACHE */
+
 static char * fiid_errmsg[] =
   {
     "success",
@@ -102,6 +194,7 @@ static char * fiid_errmsg[] =
     "out of memory",
     "internal error",
     "errnum out of range",
+    "fiid object read only",
   };
 
 #ifndef NDEBUG
@@ -773,146 +866,334 @@ FIID_TEMPLATE_COMPARE (fiid_template_t tmpl1,
   return (ret);
 }
 
+#ifdef FIID_TEMPLATE_CACHE
+static unsigned int
+_fiid_template_cache_slot (fiid_template_t tmpl)
+{
+  uintptr_t addr = (uintptr_t)tmpl;
+
+  addr ^= addr >> 16;
+  addr *= 0x9E3779B9U;
+  addr ^= addr >> 13;
+  return ((unsigned int)addr & (FIID_TEMPLATE_CACHE_SLOTS - 1));
+}
+#endif /* FIID_TEMPLATE_CACHE */
+
 void
 fiid_template_free (fiid_field_t *tmpl_dynamic)
 {
   free (tmpl_dynamic);
 }
 
-static int
-_fiid_obj_field_start_end (fiid_obj_t obj,
-                           const char *field,
-                           unsigned int *start,
-                           unsigned int *end)
+static unsigned int
+_fiid_key_len (const char *key)
+{
+  unsigned int len = 0;
+
+  assert (key);
+
+  /* template keys need not be NUL terminated at the maximum length */
+  while (len < FIID_FIELD_MAX_KEY_LEN && key[len] != '\0')
+    len++;
+
+  return (len);
+}
+
+static uint32_t
+_fiid_hash_key (const char *key, uint32_t hval)
 {
-  struct fiid_field_data *ffdptr;
   unsigned int i;
 
-  assert (obj);
-  assert (obj->magic == FIID_OBJ_MAGIC);
-  assert (field);
-  assert (start);
-  assert (end);
+  assert (key);
 
-  if ((ffdptr = hash_find (obj->lookup, field)))
+  /* FNV-1a */
+  for (i = 0; i < FIID_FIELD_MAX_KEY_LEN && key[i] != '\0'; i++)
     {
-      *start = ffdptr->start;
-      *end = ffdptr->end;
-      return (ffdptr->max_field_len);
+      hval ^= (uint8_t)key[i];
+      hval *= FIID_HASH_FNV_PRIME;
     }
 
-  /* integer overflow conditions checked during object creation */
-  for (i = 0; obj->field_data[i].max_field_len; i++)
+  return (hval);
+}
+
+static uint32_t
+_fiid_hash_uint (unsigned int val, uint32_t hval)
+{
+  unsigned int i;
+
+  for (i = 0; i < sizeof (unsigned int); i++)
     {
-      if (!strcmp (obj->field_data[i].key, field))
-        {
-          if (!hash_insert (obj->lookup,
-                            obj->field_data[i].key,
-                            &(obj->field_data[i])))
-            {
-              obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              return (-1);
-            }
+      hval ^= (val & 0xFF);
+      hval *= FIID_HASH_FNV_PRIME;
+      val >>= 8;
+    }
 
-          *start = obj->field_data[i].start;
-          *end = obj->field_data[i].end;
-          return (obj->field_data[i].max_field_len);
-        }
+  return (hval);
+}
+
+/* Mix a key hash with a seed to select an index slot.  This lets the
+ * key hash be computed once per key (and stored in its handle),
+ * while each layout picks its own seed.
+ */
+static uint32_t
+_fiid_hash_slot (uint32_t hashval, uint32_t seed)
+{
+  uint32_t h = hashval + (seed * 0x9E3779B9U);
+
+  h ^= h >> 16;
+  h *= 0x85EBCA6BU;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35U;
+  h ^= h >> 16;
+  return (h);
+}
+
+static uint32_t
+_fiid_template_hash (fiid_template_t tmpl)
+{
+  uint32_t hval = FIID_HASH_FNV_OFFSET;
+  unsigned int i;
+
+  assert (tmpl);
+
+  for (i = 0; tmpl[i].max_field_len; i++)
+    {
+      hval = _fiid_hash_uint (tmpl[i].max_field_len, hval);
+      hval = _fiid_hash_uint (tmpl[i].flags, hval);
+      hval = _fiid_hash_key (tmpl[i].key, hval);
     }
 
-  obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
-  return (-1);
+  return (hval);
+}
+
+/* fiid_template_layouts_mutex must be held */
+static struct fiid_field_handle *
+_fiid_field_handle_intern (const char *key)
+{
+  struct fiid_field_handle *handle;
+  unsigned int key_len;
+  uint32_t hashval;
+  unsigned int bucket;
+
+  assert (key);
+
+  key_len = _fiid_key_len (key);
+  hashval = _fiid_hash_key (key, FIID_HASH_FNV_OFFSET);
+  bucket = hashval & (FIID_FIELD_HANDLE_BUCKETS - 1);
+
+  for (handle = fiid_field_handles[bucket]; handle; handle = handle->next)
+    {
+      if (handle->hashval == hashval
+          && !strncmp (handle->key, key, key_len)
+          && handle->key[key_len] == '\0')
+        return (handle);
+    }
+
+  if (!(handle = (struct fiid_field_handle *)malloc (sizeof (struct fiid_field_handle) + key_len + 1)))
+    {
+      /* FIID_ERR_OUT_OF_MEMORY */
+      errno = ENOMEM;
+      return (NULL);
+    }
+  handle->key = (char *)(handle + 1);
+  memcpy (handle->key, key, key_len);
+  handle->key[key_len] = '\0';
+  handle->hashval = hashval;
+  handle->next = fiid_field_handles[bucket];
+  fiid_field_handles[bucket] = handle;
+
+  return (handle);
 }
 
 static int
-_fiid_obj_field_start (fiid_obj_t obj, const char *field)
+_fiid_template_layout_match (const struct fiid_template_layout *layout,
+                             fiid_template_t tmpl)
 {
-  unsigned int start = 0;
-  unsigned int end = 0; /* excluded always */
+  unsigned int i;
 
-  assert (obj);
-  assert (obj->magic == FIID_OBJ_MAGIC);
-  assert (field);
+  assert (layout);
+  assert (tmpl);
 
-  if (_fiid_obj_field_start_end (obj, field, &start, &end) < 0)
-    return (-1);
+  /* last entry in field_data is the 0 max_field_len terminator */
+  for (i = 0; i < layout->field_data_len; i++)
+    {
+      if (layout->field_data[i].max_field_len != tmpl[i].max_field_len)
+        return (0);
 
-  return (start);
+      if (!tmpl[i].max_field_len)
+        break;
+
+      if (layout->field_data[i].flags != tmpl[i].flags)
+        return (0);
+
+      if (strncmp (layout->field_data[i].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN))
+        return (0);
+    }
+
+  return (1);
 }
 
 static int
-_fiid_obj_field_end (fiid_obj_t obj, const char *field)
+_fiid_template_layout_lookup (const struct fiid_template_layout *layout,
+                              const char *field,
+                              unsigned int *index)
 {
-  unsigned int start = 0;
-  unsigned int end = 0; /* excluded always */
+  uint32_t hashval;
+  unsigned int slot;
 
-  assert (obj);
-  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (layout);
   assert (field);
+  assert (index);
 
-  if (_fiid_obj_field_start_end (obj, field, &start, &end) < 0)
-    return (-1);
+  hashval = _fiid_hash_key (field, FIID_HASH_FNV_OFFSET);
 
-  return (end);
+  /* index table is never full, so the probe always terminates */
+  slot = _fiid_hash_slot (hashval, layout->index_seed) & layout->index_mask;
+  while (layout->index_table[slot])
+    {
+      unsigned int i = layout->index_table[slot] - 1;
+
+      if (layout->field_data[i].handle->hashval == hashval
+          && !strcmp (layout->field_data[i].key, field))
+        {
+          (*index) = i;
+          return (0);
+        }
+
+      slot = (slot + 1) & layout->index_mask;
+    }
+
+  return (-1);
 }
 
 static int
-_fiid_obj_field_len (fiid_obj_t obj, const char *field)
+_fiid_template_layout_lookup_handle (const struct fiid_template_layout *layout,
+                                     fiid_field_handle_t handle,
+                                     unsigned int *index)
+{
+  unsigned int slot;
+
+  assert (layout);
+  assert (handle);
+  assert (index);
+
+  /* handles are interned, so a pointer comparison suffices */
+  slot = _fiid_hash_slot (handle->hashval, layout->index_seed) & layout->index_mask;
+  while (layout->index_table[slot])
+    {
+      unsigned int i = layout->index_table[slot] - 1;
+
+      if (layout->field_data[i].handle == handle)
+        {
+          (*index) = i;
+          return (0);
+        }
+
+      slot = (slot + 1) & layout->index_mask;
+    }
+
+  return (-1);
+}
+
+static int
+_fiid_template_layout_index (struct fiid_template_layout *layout)
 {
-  struct fiid_field_data *ffdptr;
+  unsigned int field_count;
+  unsigned int index_len = 2;
   unsigned int i;
 
-  assert (obj);
-  assert (obj->magic == FIID_OBJ_MAGIC);
-  assert (field);
+  assert (layout);
+  assert (layout->field_data_len);
 
-  if ((ffdptr = hash_find (obj->lookup, field)))
-    return (ffdptr->max_field_len);
+  /* do not include the terminator */
+  field_count = layout->field_data_len - 1;
 
-  for (i = 0; obj->field_data[i].max_field_len; i++)
+  while (index_len < (field_count * 2))
+    index_len <<= 1;
+
+  /* Look for a seed giving every key its own slot, so that any key
+   * lookup is a single probe.  Templates are compiled once, so we
+   * can afford to search a bit.  If nothing is found in a reasonably
+   * sized table, fall back to linear probing.
+   */
+  while (1)
     {
-      if (!strcmp (obj->field_data[i].key, field))
+      uint32_t seed;
+
+      if (!(layout->index_table = (unsigned int *)malloc (index_len * sizeof (unsigned int))))
+        {
+          errno = ENOMEM;
+          return (-1);
+        }
+      layout->index_mask = index_len - 1;
+
+      for (seed = 0; seed < FIID_TEMPLATE_LAYOUT_SEED_TRIES; seed++)
         {
-          if (!hash_insert (obj->lookup,
-                            obj->field_data[i].key,
-                            &(obj->field_data[i])))
+          memset (layout->index_table, '\0', index_len * sizeof (unsigned int));
+
+          for (i = 0; i < field_count; i++)
             {
-              obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              return (-1);
+              unsigned int slot;
+
+              slot = _fiid_hash_slot (layout->field_data[i].handle->hashval, seed) & layout->index_mask;
+              if (layout->index_table[slot])
+                break;
+              layout->index_table[slot] = i + 1;
             }
 
-          return (obj->field_data[i].max_field_len);
+          if (i == field_count)
+            {
+              layout->index_seed = seed;
+              return (0);
+            }
         }
+
+      if (index_len >= (field_count * FIID_TEMPLATE_LAYOUT_INDEX_MAX_FACTOR))
+        break;
+
+      free (layout->index_table);
+      layout->index_table = NULL;
+      index_len <<= 1;
     }
 
-  obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
-  return (-1);
+  memset (layout->index_table, '\0', index_len * sizeof (unsigned int));
+  layout->index_seed = 0;
+
+  for (i = 0; i < field_count; i++)
+    {
+      unsigned int slot;
+
+      slot = _fiid_hash_slot (layout->field_data[i].handle->hashval, 0) & layout->index_mask;
+      while (layout->index_table[slot])
+        slot = (slot + 1) & layout->index_mask;
+      layout->index_table[slot] = i + 1;
+    }
+
+  return (0);
 }
 
-char *
-fiid_strerror (fiid_err_t errnum)
+static void
+_fiid_template_layout_destroy (struct fiid_template_layout *layout)
 {
-  if (errnum >= FIID_ERR_SUCCESS && errnum <= FIID_ERR_ERRNUMRANGE)
-    return (fiid_errmsg[errnum]);
-  else
-    return (fiid_errmsg[FIID_ERR_ERRNUMRANGE]);
+  if (!layout)
+    return;
+
+  /* interned handles are never freed */
+  free (layout->field_data);
+  free (layout->index_table);
+  free (layout);
 }
 
-fiid_obj_t
-fiid_obj_create (fiid_template_t tmpl)
+/* fiid_template_layouts_mutex must be held */
+static struct fiid_template_layout *
+_fiid_template_layout_create (fiid_template_t tmpl, uint32_t hashval)
 {
-  fiid_obj_t obj = NULL;
-  unsigned int max_pkt_len = 0;
-  unsigned int i;
+  struct fiid_template_layout *layout = NULL;
   unsigned int start = 0;
+  unsigned int i;
   int data_len;
 
-  if (!tmpl)
-    {
-      /* FIID_ERR_PARAMETERS */
-      errno = EINVAL;
-      goto cleanup;
-    }
+  assert (tmpl);
 
 #ifndef NDEBUG
   if (_fiid_template_check_valid_keys (tmpl) < 0)
@@ -930,56 +1211,39 @@ fiid_obj_create (fiid_template_t tmpl)
       goto cleanup;
     }
 
-  if (!(obj = (fiid_obj_t)malloc (sizeof (struct fiid_obj))))
+  if (!(layout = (struct fiid_template_layout *)malloc (sizeof (struct fiid_template_layout))))
     {
       /* FIID_ERR_OUT_OF_MEMORY */
       errno = ENOMEM;
       goto cleanup;
     }
-  memset (obj, '\0', sizeof (struct fiid_obj));
-  obj->magic = FIID_OBJ_MAGIC;
+  memset (layout, '\0', sizeof (struct fiid_template_layout));
+  layout->hashval = hashval;
 
   /* after call to _fiid_template_len_bytes, we know each field length
    * and total field length won't overflow an int.
    */
   if ((data_len = _fiid_template_len_bytes (tmpl,
-                                            &obj->field_data_len)) < 0)
+                                            &layout->field_data_len)) < 0)
     goto cleanup;
-  obj->data_len = data_len;
+  layout->data_len = data_len;
 
-  if (!obj->field_data_len)
+  if (!layout->field_data_len)
     {
       /* FIID_ERR_TEMPLATE_INVALID */
       errno = EINVAL;
       goto cleanup;
     }
 
-  if (!(obj->data = malloc (obj->data_len)))
-    {
-      /* FIID_ERR_OUT_OF_MEMORY */
-      errno = ENOMEM;
-      goto cleanup;
-    }
-  memset (obj->data, '\0', obj->data_len);
-
-  if (!(obj->field_data = malloc (obj->field_data_len * sizeof (struct fiid_field_data))))
+  if (!(layout->field_data = malloc (layout->field_data_len * sizeof (struct fiid_field_data))))
     {
       /* FIID_ERR_OUT_OF_MEMORY */
       errno = ENOMEM;
       goto cleanup;
     }
-  memset (obj->field_data, '\0', obj->field_data_len * sizeof (struct fiid_field_data));
+  memset (layout->field_data, '\0', layout->field_data_len * sizeof (struct fiid_field_data));
 
-  if (!(obj->lookup = hash_create (obj->field_data_len,
-                                   (hash_key_f)hash_key_string,
-                                   (hash_cmp_f)strcmp,
-                                   NULL)))
-    {
-      errno = ENOMEM;
-      goto cleanup;
-    }
-
-  for (i = 0; i < obj->field_data_len; i++)
+  for (i = 0; i < layout->field_data_len; i++)
     {
 #ifndef NDEBUG
       if (tmpl[i].max_field_len)
@@ -988,7 +1252,7 @@ fiid_obj_create (fiid_template_t tmpl)
 
           for (j = 0; j < i; j++)
             {
-              if (!strncmp (obj->field_data[j].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN))
+              if (!strncmp (layout->field_data[j].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN))
                 {
                   /* FIID_ERR_TEMPLATE_INVALID */
                   errno = EINVAL;
@@ -997,118 +1261,498 @@ fiid_obj_create (fiid_template_t tmpl)
             }
         }
 #endif /* !NDEBUG */
-      obj->field_data[i].max_field_len = tmpl[i].max_field_len;
-      memset (obj->field_data[i].key, '\0', FIID_FIELD_MAX_KEY_LEN + 1);
-      strncpy (obj->field_data[i].key, tmpl[i].key, FIID_FIELD_MAX_KEY_LEN);
-      obj->field_data[i].set_field_len = 0;
-      obj->field_data[i].flags = tmpl[i].flags;
-      obj->field_data[i].index = i;
-      obj->field_data[i].start = start;
-      obj->field_data[i].end = start + obj->field_data[i].max_field_len;
-      max_pkt_len += tmpl[i].max_field_len;
+      if (!(layout->field_data[i].handle = _fiid_field_handle_intern (tmpl[i].key)))
+        goto cleanup;
+      layout->field_data[i].max_field_len = tmpl[i].max_field_len;
+      layout->field_data[i].key = layout->field_data[i].handle->key;
+      layout->field_data[i].flags = tmpl[i].flags;
+      layout->field_data[i].index = i;
+      layout->field_data[i].start = start;
+      layout->field_data[i].end = start + layout->field_data[i].max_field_len;
 
-      if (obj->field_data[i].flags & FIID_FIELD_MAKES_PACKET_SUFFICIENT)
-        obj->makes_packet_sufficient = 1;
+      if (layout->field_data[i].flags & FIID_FIELD_MAKES_PACKET_SUFFICIENT)
+        layout->makes_packet_sufficient = 1;
 
-      if (obj->field_data[i].flags & FIID_FIELD_SECURE_MEMSET_ON_CLEAR)
-        obj->secure_memset_on_clear = 1;
+      if (layout->field_data[i].flags & FIID_FIELD_SECURE_MEMSET_ON_CLEAR)
+        layout->secure_memset_on_clear = 1;
 
-      start += obj->field_data[i].max_field_len;
+      start += layout->field_data[i].max_field_len;
     }
 
-  if (max_pkt_len % 8)
+  if (start % 8)
     {
       /* FIID_ERR_TEMPLATE_NOT_BYTE_ALIGNED */
       errno = EINVAL;
       goto cleanup;
     }
 
-  obj->errnum = FIID_ERR_SUCCESS;
-  return (obj);
+  if (_fiid_template_layout_index (layout) < 0)
+    goto cleanup;
 
- cleanup:
-  if (obj)
-    {
-      free (obj->data);
-      free (obj->field_data);
-      hash_destroy (obj->lookup);
-      free (obj);
-    }
+  return (layout);
 
+ cleanup:
+  _fiid_template_layout_destroy (layout);
   return (NULL);
 }
 
-void
-fiid_obj_destroy (fiid_obj_t obj)
+/* Returns the shared compiled layout for the template, compiling and
+ * registering it on first use.  Layouts are keyed on template
+ * contents rather than template address, as templates may be
+ * dynamically allocated (e.g. via fiid_obj_template()) and freed.
+ *
+ * The layout last resolved for a template address is cached, so
+ * later lookups of the same unchanged template take neither the lock
+ * nor a hash of its contents, only a comparison.  The cache holds
+ * no per-address state and never grows.
+ */
+static const struct fiid_template_layout *
+_fiid_template_layout_get (fiid_template_t tmpl)
 {
-  if (!(obj && obj->magic == FIID_OBJ_MAGIC))
-    return;
+  struct fiid_template_layout *layout;
+  uint32_t hashval;
+  unsigned int bucket;
+  int perr;
 
-  obj->magic = ~FIID_OBJ_MAGIC;
-  obj->errnum = FIID_ERR_SUCCESS;
-  free (obj->data);
-  free (obj->field_data);
-  hash_destroy (obj->lookup);
-  free (obj);
-}
+  assert (tmpl);
 
-fiid_obj_t
-fiid_obj_dup (fiid_obj_t src_obj)
-{
-  fiid_obj_t dest_obj = NULL;
+#ifdef FIID_TEMPLATE_CACHE
+  {
+    const struct fiid_template_layout *cached;
 
-  if (!src_obj || src_obj->magic != FIID_OBJ_MAGIC)
-    goto cleanup;
+    cached = FIID_TEMPLATE_CACHE_LOAD (&fiid_template_cache[_fiid_template_cache_slot (tmpl)]);
+    if (cached && _fiid_template_layout_match (cached, tmpl))
+      return (cached);
+  }
+#endif /* FIID_TEMPLATE_CACHE */
 
-  if (!(dest_obj = malloc (sizeof (struct fiid_obj))))
+  hashval = _fiid_template_hash (tmpl);
+  bucket = hashval & (FIID_TEMPLATE_LAYOUT_BUCKETS - 1);
+
+  if ((perr = pthread_mutex_lock (&fiid_template_layouts_mutex)))
     {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
+      errno = perr;
+      return (NULL);
     }
-  memset (dest_obj, '\0', sizeof (struct fiid_obj));
-  dest_obj->magic = src_obj->magic;
-  dest_obj->data_len = src_obj->data_len;
-  dest_obj->field_data_len = src_obj->field_data_len;
 
-  if (!(dest_obj->data = malloc (src_obj->data_len)))
+  for (layout = fiid_template_layouts[bucket]; layout; layout = layout->next)
     {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
+      if (layout->hashval == hashval
+          && _fiid_template_layout_match (layout, tmpl))
+        break;
     }
-  memcpy (dest_obj->data, src_obj->data, src_obj->data_len);
 
-  if (!(dest_obj->field_data = malloc (dest_obj->field_data_len * sizeof (struct fiid_field_data))))
+  if (!layout)
     {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
+      if ((layout = _fiid_template_layout_create (tmpl, hashval)))
+        {
+          layout->next = fiid_template_layouts[bucket];
+          fiid_template_layouts[bucket] = layout;
+        }
     }
 
-  memcpy (dest_obj->field_data,
-          src_obj->field_data,
-          src_obj->field_data_len * sizeof (struct fiid_field_data));
+#ifdef FIID_TEMPLATE_CACHE
+  if (layout)
+    FIID_TEMPLATE_CACHE_STORE (&fiid_template_cache[_fiid_template_cache_slot (tmpl)], layout);
+#endif /* FIID_TEMPLATE_CACHE */
 
-  if (!(dest_obj->lookup = hash_create (dest_obj->field_data_len,
-                                        (hash_key_f)hash_key_string,
-                                        (hash_cmp_f)strcmp,
-                                        NULL)))
+  if ((perr = pthread_mutex_unlock (&fiid_template_layouts_mutex)))
     {
-      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-      goto cleanup;
+      errno = perr;
+      return (NULL);
     }
 
-  src_obj->errnum = FIID_ERR_SUCCESS;
-  dest_obj->errnum = FIID_ERR_SUCCESS;
-  return (dest_obj);
+  return (layout);
+}
 
- cleanup:
-  if (dest_obj)
+fiid_field_handle_t
+fiid_field_handle (const char *field)
+{
+  struct fiid_field_handle *handle;
+  int perr;
+
+  if (!field || !_fiid_key_len (field))
     {
-      free (dest_obj->data);
-      free (dest_obj->field_data);
-      hash_destroy (dest_obj->lookup);
-      free (dest_obj);
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (NULL);
     }
-  return (NULL);
+
+  if ((perr = pthread_mutex_lock (&fiid_template_layouts_mutex)))
+    {
+      errno = perr;
+      return (NULL);
+    }
+
+  handle = _fiid_field_handle_intern (field);
+
+  if ((perr = pthread_mutex_unlock (&fiid_template_layouts_mutex)))
+    {
+      errno = perr;
+      return (NULL);
+    }
+
+  return (handle);
+}
+
+const char *
+fiid_field_handle_key (fiid_field_handle_t handle)
+{
+  if (!handle)
+    {
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (NULL);
+    }
+
+  return (handle->key);
+}
+
+static int
+_fiid_obj_lookup_field_index (fiid_obj_t obj, const char *field, unsigned int *index)
+{
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (field);
+  assert (index);
+
+  if (_fiid_template_layout_lookup (obj->layout, field, index) < 0)
+    {
+      obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
+      return (-1);
+    }
+
+  return (0);
+}
+
+static int
+_fiid_obj_lookup_handle_index (fiid_obj_t obj, fiid_field_handle_t handle, unsigned int *index)
+{
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (handle);
+  assert (index);
+
+  if (_fiid_template_layout_lookup_handle (obj->layout, handle, index) < 0)
+    {
+      obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
+      return (-1);
+    }
+
+  return (0);
+}
+
+static int
+_fiid_obj_field_start_end (fiid_obj_t obj,
+                           const char *field,
+                           unsigned int *start,
+                           unsigned int *end)
+{
+  unsigned int key_index;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (field);
+  assert (start);
+  assert (end);
+
+  /* integer overflow conditions checked during layout creation */
+  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+    return (-1);
+
+  *start = obj->field_data[key_index].start;
+  *end = obj->field_data[key_index].end;
+  return (obj->field_data[key_index].max_field_len);
+}
+
+static int
+_fiid_obj_field_start (fiid_obj_t obj, const char *field)
+{
+  unsigned int start = 0;
+  unsigned int end = 0; /* excluded always */
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (field);
+
+  if (_fiid_obj_field_start_end (obj, field, &start, &end) < 0)
+    return (-1);
+
+  return (start);
+}
+
+static int
+_fiid_obj_field_end (fiid_obj_t obj, const char *field)
+{
+  unsigned int start = 0;
+  unsigned int end = 0; /* excluded always */
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (field);
+
+  if (_fiid_obj_field_start_end (obj, field, &start, &end) < 0)
+    return (-1);
+
+  return (end);
+}
+
+static int
+_fiid_obj_field_len (fiid_obj_t obj, const char *field)
+{
+  unsigned int key_index;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (field);
+
+  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+    return (-1);
+
+  return (obj->field_data[key_index].max_field_len);
+}
+
+/* Marks the fields covered by the first data_len bytes of the
+ * object's data as set.  data_len must not exceed the template
+ * length.
+ */
+static int
+_fiid_obj_set_all_field_len (fiid_obj_t obj, unsigned int data_len)
+{
+  unsigned int bits_counter, data_bits_len;
+  unsigned int key_index_end;
+  unsigned int i;
+
+  assert (obj);
+  assert (data_len <= obj->layout->data_len);
+
+  /* achu: Find index of last field */
+  data_bits_len = data_len * 8;
+  if (data_len < obj->layout->data_len)
+    {
+      /* integer overflow conditions checked during object creation */
+      bits_counter = 0;
+      for (i = 0; obj->field_data[i].max_field_len; i++)
+        {
+          bits_counter += obj->field_data[i].max_field_len;
+          if (bits_counter >= data_bits_len)
+            {
+              /* achu: We assume the data must end on a byte boundary. */
+              if (bits_counter % 8)
+                {
+                  obj->errnum = FIID_ERR_DATA_NOT_BYTE_ALIGNED;
+                  return (-1);
+                }
+              else
+                break;
+            }
+
+        }
+      key_index_end = i;
+    }
+  else
+    key_index_end = (obj->field_data_len - 1);
+
+  /* integer overflow conditions checked during object creation */
+  bits_counter = 0;
+  for (i = 0; i < key_index_end; i++)
+    {
+      obj->set_field_len[i] = obj->field_data[i].max_field_len;
+      bits_counter += obj->set_field_len[i];
+    }
+  if (data_bits_len < bits_counter + obj->field_data[key_index_end].max_field_len)
+    {
+      int data_bits_left = data_bits_len - bits_counter;
+      obj->set_field_len[i] = data_bits_left;
+    }
+  else
+    obj->set_field_len[i] = obj->field_data[i].max_field_len;
+
+  return (0);
+}
+
+char *
+fiid_strerror (fiid_err_t errnum)
+{
+  if (errnum >= FIID_ERR_SUCCESS && errnum <= FIID_ERR_READ_ONLY)
+    return (fiid_errmsg[errnum]);
+  else
+    return (fiid_errmsg[FIID_ERR_ERRNUMRANGE]);
+}
+
+static fiid_obj_t
+_fiid_obj_create_from_layout (const struct fiid_template_layout *layout,
+                              int read_only)
+{
+  fiid_obj_t obj = NULL;
+  size_t obj_len;
+
+  assert (layout);
+
+  /* The per-object set field lengths and data are allocated
+   * together with the object, everything else lives in the shared
+   * layout.  struct fiid_obj contains pointers, so the set field
+   * length array following it is suitably aligned.  Read only views
+   * borrow their data from the caller and need no data block.
+   */
+  obj_len = sizeof (struct fiid_obj)
+    + (layout->field_data_len * sizeof (unsigned int));
+  if (!read_only)
+    obj_len += layout->data_len;
+
+  if (!(obj = (fiid_obj_t)malloc (obj_len)))
+    {
+      /* FIID_ERR_OUT_OF_MEMORY */
+      errno = ENOMEM;
+      return (NULL);
+    }
+  memset (obj, '\0', obj_len);
+  obj->magic = FIID_OBJ_MAGIC;
+  obj->layout = layout;
+  obj->field_data = layout->field_data;
+  obj->field_data_len = layout->field_data_len;
+  obj->set_field_len = (unsigned int *)(obj + 1);
+  if (!read_only)
+    {
+      obj->data = (uint8_t *)(obj->set_field_len + layout->field_data_len);
+      obj->data_len = layout->data_len;
+    }
+  obj->read_only = read_only;
+  obj->errnum = FIID_ERR_SUCCESS;
+  return (obj);
+}
+
+fiid_obj_t
+fiid_obj_create (fiid_template_t tmpl)
+{
+  const struct fiid_template_layout *layout;
+
+  if (!tmpl)
+    {
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (NULL);
+    }
+
+  if (!(layout = _fiid_template_layout_get (tmpl)))
+    return (NULL);
+
+  return (_fiid_obj_create_from_layout (layout, 0));
+}
+
+fiid_obj_t
+fiid_obj_create_view (fiid_template_t tmpl,
+                      const void *data,
+                      unsigned int data_len)
+{
+  const struct fiid_template_layout *layout;
+  fiid_obj_t obj;
+
+  if (!tmpl || (!data && data_len))
+    {
+      /* FIID_ERR_PARAMETERS */
+      errno = EINVAL;
+      return (NULL);
+    }
+
+  if (!(layout = _fiid_template_layout_get (tmpl)))
+    return (NULL);
+
+  if (!(obj = _fiid_obj_create_from_layout (layout, 1)))
+    return (NULL);
+
+  if (data && fiid_obj_view_bind (obj, data, data_len) < 0)
+    {
+      /* FIID_ERR_DATA_NOT_BYTE_ALIGNED */
+      errno = EINVAL;
+      fiid_obj_destroy (obj);
+      return (NULL);
+    }
+
+  return (obj);
+}
+
+int
+fiid_obj_view_bind (fiid_obj_t obj,
+                    const void *data,
+                    unsigned int data_len)
+{
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!obj->read_only || (!data && data_len))
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  /* Never leave the view pointing at a buffer the caller may no
+   * longer own, even on error.
+   */
+  memset (obj->set_field_len, '\0', obj->field_data_len * sizeof (unsigned int));
+  obj->data = NULL;
+  obj->data_len = 0;
+
+  if (!data)
+    {
+      obj->errnum = FIID_ERR_SUCCESS;
+      return (0);
+    }
+
+  if (data_len > obj->layout->data_len)
+    data_len = obj->layout->data_len;
+
+  if (_fiid_obj_set_all_field_len (obj, data_len) < 0)
+    {
+      memset (obj->set_field_len, '\0', obj->field_data_len * sizeof (unsigned int));
+      return (-1);
+    }
+
+  /* The view never writes through data, see the read_only checks */
+  obj->data = (uint8_t *)data;
+  obj->data_len = data_len;
+
+  obj->errnum = FIID_ERR_SUCCESS;
+  return (data_len);
+}
+
+void
+fiid_obj_destroy (fiid_obj_t obj)
+{
+  if (!(obj && obj->magic == FIID_OBJ_MAGIC))
+    return;
+
+  obj->magic = ~FIID_OBJ_MAGIC;
+  obj->errnum = FIID_ERR_SUCCESS;
+  free (obj);
+}
+
+fiid_obj_t
+fiid_obj_dup (fiid_obj_t src_obj)
+{
+  fiid_obj_t dest_obj = NULL;
+
+  if (!src_obj || src_obj->magic != FIID_OBJ_MAGIC)
+    return (NULL);
+
+  /* A duplicate is always a writable object with its own data,
+   * even when the source is a read only view.
+   */
+  if (!(dest_obj = _fiid_obj_create_from_layout (src_obj->layout, 0)))
+    {
+      src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
+      return (NULL);
+    }
+
+  if (src_obj->data_len)
+    memcpy (dest_obj->data, src_obj->data, src_obj->data_len);
+  memcpy (dest_obj->set_field_len,
+          src_obj->set_field_len,
+          src_obj->field_data_len * sizeof (unsigned int));
+
+  src_obj->errnum = FIID_ERR_SUCCESS;
+  dest_obj->errnum = FIID_ERR_SUCCESS;
+  return (dest_obj);
 }
 
 fiid_obj_t
@@ -1125,7 +1769,7 @@ fiid_obj_copy (fiid_obj_t src_obj, fiid_template_t alt_tmpl)
   if ((data_len = _fiid_template_len_bytes (alt_tmpl, &field_data_len)) < 0)
     goto cleanup;
 
-  if (src_obj->data_len != data_len)
+  if (src_obj->layout->data_len != data_len)
     {
       src_obj->errnum = FIID_ERR_PARAMETERS;
       goto cleanup;
@@ -1134,13 +1778,13 @@ fiid_obj_copy (fiid_obj_t src_obj, fiid_template_t alt_tmpl)
   if (!(dest_obj = fiid_obj_create (alt_tmpl)))
     goto cleanup;
 
-  if (!(databuf = (uint8_t *)malloc (src_obj->data_len)))
+  if (!(databuf = (uint8_t *)malloc (src_obj->layout->data_len)))
     {
       src_obj->errnum = FIID_ERR_OUT_OF_MEMORY;
       goto cleanup;
     }
 
-  if ((data_len = fiid_obj_get_all (src_obj, databuf, src_obj->data_len)) < 0)
+  if ((data_len = fiid_obj_get_all (src_obj, databuf, src_obj->layout->data_len)) < 0)
     goto cleanup;
 
   if (fiid_obj_set_all (dest_obj, databuf, data_len) < 0)
@@ -1176,14 +1820,14 @@ _fiid_obj_packet_valid (fiid_obj_t obj, int makes_packet_sufficient_checks)
 
   assert (obj);
   assert (obj->magic == FIID_OBJ_MAGIC);
-  assert (!makes_packet_sufficient_checks || obj->makes_packet_sufficient);
+  assert (!makes_packet_sufficient_checks || obj->layout->makes_packet_sufficient);
 
   for (i = 0; i < obj->field_data_len; i++)
     {
       unsigned int required_flag = FIID_FIELD_REQUIRED_FLAG (obj->field_data[i].flags);
       unsigned int length_flag = FIID_FIELD_LENGTH_FLAG (obj->field_data[i].flags);
       unsigned int max_field_len = obj->field_data[i].max_field_len;
-      unsigned int set_field_len = obj->field_data[i].set_field_len;
+      unsigned int set_field_len = obj->set_field_len[i];
       unsigned int makes_packet_sufficient_flag = obj->field_data[i].flags & FIID_FIELD_MAKES_PACKET_SUFFICIENT;
 
       if (makes_packet_sufficient_checks)
@@ -1326,7 +1970,7 @@ fiid_obj_packet_sufficient (fiid_obj_t obj)
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
-  if (!obj->makes_packet_sufficient)
+  if (!obj->layout->makes_packet_sufficient)
     return _fiid_obj_packet_valid (obj, 0);
 
   if (!(ret = _fiid_obj_packet_valid (obj, 0)))
@@ -1376,7 +2020,7 @@ fiid_obj_template (fiid_obj_t obj)
     {
       tmpl[i].max_field_len = obj->field_data[i].max_field_len;
       /* not FIID_FIELD_MAX_KEY_LEN + 1, template does not have + 1 */
-      memcpy (tmpl[i].key, obj->field_data[i].key, FIID_FIELD_MAX_KEY_LEN);
+      strncpy (tmpl[i].key, obj->field_data[i].key, FIID_FIELD_MAX_KEY_LEN);
       tmpl[i].flags = obj->field_data[i].flags;
     }
 
@@ -1471,44 +2115,6 @@ fiid_obj_errormsg (fiid_obj_t obj)
   return (fiid_strerror (fiid_obj_errnum (obj)));
 }
 
-static int
-_fiid_obj_lookup_field_index (fiid_obj_t obj, const char *field, unsigned int *index)
-{
-  struct fiid_field_data *ffdptr;
-  unsigned int i;
-
-  assert (obj);
-  assert (obj->magic == FIID_OBJ_MAGIC);
-  assert (field);
-  assert (index);
-
-  if ((ffdptr = hash_find (obj->lookup, field)))
-    {
-      (*index) = ffdptr->index;
-      return (0);
-    }
-
-  for (i = 0; obj->field_data[i].max_field_len; i++)
-    {
-      if (!strcmp (obj->field_data[i].key, field))
-        {
-          if (!hash_insert (obj->lookup,
-                            obj->field_data[i].key,
-                            &(obj->field_data[i])))
-            {
-              obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              return (-1);
-            }
-
-          (*index) = obj->field_data[i].index;
-          return (0);
-        }
-    }
-
-  obj->errnum = FIID_ERR_FIELD_NOT_FOUND;
-  return (-1);
-}
-
 int
 fiid_obj_len (fiid_obj_t obj)
 {
@@ -1520,7 +2126,7 @@ fiid_obj_len (fiid_obj_t obj)
 
   /* integer overflow conditions checked during object creation */
   for (i = 0; obj->field_data[i].max_field_len; i++)
-    counter += obj->field_data[i].set_field_len;
+    counter += obj->set_field_len[i];
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (counter);
@@ -1565,7 +2171,28 @@ fiid_obj_field_len (fiid_obj_t obj, const char *field)
     return (-1);
 
   obj->errnum = FIID_ERR_SUCCESS;
-  return (obj->field_data[key_index].set_field_len);
+  return (obj->set_field_len[key_index]);
+}
+
+int
+fiid_obj_field_len_by_handle (fiid_obj_t obj, fiid_field_handle_t handle)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!handle)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (_fiid_obj_lookup_handle_index (obj, handle, &key_index) < 0)
+    return (-1);
+
+  obj->errnum = FIID_ERR_SUCCESS;
+  return (obj->set_field_len[key_index]);
 }
 
 int
@@ -1625,7 +2252,7 @@ fiid_obj_block_len (fiid_obj_t obj, const char *field_start, const char *field_e
 
   /* integer overflow conditions checked during object creation */
   for (i = key_index_start; i <= key_index_end; i++)
-    counter += obj->field_data[i].set_field_len;
+    counter += obj->set_field_len[i];
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (counter);
@@ -1666,13 +2293,19 @@ fiid_obj_clear (fiid_obj_t obj)
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
-  if (obj->secure_memset_on_clear)
+  if (obj->read_only)
+    {
+      obj->errnum = FIID_ERR_READ_ONLY;
+      return (-1);
+    }
+
+  if (obj->layout->secure_memset_on_clear)
     secure_memset (obj->data, '\0', obj->data_len);
   else
     memset (obj->data, '\0', obj->data_len);
 
   for (i =0; i < obj->field_data_len; i++)
-    obj->field_data[i].set_field_len = 0;
+    obj->set_field_len[i] = 0;
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (0);
@@ -1687,6 +2320,12 @@ fiid_obj_clear_field (fiid_obj_t obj, const char *field)
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
+  if (obj->read_only)
+    {
+      obj->errnum = FIID_ERR_READ_ONLY;
+      return (-1);
+    }
+
   if (!field)
     {
       obj->errnum = FIID_ERR_PARAMETERS;
@@ -1696,7 +2335,7 @@ fiid_obj_clear_field (fiid_obj_t obj, const char *field)
   if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
     return (-1);
 
-  if (!obj->field_data[key_index].set_field_len)
+  if (!obj->set_field_len[key_index])
     return (0);
 
   if ((bits_len = _fiid_obj_field_len (obj, field)) < 0)
@@ -1742,7 +2381,7 @@ fiid_obj_clear_field (fiid_obj_t obj, const char *field)
         memset (obj->data + field_offset, '\0', bytes_len);
     }
 
-  obj->field_data[key_index].set_field_len = 0;
+  obj->set_field_len[key_index] = 0;
   obj->errnum = FIID_ERR_SUCCESS;
   return (0);
 }
@@ -1788,40 +2427,33 @@ FIID_OBJ_FIELD_LOOKUP (fiid_obj_t obj, const char *field)
 
   return (ret);
 }
-
-int
-fiid_obj_set (fiid_obj_t obj,
-              const char *field,
-              uint64_t val)
+
+static int
+_fiid_obj_set (fiid_obj_t obj,
+               unsigned int key_index,
+               uint64_t val)
 {
   unsigned int start_bit_pos = 0;
-  unsigned int end_bit_pos = 0; /* excluded always */
   int byte_pos = 0;
   int start_bit_in_byte_pos = 0;
   int end_bit_in_byte_pos = 0;
   int field_len = 0;
   int bytes_used = 0;
-  unsigned int key_index;
   uint64_t merged_val = 0;
-  uint8_t *temp_data = NULL;
 
-  if (!obj || obj->magic != FIID_OBJ_MAGIC)
-    goto cleanup;
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < obj->field_data_len);
 
-  if (!field)
+  if (obj->read_only)
     {
-      obj->errnum = FIID_ERR_PARAMETERS;
-      goto cleanup;
+      obj->errnum = FIID_ERR_READ_ONLY;
+      return (-1);
     }
 
-  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
-    return (-1);
-
-  if ((field_len = _fiid_obj_field_start_end (obj,
-                                              field,
-                                              &start_bit_pos,
-                                              &end_bit_pos)) < 0)
-    return (-1);
+  /* integer overflow conditions checked during layout creation */
+  start_bit_pos = obj->field_data[key_index].start;
+  field_len = obj->field_data[key_index].max_field_len;
 
   if (field_len > 64)
     field_len = 64;
@@ -1856,18 +2488,31 @@ fiid_obj_set (fiid_obj_t obj,
 
   if (bytes_used > 1)
     {
+      /* at most 64 bits beginning anywhere within a byte */
+      uint8_t temp_data[FIID_OBJ_SET_MAX_BYTES];
+      unsigned int temp_data_len;
       int start_val_pos = 0;
       int end_val_pos = 0;
       uint64_t extracted_val = 0;
       int field_len_left = field_len;
       unsigned int i;
 
-      if (!(temp_data = malloc (obj->data_len)))
+      if (bytes_used > FIID_OBJ_SET_MAX_BYTES)
         {
-          obj->errnum = FIID_ERR_OUT_OF_MEMORY;
-          goto cleanup;
+          obj->errnum = FIID_ERR_INTERNAL_ERROR;
+          return (-1);
         }
-      memcpy (temp_data, obj->data, obj->data_len);
+
+      /* The byte count above may include a trailing byte that is
+       * merged with zero bits, it need not exist in the object.
+       */
+      temp_data_len = bytes_used;
+      if ((byte_pos + temp_data_len) > obj->data_len)
+        temp_data_len = obj->data_len - byte_pos;
+
+      /* work on a copy, so data is not touched on error */
+      memset (temp_data, '\0', FIID_OBJ_SET_MAX_BYTES);
+      memcpy (temp_data, obj->data + byte_pos, temp_data_len);
 
       for (i = 0; i < bytes_used; i++)
         {
@@ -1895,26 +2540,26 @@ fiid_obj_set (fiid_obj_t obj,
                             &extracted_val) < 0)
             {
               obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              goto cleanup;
+              return (-1);
             }
 
-          if (bits_merge (temp_data[byte_pos + i],
+          if (bits_merge (temp_data[i],
                           start_bit_in_byte_pos,
                           end_bit_in_byte_pos,
                           extracted_val,
                           &merged_val) < 0)
             {
               obj->errnum = FIID_ERR_INTERNAL_ERROR;
-              goto cleanup;
+              return (-1);
             }
 
-          temp_data[byte_pos + i] = merged_val;
+          temp_data[i] = merged_val;
           start_bit_in_byte_pos = 0;
           start_val_pos = end_val_pos;
         }
 
-      memcpy (obj->data, temp_data, obj->data_len);
-      obj->field_data[key_index].set_field_len = field_len;
+      memcpy (obj->data + byte_pos, temp_data, temp_data_len);
+      obj->set_field_len[key_index] = field_len;
     }
   else
     {
@@ -1925,40 +2570,27 @@ fiid_obj_set (fiid_obj_t obj,
                       &merged_val) < 0)
         {
           obj->errnum = FIID_ERR_INTERNAL_ERROR;
-          goto cleanup;
+          return (-1);
         }
       obj->data[byte_pos] = merged_val;
-      obj->field_data[key_index].set_field_len = field_len;
+      obj->set_field_len[key_index] = field_len;
     }
 
-  free (temp_data);
   obj->errnum = FIID_ERR_SUCCESS;
   return (0);
-
- cleanup:
-  free (temp_data);
-  return (-1);
 }
 
 int
-fiid_obj_get (fiid_obj_t obj,
+fiid_obj_set (fiid_obj_t obj,
               const char *field,
-              uint64_t *val)
+              uint64_t val)
 {
-  unsigned int start_bit_pos = 0;
-  unsigned int end_bit_pos = 0; /* excluded always */
-  int byte_pos = 0;
-  int start_bit_in_byte_pos = 0;
-  int end_bit_in_byte_pos = 0;
-  int field_len = 0;
-  int bytes_used = 0;
   unsigned int key_index;
-  uint64_t merged_val = 0;
 
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
-  if (!field || !val)
+  if (!field)
     {
       obj->errnum = FIID_ERR_PARAMETERS;
       return (-1);
@@ -1967,23 +2599,64 @@ fiid_obj_get (fiid_obj_t obj,
   if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
     return (-1);
 
-  if (!obj->field_data[key_index].set_field_len)
+  return (_fiid_obj_set (obj, key_index, val));
+}
+
+int
+fiid_obj_set_by_handle (fiid_obj_t obj,
+                        fiid_field_handle_t handle,
+                        uint64_t val)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!handle)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (_fiid_obj_lookup_handle_index (obj, handle, &key_index) < 0)
+    return (-1);
+
+  return (_fiid_obj_set (obj, key_index, val));
+}
+
+static int
+_fiid_obj_get (fiid_obj_t obj,
+               unsigned int key_index,
+               uint64_t *val)
+{
+  unsigned int start_bit_pos = 0;
+  int byte_pos = 0;
+  int start_bit_in_byte_pos = 0;
+  int end_bit_in_byte_pos = 0;
+  int field_len = 0;
+  int bytes_used = 0;
+  uint64_t merged_val = 0;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < obj->field_data_len);
+  assert (val);
+
+  if (!obj->set_field_len[key_index])
     {
       obj->errnum = FIID_ERR_SUCCESS;
       return (0);
     }
 
-  if ((field_len = _fiid_obj_field_start_end (obj,
-                                              field,
-                                              &start_bit_pos,
-                                              &end_bit_pos)) < 0)
-    return (-1);
+  /* integer overflow conditions checked during layout creation */
+  start_bit_pos = obj->field_data[key_index].start;
+  field_len = obj->field_data[key_index].max_field_len;
 
   if (field_len > 64)
     field_len = 64;
 
-  if (field_len > obj->field_data[key_index].set_field_len)
-    field_len = obj->field_data[key_index].set_field_len;
+  if (field_len > obj->set_field_len[key_index])
+    field_len = obj->set_field_len[key_index];
 
   byte_pos = start_bit_pos / 8;
 
@@ -2042,7 +2715,8 @@ fiid_obj_get (fiid_obj_t obj,
           else
             end_bit_in_byte_pos = field_len_left;
 
-          if (bits_extract (obj->data[byte_pos + i],
+          /* see comment in _fiid_obj_set() on trailing byte */
+          if (bits_extract ((byte_pos + i) < obj->data_len ? obj->data[byte_pos + i] : 0,
                             start_bit_in_byte_pos,
                             end_bit_in_byte_pos,
                             &extracted_val) < 0)
@@ -2088,6 +2762,28 @@ fiid_obj_get (fiid_obj_t obj,
   return (1);
 }
 
+int
+fiid_obj_get (fiid_obj_t obj,
+              const char *field,
+              uint64_t *val)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!field || !val)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+    return (-1);
+
+  return (_fiid_obj_get (obj, key_index, val));
+}
+
 int
 FIID_OBJ_GET (fiid_obj_t obj,
               const char *field,
@@ -2110,32 +2806,73 @@ FIID_OBJ_GET (fiid_obj_t obj,
 }
 
 int
-fiid_obj_set_data (fiid_obj_t obj,
-                   const char *field,
-                   const void *data,
-                   unsigned int data_len)
+fiid_obj_get_by_handle (fiid_obj_t obj,
+                        fiid_field_handle_t handle,
+                        uint64_t *val)
 {
-  unsigned int field_offset, bytes_len, key_index;
-  int bits_len, field_start;
+  unsigned int key_index;
 
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
-  if (!field || !data)
+  if (!handle || !val)
     {
       obj->errnum = FIID_ERR_PARAMETERS;
       return (-1);
     }
 
-  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+  if (_fiid_obj_lookup_handle_index (obj, handle, &key_index) < 0)
     return (-1);
 
+  return (_fiid_obj_get (obj, key_index, val));
+}
+
+int
+FIID_OBJ_GET_BY_HANDLE (fiid_obj_t obj,
+                        fiid_field_handle_t handle,
+                        uint64_t *val)
+{
+  uint64_t lval;
+  int ret;
+
+  if ((ret = fiid_obj_get_by_handle (obj, handle, &lval)) < 0)
+    return (ret);
+
+  if (!ret)
+    {
+      obj->errnum = FIID_ERR_DATA_NOT_AVAILABLE;
+      return (-1);
+    }
+
+  *val = lval;
+  return (ret);
+}
+
+static int
+_fiid_obj_set_data (fiid_obj_t obj,
+                    unsigned int key_index,
+                    const void *data,
+                    unsigned int data_len)
+{
+  unsigned int field_offset, bytes_len;
+  unsigned int bits_len, field_start;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < obj->field_data_len);
+  assert (data);
+
+  if (obj->read_only)
+    {
+      obj->errnum = FIID_ERR_READ_ONLY;
+      return (-1);
+    }
+
   /* achu: We assume the field must start on a byte boundary and end
    * on a byte boundary.
    */
 
-  if ((field_start = _fiid_obj_field_start (obj, field)) < 0)
-    return (-1);
+  field_start = obj->field_data[key_index].start;
 
   if (field_start % 8)
     {
@@ -2143,8 +2880,7 @@ fiid_obj_set_data (fiid_obj_t obj,
       return (-1);
     }
 
-  if ((bits_len = _fiid_obj_field_len (obj, field)) < 0)
-    return (-1);
+  bits_len = obj->field_data[key_index].max_field_len;
 
   if (bits_len % 8)
     {
@@ -2158,20 +2894,19 @@ fiid_obj_set_data (fiid_obj_t obj,
 
   field_offset = BITS_ROUND_BYTES (field_start);
   memcpy ((obj->data + field_offset), data, data_len);
-  obj->field_data[key_index].set_field_len = (data_len * 8);
+  obj->set_field_len[key_index] = (data_len * 8);
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (data_len);
 }
 
 int
-fiid_obj_get_data (fiid_obj_t obj,
+fiid_obj_set_data (fiid_obj_t obj,
                    const char *field,
-                   void *data,
+                   const void *data,
                    unsigned int data_len)
 {
-  unsigned int field_offset, bytes_len, key_index;
-  int bits_len, field_start;
+  unsigned int key_index;
 
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
@@ -2185,15 +2920,54 @@ fiid_obj_get_data (fiid_obj_t obj,
   if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
     return (-1);
 
-  if (!obj->field_data[key_index].set_field_len)
+  return (_fiid_obj_set_data (obj, key_index, data, data_len));
+}
+
+int
+fiid_obj_set_data_by_handle (fiid_obj_t obj,
+                             fiid_field_handle_t handle,
+                             const void *data,
+                             unsigned int data_len)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!handle || !data)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (_fiid_obj_lookup_handle_index (obj, handle, &key_index) < 0)
+    return (-1);
+
+  return (_fiid_obj_set_data (obj, key_index, data, data_len));
+}
+
+static int
+_fiid_obj_get_data (fiid_obj_t obj,
+                    unsigned int key_index,
+                    void *data,
+                    unsigned int data_len)
+{
+  unsigned int field_offset, bytes_len;
+  unsigned int bits_len, field_start;
+
+  assert (obj);
+  assert (obj->magic == FIID_OBJ_MAGIC);
+  assert (key_index < obj->field_data_len);
+  assert (data);
+
+  if (!obj->set_field_len[key_index])
     return (0);
 
   /* achu: We assume the field must start on a byte boundary and end
    * on a byte boundary.
    */
 
-  if ((field_start = _fiid_obj_field_start (obj, field)) < 0)
-    return (-1);
+  field_start = obj->field_data[key_index].start;
 
   if (field_start % 8)
     {
@@ -2201,11 +2975,10 @@ fiid_obj_get_data (fiid_obj_t obj,
       return (-1);
     }
 
-  if ((bits_len = _fiid_obj_field_len (obj, field)) < 0)
-    return (-1);
+  bits_len = obj->field_data[key_index].max_field_len;
 
-  if (obj->field_data[key_index].set_field_len < bits_len)
-    bits_len = obj->field_data[key_index].set_field_len;
+  if (obj->set_field_len[key_index] < bits_len)
+    bits_len = obj->set_field_len[key_index];
 
   if (bits_len % 8)
     {
@@ -2230,69 +3003,78 @@ fiid_obj_get_data (fiid_obj_t obj,
 }
 
 int
-fiid_obj_set_all (fiid_obj_t obj,
-                  const void *data,
-                  unsigned int data_len)
+fiid_obj_get_data (fiid_obj_t obj,
+                   const char *field,
+                   void *data,
+                   unsigned int data_len)
 {
-  unsigned int bits_counter, data_bits_len;
-  unsigned int key_index_end;
-  unsigned int i;
+  unsigned int key_index;
 
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
-  if (!data)
+  if (!field || !data)
     {
       obj->errnum = FIID_ERR_PARAMETERS;
       return (-1);
     }
 
-  if (data_len > obj->data_len)
-    data_len = obj->data_len;
+  if (_fiid_obj_lookup_field_index (obj, field, &key_index) < 0)
+    return (-1);
 
-  /* achu: Find index of last field */
-  data_bits_len = data_len * 8;
-  if (data_len < obj->data_len)
-    {
-      /* integer overflow conditions checked during object creation */
-      bits_counter = 0;
-      for (i = 0; obj->field_data[i].max_field_len; i++)
-        {
-          bits_counter += obj->field_data[i].max_field_len;
-          if (bits_counter >= data_bits_len)
-            {
-              /* achu: We assume the data must end on a byte boundary. */
-              if (bits_counter % 8)
-                {
-                  obj->errnum = FIID_ERR_DATA_NOT_BYTE_ALIGNED;
-                  return (-1);
-                }
-              else
-                break;
-            }
+  return (_fiid_obj_get_data (obj, key_index, data, data_len));
+}
 
-        }
-      key_index_end = i;
+int
+fiid_obj_get_data_by_handle (fiid_obj_t obj,
+                             fiid_field_handle_t handle,
+                             void *data,
+                             unsigned int data_len)
+{
+  unsigned int key_index;
+
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (!handle || !data)
+    {
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
     }
-  else
-    key_index_end = (obj->field_data_len - 1);
 
-  memcpy (obj->data, data, data_len);
+  if (_fiid_obj_lookup_handle_index (obj, handle, &key_index) < 0)
+    return (-1);
 
-  /* integer overflow conditions checked during object creation */
-  bits_counter = 0;
-  for (i = 0; i < key_index_end; i++)
+  return (_fiid_obj_get_data (obj, key_index, data, data_len));
+}
+
+int
+fiid_obj_set_all (fiid_obj_t obj,
+                  const void *data,
+                  unsigned int data_len)
+{
+  if (!obj || obj->magic != FIID_OBJ_MAGIC)
+    return (-1);
+
+  if (obj->read_only)
     {
-      obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
-      bits_counter += obj->field_data[i].set_field_len;
+      obj->errnum = FIID_ERR_READ_ONLY;
+      return (-1);
     }
-  if (data_bits_len < bits_counter + obj->field_data[key_index_end].max_field_len)
+
+  if (!data)
     {
-      int data_bits_left = data_bits_len - bits_counter;
-      obj->field_data[i].set_field_len = data_bits_left;
+      obj->errnum = FIID_ERR_PARAMETERS;
+      return (-1);
     }
-  else
-    obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
+
+  if (data_len > obj->data_len)
+    data_len = obj->data_len;
+
+  if (_fiid_obj_set_all_field_len (obj, data_len) < 0)
+    return (-1);
+
+  memcpy (obj->data, data, data_len);
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (data_len);
@@ -2330,7 +3112,11 @@ fiid_obj_get_all (fiid_obj_t obj,
     }
 
   if (bytes_len == obj->data_len)
-    memcpy (data, obj->data, bytes_len);
+    {
+      /* an unbound view has no data at all */
+      if (bytes_len)
+        memcpy (data, obj->data, bytes_len);
+    }
   else
     {
       unsigned int bytes_written = 0, max_bits_counter = 0, set_bits_counter = 0,
@@ -2341,7 +3127,7 @@ fiid_obj_get_all (fiid_obj_t obj,
       for (i = 0; i < obj->field_data_len; i++)
         {
           unsigned int max_field_len = obj->field_data[i].max_field_len;
-          unsigned int set_field_len = obj->field_data[i].set_field_len;
+          unsigned int set_field_len = obj->set_field_len[i];
 
           max_bits_counter += max_field_len;
 
@@ -2477,6 +3263,12 @@ fiid_obj_set_block (fiid_obj_t obj,
   if (!obj || obj->magic != FIID_OBJ_MAGIC)
     return (-1);
 
+  if (obj->read_only)
+    {
+      obj->errnum = FIID_ERR_READ_ONLY;
+      return (-1);
+    }
+
   if (!field_start || !field_end || !data)
     {
       obj->errnum = FIID_ERR_PARAMETERS;
@@ -2557,16 +3349,16 @@ fiid_obj_set_block (fiid_obj_t obj,
   bits_counter = 0;
   for (i = key_index_start; i < key_index_end; i++)
     {
-      obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
-      bits_counter += obj->field_data[i].set_field_len;
+      obj->set_field_len[i] = obj->field_data[i].max_field_len;
+      bits_counter += obj->set_field_len[i];
     }
   if (data_bits_len < bits_counter + obj->field_data[key_index_end].max_field_len)
     {
       int data_bits_left = data_bits_len - bits_counter;
-      obj->field_data[i].set_field_len = data_bits_left;
+      obj->set_field_len[i] = data_bits_left;
     }
   else
-    obj->field_data[i].set_field_len = obj->field_data[i].max_field_len;
+    obj->set_field_len[i] = obj->field_data[i].max_field_len;
 
   obj->errnum = FIID_ERR_SUCCESS;
   return (data_len);
@@ -2660,7 +3452,7 @@ fiid_obj_get_block (fiid_obj_t obj,
       for (i = key_index_start; i <= key_index_end; i++)
         {
           unsigned int max_field_len = obj->field_data[i].max_field_len;
-          unsigned int set_field_len = obj->field_data[i].set_field_len;
+          unsigned int set_field_len = obj->set_field_len[i];
 
           max_bits_counter += max_field_len;
 
@@ -2866,7 +3658,7 @@ fiid_iterator_field_len (fiid_iterator_t iter)
 
   iter->errnum = FIID_ERR_SUCCESS;
   /* integer overflow conditions checked during object creation */
-  return (iter->obj->field_data[iter->current_index].set_field_len);
+  return (iter->obj->set_field_len[iter->current_index]);
 }
 
 char *
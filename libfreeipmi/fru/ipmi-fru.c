@@ -72,6 +72,8 @@
 #include "ipmi-fru-trace.h"
 #include "ipmi-fru-util.h"
 
+#include "api/ipmi-api-defs.h"
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -398,7 +400,7 @@ _read_fru_data (ipmi_fru_ctx_t ctx,
       goto out;
     }
 
-  if (!(fru_read_data_rs = fiid_obj_create (tmpl_cmd_read_fru_data_rs)))
+  if (!(fru_read_data_rs = obj_pool_get (&ctx->ipmi_ctx->obj_pool, tmpl_cmd_read_fru_data_rs)))
     {
       FRU_ERRNO_TO_FRU_ERRNUM (ctx, errno);
       goto cleanup;
@@ -497,7 +499,8 @@ _read_fru_data (ipmi_fru_ctx_t ctx,
  out:
   rv = 0;
  cleanup:
-  fiid_obj_destroy (fru_read_data_rs);
+  if (fru_read_data_rs)
+    obj_pool_put (&ctx->ipmi_ctx->obj_pool, fru_read_data_rs);
   return (rv);
 }
 
@@ -226,6 +226,11 @@ typedef enum ipmi_driver_type ipmi_driver_type_t;
  * workaround flag, all authentication codes will be ignored during
  * the entire IPMI session.  With this flag, specific packets can have
  * their authentication codes ignored.
+ *
+ * NO_SESSION_BROKER - for IPMI 2.0 sessions, always establish the
+ * session directly with the BMC, even if the ipmisessiond session
+ * broker is running.  Can only be set during opening, not later using
+ * ipmi_ctx_set_flags().
  */
 
 #define IPMI_FLAGS_DEFAULT                    0x00000000
@@ -235,6 +240,10 @@ typedef enum ipmi_driver_type ipmi_driver_type_t;
 #define IPMI_FLAGS_NO_VALID_CHECK             0x00000100
 #define IPMI_FLAGS_NO_LEGAL_CHECK             0x00000200
 #define IPMI_FLAGS_IGNORE_AUTHENTICATION_CODE 0x00000400
+#define IPMI_FLAGS_NO_SESSION_BROKER          0x00000800
+
+/* most requests ipmi_cmd_multi() will keep outstanding */
+#define IPMI_CMD_MULTI_MAX                    16
 
 typedef struct ipmi_ctx *ipmi_ctx_t;
 
@@ -251,6 +260,13 @@ int ipmi_ctx_get_flags (ipmi_ctx_t ctx, unsigned int *flags);
 /* for changing flags mid-operation for corner cases */
 int ipmi_ctx_set_flags (ipmi_ctx_t ctx, unsigned int flags);
 
+/* Number of times an internal fiid object was reused rather than
+ * allocated, e.g. when bridging commands or reading sensors, FRU
+ * data, SDR and SEL entries repeatedly through the context.
+ */
+int ipmi_ctx_get_allocations_avoided (ipmi_ctx_t ctx,
+                                      uint64_t *allocations_avoided);
+
 /* For IPMI 1.5 sessions */
 /* For session_timeout and retransmission_timeout, specify 0 for default */
 int ipmi_ctx_open_outofband (ipmi_ctx_t ctx,
@@ -339,6 +355,25 @@ int ipmi_cmd_ipmb (ipmi_ctx_t ctx,
                    fiid_obj_t obj_cmd_rq,
                    fiid_obj_t obj_cmd_rs);
 
+/* Perform 'count' independent commands, at most IPMI_CMD_MULTI_MAX.
+ *
+ * On IPMI 2.0 sessions all requests are sent before waiting for
+ * responses, each with its own requester sequence number, and
+ * responses are matched to requests as they arrive.  On other
+ * interfaces, or when a bridging target is set, the commands are
+ * performed one after another.
+ *
+ * All responses must use the same template.  As with ipmi_cmd(),
+ * completion codes are not checked, callers must check each
+ * response.
+ */
+int ipmi_cmd_multi (ipmi_ctx_t ctx,
+                    uint8_t lun,
+                    uint8_t net_fn,
+                    fiid_obj_t *obj_cmd_rq,
+                    fiid_obj_t *obj_cmd_rs,
+                    unsigned int count);
+
 /* for request/response, byte #1 = cmd */
 /* for response, byte #2 (typically) = completion code */
 /* returns length written into buf_fs on success, -1 on error */
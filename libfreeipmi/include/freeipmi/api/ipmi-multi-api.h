@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_MULTI_API_H
+#define IPMI_MULTI_API_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <freeipmi/api/ipmi-api.h>
+#include <freeipmi/fiid/fiid.h>
+
+/* Drive many IPMI 2.0 out-of-band contexts from a single thread.
+ *
+ * Contexts are opened as usual with ipmi_ctx_open_outofband_2_0()
+ * and then registered with ipmi_multi_ctx_add().  Commands submitted
+ * with ipmi_multi_cmd_submit() are queued per context and sent,
+ * received and retransmitted from within ipmi_multi_ctx_run().  One
+ * request is outstanding per context at a time.  Socket readiness is
+ * waited on with epoll(7) where available, poll(2) otherwise.
+ *
+ * Completion callbacks are called from ipmi_multi_ctx_run().  'rv' is
+ * 0 on success.  On failure 'rv' is -1 and the reason is available
+ * through ipmi_ctx_errnum() on the context.  As with ipmi_cmd(),
+ * completion codes are not checked.  Callbacks may submit further
+ * commands but must not remove contexts or destroy the multi context.
+ * Commands still queued when their context is removed, or the multi
+ * context destroyed, are discarded without calling their callbacks.
+ *
+ * Only contexts that talk IPMI 2.0 directly to the BMC can be
+ * registered, i.e. not those handed to ipmisessiond, not IPMI 1.5 or
+ * inband contexts and not those opened with IPMI_FLAGS_NOSESSION.
+ * Bridged commands are not supported.  A registered context must not
+ * be used with ipmi_cmd() and friends while it has commands queued.
+ * Closing a registered context removes it.
+ *
+ * By default every context uses its own UDP socket.  When polling
+ * very many BMCs, ipmi_multi_ctx_set_contexts_per_socket() lets up to
+ * 'count' contexts share one socket instead, responses being matched
+ * to contexts by session id.  Registered contexts must then only be
+ * used through the multi context.  Removing a context gives it a
+ * socket of its own again.
+ */
+
+typedef struct ipmi_multi_ctx *ipmi_multi_ctx_t;
+
+typedef void (*Ipmi_Multi_Cmd_Callback)(ipmi_ctx_t ctx,
+                                        int rv,
+                                        fiid_obj_t obj_cmd_rs,
+                                        void *callback_data);
+
+ipmi_multi_ctx_t ipmi_multi_ctx_create (void);
+
+/* errnums are those of ipmi_ctx_errnum() */
+int ipmi_multi_ctx_errnum (ipmi_multi_ctx_t mctx);
+
+char *ipmi_multi_ctx_errormsg (ipmi_multi_ctx_t mctx);
+
+/* 0, the default, disables sharing.  Can only be changed while no
+ * contexts are registered.
+ */
+int ipmi_multi_ctx_set_contexts_per_socket (ipmi_multi_ctx_t mctx,
+                                            unsigned int count);
+
+int ipmi_multi_ctx_add (ipmi_multi_ctx_t mctx, ipmi_ctx_t ctx);
+
+int ipmi_multi_ctx_remove (ipmi_multi_ctx_t mctx, ipmi_ctx_t ctx);
+
+/* obj_cmd_rq and obj_cmd_rs must remain valid until the callback is
+ * called, obj_cmd_rs is filled in before it.
+ */
+int ipmi_multi_cmd_submit (ipmi_multi_ctx_t mctx,
+                           ipmi_ctx_t ctx,
+                           uint8_t lun,
+                           uint8_t net_fn,
+                           fiid_obj_t obj_cmd_rq,
+                           fiid_obj_t obj_cmd_rs,
+                           Ipmi_Multi_Cmd_Callback callback,
+                           void *callback_data);
+
+/* Number of submitted commands that have not yet completed */
+int ipmi_multi_ctx_pending (ipmi_multi_ctx_t mctx);
+
+/* Wait up to 'timeout' milliseconds, -1 for no limit, for commands to
+ * complete.  Returns as soon as at least one command has completed,
+ * or immediately if none are pending.  Returns the number of
+ * commands completed, -1 on error.
+ */
+int ipmi_multi_ctx_run (ipmi_multi_ctx_t mctx, int timeout);
+
+void ipmi_multi_ctx_destroy (ipmi_multi_ctx_t mctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IPMI_MULTI_API_H */
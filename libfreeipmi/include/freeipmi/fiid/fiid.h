@@ -56,7 +56,8 @@ enum fiid_err
     FIID_ERR_NOT_IDENTICAL                   = 22,
     FIID_ERR_OUT_OF_MEMORY                   = 23,
     FIID_ERR_INTERNAL_ERROR                  = 24,
-    FIID_ERR_ERRNUMRANGE                     = 25
+    FIID_ERR_ERRNUMRANGE                     = 25,
+    FIID_ERR_READ_ONLY                       = 26
   };
 
 typedef enum fiid_err fiid_err_t;
@@ -171,6 +172,15 @@ typedef struct fiid_obj *fiid_obj_t;
 
 typedef struct fiid_iterator *fiid_iterator_t;
 
+/*
+ * FIID Field Handle
+ *
+ * A field key resolved once, see fiid_field_handle().  Handles are
+ * not tied to a template, a handle may be used with any object
+ * containing a field of the same key.
+ */
+typedef struct fiid_field_handle *fiid_field_handle_t;
+
 /*****************************
 * FIID Template API         *
 *****************************/
@@ -319,6 +329,27 @@ int FIID_TEMPLATE_COMPARE (fiid_template_t tmpl1,
  */
 void fiid_template_free (fiid_field_t *tmpl_dynamic);
 
+/*****************************
+* FIID Field Handle API     *
+*****************************/
+
+/*
+ * fiid_field_handle
+ *
+ * Returns a handle for the specified field key, NULL on error.
+ * Accessing fields by handle avoids resolving the key string on
+ * every call.  Handles are valid for the lifetime of the process and
+ * need not be freed, so they are typically resolved once and stored.
+ */
+fiid_field_handle_t fiid_field_handle (const char *field);
+
+/*
+ * fiid_field_handle_key
+ *
+ * Returns the field key of the handle, NULL on error.
+ */
+const char *fiid_field_handle_key (fiid_field_handle_t handle);
+
 /*****************************
 * FIID Object API           *
 *****************************/
@@ -338,6 +369,34 @@ char *fiid_strerror (fiid_err_t errnum);
  */
 fiid_obj_t fiid_obj_create (fiid_template_t tmpl);
 
+/*
+ * fiid_obj_create_view
+ *
+ * Return a read only fiid object based on the specified template
+ * whose data is the caller's buffer rather than a private copy.
+ * Fields are set as if by fiid_obj_set_all().  The buffer is not
+ * copied, it must remain valid and unmodified until the object is
+ * destroyed or rebound.  If data is NULL and data_len is 0, an empty
+ * view is returned, to be bound later with fiid_obj_view_bind().
+ * All functions that modify an object fail on a view with
+ * FIID_ERR_READ_ONLY.  Returns NULL on error.
+ */
+fiid_obj_t fiid_obj_create_view (fiid_template_t tmpl,
+                                 const void *data,
+                                 unsigned int data_len);
+
+/*
+ * fiid_obj_view_bind
+ *
+ * Rebind a view created by fiid_obj_create_view() to a new buffer,
+ * avoiding the cost of creating a new object.  If data is NULL and
+ * data_len is 0, the view is left empty.  On error the view is left
+ * empty.  Returns length of data bound on success, -1 on error.
+ */
+int fiid_obj_view_bind (fiid_obj_t obj,
+                        const void *data,
+                        unsigned int data_len);
+
 /*
  * fiid_obj_destroy
  *
@@ -348,8 +407,9 @@ void fiid_obj_destroy (fiid_obj_t obj);
 /*
  * fiid_obj_dup
  *
- * Create and return a duplicate object from the one specified.
- * Returns NULL on error.
+ * Create and return a duplicate object from the one specified.  The
+ * duplicate of a view is a regular writable object.  Returns NULL on
+ * error.
  */
 fiid_obj_t fiid_obj_dup (fiid_obj_t src_obj);
 
@@ -490,6 +550,14 @@ int fiid_obj_field_len (fiid_obj_t obj, const char *field);
  */
 int fiid_obj_field_len_bytes (fiid_obj_t obj, const char *field);
 
+/*
+ * fiid_obj_field_len_by_handle
+ *
+ * Identical to fiid_obj_field_len() except the field is specified by
+ * handle.
+ */
+int fiid_obj_field_len_by_handle (fiid_obj_t obj, fiid_field_handle_t handle);
+
 /*
  * fiid_obj_block_len
  *
@@ -575,6 +643,36 @@ int fiid_obj_get (fiid_obj_t obj, const char *field, uint64_t *val);
  */
 int FIID_OBJ_GET (fiid_obj_t obj, const char *field, uint64_t *val);
 
+/*
+ * fiid_obj_set_by_handle
+ *
+ * Identical to fiid_obj_set() except the field is specified by
+ * handle.
+ */
+int fiid_obj_set_by_handle (fiid_obj_t obj,
+                            fiid_field_handle_t handle,
+                            uint64_t val);
+
+/*
+ * fiid_obj_get_by_handle
+ *
+ * Identical to fiid_obj_get() except the field is specified by
+ * handle.
+ */
+int fiid_obj_get_by_handle (fiid_obj_t obj,
+                            fiid_field_handle_t handle,
+                            uint64_t *val);
+
+/*
+ * FIID_OBJ_GET_BY_HANDLE
+ *
+ * Identical to FIID_OBJ_GET() except the field is specified by
+ * handle.
+ */
+int FIID_OBJ_GET_BY_HANDLE (fiid_obj_t obj,
+                            fiid_field_handle_t handle,
+                            uint64_t *val);
+
 /*
  * fiid_obj_set_data
  *
@@ -602,6 +700,28 @@ int fiid_obj_get_data (fiid_obj_t obj,
                        void *data,
                        unsigned int data_len);
 
+/*
+ * fiid_obj_set_data_by_handle
+ *
+ * Identical to fiid_obj_set_data() except the field is specified by
+ * handle.
+ */
+int fiid_obj_set_data_by_handle (fiid_obj_t obj,
+                                 fiid_field_handle_t handle,
+                                 const void *data,
+                                 unsigned int data_len);
+
+/*
+ * fiid_obj_get_data_by_handle
+ *
+ * Identical to fiid_obj_get_data() except the field is specified by
+ * handle.
+ */
+int fiid_obj_get_data_by_handle (fiid_obj_t obj,
+                                 fiid_field_handle_t handle,
+                                 void *data,
+                                 unsigned int data_len);
+
 /*
  * fiid_obj_set_all
  *
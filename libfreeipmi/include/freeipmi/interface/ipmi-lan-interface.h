@@ -98,6 +98,65 @@ ssize_t ipmi_lan_recvfrom (int s,
                            struct sockaddr *from,
                            socklen_t *fromlen);
 
+/*
+ * Batched packet I/O
+ *
+ * For tools that talk to many BMCs at once.  Packets queued with
+ * ipmi_lan_sendq_add() are sent by ipmi_lan_sendq_flush(), with
+ * consecutively queued packets for the same socket handed to the
+ * kernel in one sendmmsg() call where it is available.
+ *
+ * ipmi_lan_recvq_read() reads, without blocking, as many packets as
+ * are waiting on a socket (up to the queue count) in one recvmmsg()
+ * call where it is available.  Packets are read into buffers
+ * allocated once at ipmi_lan_recvq_create() and remain valid until
+ * the next ipmi_lan_recvq_read().
+ *
+ * Without sendmmsg()/recvmmsg(), the same semantics are provided
+ * with sendto()/recvfrom() loops.
+ */
+typedef struct ipmi_lan_sendq *ipmi_lan_sendq_t;
+typedef struct ipmi_lan_recvq *ipmi_lan_recvq_t;
+
+/* returns NULL on error */
+ipmi_lan_sendq_t ipmi_lan_sendq_create (unsigned int count,
+                                        size_t pkt_len);
+
+/* buf is copied.  If the queue is full it is flushed first.
+ * returns 0 on success, -1 on error
+ */
+int ipmi_lan_sendq_add (ipmi_lan_sendq_t q,
+                        int s,
+                        const void *buf,
+                        size_t len,
+                        const struct sockaddr *to,
+                        socklen_t tolen);
+
+/* The queue is always emptied, packets not sent on error are dropped.
+ * returns number of packets sent on success, -1 on error
+ */
+int ipmi_lan_sendq_flush (ipmi_lan_sendq_t q);
+
+void ipmi_lan_sendq_destroy (ipmi_lan_sendq_t q);
+
+/* returns NULL on error */
+ipmi_lan_recvq_t ipmi_lan_recvq_create (unsigned int count,
+                                        size_t pkt_len);
+
+/* returns number of packets read on success, 0 if none waiting, -1 on error */
+int ipmi_lan_recvq_read (ipmi_lan_recvq_t q, int s);
+
+/* from and fromlen may be NULL.
+ * returns length of packet on success, -1 on error
+ */
+ssize_t ipmi_lan_recvq_packet (ipmi_lan_recvq_t q,
+                               unsigned int index,
+                               const void **buf,
+                               const struct sockaddr **from,
+                               socklen_t *fromlen);
+
+void ipmi_lan_recvq_destroy (ipmi_lan_recvq_t q);
+
 #ifdef __cplusplus
 }
 #endif
@@ -235,6 +235,24 @@ extern fiid_template_t tmpl_rmcpplus_rakp_message_4;
  */
 int ipmi_rmcpplus_init (void);
 
+/* ipmi_rmcpplus_crypt_cache_create
+ *
+ * Per-session crypt state.  Passed to the *_cached functions below,
+ * the keyed integrity (HMAC) and confidentiality (AES) handles are
+ * kept open between packets and only re-keyed when the keys passed
+ * in change, instead of being set up for every packet.  A cache
+ * holds copies of the keys and must not be used by multiple threads
+ * at the same time.  Passing a NULL cache is identical to calling
+ * the uncached functions.
+ *
+ * Returns cache on success, NULL on error.
+ */
+typedef struct ipmi_rmcpplus_crypt_cache *ipmi_rmcpplus_crypt_cache_t;
+
+ipmi_rmcpplus_crypt_cache_t ipmi_rmcpplus_crypt_cache_create (void);
+
+void ipmi_rmcpplus_crypt_cache_destroy (ipmi_rmcpplus_crypt_cache_t cache);
+
 int fill_rmcpplus_session_hdr (uint8_t payload_type,
                                uint8_t payload_authenticated,
                                uint8_t payload_encrypted,
@@ -298,6 +316,26 @@ int assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
                                 unsigned int pkt_len,
                                 unsigned int flags);
 
+/* returns length written to pkt on success, -1 on error */
+int assemble_ipmi_rmcpplus_pkt_cached (ipmi_rmcpplus_crypt_cache_t cache,
+                                       uint8_t authentication_algorithm,
+                                       uint8_t integrity_algorithm,
+                                       uint8_t confidentiality_algorithm,
+                                       const void *integrity_key,
+                                       unsigned int integrity_key_len,
+                                       const void *confidentiality_key,
+                                       unsigned int confidentiality_key_len,
+                                       const void *authentication_code_data,
+                                       unsigned int authentication_code_data_len,
+                                       fiid_obj_t obj_rmcp_hdr,
+                                       fiid_obj_t obj_rmcpplus_session_hdr,
+                                       fiid_obj_t obj_lan_msg_hdr,
+                                       fiid_obj_t obj_cmd,
+                                       fiid_obj_t obj_rmcpplus_session_trlr,
+                                       void *pkt,
+                                       unsigned int pkt_len,
+                                       unsigned int flags);
+
 /* returns 1 if fully unparsed, 0 if not, -1 on error */
 int unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
                                   uint8_t integrity_algorithm,
@@ -317,6 +355,26 @@ int unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
                                   fiid_obj_t obj_rmcpplus_session_trlr,
                                   unsigned int flags);
 
+/* returns 1 if fully unparsed, 0 if not, -1 on error */
+int unassemble_ipmi_rmcpplus_pkt_cached (ipmi_rmcpplus_crypt_cache_t cache,
+                                         uint8_t authentication_algorithm,
+                                         uint8_t integrity_algorithm,
+                                         uint8_t confidentiality_algorithm,
+                                         const void *integrity_key,
+                                         unsigned int integrity_key_len,
+                                         const void *confidentiality_key,
+                                         unsigned int confidentiality_key_len,
+                                         const void *pkt,
+                                         unsigned int pkt_len,
+                                         fiid_obj_t obj_rmcp_hdr,
+                                         fiid_obj_t obj_rmcpplus_session_hdr,
+                                         fiid_obj_t obj_rmcpplus_payload,
+                                         fiid_obj_t obj_lan_msg_hdr,
+                                         fiid_obj_t obj_cmd,
+                                         fiid_obj_t obj_lan_msg_trlr,
+                                         fiid_obj_t obj_rmcpplus_session_trlr,
+                                         unsigned int flags);
+
 /* returns length sent on success, -1 on error */
 /* A few extra error checks, but nearly identical to system sendto() */
 ssize_t ipmi_rmcpplus_sendto (int s,
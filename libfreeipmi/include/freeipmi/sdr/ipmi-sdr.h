@@ -79,8 +79,22 @@ extern "C" {
 #define IPMI_SDR_ERR_INTERNAL_ERROR                               27
 #define IPMI_SDR_ERR_ERRNUMRANGE                                  28
 
+/* SDR Context Flags
+ *
+ * DEBUG_DUMP - dump SDR records as they are read.
+ *
+ * DECODED_CACHE - decode every record once in ipmi_sdr_cache_open()
+ * and answer the common parse functions (record id and type, owner,
+ * number, entity, sensor type, event/reading type code, id string,
+ * units, decoding data, raw thresholds) from the decoded table when
+ * they are called on the current cache record (i.e. with a NULL
+ * record and 0 length).  Must be set before the cache is opened.
+ * Trades memory and a slower open for faster parsing when many
+ * records are parsed.
+ */
 #define IPMI_SDR_FLAGS_DEFAULT                   0x0000
 #define IPMI_SDR_FLAGS_DEBUG_DUMP                0x0001
+#define IPMI_SDR_FLAGS_DECODED_CACHE             0x0002
 
 /* Flags just for cache creation
  *
@@ -91,11 +105,16 @@ extern "C" {
  * ASSUME_MAX_SDR_RECORD_COUNT - If motherboard does not implement SDR
  * record reading properly, this workaround will allow code to not
  * fail out.
+ *
+ * PIPELINED - keep several Get SDR requests outstanding at once.
+ * Only effective on IPMI 2.0 sessions, see ipmi_cmd_multi().
+ * Records that cannot be read in one request are read normally.
  */
 #define IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT                     0x00
 #define IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE                   0x01
 #define IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID         0x02
 #define IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT 0x04
+#define IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED                   0x08
 
 #define IPMI_SDR_SENSOR_NAME_FLAGS_DEFAULT                       0x00000000
 #define IPMI_SDR_SENSOR_NAME_FLAGS_IGNORE_SHARED_SENSORS         0x00000001
@@ -143,6 +162,12 @@ int ipmi_sdr_ctx_set_flags (ipmi_sdr_ctx_t ctx, unsigned int flags);
 char *ipmi_sdr_ctx_get_debug_prefix (ipmi_sdr_ctx_t ctx);
 int ipmi_sdr_ctx_set_debug_prefix (ipmi_sdr_ctx_t ctx, const char *debug_prefix);
 
+/* Number of times a record object was reused rather than allocated
+ * while parsing or caching SDR records with this context.
+ */
+int ipmi_sdr_ctx_get_allocations_avoided (ipmi_sdr_ctx_t ctx,
+                                          uint64_t *allocations_avoided);
+
 /*
  * SDR Cache Creation Functions
  */
@@ -156,6 +181,48 @@ int ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
                            Ipmi_Sdr_Cache_Create_Callback create_callback,
                            void *create_callback_data);
 
+/* ipmi_sdr_cache_update
+ * - like ipmi_sdr_cache_create, but if the SDR version and most
+ *   recent erase timestamp of the BMC match the existing cache in
+ *   'filename', nothing was deleted since it was made and only
+ *   records added since are downloaded.  The other records are
+ *   reused after reading just their headers.  Otherwise the entire
+ *   SDR is downloaded.
+ * - the new cache is written to a temporary file and renamed over
+ *   'filename', readers of the old cache are unaffected
+ * - if 'filename' does not exist or is invalid, the entire SDR is
+ *   downloaded
+ * - IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE is implied,
+ *   IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED only applies when the
+ *   entire SDR is downloaded
+ */
+int ipmi_sdr_cache_update (ipmi_sdr_ctx_t ctx,
+                           ipmi_ctx_t ipmi_ctx,
+                           const char *filename,
+                           int cache_create_flags,
+                           Ipmi_Sdr_Cache_Create_Callback create_callback,
+                           void *create_callback_data);
+
+/* ipmi_sdr_cache_create_shared
+ * - like ipmi_sdr_cache_create, but 'filename' becomes a symlink to
+ *   a cache shared by every host whose BMC reports the same
+ *   manufacturer id, product id, firmware and auxiliary firmware
+ *   revisions, SDR version, record count, and addition/erase
+ *   timestamps
+ * - shared caches live in shared_directory, named by the SHA-256 of
+ *   their contents, and are verified against that name before reuse
+ * - the SDR is only downloaded if no valid shared cache exists
+ * - shared_directory is created if it does not exist
+ * - ipmi_sdr_cache_delete() removes only the per-host link
+ */
+int ipmi_sdr_cache_create_shared (ipmi_sdr_ctx_t ctx,
+                                  ipmi_ctx_t ipmi_ctx,
+                                  const char *filename,
+                                  const char *shared_directory,
+                                  int cache_create_flags,
+                                  Ipmi_Sdr_Cache_Create_Callback create_callback,
+                                  void *create_callback_data);
+
 /*
  * SDR Cache Reading Functions
  */
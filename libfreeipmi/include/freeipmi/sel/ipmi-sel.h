@@ -49,9 +49,14 @@ extern "C" {
 #define IPMI_SEL_ERR_INTERNAL_ERROR                         17
 #define IPMI_SEL_ERR_ERRNUMRANGE                            18
 
+/* PIPELINED - once record ids are seen to be sequential, keep several
+ * Get SEL Entry requests outstanding at once in ipmi_sel_parse().
+ * Only effective on IPMI 2.0 sessions, see ipmi_cmd_multi().
+ */
 #define IPMI_SEL_FLAGS_DEFAULT                              0x0000
 #define IPMI_SEL_FLAGS_DEBUG_DUMP                           0x0001
 #define IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS           0x0002
+#define IPMI_SEL_FLAGS_PIPELINED                            0x0004
 
 #define IPMI_SEL_PARAMETER_INTERPRET_CONTEXT                0x0001
 #define IPMI_SEL_PARAMETER_UTC_OFFSET                       0x0002
@@ -107,6 +112,12 @@ char * ipmi_sel_ctx_errormsg (ipmi_sel_ctx_t ctx);
 int ipmi_sel_ctx_get_flags (ipmi_sel_ctx_t ctx, unsigned int *flags);
 int ipmi_sel_ctx_set_flags (ipmi_sel_ctx_t ctx, unsigned int flags);
 
+/* Number of times a record object was reused rather than allocated
+ * while reading or parsing SEL entries with this context.
+ */
+int ipmi_sel_ctx_get_allocations_avoided (ipmi_sel_ctx_t ctx,
+                                          uint64_t *allocations_avoided);
+
 /* for use w/ string parsing w/ IPMI_SEL_STRING_FLAGS_INTERPRET_OEM_DATA */
 int ipmi_sel_ctx_get_manufacturer_id (ipmi_sel_ctx_t ctx, uint32_t *manufacturer_id);
 int ipmi_sel_ctx_set_manufacturer_id (ipmi_sel_ctx_t ctx, uint32_t manufacturer_id);
@@ -200,6 +211,19 @@ int ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
                                Ipmi_Sel_Parse_Callback callback,
                                void *callback_data);
 
+/* ipmi_sel_parse_buffer
+ * - like ipmi_sel_parse, but SEL records are taken from buf (e.g. a
+ *   local copy of the SEL) instead of being read from the BMC.  An
+ *   ipmi_ctx is not required.
+ * - buf holds buflen / IPMI_SEL_RECORD_MAX_RECORD_LENGTH records
+ * - Returns the number of entries parsed
+ */
+int ipmi_sel_parse_buffer (ipmi_sel_ctx_t ctx,
+                           const void *buf,
+                           unsigned int buflen,
+                           Ipmi_Sel_Parse_Callback callback,
+                           void *callback_data);
+
 /* SEL data retrieval functions after SEL is parsed
  *
  * seek_record_id moves the iterator to the closest record_id >= record_id
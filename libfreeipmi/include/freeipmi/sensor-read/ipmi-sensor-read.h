@@ -25,6 +25,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <freeipmi/api/ipmi-api.h>
+#include <freeipmi/api/ipmi-multi-api.h>
 #include <freeipmi/sdr/ipmi-sdr.h>
 
 /* note: SENSOR_READING_UNAVAILABLE and SENSOR_SCANNING_DISABLED are
@@ -108,6 +109,53 @@ int ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
                       double **sensor_reading,
                       uint16_t *sensor_event_bitmask);
 
+/*
+ * Read the sensors of the records in 'record_ids' ahead of time,
+ * keeping several Get Sensor Reading requests outstanding on the
+ * session (see ipmi_cmd_multi()).  If record_ids is NULL, the
+ * sensors of every record in the SDR cache are read.  Later calls to
+ * ipmi_sensor_read() use the prefetched responses, each one once,
+ * instead of sending a request.  Prefetching again discards any
+ * unused responses.
+ *
+ * Only sensors read directly from the BMC are prefetched, shared
+ * sensors beyond the first in a record and bridged sensors are read
+ * by ipmi_sensor_read() as usual.  The SDR cache position of sdr_ctx
+ * is changed.
+ *
+ * Returns 0 on success, -1 on error.  Responses prefetched before an
+ * error may still be used.
+ */
+int ipmi_sensor_read_prefetch (ipmi_sensor_read_ctx_t ctx,
+                               ipmi_sdr_ctx_t sdr_ctx,
+                               const unsigned int *record_ids,
+                               unsigned int record_ids_len);
+
+typedef void (*Ipmi_Sensor_Read_Prefetch_Callback)(ipmi_sensor_read_ctx_t ctx,
+                                                   void *callback_data);
+
+/*
+ * Like ipmi_sensor_read_prefetch(), but the Get Sensor Reading
+ * requests are submitted to 'mctx' (see ipmi_multi_cmd_submit()),
+ * with which the IPMI context of 'ctx' must be registered.  Many
+ * contexts can then be prefetched from one thread by
+ * ipmi_multi_ctx_run(), which calls 'callback' once all of the
+ * context's requests have completed.  Sensors whose request failed
+ * are read by ipmi_sensor_read() as usual.  'ctx' must not be used
+ * until the callback is called, unless the IPMI context is removed
+ * from 'mctx' first.
+ *
+ * Returns 1 if requests were submitted, 0 if there is nothing to
+ * prefetch and callback will not be called, -1 on error.
+ */
+int ipmi_sensor_read_prefetch_submit (ipmi_sensor_read_ctx_t ctx,
+                                      ipmi_sdr_ctx_t sdr_ctx,
+                                      const unsigned int *record_ids,
+                                      unsigned int record_ids_len,
+                                      ipmi_multi_ctx_t mctx,
+                                      Ipmi_Sensor_Read_Prefetch_Callback callback,
+                                      void *callback_data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <freeipmi/fiid/fiid.h>
+#include <freeipmi/interface/ipmi-rmcpplus-interface.h>
 
 /* return length of data written into buffer on success, -1 on error */
 int ipmi_calculate_sik (uint8_t authentication_algorithm,
@@ -145,6 +146,17 @@ int ipmi_rmcpplus_check_packet_session_authentication_code (uint8_t integrity_al
                                                             unsigned int authentication_code_data_len,
                                                             fiid_obj_t obj_rmcpplus_session_trlr);
 
+/* returns 1 on pass, 0 on fail, -1 on error */
+int ipmi_rmcpplus_check_packet_session_authentication_code_cached (ipmi_rmcpplus_crypt_cache_t cache,
+                                                                   uint8_t integrity_algorithm,
+                                                                   const void *pkt,
+                                                                   unsigned int pkt_len,
+                                                                   const void *integrity_key,
+                                                                   unsigned int integrity_key_len,
+                                                                   const void *authentication_code_data,
+                                                                   unsigned int authentication_code_data_len,
+                                                                   fiid_obj_t obj_rmcpplus_session_trlr);
+
 /* returns 1 on pass, 0 on fail, -1 on error */
 int ipmi_rmcpplus_check_payload_type (fiid_obj_t obj_rmcpplus_session_hdr,
                                       uint8_t payload_type);
@@ -25,7 +25,12 @@
 #ifdef STDC_HEADERS
 #include <string.h>
 #endif /* STDC_HEADERS */
+#include <stdint.h>
+#include <assert.h>
 #include <errno.h>
+#include <sys/uio.h>
+
+#include "freeipmi/interface/ipmi-lan-interface.h"
 
 #include "ipmi-network.h"
 #include "libcommon/ipmi-trace.h"
@@ -84,3 +89,470 @@ ipmi_network_recvfrom (int s,
   return (rv);
 }
 
+
+struct ipmi_lan_sendq_pkt
+{
+  int s;
+  uint8_t *buf;
+  size_t len;
+  struct sockaddr_storage to;
+  socklen_t tolen;
+};
+
+struct ipmi_lan_sendq
+{
+  struct ipmi_lan_sendq_pkt *pkts;
+  uint8_t *bufs;
+  unsigned int count;
+  unsigned int pkts_len;
+  size_t pkt_len;
+#ifdef HAVE_SENDMMSG
+  struct mmsghdr *msgs;
+  struct iovec *iovs;
+#endif /* HAVE_SENDMMSG */
+};
+
+struct ipmi_lan_recvq
+{
+  uint8_t *bufs;
+  unsigned int count;
+  unsigned int pkts_len;
+  size_t pkt_len;
+  size_t *lens;
+  struct sockaddr_storage *froms;
+  socklen_t *fromlens;
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr *msgs;
+  struct iovec *iovs;
+#endif /* HAVE_RECVMMSG */
+};
+
+ipmi_lan_sendq_t
+ipmi_lan_sendq_create (unsigned int count, size_t pkt_len)
+{
+  struct ipmi_lan_sendq *q = NULL;
+  unsigned int i;
+
+  if (!count
+      || !pkt_len)
+    {
+      SET_ERRNO (EINVAL);
+      return (NULL);
+    }
+
+  if (!(q = (struct ipmi_lan_sendq *)malloc (sizeof (struct ipmi_lan_sendq))))
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+  memset (q, '\0', sizeof (struct ipmi_lan_sendq));
+  q->count = count;
+  q->pkt_len = pkt_len;
+
+  if (!(q->pkts = (struct ipmi_lan_sendq_pkt *)calloc (count, sizeof (struct ipmi_lan_sendq_pkt))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(q->bufs = (uint8_t *)calloc (count, pkt_len)))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+#ifdef HAVE_SENDMMSG
+  if (!(q->msgs = (struct mmsghdr *)calloc (count, sizeof (struct mmsghdr))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(q->iovs = (struct iovec *)calloc (count, sizeof (struct iovec))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+#endif /* HAVE_SENDMMSG */
+
+  for (i = 0; i < count; i++)
+    q->pkts[i].buf = q->bufs + (i * pkt_len);
+
+  return (q);
+
+ cleanup:
+  ipmi_lan_sendq_destroy (q);
+  return (NULL);
+}
+
+int
+ipmi_lan_sendq_add (ipmi_lan_sendq_t q,
+                    int s,
+                    const void *buf,
+                    size_t len,
+                    const struct sockaddr *to,
+                    socklen_t tolen)
+{
+  struct ipmi_lan_sendq_pkt *pkt;
+
+  if (!q
+      || !buf
+      || !len
+      || !to
+      || !tolen
+      || tolen > sizeof (struct sockaddr_storage))
+    {
+      SET_ERRNO (EINVAL);
+      return (-1);
+    }
+
+  if (len > q->pkt_len)
+    {
+      SET_ERRNO (EMSGSIZE);
+      return (-1);
+    }
+
+  if (q->pkts_len == q->count)
+    {
+      if (ipmi_lan_sendq_flush (q) < 0)
+        return (-1);
+    }
+
+  pkt = &q->pkts[q->pkts_len];
+  pkt->s = s;
+  memcpy (pkt->buf, buf, len);
+  pkt->len = len;
+  memcpy (&pkt->to, to, tolen);
+  pkt->tolen = tolen;
+  q->pkts_len++;
+  return (0);
+}
+
+#ifdef HAVE_SENDMMSG
+/* sends pkts [start, end), all for the same socket */
+static int
+_sendq_flush_run (struct ipmi_lan_sendq *q, unsigned int start, unsigned int end)
+{
+  unsigned int i;
+  int count = 0;
+
+  assert (q);
+  assert (start < end);
+
+  for (i = start; i < end; i++)
+    {
+      q->iovs[i].iov_base = q->pkts[i].buf;
+      q->iovs[i].iov_len = q->pkts[i].len;
+      memset (&q->msgs[i], '\0', sizeof (struct mmsghdr));
+      q->msgs[i].msg_hdr.msg_name = &q->pkts[i].to;
+      q->msgs[i].msg_hdr.msg_namelen = q->pkts[i].tolen;
+      q->msgs[i].msg_hdr.msg_iov = &q->iovs[i];
+      q->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  /* sendmmsg() may send only some of the packets, so loop on the rest */
+  i = start;
+  while (i < end)
+    {
+      int n;
+
+      if ((n = sendmmsg (q->pkts[start].s, &q->msgs[i], end - i, 0)) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          ERRNO_TRACE (errno);
+          return (-1);
+        }
+
+      i += n;
+      count += n;
+    }
+
+  return (count);
+}
+#else /* !HAVE_SENDMMSG */
+static int
+_sendq_flush_run (struct ipmi_lan_sendq *q, unsigned int start, unsigned int end)
+{
+  unsigned int i;
+  int count = 0;
+
+  assert (q);
+  assert (start < end);
+
+  i = start;
+  while (i < end)
+    {
+      if (sendto (q->pkts[i].s,
+                  q->pkts[i].buf,
+                  q->pkts[i].len,
+                  0,
+                  (struct sockaddr *)&q->pkts[i].to,
+                  q->pkts[i].tolen) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          ERRNO_TRACE (errno);
+          return (-1);
+        }
+      i++;
+      count++;
+    }
+
+  return (count);
+}
+#endif /* !HAVE_SENDMMSG */
+
+int
+ipmi_lan_sendq_flush (ipmi_lan_sendq_t q)
+{
+  unsigned int start = 0;
+  int count = 0;
+  int rv = -1;
+
+  if (!q)
+    {
+      SET_ERRNO (EINVAL);
+      return (-1);
+    }
+
+  while (start < q->pkts_len)
+    {
+      unsigned int end = start + 1;
+      int n;
+
+      while (end < q->pkts_len
+             && q->pkts[end].s == q->pkts[start].s)
+        end++;
+
+      if ((n = _sendq_flush_run (q, start, end)) < 0)
+        goto cleanup;
+
+      count += n;
+      start = end;
+    }
+
+  rv = count;
+ cleanup:
+  q->pkts_len = 0;
+  return (rv);
+}
+
+void
+ipmi_lan_sendq_destroy (ipmi_lan_sendq_t q)
+{
+  if (!q)
+    return;
+
+  free (q->pkts);
+  free (q->bufs);
+#ifdef HAVE_SENDMMSG
+  free (q->msgs);
+  free (q->iovs);
+#endif /* HAVE_SENDMMSG */
+  free (q);
+}
+
+ipmi_lan_recvq_t
+ipmi_lan_recvq_create (unsigned int count, size_t pkt_len)
+{
+  struct ipmi_lan_recvq *q = NULL;
+
+  if (!count
+      || !pkt_len)
+    {
+      SET_ERRNO (EINVAL);
+      return (NULL);
+    }
+
+  if (!(q = (struct ipmi_lan_recvq *)malloc (sizeof (struct ipmi_lan_recvq))))
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+  memset (q, '\0', sizeof (struct ipmi_lan_recvq));
+  q->count = count;
+  q->pkt_len = pkt_len;
+
+  if (!(q->bufs = (uint8_t *)calloc (count, pkt_len)))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(q->lens = (size_t *)calloc (count, sizeof (size_t))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(q->froms = (struct sockaddr_storage *)calloc (count, sizeof (struct sockaddr_storage))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(q->fromlens = (socklen_t *)calloc (count, sizeof (socklen_t))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+#ifdef HAVE_RECVMMSG
+  if (!(q->msgs = (struct mmsghdr *)calloc (count, sizeof (struct mmsghdr))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+
+  if (!(q->iovs = (struct iovec *)calloc (count, sizeof (struct iovec))))
+    {
+      ERRNO_TRACE (errno);
+      goto cleanup;
+    }
+#endif /* HAVE_RECVMMSG */
+
+  return (q);
+
+ cleanup:
+  ipmi_lan_recvq_destroy (q);
+  return (NULL);
+}
+
+#ifdef HAVE_RECVMMSG
+static int
+_recvq_read (struct ipmi_lan_recvq *q, int s)
+{
+  unsigned int i;
+  int n;
+
+  assert (q);
+
+  for (i = 0; i < q->count; i++)
+    {
+      q->iovs[i].iov_base = q->bufs + (i * q->pkt_len);
+      q->iovs[i].iov_len = q->pkt_len;
+      memset (&q->msgs[i], '\0', sizeof (struct mmsghdr));
+      q->msgs[i].msg_hdr.msg_name = &q->froms[i];
+      q->msgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_storage);
+      q->msgs[i].msg_hdr.msg_iov = &q->iovs[i];
+      q->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  do {
+    n = recvmmsg (s, q->msgs, q->count, MSG_DONTWAIT, NULL);
+  } while (n < 0 && errno == EINTR);
+
+  if (n < 0)
+    {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return (0);
+      ERRNO_TRACE (errno);
+      return (-1);
+    }
+
+  for (i = 0; i < (unsigned int)n; i++)
+    {
+      q->lens[i] = q->msgs[i].msg_len;
+      q->fromlens[i] = q->msgs[i].msg_hdr.msg_namelen;
+    }
+
+  return (n);
+}
+#else /* !HAVE_RECVMMSG */
+static int
+_recvq_read (struct ipmi_lan_recvq *q, int s)
+{
+  unsigned int i = 0;
+
+  assert (q);
+
+  while (i < q->count)
+    {
+      ssize_t len;
+
+      q->fromlens[i] = sizeof (struct sockaddr_storage);
+      if ((len = recvfrom (s,
+                           q->bufs + (i * q->pkt_len),
+                           q->pkt_len,
+                           MSG_DONTWAIT,
+                           (struct sockaddr *)&q->froms[i],
+                           &q->fromlens[i])) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+          /* report the error on the next read, like recvmmsg() */
+          if (i)
+            break;
+          ERRNO_TRACE (errno);
+          return (-1);
+        }
+      q->lens[i] = len;
+      i++;
+    }
+
+  return (i);
+}
+#endif /* !HAVE_RECVMMSG */
+
+int
+ipmi_lan_recvq_read (ipmi_lan_recvq_t q, int s)
+{
+  int n;
+
+  if (!q)
+    {
+      SET_ERRNO (EINVAL);
+      return (-1);
+    }
+
+  q->pkts_len = 0;
+
+  if ((n = _recvq_read (q, s)) < 0)
+    return (-1);
+
+  q->pkts_len = n;
+  return (n);
+}
+
+ssize_t
+ipmi_lan_recvq_packet (ipmi_lan_recvq_t q,
+                       unsigned int index,
+                       const void **buf,
+                       const struct sockaddr **from,
+                       socklen_t *fromlen)
+{
+  if (!q
+      || index >= q->pkts_len
+      || !buf)
+    {
+      SET_ERRNO (EINVAL);
+      return (-1);
+    }
+
+  *buf = q->bufs + (index * q->pkt_len);
+  if (from)
+    *from = (const struct sockaddr *)&q->froms[index];
+  if (fromlen)
+    *fromlen = q->fromlens[index];
+  return (q->lens[index]);
+}
+
+void
+ipmi_lan_recvq_destroy (ipmi_lan_recvq_t q)
+{
+  if (!q)
+    return;
+
+  free (q->bufs);
+  free (q->lens);
+  free (q->froms);
+  free (q->fromlens);
+#ifdef HAVE_RECVMMSG
+  free (q->msgs);
+  free (q->iovs);
+#endif /* HAVE_RECVMMSG */
+  free (q);
+}
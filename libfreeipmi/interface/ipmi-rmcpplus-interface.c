@@ -28,6 +28,9 @@
 #include <limits.h>
 #include <assert.h>
 #include <errno.h>
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include "freeipmi/interface/ipmi-rmcpplus-interface.h"
 #include "freeipmi/cmds/ipmi-messaging-support-cmds.h"
@@ -212,14 +215,97 @@ fiid_template_t tmpl_rmcpplus_rakp_message_4 =
     { 0, "", 0}
   };
 
+/* Session header, payload, and session trailer fields accessed on
+ * every packet assembled or unassembled, resolved to field handles
+ * once.
+ */
+static fiid_field_handle_t rmcpplus_payload_type_handle;
+static fiid_field_handle_t rmcpplus_payload_type_authenticated_handle;
+static fiid_field_handle_t rmcpplus_payload_type_encrypted_handle;
+static fiid_field_handle_t rmcpplus_session_id_handle;
+static fiid_field_handle_t rmcpplus_session_sequence_number_handle;
+static fiid_field_handle_t rmcpplus_ipmi_payload_len_handle;
+static fiid_field_handle_t rmcpplus_payload_data_handle;
+static fiid_field_handle_t rmcpplus_confidentiality_header_handle;
+static fiid_field_handle_t rmcpplus_confidentiality_trailer_handle;
+static fiid_field_handle_t rmcpplus_integrity_pad_handle;
+static fiid_field_handle_t rmcpplus_pad_length_handle;
+static fiid_field_handle_t rmcpplus_next_header_handle;
+static fiid_field_handle_t rmcpplus_authentication_code_handle;
+
+static pthread_once_t rmcpplus_field_handles_once = PTHREAD_ONCE_INIT;
+static int rmcpplus_field_handles_errnum = 0;
+
+static void
+_rmcpplus_field_handles_init_once (void)
+{
+  if (!(rmcpplus_payload_type_handle = fiid_field_handle ("payload_type"))
+      || !(rmcpplus_payload_type_authenticated_handle = fiid_field_handle ("payload_type.authenticated"))
+      || !(rmcpplus_payload_type_encrypted_handle = fiid_field_handle ("payload_type.encrypted"))
+      || !(rmcpplus_session_id_handle = fiid_field_handle ("session_id"))
+      || !(rmcpplus_session_sequence_number_handle = fiid_field_handle ("session_sequence_number"))
+      || !(rmcpplus_ipmi_payload_len_handle = fiid_field_handle ("ipmi_payload_len"))
+      || !(rmcpplus_payload_data_handle = fiid_field_handle ("payload_data"))
+      || !(rmcpplus_confidentiality_header_handle = fiid_field_handle ("confidentiality_header"))
+      || !(rmcpplus_confidentiality_trailer_handle = fiid_field_handle ("confidentiality_trailer"))
+      || !(rmcpplus_integrity_pad_handle = fiid_field_handle ("integrity_pad"))
+      || !(rmcpplus_pad_length_handle = fiid_field_handle ("pad_length"))
+      || !(rmcpplus_next_header_handle = fiid_field_handle ("next_header"))
+      || !(rmcpplus_authentication_code_handle = fiid_field_handle ("authentication_code")))
+    rmcpplus_field_handles_errnum = errno ? errno : ENOMEM;
+}
+
+static int
+_rmcpplus_field_handles_init (void)
+{
+  int perr;
+
+  if ((perr = pthread_once (&rmcpplus_field_handles_once,
+                            _rmcpplus_field_handles_init_once)))
+    {
+      ERRNO_TRACE (perr);
+      return (-1);
+    }
+
+  if (rmcpplus_field_handles_errnum)
+    {
+      ERRNO_TRACE (rmcpplus_field_handles_errnum);
+      return (-1);
+    }
+
+  return (0);
+}
+
 int
 ipmi_rmcpplus_init (void)
 {
   if (crypt_init ())
     return (-1);
+  if (_rmcpplus_field_handles_init () < 0)
+    return (-1);
   return (0);
 }
 
+ipmi_rmcpplus_crypt_cache_t
+ipmi_rmcpplus_crypt_cache_create (void)
+{
+  ipmi_rmcpplus_crypt_cache_t cache;
+
+  if (!(cache = crypt_cache_create ()))
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+
+  return (cache);
+}
+
+void
+ipmi_rmcpplus_crypt_cache_destroy (ipmi_rmcpplus_crypt_cache_t cache)
+{
+  crypt_cache_destroy (cache);
+}
+
 int
 fill_rmcpplus_session_hdr (uint8_t payload_type,
                            uint8_t payload_authenticated,
@@ -712,10 +798,10 @@ _construct_payload_confidentiality_none (uint8_t payload_type,
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         payload_buf,
-                         payload_len) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_payload_data_handle,
+                                   payload_buf,
+                                   payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -725,7 +811,8 @@ _construct_payload_confidentiality_none (uint8_t payload_type,
 }
 
 static int
-_construct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
+_construct_payload_confidentiality_aes_cbc_128 (ipmi_rmcpplus_crypt_cache_t cache,
+                                                uint8_t payload_type,
                                                 uint8_t payload_encrypted,
                                                 fiid_obj_t obj_lan_msg_hdr,
                                                 fiid_obj_t obj_cmd,
@@ -826,14 +913,15 @@ _construct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
   payload_buf[payload_len + pad_len] = pad_len;
 
   /* +1 for pad length field */
-  if ((encrypt_len = crypt_cipher_encrypt (IPMI_CRYPT_CIPHER_AES,
-                                           IPMI_CRYPT_CIPHER_MODE_CBC,
-                                           confidentiality_key,
-                                           confidentiality_key_len,
-                                           iv,
-                                           iv_len,
-                                           payload_buf,
-                                           payload_len + pad_len + 1)) < 0)
+  if ((encrypt_len = crypt_cipher_encrypt_cached (cache,
+                                                  IPMI_CRYPT_CIPHER_AES,
+                                                  IPMI_CRYPT_CIPHER_MODE_CBC,
+                                                  confidentiality_key,
+                                                  confidentiality_key_len,
+                                                  iv,
+                                                  iv_len,
+                                                  payload_buf,
+                                                  payload_len + pad_len + 1)) < 0)
     {
       ERRNO_TRACE (errno);
       return (-1);
@@ -845,28 +933,28 @@ _construct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_header",
-                         iv,
-                         IPMI_CRYPT_AES_CBC_128_IV_LENGTH) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_confidentiality_header_handle,
+                                   iv,
+                                   IPMI_CRYPT_AES_CBC_128_IV_LENGTH) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         payload_buf,
-                         payload_len) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_payload_data_handle,
+                                   payload_buf,
+                                   payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_trailer",
-                         payload_buf + payload_len,
-                         pad_len + 1) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_confidentiality_trailer_handle,
+                                   payload_buf + payload_len,
+                                   pad_len + 1) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -905,10 +993,10 @@ _construct_payload_rakp (uint8_t payload_type,
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         obj_cmd_buf,
-                         obj_cmd_len) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_payload_data_handle,
+                                   obj_cmd_buf,
+                                   obj_cmd_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -918,7 +1006,8 @@ _construct_payload_rakp (uint8_t payload_type,
 }
 
 static int
-_construct_payload (uint8_t payload_type,
+_construct_payload (ipmi_rmcpplus_crypt_cache_t cache,
+                    uint8_t payload_type,
                     uint8_t payload_encrypted,
                     uint8_t authentication_algorithm,
                     uint8_t confidentiality_algorithm,
@@ -952,7 +1041,8 @@ _construct_payload (uint8_t payload_type,
                                                          obj_cmd,
                                                          obj_rmcpplus_payload));
       else /* IPMI_CONFIDENTIALITY_ALGORITHM_AES_CBC_128 */
-        return (_construct_payload_confidentiality_aes_cbc_128 (payload_type,
+        return (_construct_payload_confidentiality_aes_cbc_128 (cache,
+                                                                payload_type,
                                                                 payload_encrypted,
                                                                 obj_lan_msg_hdr,
                                                                 obj_cmd,
@@ -1003,19 +1093,19 @@ _construct_session_trlr_pad (uint8_t integrity_algorithm,
 
   if (pad_length)
     {
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "integrity_pad",
-                             pad_bytes,
-                             pad_length) < 0)
+      if (fiid_obj_set_data_by_handle (obj_rmcpplus_session_trlr,
+                                       rmcpplus_integrity_pad_handle,
+                                       pad_bytes,
+                                       pad_length) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
         }
     }
 
-  if (fiid_obj_set (obj_rmcpplus_session_trlr,
-                    "pad_length",
-                    pad_length) < 0)
+  if (fiid_obj_set_by_handle (obj_rmcpplus_session_trlr,
+                              rmcpplus_pad_length_handle,
+                              pad_length) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
       return (-1);
@@ -1050,7 +1140,8 @@ _calculate_authentication_code_len (uint8_t integrity_algorithm)
 }
 
 static int
-_construct_session_trlr_authentication_code (uint8_t integrity_algorithm,
+_construct_session_trlr_authentication_code (ipmi_rmcpplus_crypt_cache_t cache,
+                                             uint8_t integrity_algorithm,
                                              const void *integrity_key,
                                              unsigned int integrity_key_len,
                                              const void *authentication_code_data,
@@ -1097,10 +1188,10 @@ _construct_session_trlr_authentication_code (uint8_t integrity_algorithm,
 
   if (len)
     {
-      if ((len = fiid_obj_get_data (obj_rmcpplus_session_trlr,
-                                    "authentication_code",
-                                    authentication_code_buf,
-                                    authentication_code_buf_len)) < 0)
+      if ((len = fiid_obj_get_data_by_handle (obj_rmcpplus_session_trlr,
+                                              rmcpplus_authentication_code_handle,
+                                              authentication_code_buf,
+                                              authentication_code_buf_len)) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
@@ -1180,14 +1271,15 @@ _construct_session_trlr_authentication_code (uint8_t integrity_algorithm,
       hash_data_len += IPMI_2_0_MAX_PASSWORD_LENGTH;
     }
 
-  if ((integrity_digest_len = crypt_hash (hash_algorithm,
-                                          hash_flags,
-                                          integrity_key,
-                                          integrity_key_len,
-                                          hash_data,
-                                          hash_data_len,
-                                          integrity_digest,
-                                          IPMI_MAX_INTEGRITY_DATA_LENGTH)) < 0)
+  if ((integrity_digest_len = crypt_hash_cached (cache,
+                                                 hash_algorithm,
+                                                 hash_flags,
+                                                 integrity_key,
+                                                 integrity_key_len,
+                                                 hash_data,
+                                                 hash_data_len,
+                                                 integrity_digest,
+                                                 IPMI_MAX_INTEGRITY_DATA_LENGTH)) < 0)
     {
       ERRNO_TRACE (errno);
       goto cleanup;
@@ -1232,6 +1324,46 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
                             void *pkt,
                             unsigned int pkt_len,
                             unsigned int flags)
+{
+  return (assemble_ipmi_rmcpplus_pkt_cached (NULL,
+                                             authentication_algorithm,
+                                             integrity_algorithm,
+                                             confidentiality_algorithm,
+                                             integrity_key,
+                                             integrity_key_len,
+                                             confidentiality_key,
+                                             confidentiality_key_len,
+                                             authentication_code_data,
+                                             authentication_code_data_len,
+                                             obj_rmcp_hdr,
+                                             obj_rmcpplus_session_hdr,
+                                             obj_lan_msg_hdr,
+                                             obj_cmd,
+                                             obj_rmcpplus_session_trlr,
+                                             pkt,
+                                             pkt_len,
+                                             flags));
+}
+
+int
+assemble_ipmi_rmcpplus_pkt_cached (ipmi_rmcpplus_crypt_cache_t cache,
+                                   uint8_t authentication_algorithm,
+                                   uint8_t integrity_algorithm,
+                                   uint8_t confidentiality_algorithm,
+                                   const void *integrity_key,
+                                   unsigned int integrity_key_len,
+                                   const void *confidentiality_key,
+                                   unsigned int confidentiality_key_len,
+                                   const void *authentication_code_data,
+                                   unsigned int authentication_code_data_len,
+                                   fiid_obj_t obj_rmcp_hdr,
+                                   fiid_obj_t obj_rmcpplus_session_hdr,
+                                   fiid_obj_t obj_lan_msg_hdr,
+                                   fiid_obj_t obj_cmd,
+                                   fiid_obj_t obj_rmcpplus_session_trlr,
+                                   void *pkt,
+                                   unsigned int pkt_len,
+                                   unsigned int flags)
 {
   unsigned int indx = 0;
   int obj_rmcp_hdr_len, obj_len, oem_iana_len, oem_payload_id_len, payload_len, len, rv = -1;
@@ -1267,6 +1399,9 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (-1);
     }
 
+  if (_rmcpplus_field_handles_init () < 0)
+    return (-1);
+
   if (FIID_OBJ_TEMPLATE_COMPARE (obj_rmcp_hdr, tmpl_rmcp_hdr) < 0)
     {
       ERRNO_TRACE (errno);
@@ -1294,45 +1429,45 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
    * a ipmi_payload_len is required but may not be set yet.
    */
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_payload_type_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_type = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.authenticated",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_payload_type_authenticated_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_authenticated = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.encrypted",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_payload_type_encrypted_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_encrypted = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_id",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_session_id_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   session_id = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_sequence_number",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_session_sequence_number_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
@@ -1528,7 +1663,8 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       goto cleanup;
     }
 
-  if ((payload_len = _construct_payload (payload_type,
+  if ((payload_len = _construct_payload (cache,
+                                         payload_type,
                                          payload_encrypted,
                                          authentication_algorithm,
                                          confidentiality_algorithm,
@@ -1552,9 +1688,9 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       goto cleanup;
     }
 
-  if (fiid_obj_set (obj_session_hdr_temp,
-                    "ipmi_payload_len",
-                    payload_len) < 0)
+  if (fiid_obj_set_by_handle (obj_session_hdr_temp,
+                              rmcpplus_ipmi_payload_len_handle,
+                              payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_session_hdr_temp);
       goto cleanup;
@@ -1653,7 +1789,8 @@ assemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
        * call must be done after the pad, pad length, and next header are copied into
        * the pkt buffer.
        */
-      if ((authentication_code_len = _construct_session_trlr_authentication_code (integrity_algorithm,
+      if ((authentication_code_len = _construct_session_trlr_authentication_code (cache,
+                                                                                  integrity_algorithm,
                                                                                   integrity_key,
                                                                                   integrity_key_len,
                                                                                   authentication_code_data,
@@ -1839,10 +1976,10 @@ _deconstruct_payload_confidentiality_none (uint8_t payload_type,
   if (!ret)
     return (0);
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         pkt,
-                         ipmi_payload_len) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_payload_data_handle,
+                                   pkt,
+                                   ipmi_payload_len) < 0)
 
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
@@ -1854,7 +1991,8 @@ _deconstruct_payload_confidentiality_none (uint8_t payload_type,
 
 /* return 1 on full parse, 0 if not, -1 on error */
 static int
-_deconstruct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
+_deconstruct_payload_confidentiality_aes_cbc_128 (ipmi_rmcpplus_crypt_cache_t cache,
+                                                  uint8_t payload_type,
                                                   uint8_t payload_encrypted,
                                                   fiid_obj_t obj_rmcpplus_payload,
                                                   fiid_obj_t obj_lan_msg_hdr,
@@ -1935,23 +2073,24 @@ _deconstruct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
   indx += IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH;
   memcpy (payload_buf, pkt + indx, payload_data_len);
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_header",
-                         iv,
-                         IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_confidentiality_header_handle,
+                                   iv,
+                                   IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if ((decrypt_len = crypt_cipher_decrypt (IPMI_CRYPT_CIPHER_AES,
-                                           IPMI_CRYPT_CIPHER_MODE_CBC,
-                                           confidentiality_key,
-                                           confidentiality_key_len,
-                                           iv,
-                                           IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH,
-                                           payload_buf,
-                                           payload_data_len)) < 0)
+  if ((decrypt_len = crypt_cipher_decrypt_cached (cache,
+                                                  IPMI_CRYPT_CIPHER_AES,
+                                                  IPMI_CRYPT_CIPHER_MODE_CBC,
+                                                  confidentiality_key,
+                                                  confidentiality_key_len,
+                                                  iv,
+                                                  IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH,
+                                                  payload_buf,
+                                                  payload_data_len)) < 0)
     {
       ERRNO_TRACE (errno);
       return (-1);
@@ -1987,19 +2126,19 @@ _deconstruct_payload_confidentiality_aes_cbc_128 (uint8_t payload_type,
       return (0);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         payload_buf,
-                         cmd_data_len) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_payload_data_handle,
+                                   payload_buf,
+                                   cmd_data_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
     }
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "confidentiality_trailer",
-                         payload_buf + cmd_data_len,
-                         pad_length + 1), 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_confidentiality_trailer_handle,
+                                   payload_buf + cmd_data_len,
+                                   pad_length + 1), 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -2038,10 +2177,10 @@ _deconstruct_payload_rakp (uint8_t payload_type,
           && pkt
           && ipmi_payload_len);
 
-  if (fiid_obj_set_data (obj_rmcpplus_payload,
-                         "payload_data",
-                         pkt,
-                         ipmi_payload_len) < 0)
+  if (fiid_obj_set_data_by_handle (obj_rmcpplus_payload,
+                                   rmcpplus_payload_data_handle,
+                                   pkt,
+                                   ipmi_payload_len) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_payload);
       return (-1);
@@ -2060,7 +2199,8 @@ _deconstruct_payload_rakp (uint8_t payload_type,
 
 /* return 1 on full parse, 0 if not, -1 on error */
 static int
-_deconstruct_payload (uint8_t payload_type,
+_deconstruct_payload (ipmi_rmcpplus_crypt_cache_t cache,
+                      uint8_t payload_type,
                       uint8_t payload_encrypted,
                       uint8_t authentication_algorithm,
                       uint8_t confidentiality_algorithm,
@@ -2102,7 +2242,8 @@ _deconstruct_payload (uint8_t payload_type,
                                                            pkt,
                                                            ipmi_payload_len));
       else /* IPMI_CONFIDENTIALITY_ALGORITHM_AES_CBC_128 */
-        return (_deconstruct_payload_confidentiality_aes_cbc_128 (payload_type,
+        return (_deconstruct_payload_confidentiality_aes_cbc_128 (cache,
+                                                                  payload_type,
                                                                   payload_encrypted,
                                                                   obj_rmcpplus_payload,
                                                                   obj_lan_msg_hdr,
@@ -2139,6 +2280,46 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
                               fiid_obj_t obj_lan_msg_trlr,
                               fiid_obj_t obj_rmcpplus_session_trlr,
                               unsigned int flags)
+{
+  return (unassemble_ipmi_rmcpplus_pkt_cached (NULL,
+                                               authentication_algorithm,
+                                               integrity_algorithm,
+                                               confidentiality_algorithm,
+                                               integrity_key,
+                                               integrity_key_len,
+                                               confidentiality_key,
+                                               confidentiality_key_len,
+                                               pkt,
+                                               pkt_len,
+                                               obj_rmcp_hdr,
+                                               obj_rmcpplus_session_hdr,
+                                               obj_rmcpplus_payload,
+                                               obj_lan_msg_hdr,
+                                               obj_cmd,
+                                               obj_lan_msg_trlr,
+                                               obj_rmcpplus_session_trlr,
+                                               flags));
+}
+
+int
+unassemble_ipmi_rmcpplus_pkt_cached (ipmi_rmcpplus_crypt_cache_t cache,
+                                     uint8_t authentication_algorithm,
+                                     uint8_t integrity_algorithm,
+                                     uint8_t confidentiality_algorithm,
+                                     const void *integrity_key,
+                                     unsigned int integrity_key_len,
+                                     const void *confidentiality_key,
+                                     unsigned int confidentiality_key_len,
+                                     const void *pkt,
+                                     unsigned int pkt_len,
+                                     fiid_obj_t obj_rmcp_hdr,
+                                     fiid_obj_t obj_rmcpplus_session_hdr,
+                                     fiid_obj_t obj_rmcpplus_payload,
+                                     fiid_obj_t obj_lan_msg_hdr,
+                                     fiid_obj_t obj_cmd,
+                                     fiid_obj_t obj_lan_msg_trlr,
+                                     fiid_obj_t obj_rmcpplus_session_trlr,
+                                     unsigned int flags)
 {
   unsigned int indx = 0;
   int obj_rmcp_hdr_len, obj_len;
@@ -2170,6 +2351,9 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (-1);
     }
 
+  if (_rmcpplus_field_handles_init () < 0)
+    return (-1);
+
   if (FIID_OBJ_TEMPLATE_COMPARE (obj_rmcp_hdr, tmpl_rmcp_hdr) < 0)
     {
       ERRNO_TRACE (errno);
@@ -2250,9 +2434,9 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (0);
     }
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_payload_type_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
@@ -2321,45 +2505,45 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
       return (0);
     }
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.authenticated",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_payload_type_authenticated_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_authenticated = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "payload_type.encrypted",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_payload_type_encrypted_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   payload_encrypted = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_id",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_session_id_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   session_id = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "session_sequence_number",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_session_sequence_number_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
     }
   session_sequence_number = val;
 
-  if (FIID_OBJ_GET (obj_rmcpplus_session_hdr,
-                    "ipmi_payload_len",
-                    &val) < 0)
+  if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_hdr,
+                              rmcpplus_ipmi_payload_len_handle,
+                              &val) < 0)
     {
       FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_hdr);
       return (-1);
@@ -2482,7 +2666,8 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
   /*
    * Deconstruct/Decrypt Payload
    */
-  if ((ret = _deconstruct_payload (payload_type,
+  if ((ret = _deconstruct_payload (cache,
+                                   payload_type,
                                    payload_encrypted,
                                    authentication_algorithm,
                                    confidentiality_algorithm,
@@ -2542,37 +2727,37 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
 
       if (authentication_code_len)
         {
-          if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                                 "authentication_code",
-                                 pkt + indx + ((pkt_len - indx) - authentication_code_len),
-                                 authentication_code_len) < 0)
+          if (fiid_obj_set_data_by_handle (obj_rmcpplus_session_trlr,
+                                           rmcpplus_authentication_code_handle,
+                                           pkt + indx + ((pkt_len - indx) - authentication_code_len),
+                                           authentication_code_len) < 0)
             {
               FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
               return (-1);
             }
         }
 
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "next_header",
-                             pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len),
-                             next_header_field_len) < 0)
+      if (fiid_obj_set_data_by_handle (obj_rmcpplus_session_trlr,
+                                       rmcpplus_next_header_handle,
+                                       pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len),
+                                       next_header_field_len) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
         }
 
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "pad_length",
-                             pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len - pad_length_field_len),
-                             pad_length_field_len) < 0)
+      if (fiid_obj_set_data_by_handle (obj_rmcpplus_session_trlr,
+                                       rmcpplus_pad_length_handle,
+                                       pkt + indx + ((pkt_len - indx) - authentication_code_len - next_header_field_len - pad_length_field_len),
+                                       pad_length_field_len) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
         }
 
-      if (FIID_OBJ_GET (obj_rmcpplus_session_trlr,
-                        "pad_length",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_rmcpplus_session_trlr,
+                                  rmcpplus_pad_length_handle,
+                                  &val) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
@@ -2592,10 +2777,10 @@ unassemble_ipmi_rmcpplus_pkt (uint8_t authentication_algorithm,
           pad_length = (pkt_len - indx - authentication_code_len - pad_length_field_len - next_header_field_len);
         }
 
-      if (fiid_obj_set_data (obj_rmcpplus_session_trlr,
-                             "integrity_pad",
-                             pkt + indx,
-                             pad_length) < 0)
+      if (fiid_obj_set_data_by_handle (obj_rmcpplus_session_trlr,
+                                       rmcpplus_integrity_pad_handle,
+                                       pkt + indx,
+                                       pad_length) < 0)
         {
           FIID_OBJECT_ERROR_TO_ERRNO (obj_rmcpplus_session_trlr);
           return (-1);
@@ -39,6 +39,25 @@ GCRY_THREAD_OPTION_PTHREAD_IMPL;
 #include "ipmi-trace.h"
 
 #include "freeipmi-portability.h"
+#include "secure.h"
+
+/* large enough for any RMCP+ integrity or confidentiality key */
+#define IPMI_CRYPT_CACHE_KEY_LENGTH_MAX 64
+
+struct ipmi_rmcpplus_crypt_cache
+{
+#ifdef WITH_ENCRYPTION
+  gcry_md_hd_t md;
+  int md_algorithm;
+  int md_flags;
+  gcry_cipher_hd_t cipher;
+  int cipher_mode;
+#endif /* !WITH_ENCRYPTION */
+  uint8_t md_key[IPMI_CRYPT_CACHE_KEY_LENGTH_MAX];
+  unsigned int md_key_len;
+  uint8_t cipher_key[IPMI_CRYPT_CACHE_KEY_LENGTH_MAX];
+  unsigned int cipher_key_len;
+};
 
 static int crypt_initialized = 0;
 
@@ -132,6 +151,28 @@ crypt_init (void)
 #endif /* !WITH_ENCRYPTION */
 }
 
+#ifdef WITH_ENCRYPTION
+/* returns 1 if the cached hash handle can be reused, 0 if not */
+static int
+_crypt_cache_md_match (struct ipmi_rmcpplus_crypt_cache *cache,
+                       int gcry_md_algorithm,
+                       int gcry_md_flags,
+                       const void *key,
+                       unsigned int key_len)
+{
+  if (!cache->md
+      || cache->md_algorithm != gcry_md_algorithm
+      || cache->md_flags != gcry_md_flags
+      || cache->md_key_len != key_len)
+    return (0);
+
+  if (key_len && memcmp (cache->md_key, key, key_len))
+    return (0);
+
+  return (1);
+}
+#endif /* !WITH_ENCRYPTION */
+
 int
 crypt_hash (unsigned int hash_algorithm,
             unsigned int hash_flags,
@@ -141,6 +182,28 @@ crypt_hash (unsigned int hash_algorithm,
             unsigned int hash_data_len,
             void *digest,
             unsigned int digest_len)
+{
+  return (crypt_hash_cached (NULL,
+                             hash_algorithm,
+                             hash_flags,
+                             key,
+                             key_len,
+                             hash_data,
+                             hash_data_len,
+                             digest,
+                             digest_len));
+}
+
+int
+crypt_hash_cached (struct ipmi_rmcpplus_crypt_cache *cache,
+                   unsigned int hash_algorithm,
+                   unsigned int hash_flags,
+                   const void *key,
+                   unsigned int key_len,
+                   const void *hash_data,
+                   unsigned int hash_data_len,
+                   void *digest,
+                   unsigned int digest_len)
 {
 #ifdef WITH_ENCRYPTION
   gcry_md_hd_t h = NULL;
@@ -181,6 +244,25 @@ crypt_hash (unsigned int hash_algorithm,
       return (-1);
     }
 
+  /* only a key set below needs to match */
+  if (!(hash_flags & IPMI_CRYPT_HASH_FLAGS_HMAC) || !key)
+    key_len = 0;
+
+  if (cache && key_len > IPMI_CRYPT_CACHE_KEY_LENGTH_MAX)
+    cache = NULL;
+
+  if (cache && _crypt_cache_md_match (cache,
+                                      gcry_md_algorithm,
+                                      gcry_md_flags,
+                                      key,
+                                      key_len))
+    {
+      /* an HMAC key survives the reset */
+      h = cache->md;
+      gcry_md_reset (h);
+      goto hash;
+    }
+
   if ((e = gcry_md_open (&h, gcry_md_algorithm, gcry_md_flags)) != GPG_ERR_NO_ERROR)
     {
       ERR_GCRYPT_TRACE (e);
@@ -200,16 +282,30 @@ crypt_hash (unsigned int hash_algorithm,
   /* SPEC: There is no indication that if a NULL password/key is used,
    * that a zero padded password of some length should be the key.
    */
-  if ((hash_flags & IPMI_CRYPT_HASH_FLAGS_HMAC) && key && key_len)
+  if (key_len)
     {
       if ((e = gcry_md_setkey (h, key, key_len)) != GPG_ERR_NO_ERROR)
         {
           ERR_GCRYPT_TRACE (e);
           SET_ERRNO (_gpg_error_to_errno (e));
-          goto cleanup;
+          gcry_md_close (h);
+          return (-1);
         }
     }
 
+  if (cache)
+    {
+      if (cache->md)
+        gcry_md_close (cache->md);
+      cache->md = h;
+      cache->md_algorithm = gcry_md_algorithm;
+      cache->md_flags = gcry_md_flags;
+      if (key_len)
+        memcpy (cache->md_key, key, key_len);
+      cache->md_key_len = key_len;
+    }
+
+ hash:
   if (hash_data && hash_data_len)
     gcry_md_write (h, (void *)hash_data, hash_data_len);
 
@@ -230,7 +326,7 @@ crypt_hash (unsigned int hash_algorithm,
   memcpy (digest, digestPtr, gcry_md_digest_len);
   rv = gcry_md_digest_len;
  cleanup:
-  if (h)
+  if (!cache)
     gcry_md_close (h);
   return (rv);
 #else /* !WITH_ENCRYPTION */
@@ -273,7 +369,8 @@ crypt_hash_digest_len (unsigned int hash_algorithm)
 
 #ifdef WITH_ENCRYPTION
 static int
-_cipher_crypt (unsigned int cipher_algorithm,
+_cipher_crypt (struct ipmi_rmcpplus_crypt_cache *cache,
+               unsigned int cipher_algorithm,
                unsigned int cipher_mode,
                const void *key,
                unsigned int key_len,
@@ -347,12 +444,27 @@ _cipher_crypt (unsigned int cipher_algorithm,
   if (key && key_len > expected_cipher_key_len)
     key_len = expected_cipher_key_len;
 
+  if (!key)
+    key_len = 0;
+
   if (!crypt_initialized)
     {
       SET_ERRNO (EINVAL);
       return (-1);
     }
 
+  if (cache
+      && cache->cipher
+      && cache->cipher_mode == gcry_cipher_mode
+      && cache->cipher_key_len == key_len
+      && (!key_len || !memcmp (cache->cipher_key, key, key_len)))
+    {
+      /* the key survives the reset, the iv is set below */
+      h = cache->cipher;
+      gcry_cipher_reset (h);
+      goto crypt;
+    }
+
   if ((e = gcry_cipher_open (&h,
                              gcry_cipher_algorithm,
                              gcry_cipher_mode,
@@ -363,7 +475,7 @@ _cipher_crypt (unsigned int cipher_algorithm,
       return (-1);
     }
 
-  if (key && key_len)
+  if (key_len)
     {
       if ((e = gcry_cipher_setkey (h,
                                    (void *)key,
@@ -371,10 +483,23 @@ _cipher_crypt (unsigned int cipher_algorithm,
         {
           ERR_GCRYPT_TRACE (e);
           SET_ERRNO (_gpg_error_to_errno (e));
-          goto cleanup;
+          gcry_cipher_close (h);
+          return (-1);
         }
     }
 
+  if (cache)
+    {
+      if (cache->cipher)
+        gcry_cipher_close (cache->cipher);
+      cache->cipher = h;
+      cache->cipher_mode = gcry_cipher_mode;
+      if (key_len)
+        memcpy (cache->cipher_key, key, key_len);
+      cache->cipher_key_len = key_len;
+    }
+
+ crypt:
   if (iv && iv_len)
     {
       if ((e = gcry_cipher_setiv (h, (void *)iv, iv_len)) != GPG_ERR_NO_ERROR)
@@ -420,7 +545,7 @@ _cipher_crypt (unsigned int cipher_algorithm,
 
   rv = data_len;
  cleanup:
-  if (h)
+  if (!cache)
     gcry_cipher_close (h);
   return (rv);
 }
@@ -435,9 +560,32 @@ crypt_cipher_encrypt (unsigned int cipher_algorithm,
                       unsigned int iv_len,
                       void *data,
                       unsigned int data_len)
+{
+  return (crypt_cipher_encrypt_cached (NULL,
+                                      cipher_algorithm,
+                                      cipher_mode,
+                                      key,
+                                      key_len,
+                                      iv,
+                                      iv_len,
+                                      data,
+                                      data_len));
+}
+
+int
+crypt_cipher_encrypt_cached (struct ipmi_rmcpplus_crypt_cache *cache,
+                             unsigned int cipher_algorithm,
+                             unsigned int cipher_mode,
+                             const void *key,
+                             unsigned int key_len,
+                             const void *iv,
+                             unsigned int iv_len,
+                             void *data,
+                             unsigned int data_len)
 {
 #ifdef WITH_ENCRYPTION
-  return (_cipher_crypt (cipher_algorithm,
+  return (_cipher_crypt (cache,
+                         cipher_algorithm,
                          cipher_mode,
                          key,
                          key_len,
@@ -461,9 +609,32 @@ crypt_cipher_decrypt (unsigned int cipher_algorithm,
                       unsigned int iv_len,
                       void *data,
                       unsigned int data_len)
+{
+  return (crypt_cipher_decrypt_cached (NULL,
+                                      cipher_algorithm,
+                                      cipher_mode,
+                                      key,
+                                      key_len,
+                                      iv,
+                                      iv_len,
+                                      data,
+                                      data_len));
+}
+
+int
+crypt_cipher_decrypt_cached (struct ipmi_rmcpplus_crypt_cache *cache,
+                             unsigned int cipher_algorithm,
+                             unsigned int cipher_mode,
+                             const void *key,
+                             unsigned int key_len,
+                             const void *iv,
+                             unsigned int iv_len,
+                             void *data,
+                             unsigned int data_len)
 {
 #ifdef WITH_ENCRYPTION
-  return (_cipher_crypt (cipher_algorithm,
+  return (_cipher_crypt (cache,
+                         cipher_algorithm,
                          cipher_mode,
                          key,
                          key_len,
@@ -478,6 +649,38 @@ crypt_cipher_decrypt (unsigned int cipher_algorithm,
 #endif /* !WITH_ENCRYPTION */
 }
 
+struct ipmi_rmcpplus_crypt_cache *
+crypt_cache_create (void)
+{
+  struct ipmi_rmcpplus_crypt_cache *cache;
+
+  if (!(cache = (struct ipmi_rmcpplus_crypt_cache *)malloc (sizeof (struct ipmi_rmcpplus_crypt_cache))))
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+  memset (cache, '\0', sizeof (struct ipmi_rmcpplus_crypt_cache));
+
+  return (cache);
+}
+
+void
+crypt_cache_destroy (struct ipmi_rmcpplus_crypt_cache *cache)
+{
+  if (!cache)
+    return;
+
+#ifdef WITH_ENCRYPTION
+  if (cache->md)
+    gcry_md_close (cache->md);
+  if (cache->cipher)
+    gcry_cipher_close (cache->cipher);
+#endif /* !WITH_ENCRYPTION */
+  /* secure_memset b/c contains keys */
+  secure_memset (cache, '\0', sizeof (struct ipmi_rmcpplus_crypt_cache));
+  free (cache);
+}
+
 #ifdef WITH_ENCRYPTION
 static int
 _crypt_cipher_info (unsigned int cipher_algorithm, unsigned int cipher_info)
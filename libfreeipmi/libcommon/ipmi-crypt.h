@@ -55,6 +55,16 @@
 #define IPMI_CRYPT_AES_CBC_128_KEY_LENGTH        16
 #define IPMI_CRYPT_AES_CBC_128_BLOCK_LENGTH      16
 
+/* Keyed handle cache, see ipmi_rmcpplus_crypt_cache_create().
+ *
+ * Keeps keyed hash and cipher handles open between calls, so a
+ * session's keys are only set up when they change rather than for
+ * every packet.  A cache must not be used by multiple threads at the
+ * same time.  Passing a NULL cache to the *_cached functions is
+ * identical to calling the uncached functions.
+ */
+struct ipmi_rmcpplus_crypt_cache;
+
 /* crypt_init
  *
  * Must be called first before anything else that may use crypt
@@ -75,6 +85,16 @@ int crypt_hash (unsigned int hash_algorithm,
                      void *digest,
                      unsigned int digest_len);
 
+int crypt_hash_cached (struct ipmi_rmcpplus_crypt_cache *cache,
+                       unsigned int hash_algorithm,
+                       unsigned int hash_flags,
+                       const void *key,
+                       unsigned int key_len,
+                       const void *hash_data,
+                       unsigned int hash_data_len,
+                       void *digest,
+                       unsigned int digest_len);
+
 int crypt_hash_digest_len (unsigned int hash_algorithm);
 
 /* return length of data written into buffer on success, -1 on error */
@@ -97,6 +117,31 @@ int crypt_cipher_decrypt (unsigned int cipher_algorithm,
                                void *data,
                                unsigned int data_len);
 
+int crypt_cipher_encrypt_cached (struct ipmi_rmcpplus_crypt_cache *cache,
+                                 unsigned int cipher_algorithm,
+                                 unsigned int cipher_mode,
+                                 const void *key,
+                                 unsigned int key_len,
+                                 const void *iv,
+                                 unsigned int iv_len,
+                                 void *data,
+                                 unsigned int data_len);
+
+int crypt_cipher_decrypt_cached (struct ipmi_rmcpplus_crypt_cache *cache,
+                                 unsigned int cipher_algorithm,
+                                 unsigned int cipher_mode,
+                                 const void *key,
+                                 unsigned int key_len,
+                                 const void *iv,
+                                 unsigned int iv_len,
+                                 void *data,
+                                 unsigned int data_len);
+
+/* returns NULL on error */
+struct ipmi_rmcpplus_crypt_cache *crypt_cache_create (void);
+
+void crypt_cache_destroy (struct ipmi_rmcpplus_crypt_cache *cache);
+
 int crypt_cipher_key_len (unsigned int cipher_algorithm);
 
 int crypt_cipher_block_len (unsigned int cipher_algorithm);
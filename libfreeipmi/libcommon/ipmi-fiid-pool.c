@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/fiid/fiid.h"
+
+#include "ipmi-fiid-pool.h"
+#include "ipmi-fiid-util.h"
+#include "ipmi-trace.h"
+
+#include "freeipmi-portability.h"
+
+static fiid_obj_t
+_obj_pool_get (struct obj_pool *pool, fiid_template_t tmpl, int view)
+{
+  struct obj_pool_entry *slot = NULL;
+  fiid_obj_t obj;
+  unsigned int i;
+
+  assert (pool);
+  assert (tmpl);
+
+  for (i = 0; i < OBJ_POOL_LEN; i++)
+    {
+      struct obj_pool_entry *entry = &pool->entries[i];
+
+      if (entry->obj
+          && !entry->in_use
+          && entry->tmpl == tmpl
+          && entry->view == view)
+        {
+          /* views are rebound by the caller, nothing to clear */
+          if (!view && fiid_obj_clear (entry->obj) < 0)
+            {
+              FIID_OBJECT_ERROR_TO_ERRNO (entry->obj);
+              return (NULL);
+            }
+          entry->in_use = 1;
+          pool->allocations_avoided++;
+          return (entry->obj);
+        }
+
+      /* prefer an empty slot, otherwise evict an idle object of
+       * another template
+       */
+      if (!entry->obj)
+        {
+          if (!slot || slot->obj)
+            slot = entry;
+        }
+      else if (!entry->in_use && !slot)
+        slot = entry;
+    }
+
+  if (view)
+    obj = fiid_obj_create_view (tmpl, NULL, 0);
+  else
+    obj = fiid_obj_create (tmpl);
+
+  if (!obj)
+    {
+      ERRNO_TRACE (errno);
+      return (NULL);
+    }
+
+  /* pool exhausted, hand out an unpooled object */
+  if (!slot)
+    return (obj);
+
+  fiid_obj_destroy (slot->obj);
+  slot->tmpl = tmpl;
+  slot->obj = obj;
+  slot->view = view;
+  slot->in_use = 1;
+  return (obj);
+}
+
+fiid_obj_t
+obj_pool_get (struct obj_pool *pool, fiid_template_t tmpl)
+{
+  return (_obj_pool_get (pool, tmpl, 0));
+}
+
+fiid_obj_t
+obj_pool_get_view (struct obj_pool *pool, fiid_template_t tmpl)
+{
+  return (_obj_pool_get (pool, tmpl, 1));
+}
+
+void
+obj_pool_put (struct obj_pool *pool, fiid_obj_t obj)
+{
+  unsigned int i;
+
+  assert (pool);
+
+  if (!obj)
+    return;
+
+  for (i = 0; i < OBJ_POOL_LEN; i++)
+    {
+      if (pool->entries[i].obj == obj)
+        {
+          assert (pool->entries[i].in_use);
+          pool->entries[i].in_use = 0;
+          return;
+        }
+    }
+
+  fiid_obj_destroy (obj);
+}
+
+void
+obj_pool_destroy (struct obj_pool *pool)
+{
+  unsigned int i;
+
+  assert (pool);
+
+  for (i = 0; i < OBJ_POOL_LEN; i++)
+    {
+      assert (!pool->entries[i].in_use);
+      fiid_obj_destroy (pool->entries[i].obj);
+      pool->entries[i].tmpl = NULL;
+      pool->entries[i].obj = NULL;
+      pool->entries[i].view = 0;
+    }
+}
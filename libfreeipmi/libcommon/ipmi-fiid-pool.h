@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_FIID_POOL_H
+#define IPMI_FIID_POOL_H
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdint.h>
+
+#include "freeipmi/fiid/fiid.h"
+
+/* A small per-context cache of fiid objects, so functions called
+ * repeatedly (e.g. once per sensor or per SEL entry) can reuse
+ * objects rather than create and destroy them on every call.
+ *
+ * A zeroed struct obj_pool is an empty pool.  Pools are not thread
+ * safe, they are protected by whatever protects the context they
+ * live in.
+ */
+#define OBJ_POOL_LEN 16
+
+struct obj_pool_entry
+{
+  fiid_field_t *tmpl;
+  fiid_obj_t obj;
+  int view;
+  int in_use;
+};
+
+struct obj_pool
+{
+  struct obj_pool_entry entries[OBJ_POOL_LEN];
+  uint64_t allocations_avoided;
+};
+
+/* Returns a cleared object of the template, reusing an idle pooled
+ * object created from the same template if one is available.
+ * Objects must be returned with obj_pool_put().
+ *
+ * Returns NULL on error and sets errno.
+ */
+fiid_obj_t obj_pool_get (struct obj_pool *pool, fiid_template_t tmpl);
+
+/* Like obj_pool_get(), but returns a read only view (see
+ * fiid_obj_create_view()).  The view may still be bound to a buffer
+ * from an earlier use, callers must bind it with
+ * fiid_obj_view_bind() before reading from it.
+ *
+ * Returns NULL on error and sets errno.
+ */
+fiid_obj_t obj_pool_get_view (struct obj_pool *pool, fiid_template_t tmpl);
+
+/* Returns an object to the pool, or destroys it if it did not come
+ * from the pool.  obj may be NULL.
+ */
+void obj_pool_put (struct obj_pool *pool, fiid_obj_t obj);
+
+/* Destroys all pooled objects */
+void obj_pool_destroy (struct obj_pool *pool);
+
+#endif /* IPMI_FIID_POOL_H */
@@ -45,19 +45,24 @@
 #include <errno.h>
 
 #include "freeipmi/sdr/ipmi-sdr.h"
+#include "freeipmi/api/ipmi-api.h"
 #include "freeipmi/api/ipmi-sdr-repository-cmds-api.h"
 #include "freeipmi/cmds/ipmi-sdr-repository-cmds.h"
 #include "freeipmi/fiid/fiid.h"
 #include "freeipmi/debug/ipmi-debug.h"
 #include "freeipmi/record-format/ipmi-sdr-record-format.h"
 #include "freeipmi/spec/ipmi-comp-code-spec.h"
+#include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
 #include "freeipmi/util/ipmi-util.h"
 
+#include "ipmi-sdr-cache-index.h"
 #include "ipmi-sdr-common.h"
 #include "ipmi-sdr-defs.h"
 #include "ipmi-sdr-trace.h"
 #include "ipmi-sdr-util.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -73,6 +78,41 @@
 #define IPMI_SDR_CACHE_BYTES_TO_READ_START      16
 #define IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT  4
 
+/* Get SDR requests outstanding at once with
+ * IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED, must be <= IPMI_CMD_MULTI_MAX
+ */
+#define IPMI_SDR_CACHE_PIPELINE_DEPTH           8
+
+/* records are stored only if read completely in one request,
+ * requested is cleared once the record list has passed the record id
+ */
+struct sdr_cache_prefetch
+{
+  uint16_t record_id;
+  uint16_t next_record_id;
+  int requested;
+  unsigned int record_len;
+  uint8_t record[IPMI_SDR_MAX_RECORD_LENGTH];
+};
+
+/* records of the cache being replaced by ipmi_sdr_cache_update() */
+struct sdr_cache_old_record
+{
+  uint16_t record_id;
+  unsigned int offset;
+  unsigned int record_len;
+};
+
+struct sdr_cache_old_records
+{
+  uint8_t sdr_version;
+  uint32_t most_recent_erase_timestamp;
+  uint8_t *records;
+  unsigned int records_len;
+  struct sdr_cache_old_record *entries;
+  unsigned int count;
+};
+
 static int
 _sdr_cache_header_write (ipmi_sdr_ctx_t ctx,
                          ipmi_ctx_t ipmi_ctx,
@@ -119,10 +159,10 @@ _sdr_cache_header_write (ipmi_sdr_ctx_t ctx,
   memcpy(&header_checksum_buf[header_checksum_buf_len], sdr_cache_magic_buf, 4);
   header_checksum_buf_len += 4;
 
-  sdr_cache_version_buf[0] = IPMI_SDR_CACHE_FILE_VERSION_1_2_0;
-  sdr_cache_version_buf[1] = IPMI_SDR_CACHE_FILE_VERSION_1_2_1;
-  sdr_cache_version_buf[2] = IPMI_SDR_CACHE_FILE_VERSION_1_2_2;
-  sdr_cache_version_buf[3] = IPMI_SDR_CACHE_FILE_VERSION_1_2_3;
+  sdr_cache_version_buf[0] = IPMI_SDR_CACHE_FILE_VERSION_1_3_0;
+  sdr_cache_version_buf[1] = IPMI_SDR_CACHE_FILE_VERSION_1_3_1;
+  sdr_cache_version_buf[2] = IPMI_SDR_CACHE_FILE_VERSION_1_3_2;
+  sdr_cache_version_buf[3] = IPMI_SDR_CACHE_FILE_VERSION_1_3_3;
 
   if ((n = fd_write_n (fd, sdr_cache_version_buf, 4)) < 0)
     {
@@ -325,6 +365,139 @@ _sdr_cache_reservation_id (ipmi_sdr_ctx_t ctx,
   return (rv);
 }
 
+/* Read bytes offset_into_record through record_length of a record
+ * with partial reads.  Returns record_length, 0 if the record could
+ * not be returned (see Dell workaround), -1 on error.
+ */
+static int
+_sdr_cache_get_record_data (ipmi_sdr_ctx_t ctx,
+                            ipmi_ctx_t ipmi_ctx,
+                            fiid_obj_t obj_cmd_rs,
+                            uint16_t record_id,
+                            uint8_t *record_buf,
+                            unsigned int record_buf_len,
+                            unsigned int offset_into_record,
+                            unsigned int record_length,
+                            uint16_t *reservation_id,
+                            uint16_t next_record_id)
+{
+  unsigned int bytes_to_read = IPMI_SDR_CACHE_BYTES_TO_READ_START;
+  unsigned int reservation_id_retry_count;
+  uint64_t val;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (obj_cmd_rs);
+  assert (record_buf);
+  assert (record_length <= record_buf_len);
+  assert (reservation_id);
+
+  reservation_id_retry_count = 0;
+  while (offset_into_record < record_length)
+    {
+      int record_data_len;
+
+      if ((record_length - offset_into_record) < bytes_to_read)
+        bytes_to_read = record_length - offset_into_record;
+
+      if (ipmi_cmd_get_sdr (ipmi_ctx,
+                            *reservation_id,
+                            record_id,
+                            offset_into_record,
+                            bytes_to_read,
+                            obj_cmd_rs) < 0)
+        {
+          /* Workaround
+           *
+           * Dell Poweredge FC830
+           *
+           * Last SDR record can't be read, it always returns
+           * 0xC3.  If this is the last record, just don't return
+           * a record back to the caller.
+           */
+          if (ipmi_ctx_errnum (ipmi_ctx) == IPMI_ERR_MESSAGE_TIMEOUT)
+            {
+              uint8_t comp_code;
+
+              if (FIID_OBJ_GET (obj_cmd_rs,
+                                "comp_code",
+                                &val) < 0)
+                {
+                  SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+                  goto cleanup;
+                }
+              comp_code = val;
+
+              if (comp_code == IPMI_COMP_CODE_COMMAND_TIMEOUT
+                  && next_record_id == IPMI_SDR_RECORD_ID_LAST)
+                {
+                  rv = 0;
+                  goto cleanup;
+                }
+            }
+
+          if (ipmi_ctx_errnum (ipmi_ctx) != IPMI_ERR_BAD_COMPLETION_CODE)
+            {
+              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+              goto cleanup;
+            }
+          else
+            {
+              uint8_t comp_code;
+
+              if (FIID_OBJ_GET (obj_cmd_rs,
+                                "comp_code",
+                                &val) < 0)
+                {
+                  SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+                  goto cleanup;
+                }
+              comp_code = val;
+
+              if (comp_code == IPMI_COMP_CODE_RESERVATION_CANCELLED
+                  && (reservation_id_retry_count < IPMI_SDR_CACHE_MAX_RESERVATION_ID_RETRY))
+                {
+                  if (_sdr_cache_reservation_id (ctx,
+                                                 ipmi_ctx,
+                                                 reservation_id) < 0)
+                    goto cleanup;
+                  reservation_id_retry_count++;
+                  continue;
+                }
+              else if  ((comp_code == IPMI_COMP_CODE_CANNOT_RETURN_REQUESTED_NUMBER_OF_BYTES
+                         || comp_code == IPMI_COMP_CODE_UNSPECIFIED_ERROR)
+                        && bytes_to_read > IPMI_SDR_RECORD_HEADER_LENGTH)
+                {
+                  bytes_to_read -= IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT;
+                  if (bytes_to_read < IPMI_SDR_RECORD_HEADER_LENGTH)
+                    bytes_to_read = IPMI_SDR_RECORD_HEADER_LENGTH;
+                  continue;
+                }
+
+              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+              goto cleanup;
+            }
+        }
+
+      if ((record_data_len = fiid_obj_get_data (obj_cmd_rs,
+                                                "record_data",
+                                                record_buf + offset_into_record,
+                                                record_buf_len - offset_into_record)) < 0)
+        {
+          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+          goto cleanup;
+        }
+
+      offset_into_record += record_data_len;
+    }
+
+  rv = offset_into_record;
+ cleanup:
+  return (rv);
+}
+
 static int
 _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
                        ipmi_ctx_t ipmi_ctx,
@@ -340,11 +513,11 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
   int sdr_record_len = 0;
   unsigned int record_length = 0;
   int rv = -1;
-  unsigned int bytes_to_read = IPMI_SDR_CACHE_BYTES_TO_READ_START;
   unsigned int offset_into_record = 0;
   unsigned int reservation_id_retry_count = 0;
   uint8_t temp_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
   uint64_t val;
+  int ret;
 
   assert (ctx);
   assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
@@ -354,13 +527,13 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
   assert (reservation_id);
   assert (next_record_id);
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sdr_rs)))
+  if (!(obj_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sdr_rs)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
     }
 
-  if (!(obj_sdr_record_header = fiid_obj_create (tmpl_sdr_record_header)))
+  if (!(obj_sdr_record_header = obj_pool_get (&ctx->obj_pool, tmpl_sdr_record_header)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
@@ -572,110 +745,24 @@ _sdr_cache_get_record (ipmi_sdr_ctx_t ctx,
     }
   *next_record_id = val;
 
-  reservation_id_retry_count = 0;
-  while (offset_into_record < record_length)
-    {
-      int record_data_len;
-
-      if ((record_length - offset_into_record) < bytes_to_read)
-        bytes_to_read = record_length - offset_into_record;
-
-      if (ipmi_cmd_get_sdr (ipmi_ctx,
-                            *reservation_id,
-                            record_id,
-                            offset_into_record,
-                            bytes_to_read,
-                            obj_cmd_rs) < 0)
-        {
-          /* Workaround
-           *
-           * Dell Poweredge FC830
-           *
-           * Last SDR record can't be read, it always returns
-           * 0xC3.  If this is the last record, just don't return
-           * a record back to the caller.
-           */
-          if (ipmi_ctx_errnum (ipmi_ctx) == IPMI_ERR_MESSAGE_TIMEOUT)
-            {
-              uint8_t comp_code;
-
-              if (FIID_OBJ_GET (obj_cmd_rs,
-                                "comp_code",
-                                &val) < 0)
-                {
-                  SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
-                  goto cleanup;
-                }
-              comp_code = val;
-
-              if (comp_code == IPMI_COMP_CODE_COMMAND_TIMEOUT
-                  && (*next_record_id) == IPMI_SDR_RECORD_ID_LAST)
-                {
-                  offset_into_record = 0;
-                  goto out;
-                }
-            }
-
-          if (ipmi_ctx_errnum (ipmi_ctx) != IPMI_ERR_BAD_COMPLETION_CODE)
-            {
-              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
-              goto cleanup;
-            }
-          else
-            {
-              uint8_t comp_code;
-
-              if (FIID_OBJ_GET (obj_cmd_rs,
-                                "comp_code",
-                                &val) < 0)
-                {
-                  SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
-                  goto cleanup;
-                }
-              comp_code = val;
-
-              if (comp_code == IPMI_COMP_CODE_RESERVATION_CANCELLED
-                  && (reservation_id_retry_count < IPMI_SDR_CACHE_MAX_RESERVATION_ID_RETRY))
-                {
-                  if (_sdr_cache_reservation_id (ctx,
-                                                 ipmi_ctx,
-                                                 reservation_id) < 0)
-                    goto cleanup;
-                  reservation_id_retry_count++;
-                  continue;
-                }
-              else if  ((comp_code == IPMI_COMP_CODE_CANNOT_RETURN_REQUESTED_NUMBER_OF_BYTES
-                         || comp_code == IPMI_COMP_CODE_UNSPECIFIED_ERROR)
-                        && bytes_to_read > sdr_record_header_length)
-                {
-                  bytes_to_read -= IPMI_SDR_CACHE_BYTES_TO_READ_DECREMENT;
-                  if (bytes_to_read < sdr_record_header_length)
-                    bytes_to_read = sdr_record_header_length;
-                  continue;
-                }
-
-              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
-              goto cleanup;
-            }
-        }
-
-      if ((record_data_len = fiid_obj_get_data (obj_cmd_rs,
-                                                "record_data",
-                                                record_buf + offset_into_record,
-                                                record_buf_len - offset_into_record)) < 0)
-        {
-          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
-          goto cleanup;
-        }
-
-      offset_into_record += record_data_len;
-    }
+  if ((ret = _sdr_cache_get_record_data (ctx,
+                                         ipmi_ctx,
+                                         obj_cmd_rs,
+                                         record_id,
+                                         record_buf,
+                                         record_buf_len,
+                                         offset_into_record,
+                                         record_length,
+                                         reservation_id,
+                                         *next_record_id)) < 0)
+    goto cleanup;
+  offset_into_record = ret;
 
  out:
   rv = offset_into_record;
  cleanup:
-  fiid_obj_destroy (obj_cmd_rs);
-  fiid_obj_destroy (obj_sdr_record_header);
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rs);
+  obj_pool_put (&ctx->obj_pool, obj_sdr_record_header);
   return (rv);
 }
 
@@ -685,6 +772,8 @@ _sdr_cache_record_write (ipmi_sdr_ctx_t ctx,
                          unsigned int *total_bytes_written,
                          uint16_t *record_ids,
                          unsigned int *record_ids_count,
+                         uint8_t *records,
+                         unsigned int *records_len,
                          uint8_t *buf,
                          unsigned int buflen,
                          uint8_t *trailer_checksum)
@@ -696,6 +785,8 @@ _sdr_cache_record_write (ipmi_sdr_ctx_t ctx,
   assert (fd);
   assert (total_bytes_written);
   assert (!record_ids || (record_ids && record_ids_count));
+  assert (records);
+  assert (records_len);
   assert (buf);
   assert (buflen);
   assert (trailer_checksum);
@@ -767,47 +858,498 @@ _sdr_cache_record_write (ipmi_sdr_ctx_t ctx,
 
   (*trailer_checksum) = ipmi_checksum_incremental (buf, buflen, (*trailer_checksum));
 
+  /* kept for the indexes written after the records */
+  memcpy (records + (*records_len), buf, buflen);
+  (*records_len) += buflen;
+
   return (0);
 
 }
 
-int
-ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
-                       ipmi_ctx_t ipmi_ctx,
-                       const char *filename,
-                       int cache_create_flags,
-                       Ipmi_Sdr_Cache_Create_Callback create_callback,
-                       void *create_callback_data)
+/* Record ids are a linked list, but nearly every BMC hands them out
+ * sequentially.  Speculatively read record_id, record_id + stride,
+ * ... with all requests outstanding at once.  Records that could not
+ * be read completely in one request are left for
+ * _sdr_cache_get_record() to handle.
+ */
+static int
+_sdr_cache_prefetch_records (ipmi_sdr_ctx_t ctx,
+                             ipmi_ctx_t ipmi_ctx,
+                             uint16_t record_id,
+                             uint16_t stride,
+                             uint16_t *reservation_id,
+                             fiid_obj_t *obj_cmd_rq,
+                             fiid_obj_t *obj_cmd_rs,
+                             struct sdr_cache_prefetch *prefetch)
 {
-  int open_flags;
-  uint8_t sdr_version;
-  uint16_t record_count, reservation_id, record_id, next_record_id;
-  uint32_t most_recent_addition_timestamp, most_recent_erase_timestamp;
-  unsigned int record_count_written = 0;
-  unsigned int total_bytes_written = 0;
-  uint16_t *record_ids = NULL;
-  unsigned int record_ids_count = 0;
-  unsigned int cache_create_flags_mask = (IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE
-                                          | IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID
-                                          | IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT);
-  uint8_t trailer_checksum = 0;
-  int fd = -1;
-  int rv = -1;
+  unsigned int prefetch_index[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  unsigned int reservation_id_retry_count = 0;
+  unsigned int prefetch_count = 0;
+  unsigned int i;
+  uint64_t val;
 
-  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (stride);
+  assert (reservation_id);
+  assert (obj_cmd_rq);
+  assert (obj_cmd_rs);
+  assert (prefetch);
+
+  for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
     {
-      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
-      return (-1);
+      uint32_t id = record_id + (uint32_t)i * stride;
+
+      prefetch[i].record_len = 0;
+      prefetch[i].requested = 0;
+      if (id >= IPMI_SDR_RECORD_ID_LAST)
+        continue;
+      prefetch[i].record_id = id;
+      prefetch[i].requested = 1;
+      prefetch_count = i + 1;
     }
 
-  /* Version cannot be 0h according to the IPMI spec */
-  if (!ipmi_ctx
-      || !filename
-      || (strlen (filename) > MAXPATHLEN)
-      || (cache_create_flags & ~cache_create_flags_mask))
+  while (1)
     {
-      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
-      return (-1);
+      unsigned int count = 0;
+      int reservation_cancelled = 0;
+
+      for (i = 0; i < prefetch_count; i++)
+        {
+          if (prefetch[i].record_len)
+            continue;
+
+          if (fill_cmd_get_sdr (*reservation_id,
+                                prefetch[i].record_id,
+                                0,
+                                IPMI_SDR_READ_ENTIRE_RECORD_BYTES_TO_READ,
+                                obj_cmd_rq[count]) < 0)
+            {
+              SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+              return (-1);
+            }
+          prefetch_index[count] = i;
+          count++;
+        }
+
+      if (!count)
+        break;
+
+      if (ipmi_cmd_multi (ipmi_ctx,
+                          IPMI_BMC_IPMB_LUN_BMC,
+                          IPMI_NET_FN_STORAGE_RQ,
+                          obj_cmd_rq,
+                          obj_cmd_rs,
+                          count) < 0)
+        {
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+          return (-1);
+        }
+
+      for (i = 0; i < count; i++)
+        {
+          struct sdr_cache_prefetch *p = &prefetch[prefetch_index[i]];
+          int sdr_record_len;
+
+          if (FIID_OBJ_GET (obj_cmd_rs[i],
+                            "comp_code",
+                            &val) < 0)
+            {
+              SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs[i]);
+              return (-1);
+            }
+
+          if (val == IPMI_COMP_CODE_RESERVATION_CANCELLED)
+            {
+              reservation_cancelled++;
+              continue;
+            }
+
+          if (val != IPMI_COMP_CODE_COMMAND_SUCCESS)
+            continue;
+
+          if ((sdr_record_len = fiid_obj_get_data (obj_cmd_rs[i],
+                                                   "record_data",
+                                                   p->record,
+                                                   IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
+            {
+              SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs[i]);
+              return (-1);
+            }
+
+          /* see Xyratex workaround in _sdr_cache_get_record() */
+          if (sdr_record_len < IPMI_SDR_RECORD_HEADER_LENGTH
+              || (((uint8_t)p->record[IPMI_SDR_RECORD_LENGTH_INDEX]) + IPMI_SDR_RECORD_HEADER_LENGTH) > sdr_record_len)
+            continue;
+
+          if (FIID_OBJ_GET (obj_cmd_rs[i],
+                            "next_record_id",
+                            &val) < 0)
+            {
+              SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs[i]);
+              return (-1);
+            }
+          p->next_record_id = val;
+          p->record_len = sdr_record_len;
+        }
+
+      if (!reservation_cancelled
+          || reservation_id_retry_count >= IPMI_SDR_CACHE_MAX_RESERVATION_ID_RETRY)
+        break;
+
+      if (_sdr_cache_reservation_id (ctx,
+                                     ipmi_ctx,
+                                     reservation_id) < 0)
+        return (-1);
+      reservation_id_retry_count++;
+    }
+
+  return (0);
+}
+
+/* The record is consumed, and with it any records predicted before
+ * it the record list skipped.
+ */
+static struct sdr_cache_prefetch *
+_sdr_cache_prefetch_find (struct sdr_cache_prefetch *prefetch,
+                          uint16_t record_id)
+{
+  unsigned int i, j;
+
+  assert (prefetch);
+
+  for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
+    {
+      if (prefetch[i].requested
+          && prefetch[i].record_len
+          && prefetch[i].record_id == record_id)
+        {
+          for (j = 0; j <= i; j++)
+            prefetch[j].requested = 0;
+          return (&prefetch[i]);
+        }
+    }
+
+  return (NULL);
+}
+
+/* returns 1 if predicted records are left the record list did not
+ * reach, 0 if not
+ */
+static int
+_sdr_cache_prefetch_pending (struct sdr_cache_prefetch *prefetch)
+{
+  unsigned int i;
+
+  assert (prefetch);
+
+  for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
+    {
+      if (prefetch[i].requested)
+        return (1);
+    }
+
+  return (0);
+}
+
+/* Read only the header of a record, enough to find the next record
+ * and see whether the cached copy still fits.  Returns the number of
+ * bytes read, or 0 if the BMC would not return the header.  If the
+ * reservation was cancelled, the repository changed during the
+ * update, '*repository_changed' is set and 0 is returned.
+ */
+static int
+_sdr_cache_get_record_header (ipmi_sdr_ctx_t ctx,
+                              ipmi_ctx_t ipmi_ctx,
+                              uint16_t record_id,
+                              void *record_buf,
+                              unsigned int record_buf_len,
+                              uint16_t reservation_id,
+                              uint16_t *next_record_id,
+                              int *repository_changed)
+{
+  fiid_obj_t obj_cmd_rs = NULL;
+  int sdr_record_len;
+  uint64_t val;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (record_buf);
+  assert (record_buf_len >= IPMI_SDR_RECORD_HEADER_LENGTH);
+  assert (next_record_id);
+  assert (repository_changed);
+
+  if (!(obj_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sdr_rs)))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (ipmi_cmd_get_sdr (ipmi_ctx,
+                        reservation_id,
+                        record_id,
+                        0,
+                        IPMI_SDR_RECORD_HEADER_LENGTH,
+                        obj_cmd_rs) < 0)
+    {
+      if (ipmi_ctx_errnum (ipmi_ctx) != IPMI_ERR_BAD_COMPLETION_CODE)
+        {
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+          goto cleanup;
+        }
+
+      if (FIID_OBJ_GET (obj_cmd_rs,
+                        "comp_code",
+                        &val) < 0)
+        {
+          SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+          goto cleanup;
+        }
+
+      if (val == IPMI_COMP_CODE_RESERVATION_CANCELLED)
+        (*repository_changed) = 1;
+
+      rv = 0;
+      goto cleanup;
+    }
+
+  if ((sdr_record_len = fiid_obj_get_data (obj_cmd_rs,
+                                           "record_data",
+                                           record_buf,
+                                           record_buf_len)) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+
+  if (sdr_record_len < IPMI_SDR_RECORD_HEADER_LENGTH)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "next_record_id",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  *next_record_id = val;
+
+  rv = sdr_record_len;
+ cleanup:
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rs);
+  return (rv);
+}
+
+static int
+_sdr_cache_old_record_compare (const void *a, const void *b)
+{
+  const struct sdr_cache_old_record *ra = a;
+  const struct sdr_cache_old_record *rb = b;
+
+  if (ra->record_id < rb->record_id)
+    return (-1);
+  if (ra->record_id > rb->record_id)
+    return (1);
+  return (0);
+}
+
+/* Returns the cached copy of the record if it still begins with
+ * 'prefix' and has the length the prefix's header claims.  Only
+ * valid while the repository has not been erased since the cache was
+ * made, see _sdr_cache_create().
+ */
+static const struct sdr_cache_old_record *
+_sdr_cache_old_record_find (const struct sdr_cache_old_records *old,
+                            const uint8_t *prefix,
+                            unsigned int prefix_len)
+{
+  struct sdr_cache_old_record key;
+  const struct sdr_cache_old_record *entry;
+  unsigned int len;
+
+  assert (old);
+  assert (prefix);
+  assert (prefix_len >= IPMI_SDR_RECORD_HEADER_LENGTH);
+
+  if (!old->count)
+    return (NULL);
+
+  key.record_id = prefix[0];
+  key.record_id |= (uint16_t)prefix[1] << 8;
+  if (!(entry = bsearch (&key,
+                         old->entries,
+                         old->count,
+                         sizeof (struct sdr_cache_old_record),
+                         _sdr_cache_old_record_compare)))
+    return (NULL);
+
+  if (entry->record_len != (prefix[IPMI_SDR_RECORD_LENGTH_INDEX] + IPMI_SDR_RECORD_HEADER_LENGTH))
+    return (NULL);
+
+  len = prefix_len < entry->record_len ? prefix_len : entry->record_len;
+  if (memcmp (old->records + entry->offset, prefix, len))
+    return (NULL);
+
+  return (entry);
+}
+
+/* Copy the records of an existing cache into memory.  A missing or
+ * invalid cache simply leaves 'old' empty.
+ */
+static int
+_sdr_cache_old_records_load (ipmi_sdr_ctx_t ctx,
+                             const char *filename,
+                             struct sdr_cache_old_records *old)
+{
+  uint16_t record_count;
+  int ret = 0;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (filename);
+  assert (old);
+
+  memset (old, '\0', sizeof (struct sdr_cache_old_records));
+
+  if (ipmi_sdr_cache_open (ctx, NULL, filename) < 0)
+    {
+      if (ctx->errnum == IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST
+          || ctx->errnum == IPMI_SDR_ERR_CACHE_INVALID)
+        return (0);
+      return (-1);
+    }
+
+  old->sdr_version = ctx->sdr_version;
+  old->most_recent_erase_timestamp = ctx->most_recent_erase_timestamp;
+
+  if (ipmi_sdr_cache_record_count (ctx, &record_count) < 0)
+    goto cleanup;
+
+  if (!record_count)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  if (!(old->records = (uint8_t *)malloc (record_count * IPMI_SDR_MAX_RECORD_LENGTH)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  if (!(old->entries = (struct sdr_cache_old_record *)malloc (record_count * sizeof (struct sdr_cache_old_record))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  if (ipmi_sdr_cache_first (ctx) < 0)
+    goto cleanup;
+
+  do
+    {
+      struct sdr_cache_old_record *entry;
+      int record_len;
+
+      if (old->count >= record_count)
+        break;
+
+      entry = &old->entries[old->count];
+
+      if ((record_len = ipmi_sdr_cache_record_read (ctx,
+                                                    old->records + old->records_len,
+                                                    IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
+        goto cleanup;
+
+      if (record_len < IPMI_SDR_RECORD_HEADER_LENGTH)
+        continue;
+
+      entry->record_id = old->records[old->records_len];
+      entry->record_id |= (uint16_t)old->records[old->records_len + 1] << 8;
+      entry->offset = old->records_len;
+      entry->record_len = record_len;
+      old->records_len += record_len;
+      old->count++;
+    } while ((ret = ipmi_sdr_cache_next (ctx)) == 1);
+
+  if (ret < 0)
+    goto cleanup;
+
+  qsort (old->entries,
+         old->count,
+         sizeof (struct sdr_cache_old_record),
+         _sdr_cache_old_record_compare);
+
+  rv = 0;
+ cleanup:
+  /* ignore potential error, cleanup path */
+  ipmi_sdr_cache_close (ctx);
+  if (rv < 0)
+    {
+      free (old->records);
+      free (old->entries);
+      memset (old, '\0', sizeof (struct sdr_cache_old_records));
+    }
+  return (rv);
+}
+
+static int
+_sdr_cache_create (ipmi_sdr_ctx_t ctx,
+                   ipmi_ctx_t ipmi_ctx,
+                   const char *filename,
+                   int cache_create_flags,
+                   Ipmi_Sdr_Cache_Create_Callback create_callback,
+                   void *create_callback_data,
+                   const struct sdr_cache_old_records *old)
+{
+  int open_flags;
+  uint8_t sdr_version;
+  uint16_t record_count, reservation_id, record_id, next_record_id;
+  uint32_t most_recent_addition_timestamp, most_recent_erase_timestamp;
+  unsigned int record_count_written = 0;
+  unsigned int total_bytes_written = 0;
+  uint16_t *record_ids = NULL;
+  unsigned int record_ids_count = 0;
+  uint8_t *records = NULL;
+  unsigned int records_len = 0;
+  unsigned int cache_create_flags_mask = (IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED);
+  struct sdr_cache_prefetch *prefetch = NULL;
+  fiid_obj_t prefetch_rq[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  fiid_obj_t prefetch_rs[IPMI_SDR_CACHE_PIPELINE_DEPTH];
+  uint16_t prefetch_stride = 1;
+  uint8_t trailer_checksum = 0;
+  int reserved = 0;
+  unsigned int i;
+  int fd = -1;
+  int rv = -1;
+
+  memset (prefetch_rq, '\0', sizeof (prefetch_rq));
+  memset (prefetch_rs, '\0', sizeof (prefetch_rs));
+
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  /* Version cannot be 0h according to the IPMI spec */
+  if (!ipmi_ctx
+      || !filename
+      || (strlen (filename) > MAXPATHLEN)
+      || (cache_create_flags & ~cache_create_flags_mask))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (-1);
     }
 
   if (ctx->operation != IPMI_SDR_OPERATION_UNINITIALIZED)
@@ -849,6 +1391,18 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
+  /* Reserve before reading the timestamps, so a change after they
+   * were read cancels the reservation records are reused under.
+   */
+  if (old)
+    {
+      if (_sdr_cache_reservation_id (ctx,
+                                     ipmi_ctx,
+                                     &reservation_id) < 0)
+        goto cleanup;
+      reserved = 1;
+    }
+
   if (sdr_info (ctx,
                 ipmi_ctx,
                 &sdr_version,
@@ -863,6 +1417,17 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
+  /* Records can only be added to a repository, or deleted or the
+   * whole repository cleared, which moves the erase timestamp.  While
+   * it has not moved, every cached record is still current and only
+   * records added since need to be read.  Otherwise read everything.
+   */
+  if (old
+      && (!old->count
+          || old->sdr_version != sdr_version
+          || old->most_recent_erase_timestamp != most_recent_erase_timestamp))
+    old = NULL;
+
   if (_sdr_cache_header_write (ctx,
                                ipmi_ctx,
                                fd,
@@ -889,11 +1454,51 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
       record_ids_count = 0;
     }
 
-  if (_sdr_cache_reservation_id (ctx,
-                                 ipmi_ctx,
-                                 &reservation_id) < 0)
+  /* At most record_count records are written, see the Inspur
+   * workaround below.
+   */
+  if (!(records = (uint8_t *)malloc (ctx->record_count * IPMI_SDR_MAX_RECORD_LENGTH)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  /* Speculative full reads would defeat the point of an update */
+  if ((cache_create_flags & IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED)
+      && !old)
+    {
+      if (!(prefetch = (struct sdr_cache_prefetch *)malloc (IPMI_SDR_CACHE_PIPELINE_DEPTH * sizeof (struct sdr_cache_prefetch))))
+        {
+          SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+          goto cleanup;
+        }
+
+      for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
+        {
+          prefetch[i].record_len = 0;
+          prefetch[i].requested = 0;
+
+          if (!(prefetch_rq[i] = fiid_obj_create (tmpl_cmd_get_sdr_rq)))
+            {
+              SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
+
+          if (!(prefetch_rs[i] = fiid_obj_create (tmpl_cmd_get_sdr_rs)))
+            {
+              SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
+        }
+    }
+
+  if (!reserved
+      && _sdr_cache_reservation_id (ctx,
+                                    ipmi_ctx,
+                                    &reservation_id) < 0)
     goto cleanup;
 
+  record_id = IPMI_SDR_RECORD_ID_FIRST;
   next_record_id = IPMI_SDR_RECORD_ID_FIRST;
   while (next_record_id != IPMI_SDR_RECORD_ID_LAST)
     {
@@ -920,15 +1525,99 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
           goto cleanup;
         }
 
+      /* Guess the spacing of the next batch from the last link */
+      if (next_record_id > record_id
+          && record_id != IPMI_SDR_RECORD_ID_FIRST)
+        prefetch_stride = next_record_id - record_id;
+
       record_id = next_record_id;
-      if ((record_len = _sdr_cache_get_record (ctx,
-                                               ipmi_ctx,
-                                               record_id,
-                                               record_buf,
-                                               IPMI_SDR_MAX_RECORD_LENGTH,
-                                               &reservation_id,
-                                               &next_record_id)) < 0)
-        goto cleanup;
+      record_len = -1;
+
+      if (old)
+        {
+          const struct sdr_cache_old_record *entry;
+          uint16_t header_next_record_id;
+          int repository_changed = 0;
+          int header_len;
+
+          if ((header_len = _sdr_cache_get_record_header (ctx,
+                                                          ipmi_ctx,
+                                                          record_id,
+                                                          record_buf,
+                                                          IPMI_SDR_MAX_RECORD_LENGTH,
+                                                          reservation_id,
+                                                          &header_next_record_id,
+                                                          &repository_changed)) < 0)
+            goto cleanup;
+
+          /* Changed under us, the records reused so far were read
+           * under the reservation, read the rest in full.
+           */
+          if (repository_changed)
+            old = NULL;
+          else if (header_len
+                   && (entry = _sdr_cache_old_record_find (old,
+                                                           record_buf,
+                                                           header_len)))
+            {
+              memcpy (record_buf, old->records + entry->offset, entry->record_len);
+              record_len = entry->record_len;
+              next_record_id = header_next_record_id;
+            }
+        }
+
+      if (prefetch)
+        {
+          struct sdr_cache_prefetch *p;
+
+          if (!(p = _sdr_cache_prefetch_find (prefetch, record_id)))
+            {
+              /* The record list left the predicted record ids, or
+               * the record could not be read in one request.  Don't
+               * speculate for the rest of the SDR, every further
+               * batch would likely be wasted as well.
+               */
+              if (!_sdr_cache_prefetch_pending (prefetch))
+                {
+                  if (_sdr_cache_prefetch_records (ctx,
+                                                   ipmi_ctx,
+                                                   record_id,
+                                                   prefetch_stride,
+                                                   &reservation_id,
+                                                   prefetch_rq,
+                                                   prefetch_rs,
+                                                   prefetch) < 0)
+                    goto cleanup;
+
+                  p = _sdr_cache_prefetch_find (prefetch, record_id);
+                }
+
+              if (!p)
+                {
+                  free (prefetch);
+                  prefetch = NULL;
+                }
+            }
+
+          if (p)
+            {
+              memcpy (record_buf, p->record, p->record_len);
+              record_len = p->record_len;
+              next_record_id = p->next_record_id;
+            }
+        }
+
+      if (record_len < 0)
+        {
+          if ((record_len = _sdr_cache_get_record (ctx,
+                                                   ipmi_ctx,
+                                                   record_id,
+                                                   record_buf,
+                                                   IPMI_SDR_MAX_RECORD_LENGTH,
+                                                   &reservation_id,
+                                                   &next_record_id)) < 0)
+            goto cleanup;
+        }
 
       if (record_len)
         {
@@ -965,6 +1654,8 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
                                        &total_bytes_written,
                                        record_ids,
                                        &record_ids_count,
+                                       records,
+                                       &records_len,
                                        record_buf,
                                        record_len,
                                        &trailer_checksum) < 0)
@@ -1044,6 +1735,14 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
         }
     }
 
+  if (sdr_cache_index_write (ctx,
+                             fd,
+                             records,
+                             records_len,
+                             &total_bytes_written,
+                             &trailer_checksum) < 0)
+    goto cleanup;
+
   if (_sdr_cache_trailer_write (ctx,
                                 ipmi_ctx,
                                 fd,
@@ -1076,7 +1775,132 @@ ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
       /* ignore potential error, cleanup path */
       close (fd);
     }
+  for (i = 0; i < IPMI_SDR_CACHE_PIPELINE_DEPTH; i++)
+    {
+      fiid_obj_destroy (prefetch_rq[i]);
+      fiid_obj_destroy (prefetch_rs[i]);
+    }
+  free (prefetch);
   free (record_ids);
+  free (records);
   sdr_init_ctx (ctx);
   return (rv);
 }
+
+int
+ipmi_sdr_cache_create (ipmi_sdr_ctx_t ctx,
+                       ipmi_ctx_t ipmi_ctx,
+                       const char *filename,
+                       int cache_create_flags,
+                       Ipmi_Sdr_Cache_Create_Callback create_callback,
+                       void *create_callback_data)
+{
+  return (_sdr_cache_create (ctx,
+                             ipmi_ctx,
+                             filename,
+                             cache_create_flags,
+                             create_callback,
+                             create_callback_data,
+                             NULL));
+}
+
+int
+ipmi_sdr_cache_update (ipmi_sdr_ctx_t ctx,
+                       ipmi_ctx_t ipmi_ctx,
+                       const char *filename,
+                       int cache_create_flags,
+                       Ipmi_Sdr_Cache_Create_Callback create_callback,
+                       void *create_callback_data)
+{
+  struct sdr_cache_old_records old;
+  char tmppath[MAXPATHLEN + 1];
+  unsigned int cache_create_flags_mask = (IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED);
+  int tmpfd;
+  int rv = -1;
+
+  memset (&old, '\0', sizeof (struct sdr_cache_old_records));
+  tmppath[0] = '\0';
+
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!ipmi_ctx
+      || !filename
+      || (strlen (filename) + strlen (".XXXXXX") > MAXPATHLEN)
+      || (cache_create_flags & ~cache_create_flags_mask))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (ctx->operation != IPMI_SDR_OPERATION_UNINITIALIZED)
+    {
+      if (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE)
+        SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CONTEXT_PERFORMING_OTHER_OPERATION);
+      else
+        SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
+      return (-1);
+    }
+
+  if (_sdr_cache_old_records_load (ctx, filename, &old) < 0)
+    goto cleanup;
+
+  /* Build the new cache next to the old one and rename it into
+   * place, readers that already mapped the old cache keep it.
+   */
+  snprintf (tmppath,
+            MAXPATHLEN + 1,
+            "%s.XXXXXX",
+            filename);
+
+  if ((tmpfd = mkstemp (tmppath)) < 0)
+    {
+      if (errno == ENOENT
+          || errno == ENOTDIR)
+        SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      else
+        SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      tmppath[0] = '\0';
+      goto cleanup;
+    }
+  /* ignore potential error, file is rewritten below */
+  close (tmpfd);
+
+  if (_sdr_cache_create (ctx,
+                         ipmi_ctx,
+                         tmppath,
+                         cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE,
+                         create_callback,
+                         create_callback_data,
+                         &old) < 0)
+    goto cleanup;
+
+  /* mkstemp() creates the file 0600 */
+  if (chmod (tmppath, 0644) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (rename (tmppath, filename) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  rv = 0;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+ cleanup:
+  /* ignore potential error, cleanup path */
+  if (rv < 0 && tmppath[0])
+    unlink (tmppath);
+  free (old.records);
+  free (old.entries);
+  return (rv);
+}
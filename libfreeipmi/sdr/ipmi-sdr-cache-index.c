@@ -0,0 +1,869 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+
+#include "freeipmi/sdr/ipmi-sdr.h"
+#include "freeipmi/record-format/ipmi-sdr-record-format.h"
+#include "freeipmi/util/ipmi-util.h"
+
+#include "ipmi-sdr-cache-index.h"
+#include "ipmi-sdr-common.h"
+#include "ipmi-sdr-defs.h"
+#include "ipmi-sdr-trace.h"
+#include "ipmi-sdr-util.h"
+
+#include "freeipmi-portability.h"
+#include "fd.h"
+
+#define SDR_CACHE_INDEX_BITS_MIN 4
+
+#define SDR_CACHE_INDEX_SENSOR_KEY(__sensor_owner_id, __sensor_number) \
+  ((((uint32_t)(__sensor_owner_id)) << 8) | (uint32_t)(__sensor_number))
+
+static unsigned int
+_sdr_cache_index_bits (unsigned int entries)
+{
+  unsigned int bits = SDR_CACHE_INDEX_BITS_MIN;
+
+  /* keep the load factor at or below 1/2 */
+  while ((1U << bits) < (entries * 2))
+    bits++;
+
+  return (bits);
+}
+
+static uint32_t
+_sdr_cache_index_hash (uint32_t key, unsigned int bits)
+{
+  /* Fibonacci hashing */
+  return ((key * 0x9E3779B1U) >> (32 - bits));
+}
+
+/* returns 1 if inserted, 0 if key already present */
+static int
+_sdr_cache_index_insert (struct ipmi_sdr_cache_index_slot *slots,
+                         unsigned int bits,
+                         uint32_t key,
+                         uint32_t pos)
+{
+  uint32_t mask = (1U << bits) - 1;
+  uint32_t i;
+
+  assert (slots);
+  assert (pos);
+
+  i = _sdr_cache_index_hash (key, bits);
+  while (slots[i].pos)
+    {
+      if (slots[i].key == key)
+        return (0);
+      i = (i + 1) & mask;
+    }
+
+  slots[i].key = key;
+  slots[i].pos = pos;
+  return (1);
+}
+
+static uint32_t
+_sdr_cache_index_lookup (const struct ipmi_sdr_cache_index_slot *slots,
+                         unsigned int bits,
+                         uint32_t key)
+{
+  uint32_t mask = (1U << bits) - 1;
+  uint32_t i;
+
+  assert (slots);
+
+  i = _sdr_cache_index_hash (key, bits);
+  while (slots[i].pos)
+    {
+      if (slots[i].key == key)
+        return (slots[i].pos);
+      i = (i + 1) & mask;
+    }
+
+  return (0);
+}
+
+/* Returns 1 and the range of sensor numbers a record answers to in
+ * ipmi_sdr_cache_search_sensor() if it is a sensor record, 0 if not.
+ */
+static int
+_sdr_cache_index_sensor_range (const uint8_t *cache,
+                               off_t cache_len,
+                               off_t offset,
+                               uint8_t *sensor_owner_id,
+                               unsigned int *sensor_number_first,
+                               unsigned int *sensor_number_last)
+{
+  const uint8_t *ptr = cache + offset;
+  uint8_t record_type;
+  uint8_t share_count = 0;
+
+  if ((offset + IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX) >= cache_len)
+    return (0);
+
+  record_type = ptr[IPMI_SDR_RECORD_TYPE_INDEX];
+
+  if (record_type != IPMI_SDR_FORMAT_FULL_SENSOR_RECORD
+      && record_type != IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD
+      && record_type != IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
+    return (0);
+
+  (*sensor_owner_id) = ptr[IPMI_SDR_RECORD_SENSOR_OWNER_ID_INDEX];
+  (*sensor_number_first) = ptr[IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX];
+
+  if (record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD
+      && (offset + IPMI_SDR_RECORD_COMPACT_SHARE_COUNT) < cache_len)
+    {
+      share_count = ptr[IPMI_SDR_RECORD_COMPACT_SHARE_COUNT];
+      share_count &= IPMI_SDR_RECORD_COMPACT_SHARE_COUNT_BITMASK;
+      share_count >>= IPMI_SDR_RECORD_COMPACT_SHARE_COUNT_SHIFT;
+    }
+  else if (record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD
+           && (offset + IPMI_SDR_RECORD_EVENT_SHARE_COUNT) < cache_len)
+    {
+      share_count = ptr[IPMI_SDR_RECORD_EVENT_SHARE_COUNT];
+      share_count &= IPMI_SDR_RECORD_EVENT_SHARE_COUNT_BITMASK;
+      share_count >>= IPMI_SDR_RECORD_EVENT_SHARE_COUNT_SHIFT;
+    }
+
+  /* sensor numbers beyond 255 cannot be searched for */
+  (*sensor_number_last) = (*sensor_number_first);
+  if (share_count > 1)
+    {
+      (*sensor_number_last) += (share_count - 1);
+      if ((*sensor_number_last) > UCHAR_MAX)
+        (*sensor_number_last) = UCHAR_MAX;
+    }
+
+  return (1);
+}
+
+/* Walks records exactly as the linear searches in
+ * ipmi-sdr-cache-read.c did.  If index is NULL, only counts records
+ * and sensor index entries.
+ */
+static void
+_sdr_cache_index_walk (const uint8_t *cache,
+                       off_t cache_len,
+                       off_t records_start_offset,
+                       off_t records_end_offset,
+                       struct ipmi_sdr_cache_index *index,
+                       unsigned int *record_count,
+                       unsigned int *sensor_count)
+{
+  unsigned int records = 0;
+  unsigned int sensors = 0;
+  off_t offset;
+
+  offset = records_start_offset;
+  while (offset < records_end_offset)
+    {
+      const uint8_t *ptr = cache + offset;
+      uint8_t sensor_owner_id;
+      unsigned int sensor_number_first, sensor_number_last;
+      unsigned int record_length;
+
+      if (index)
+        {
+          uint16_t record_id;
+
+          /* Record ID stored little-endian */
+          record_id = (uint16_t)ptr[IPMI_SDR_RECORD_ID_INDEX_LS] & 0xFF;
+          record_id |= ((uint16_t)ptr[IPMI_SDR_RECORD_ID_INDEX_MS] & 0xFF) << 8;
+
+          index->offset[records] = offset;
+          _sdr_cache_index_insert (index->record_id_slots,
+                                   index->record_id_bits,
+                                   record_id,
+                                   records + 1);
+        }
+
+      if (_sdr_cache_index_sensor_range (cache,
+                                         cache_len,
+                                         offset,
+                                         &sensor_owner_id,
+                                         &sensor_number_first,
+                                         &sensor_number_last))
+        {
+          unsigned int n;
+
+          for (n = sensor_number_first; n <= sensor_number_last; n++)
+            {
+              if (index)
+                _sdr_cache_index_insert (index->sensor_slots,
+                                         index->sensor_bits,
+                                         SDR_CACHE_INDEX_SENSOR_KEY (sensor_owner_id, n),
+                                         records + 1);
+              sensors++;
+            }
+        }
+
+      records++;
+
+      record_length = (uint8_t)ptr[IPMI_SDR_RECORD_LENGTH_INDEX];
+
+      if ((offset + record_length + IPMI_SDR_RECORD_HEADER_LENGTH) >= records_end_offset)
+        break;
+
+      offset += IPMI_SDR_RECORD_HEADER_LENGTH;
+      offset += record_length;
+    }
+
+  if (record_count)
+    (*record_count) = records;
+  if (sensor_count)
+    (*sensor_count) = sensors;
+}
+
+static void
+_sdr_cache_index_free (struct ipmi_sdr_cache_index *index)
+{
+  if (!index)
+    return;
+
+  free (index->offset);
+  free (index->record_id_slots);
+  free (index->sensor_slots);
+  free (index);
+}
+
+static struct ipmi_sdr_cache_index *
+_sdr_cache_index_create (const uint8_t *cache,
+                         off_t cache_len,
+                         off_t records_start_offset,
+                         off_t records_end_offset)
+{
+  struct ipmi_sdr_cache_index *index = NULL;
+  unsigned int record_count, sensor_count;
+
+  assert (cache);
+
+  _sdr_cache_index_walk (cache,
+                         cache_len,
+                         records_start_offset,
+                         records_end_offset,
+                         NULL,
+                         &record_count,
+                         &sensor_count);
+
+  if (!(index = (struct ipmi_sdr_cache_index *)malloc (sizeof (struct ipmi_sdr_cache_index))))
+    goto cleanup;
+  memset (index, '\0', sizeof (struct ipmi_sdr_cache_index));
+
+  index->count = record_count;
+  index->record_id_bits = _sdr_cache_index_bits (record_count);
+  index->sensor_bits = _sdr_cache_index_bits (sensor_count);
+
+  /* +1, calloc (0, ...) may legitimately return NULL */
+  if (!(index->offset = (off_t *)calloc (record_count + 1, sizeof (off_t))))
+    goto cleanup;
+
+  if (!(index->record_id_slots = (struct ipmi_sdr_cache_index_slot *)calloc (1U << index->record_id_bits,
+                                                                             sizeof (struct ipmi_sdr_cache_index_slot))))
+    goto cleanup;
+
+  if (!(index->sensor_slots = (struct ipmi_sdr_cache_index_slot *)calloc (1U << index->sensor_bits,
+                                                                          sizeof (struct ipmi_sdr_cache_index_slot))))
+    goto cleanup;
+
+  _sdr_cache_index_walk (cache,
+                         cache_len,
+                         records_start_offset,
+                         records_end_offset,
+                         index,
+                         NULL,
+                         NULL);
+
+  return (index);
+
+ cleanup:
+  _sdr_cache_index_free (index);
+  return (NULL);
+}
+
+int
+sdr_cache_index_build (ipmi_sdr_ctx_t ctx)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->sdr_cache);
+  assert (!ctx->cache_index);
+
+  if (!(ctx->cache_index = _sdr_cache_index_create (ctx->sdr_cache,
+                                                    ctx->file_size,
+                                                    ctx->records_start_offset,
+                                                    ctx->records_end_offset)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+
+  return (0);
+}
+
+static uint32_t
+_sdr_cache_index_get32 (const uint8_t *ptr)
+{
+  uint32_t val;
+
+  /* stored little-endian */
+  val = (uint32_t)ptr[0];
+  val |= (uint32_t)ptr[1] << 8;
+  val |= (uint32_t)ptr[2] << 16;
+  val |= (uint32_t)ptr[3] << 24;
+  return (val);
+}
+
+static void
+_sdr_cache_index_set32 (uint8_t *ptr, uint32_t val)
+{
+  /* stored little-endian */
+  ptr[0] = (val & 0x000000FF);
+  ptr[1] = (val & 0x0000FF00) >> 8;
+  ptr[2] = (val & 0x00FF0000) >> 16;
+  ptr[3] = (val & 0xFF000000) >> 24;
+}
+
+/* Returns the entry count of the section at offset, -1 if the
+ * entries do not fit before section_end.
+ */
+static int64_t
+_sdr_cache_index_section_count (ipmi_sdr_ctx_t ctx,
+                                off_t offset,
+                                off_t section_end,
+                                unsigned int entry_length)
+{
+  uint32_t count;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (entry_length);
+
+  if (offset > section_end
+      || (section_end - offset) < SDR_CACHE_INDEX_COUNT_LENGTH)
+    return (-1);
+
+  count = _sdr_cache_index_get32 (ctx->sdr_cache + offset);
+
+  if ((int64_t)count * entry_length > (int64_t)(section_end - offset - SDR_CACHE_INDEX_COUNT_LENGTH))
+    return (-1);
+
+  return (count);
+}
+
+int
+sdr_cache_index_load (ipmi_sdr_ctx_t ctx,
+                      off_t record_id_index_offset,
+                      off_t sensor_index_offset,
+                      off_t name_table_offset)
+{
+  struct ipmi_sdr_cache_index *index = NULL;
+  int64_t record_id_entries_count;
+  int64_t sensor_entries_count;
+  int64_t name_entries_count;
+  off_t sections_end_offset;
+  off_t name_strings_offset;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->sdr_cache);
+  assert (!ctx->cache_index);
+
+  /* sections end where their offsets, total bytes, and checksum begin */
+  sections_end_offset = ctx->file_size - SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH - 4 - 1;
+
+  if (record_id_index_offset < ctx->records_start_offset
+      || sensor_index_offset < record_id_index_offset
+      || name_table_offset < sensor_index_offset
+      || sections_end_offset < name_table_offset)
+    goto invalid;
+
+  if ((record_id_entries_count = _sdr_cache_index_section_count (ctx,
+                                                                 record_id_index_offset,
+                                                                 sensor_index_offset,
+                                                                 SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH)) < 0)
+    goto invalid;
+
+  if ((sensor_entries_count = _sdr_cache_index_section_count (ctx,
+                                                              sensor_index_offset,
+                                                              name_table_offset,
+                                                              SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH)) < 0)
+    goto invalid;
+
+  if ((name_entries_count = _sdr_cache_index_section_count (ctx,
+                                                            name_table_offset,
+                                                            sections_end_offset,
+                                                            SDR_CACHE_INDEX_NAME_ENTRY_LENGTH)) < 0)
+    goto invalid;
+
+  if (!(index = (struct ipmi_sdr_cache_index *)malloc (sizeof (struct ipmi_sdr_cache_index))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+  memset (index, '\0', sizeof (struct ipmi_sdr_cache_index));
+
+  index->record_id_entries = ctx->sdr_cache + record_id_index_offset + SDR_CACHE_INDEX_COUNT_LENGTH;
+  index->record_id_entries_count = record_id_entries_count;
+  index->sensor_entries = ctx->sdr_cache + sensor_index_offset + SDR_CACHE_INDEX_COUNT_LENGTH;
+  index->sensor_entries_count = sensor_entries_count;
+  index->name_entries = ctx->sdr_cache + name_table_offset + SDR_CACHE_INDEX_COUNT_LENGTH;
+  index->name_entries_count = name_entries_count;
+
+  name_strings_offset = name_table_offset + SDR_CACHE_INDEX_COUNT_LENGTH;
+  name_strings_offset += name_entries_count * SDR_CACHE_INDEX_NAME_ENTRY_LENGTH;
+  index->name_strings = ctx->sdr_cache + name_strings_offset;
+  index->name_strings_len = sections_end_offset - name_strings_offset;
+
+  ctx->cache_index = index;
+  return (0);
+
+ invalid:
+  SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+  return (-1);
+}
+
+struct sdr_cache_index_entry {
+  uint32_t key;
+  uint32_t offset;
+};
+
+static int
+_sdr_cache_index_entry_cmp (const void *a, const void *b)
+{
+  const struct sdr_cache_index_entry *ea = (const struct sdr_cache_index_entry *)a;
+  const struct sdr_cache_index_entry *eb = (const struct sdr_cache_index_entry *)b;
+
+  if (ea->key < eb->key)
+    return (-1);
+  if (ea->key > eb->key)
+    return (1);
+  return (0);
+}
+
+/* Returns the occupied slots, sorted by key, with record offsets
+ * relative to the start of the file.  Keys are unique.
+ */
+static unsigned int
+_sdr_cache_index_entries (const struct ipmi_sdr_cache_index *index,
+                          const struct ipmi_sdr_cache_index_slot *slots,
+                          unsigned int bits,
+                          uint32_t records_offset,
+                          struct sdr_cache_index_entry *entries)
+{
+  unsigned int count = 0;
+  uint32_t i;
+
+  for (i = 0; i < (1U << bits); i++)
+    {
+      if (!slots[i].pos)
+        continue;
+      entries[count].key = slots[i].key;
+      entries[count].offset = records_offset + index->offset[slots[i].pos - 1];
+      count++;
+    }
+
+  qsort (entries, count, sizeof (struct sdr_cache_index_entry), _sdr_cache_index_entry_cmp);
+  return (count);
+}
+
+int
+sdr_cache_index_write (ipmi_sdr_ctx_t ctx,
+                       int fd,
+                       const uint8_t *records,
+                       unsigned int records_len,
+                       unsigned int *total_bytes_written,
+                       uint8_t *trailer_checksum)
+{
+  struct ipmi_sdr_cache_index *index = NULL;
+  struct sdr_cache_index_entry *entries = NULL;
+  unsigned int entries_len;
+  uint8_t *buf = NULL;
+  unsigned int buflen = 0;
+  unsigned int buf_size;
+  uint32_t records_offset;
+  uint32_t record_id_index_offset;
+  uint32_t sensor_index_offset;
+  uint32_t name_table_offset;
+  unsigned int name_strings_len = 0;
+  uint8_t *name_entry;
+  unsigned int count;
+  unsigned int i;
+  ssize_t n;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (fd);
+  assert (records);
+  assert (total_bytes_written);
+  assert ((*total_bytes_written) >= records_len);
+  assert (trailer_checksum);
+
+  records_offset = (*total_bytes_written) - records_len;
+
+  if (!(index = _sdr_cache_index_create (records,
+                                         records_len,
+                                         0,
+                                         records_len)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  entries_len = (1U << index->record_id_bits);
+  if ((1U << index->sensor_bits) > entries_len)
+    entries_len = (1U << index->sensor_bits);
+
+  buf_size = SDR_CACHE_INDEX_COUNT_LENGTH + SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH * (1U << index->record_id_bits);
+  buf_size += SDR_CACHE_INDEX_COUNT_LENGTH + SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH * (1U << index->sensor_bits);
+  buf_size += SDR_CACHE_INDEX_COUNT_LENGTH;
+  buf_size += (SDR_CACHE_INDEX_NAME_ENTRY_LENGTH + IPMI_SDR_MAX_ID_STRING_LENGTH) * index->count;
+  buf_size += SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH;
+
+  if (!(entries = (struct sdr_cache_index_entry *)malloc (entries_len * sizeof (struct sdr_cache_index_entry))))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  if (!(buf = (uint8_t *)malloc (buf_size)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
+  /* record id index */
+  record_id_index_offset = (*total_bytes_written) + buflen;
+  count = _sdr_cache_index_entries (index,
+                                    index->record_id_slots,
+                                    index->record_id_bits,
+                                    records_offset,
+                                    entries);
+  _sdr_cache_index_set32 (buf + buflen, count);
+  buflen += SDR_CACHE_INDEX_COUNT_LENGTH;
+  for (i = 0; i < count; i++)
+    {
+      buf[buflen] = (entries[i].key & 0x00FF);
+      buf[buflen + 1] = (entries[i].key & 0xFF00) >> 8;
+      _sdr_cache_index_set32 (buf + buflen + 2, entries[i].offset);
+      buflen += SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH;
+    }
+
+  /* sensor index */
+  sensor_index_offset = (*total_bytes_written) + buflen;
+  count = _sdr_cache_index_entries (index,
+                                    index->sensor_slots,
+                                    index->sensor_bits,
+                                    records_offset,
+                                    entries);
+  _sdr_cache_index_set32 (buf + buflen, count);
+  buflen += SDR_CACHE_INDEX_COUNT_LENGTH;
+  for (i = 0; i < count; i++)
+    {
+      /* sensor owner id, then sensor number */
+      buf[buflen] = (entries[i].key & 0xFF00) >> 8;
+      buf[buflen + 1] = (entries[i].key & 0x00FF);
+      _sdr_cache_index_set32 (buf + buflen + 2, entries[i].offset);
+      buflen += SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH;
+    }
+
+  /* name table, id strings follow the entries */
+  name_table_offset = (*total_bytes_written) + buflen;
+  _sdr_cache_index_set32 (buf + buflen, index->count);
+  buflen += SDR_CACHE_INDEX_COUNT_LENGTH;
+  name_entry = buf + buflen;
+  buflen += SDR_CACHE_INDEX_NAME_ENTRY_LENGTH * index->count;
+  for (i = 0; i < index->count; i++)
+    {
+      const uint8_t *record = records + index->offset[i];
+      unsigned int record_len;
+      char id_string[IPMI_SDR_MAX_ID_STRING_LENGTH];
+      int len;
+
+      record_len = IPMI_SDR_RECORD_HEADER_LENGTH + record[IPMI_SDR_RECORD_LENGTH_INDEX];
+      if ((index->offset[i] + record_len) > records_len)
+        record_len = records_len - index->offset[i];
+
+      _sdr_cache_index_set32 (name_entry, records_offset + index->offset[i]);
+
+      /* records without an id string are left to the parse path */
+      if ((len = ipmi_sdr_parse_id_string (ctx,
+                                           record,
+                                           record_len,
+                                           id_string,
+                                           IPMI_SDR_MAX_ID_STRING_LENGTH)) < 0)
+        {
+          _sdr_cache_index_set32 (name_entry + 4, SDR_CACHE_INDEX_NAME_NONE);
+          name_entry[8] = 0;
+        }
+      else
+        {
+          _sdr_cache_index_set32 (name_entry + 4, name_strings_len);
+          name_entry[8] = len;
+          memcpy (buf + buflen, id_string, len);
+          buflen += len;
+          name_strings_len += len;
+        }
+
+      name_entry += SDR_CACHE_INDEX_NAME_ENTRY_LENGTH;
+    }
+
+  _sdr_cache_index_set32 (buf + buflen, record_id_index_offset);
+  buflen += 4;
+  _sdr_cache_index_set32 (buf + buflen, sensor_index_offset);
+  buflen += 4;
+  _sdr_cache_index_set32 (buf + buflen, name_table_offset);
+  buflen += 4;
+
+  assert (buflen <= buf_size);
+
+  if ((n = fd_write_n (fd, buf, buflen)) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+  if (n != buflen)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_SYSTEM_ERROR);
+      goto cleanup;
+    }
+  (*total_bytes_written) += buflen;
+
+  (*trailer_checksum) = ipmi_checksum_incremental (buf, buflen, (*trailer_checksum));
+
+  rv = 0;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+ cleanup:
+  _sdr_cache_index_free (index);
+  free (entries);
+  free (buf);
+  return (rv);
+}
+
+void
+sdr_cache_index_destroy (ipmi_sdr_ctx_t ctx)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+
+  _sdr_cache_index_free (ctx->cache_index);
+  ctx->cache_index = NULL;
+}
+
+/* Binary search entries stored in a version 1.3 cache, returns the
+ * entry or NULL if not found.
+ */
+static const uint8_t *
+_sdr_cache_index_search (const uint8_t *entries,
+                         unsigned int entries_count,
+                         unsigned int entry_length,
+                         uint32_t (*entry_key)(const uint8_t *),
+                         uint32_t key)
+{
+  unsigned int lo = 0, hi = entries_count;
+
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (entry_key (entries + mid * entry_length) < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo >= entries_count
+      || entry_key (entries + lo * entry_length) != key)
+    return (NULL);
+
+  return (entries + lo * entry_length);
+}
+
+static uint32_t
+_sdr_cache_index_record_id_key (const uint8_t *entry)
+{
+  /* Record ID stored little-endian */
+  return ((uint32_t)entry[0] | ((uint32_t)entry[1] << 8));
+}
+
+static uint32_t
+_sdr_cache_index_sensor_key (const uint8_t *entry)
+{
+  return (SDR_CACHE_INDEX_SENSOR_KEY (entry[0], entry[1]));
+}
+
+/* Returns 1 and offset of record at entry if it lies within the
+ * records, 0 if not.
+ */
+static int
+_sdr_cache_index_entry_offset (ipmi_sdr_ctx_t ctx,
+                               const uint8_t *entry,
+                               off_t *offset)
+{
+  off_t entry_offset;
+
+  entry_offset = _sdr_cache_index_get32 (entry);
+
+  if (entry_offset < ctx->records_start_offset
+      || (entry_offset + IPMI_SDR_RECORD_HEADER_LENGTH) > ctx->records_end_offset)
+    return (0);
+
+  (*offset) = entry_offset;
+  return (1);
+}
+
+int
+sdr_cache_index_find_record_id (ipmi_sdr_ctx_t ctx,
+                                uint16_t record_id,
+                                off_t *offset)
+{
+  struct ipmi_sdr_cache_index *index;
+  const uint8_t *entry;
+  uint32_t pos;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->cache_index);
+  assert (offset);
+
+  index = ctx->cache_index;
+
+  if (index->record_id_entries)
+    {
+      if (!(entry = _sdr_cache_index_search (index->record_id_entries,
+                                             index->record_id_entries_count,
+                                             SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH,
+                                             _sdr_cache_index_record_id_key,
+                                             record_id)))
+        return (0);
+
+      return (_sdr_cache_index_entry_offset (ctx, entry + 2, offset));
+    }
+
+  if (!(pos = _sdr_cache_index_lookup (index->record_id_slots,
+                                       index->record_id_bits,
+                                       record_id)))
+    return (0);
+
+  (*offset) = index->offset[pos - 1];
+  return (1);
+}
+
+int
+sdr_cache_index_find_sensor (ipmi_sdr_ctx_t ctx,
+                             uint8_t sensor_number,
+                             uint8_t sensor_owner_id,
+                             off_t *offset)
+{
+  struct ipmi_sdr_cache_index *index;
+  const uint8_t *entry;
+  uint32_t pos;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->cache_index);
+  assert (offset);
+
+  index = ctx->cache_index;
+
+  if (index->sensor_entries)
+    {
+      if (!(entry = _sdr_cache_index_search (index->sensor_entries,
+                                             index->sensor_entries_count,
+                                             SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH,
+                                             _sdr_cache_index_sensor_key,
+                                             SDR_CACHE_INDEX_SENSOR_KEY (sensor_owner_id, sensor_number))))
+        return (0);
+
+      return (_sdr_cache_index_entry_offset (ctx, entry + 2, offset));
+    }
+
+  if (!(pos = _sdr_cache_index_lookup (index->sensor_slots,
+                                       index->sensor_bits,
+                                       SDR_CACHE_INDEX_SENSOR_KEY (sensor_owner_id, sensor_number))))
+    return (0);
+
+  (*offset) = index->offset[pos - 1];
+  return (1);
+}
+
+int
+sdr_cache_index_id_string (ipmi_sdr_ctx_t ctx,
+                           const void *sdr_record,
+                           unsigned int sdr_record_len,
+                           const char **id_string,
+                           unsigned int *id_string_len)
+{
+  struct ipmi_sdr_cache_index *index;
+  const uint8_t *entry;
+  uint32_t name_offset;
+  uint8_t name_len;
+
+  assert (id_string);
+  assert (id_string_len);
+
+  if (!ctx
+      || ctx->magic != IPMI_SDR_CTX_MAGIC
+      || !ctx->cache_index
+      || !ctx->cache_index->name_entries
+      || ctx->operation != IPMI_SDR_OPERATION_READ_CACHE
+      || sdr_record
+      || sdr_record_len)
+    return (0);
+
+  index = ctx->cache_index;
+
+  /* entries are in record order, so sorted by record offset */
+  if (!(entry = _sdr_cache_index_search (index->name_entries,
+                                         index->name_entries_count,
+                                         SDR_CACHE_INDEX_NAME_ENTRY_LENGTH,
+                                         _sdr_cache_index_get32,
+                                         ctx->current_offset.offset)))
+    return (0);
+
+  name_offset = _sdr_cache_index_get32 (entry + 4);
+  name_len = entry[8];
+
+  if (name_offset == SDR_CACHE_INDEX_NAME_NONE
+      || name_offset > index->name_strings_len
+      || name_len > (index->name_strings_len - name_offset))
+    return (0);
+
+  sdr_check_read_status (ctx);
+
+  (*id_string) = (const char *)index->name_strings + name_offset;
+  (*id_string_len) = name_len;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (1);
+}
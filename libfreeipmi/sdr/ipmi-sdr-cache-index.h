@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_SDR_CACHE_INDEX_H
+#define IPMI_SDR_CACHE_INDEX_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "freeipmi/sdr/ipmi-sdr.h"
+
+/* Lookup indexes over the records of an open SDR cache, so
+ * ipmi_sdr_cache_search_record_id() and
+ * ipmi_sdr_cache_search_sensor() need not walk the cache.
+ *
+ * Both indexes are open addressed hash tables keyed by a 16 bit
+ * value, the record id or (sensor owner id << 8 | sensor number).
+ * Shared compact and event only records are entered once for each
+ * sensor number they cover.  Records are entered in cache order and
+ * the first record entered for a key wins, giving the same answer as
+ * a linear search.
+ *
+ * Version 1.3 caches store the same indexes, along with a table of
+ * record id strings, in the cache file itself (see ipmi-sdr-defs.h).
+ * They are searched in place and nothing is built at open.
+ */
+
+#define SDR_CACHE_INDEX_RECORD_ID_ENTRY_LENGTH 6
+#define SDR_CACHE_INDEX_SENSOR_ENTRY_LENGTH    6
+#define SDR_CACHE_INDEX_NAME_ENTRY_LENGTH      9
+#define SDR_CACHE_INDEX_COUNT_LENGTH           4
+#define SDR_CACHE_INDEX_NAME_NONE              0xFFFFFFFF
+
+/* record id index, sensor index, and name table offsets */
+#define SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH 12
+
+struct ipmi_sdr_cache_index_slot {
+  uint32_t key;
+  uint32_t pos;                 /* record + 1, 0 if slot is empty */
+};
+
+struct ipmi_sdr_cache_index {
+  unsigned int count;
+  off_t *offset;
+
+  struct ipmi_sdr_cache_index_slot *record_id_slots;
+  unsigned int record_id_bits;
+
+  struct ipmi_sdr_cache_index_slot *sensor_slots;
+  unsigned int sensor_bits;
+
+  /* version 1.3 caches, point into the mapped cache */
+  const uint8_t *record_id_entries;
+  unsigned int record_id_entries_count;
+  const uint8_t *sensor_entries;
+  unsigned int sensor_entries_count;
+  const uint8_t *name_entries;
+  unsigned int name_entries_count;
+  const uint8_t *name_strings;
+  unsigned int name_strings_len;
+};
+
+/* Index the records of the cache being opened. */
+int sdr_cache_index_build (ipmi_sdr_ctx_t ctx);
+
+/* Use the indexes stored in a version 1.3 cache being opened. */
+int sdr_cache_index_load (ipmi_sdr_ctx_t ctx,
+                          off_t record_id_index_offset,
+                          off_t sensor_index_offset,
+                          off_t name_table_offset);
+
+/* Write the version 1.3 index sections and their offsets for the
+ * records just written to fd, which are the last records_len bytes
+ * of total_bytes_written.
+ */
+int sdr_cache_index_write (ipmi_sdr_ctx_t ctx,
+                           int fd,
+                           const uint8_t *records,
+                           unsigned int records_len,
+                           unsigned int *total_bytes_written,
+                           uint8_t *trailer_checksum);
+
+void sdr_cache_index_destroy (ipmi_sdr_ctx_t ctx);
+
+/* Return 1 and offset of record if found, 0 if not */
+int sdr_cache_index_find_record_id (ipmi_sdr_ctx_t ctx,
+                                    uint16_t record_id,
+                                    off_t *offset);
+
+int sdr_cache_index_find_sensor (ipmi_sdr_ctx_t ctx,
+                                 uint8_t sensor_number,
+                                 uint8_t sensor_owner_id,
+                                 off_t *offset);
+
+/* Returns 1 and the id string of the current cache record if it is
+ * stored in the cache, 0 if the caller must parse the record.  Only
+ * records read from the cache (sdr_record NULL, sdr_record_len 0)
+ * are served.
+ */
+int sdr_cache_index_id_string (ipmi_sdr_ctx_t ctx,
+                               const void *sdr_record,
+                               unsigned int sdr_record_len,
+                               const char **id_string,
+                               unsigned int *id_string_len);
+
+#endif /* IPMI_SDR_CACHE_INDEX_H */
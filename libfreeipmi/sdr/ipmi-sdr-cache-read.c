@@ -50,7 +50,9 @@
 #include "freeipmi/record-format/ipmi-sdr-record-format.h"
 #include "freeipmi/util/ipmi-util.h"
 
+#include "ipmi-sdr-cache-index.h"
 #include "ipmi-sdr-common.h"
+#include "ipmi-sdr-decoded.h"
 #include "ipmi-sdr-defs.h"
 #include "ipmi-sdr-trace.h"
 #include "ipmi-sdr-util.h"
@@ -81,6 +83,9 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
   char record_count_buf[2];
   char most_recent_addition_timestamp_buf[4];
   char most_recent_erase_timestamp_buf[4];
+  off_t record_id_index_offset = 0;
+  off_t sensor_index_offset = 0;
+  off_t name_table_offset = 0;
   struct stat stat_buf;
 
   if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
@@ -171,7 +176,11 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
       && ((uint8_t)sdr_cache_version_buf[0] != IPMI_SDR_CACHE_FILE_VERSION_1_2_0
           || (uint8_t)sdr_cache_version_buf[1] != IPMI_SDR_CACHE_FILE_VERSION_1_2_1
           || (uint8_t)sdr_cache_version_buf[2] != IPMI_SDR_CACHE_FILE_VERSION_1_2_2
-          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_2_3))
+          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_2_3)
+      && ((uint8_t)sdr_cache_version_buf[0] != IPMI_SDR_CACHE_FILE_VERSION_1_3_0
+          || (uint8_t)sdr_cache_version_buf[1] != IPMI_SDR_CACHE_FILE_VERSION_1_3_1
+          || (uint8_t)sdr_cache_version_buf[2] != IPMI_SDR_CACHE_FILE_VERSION_1_3_2
+          || (uint8_t)sdr_cache_version_buf[3] != IPMI_SDR_CACHE_FILE_VERSION_1_3_3))
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
       goto cleanup;
@@ -208,10 +217,15 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
         }
     }
 
-  if ((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_2_0
-      && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_2_1
-      && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_2_2
-      && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_2_3)
+  /* Version 1.3 has the same header and trailer as 1.2 */
+  if (((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_2_0
+       && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_2_1
+       && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_2_2
+       && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_2_3)
+      || ((uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_3_0
+          && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_3_1
+          && (uint8_t)sdr_cache_version_buf[2] == IPMI_SDR_CACHE_FILE_VERSION_1_3_2
+          && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_3_3))
     {
       uint8_t header_checksum_buf[512];
       unsigned int header_checksum_buf_len = 0;
@@ -287,7 +301,48 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
           goto cleanup;
         }
 
-      ctx->records_end_offset = ctx->file_size - trailer_bytes_len;
+      if ((uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_3_3)
+        {
+          char section_offsets_buf[SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH];
+
+          /* Index section offsets are written before the trailer,
+           * the sections themselves are checked when loaded.
+           */
+          if (ctx->file_size < (header_bytes_len + SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH + trailer_bytes_len))
+            {
+              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+              goto cleanup;
+            }
+
+          memcpy (section_offsets_buf,
+                  ctx->sdr_cache + ctx->file_size - trailer_bytes_len - SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH,
+                  SDR_CACHE_INDEX_SECTION_OFFSETS_LENGTH);
+
+          record_id_index_offset = ((uint32_t)section_offsets_buf[0] & 0xFF);
+          record_id_index_offset |= ((uint32_t)section_offsets_buf[1] & 0xFF) << 8;
+          record_id_index_offset |= ((uint32_t)section_offsets_buf[2] & 0xFF) << 16;
+          record_id_index_offset |= ((uint32_t)section_offsets_buf[3] & 0xFF) << 24;
+          sensor_index_offset = ((uint32_t)section_offsets_buf[4] & 0xFF);
+          sensor_index_offset |= ((uint32_t)section_offsets_buf[5] & 0xFF) << 8;
+          sensor_index_offset |= ((uint32_t)section_offsets_buf[6] & 0xFF) << 16;
+          sensor_index_offset |= ((uint32_t)section_offsets_buf[7] & 0xFF) << 24;
+          name_table_offset = ((uint32_t)section_offsets_buf[8] & 0xFF);
+          name_table_offset |= ((uint32_t)section_offsets_buf[9] & 0xFF) << 8;
+          name_table_offset |= ((uint32_t)section_offsets_buf[10] & 0xFF) << 16;
+          name_table_offset |= ((uint32_t)section_offsets_buf[11] & 0xFF) << 24;
+
+          if (record_id_index_offset < ctx->records_start_offset
+              || record_id_index_offset > ctx->file_size)
+            {
+              SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+              goto cleanup;
+            }
+
+          /* records end where the indexes begin */
+          ctx->records_end_offset = record_id_index_offset;
+        }
+      else
+        ctx->records_end_offset = ctx->file_size - trailer_bytes_len;
     }
   else /* (uint8_t)sdr_cache_version_buf[0] == IPMI_SDR_CACHE_FILE_VERSION_1_0
           && (uint8_t)sdr_cache_version_buf[1] == IPMI_SDR_CACHE_FILE_VERSION_1_1
@@ -295,12 +350,34 @@ ipmi_sdr_cache_open (ipmi_sdr_ctx_t ctx,
           && (uint8_t)sdr_cache_version_buf[3] == IPMI_SDR_CACHE_FILE_VERSION_1_3 */
     ctx->records_end_offset = ctx->file_size;
 
+  if (record_id_index_offset)
+    {
+      if (sdr_cache_index_load (ctx,
+                                record_id_index_offset,
+                                sensor_index_offset,
+                                name_table_offset) < 0)
+        goto cleanup;
+    }
+  else
+    {
+      if (sdr_cache_index_build (ctx) < 0)
+        goto cleanup;
+    }
+
+  if (ctx->flags & IPMI_SDR_FLAGS_DECODED_CACHE)
+    {
+      if (sdr_decoded_build (ctx) < 0)
+        goto cleanup;
+    }
+
   _sdr_set_current_offset (ctx, ctx->records_start_offset);
   ctx->operation = IPMI_SDR_OPERATION_READ_CACHE;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
   return (0);
 
  cleanup:
+  sdr_cache_index_destroy (ctx);
+  sdr_decoded_destroy (ctx);
   /* ignore potential error, cleanup path */
   if (ctx->fd >= 0)
     close (ctx->fd);
@@ -526,31 +603,10 @@ ipmi_sdr_cache_search_record_id (ipmi_sdr_ctx_t ctx, uint16_t record_id)
       return (-1);
     }
 
-  offset = ctx->records_start_offset;
-  while (offset < ctx->records_end_offset)
+  if (sdr_cache_index_find_record_id (ctx, record_id, &offset))
     {
-      uint8_t *ptr = ctx->sdr_cache + offset;
-      uint16_t record_id_current;
-      unsigned int record_length;
-
-      /* Record ID stored little-endian */
-      record_id_current = (uint16_t)ptr[IPMI_SDR_RECORD_ID_INDEX_LS] & 0xFF;
-      record_id_current |= ((uint16_t)ptr[IPMI_SDR_RECORD_ID_INDEX_MS] & 0xFF) << 8;
-
-      if (record_id == record_id_current)
-        {
-          found++;
-          _sdr_set_current_offset (ctx, offset);
-          break;
-        }
-
-      record_length = (uint8_t)((ctx->sdr_cache + offset)[IPMI_SDR_RECORD_LENGTH_INDEX]);
-
-      if ((offset + record_length + IPMI_SDR_RECORD_HEADER_LENGTH) >= ctx->records_end_offset)
-        break;
-
-      offset += IPMI_SDR_RECORD_HEADER_LENGTH;
-      offset += record_length;
+      found++;
+      _sdr_set_current_offset (ctx, offset);
     }
 
   if (!found)
@@ -581,79 +637,13 @@ ipmi_sdr_cache_search_sensor (ipmi_sdr_ctx_t ctx, uint8_t sensor_number, uint8_t
       return (-1);
     }
 
-  offset = ctx->records_start_offset;
-  while (offset < ctx->records_end_offset)
+  /* Compact and event only sensor records can do record sharing,
+   * the index holds an entry for every sensor number they cover.
+   */
+  if (sdr_cache_index_find_sensor (ctx, sensor_number, sensor_owner_id, &offset))
     {
-      uint8_t *ptr = ctx->sdr_cache + offset;
-      uint8_t record_type_current;
-      unsigned int record_length;
-
-      record_type_current = ptr[IPMI_SDR_RECORD_TYPE_INDEX];
-
-      if (record_type_current == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD
-          || record_type_current == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD
-          || record_type_current == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
-        {
-          uint8_t sensor_number_current;
-          uint8_t sensor_owner_id_current;
-
-          sensor_owner_id_current = ptr[IPMI_SDR_RECORD_SENSOR_OWNER_ID_INDEX];
-          sensor_number_current = ptr[IPMI_SDR_RECORD_SENSOR_NUMBER_INDEX];
-
-          if (sensor_owner_id_current == sensor_owner_id
-              && sensor_number_current == sensor_number)
-            {
-              found++;
-              _sdr_set_current_offset (ctx, offset);
-              break;
-            }
-
-          /* Compact sensor records can do record sharing, so check
-           * for this case if the sensor_owner_id matches up.
-           */
-          if (sensor_owner_id_current == sensor_owner_id
-              && (record_type_current == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD
-                  || record_type_current == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD))
-            {
-              uint8_t share_count;
-
-              if (record_type_current == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
-                {
-                  share_count = ptr[IPMI_SDR_RECORD_COMPACT_SHARE_COUNT];
-                  share_count &= IPMI_SDR_RECORD_COMPACT_SHARE_COUNT_BITMASK;
-                  share_count >>= IPMI_SDR_RECORD_COMPACT_SHARE_COUNT_SHIFT;
-                }
-              else
-                {
-                  share_count = ptr[IPMI_SDR_RECORD_EVENT_SHARE_COUNT];
-                  share_count &= IPMI_SDR_RECORD_EVENT_SHARE_COUNT_BITMASK;
-                  share_count >>= IPMI_SDR_RECORD_EVENT_SHARE_COUNT_SHIFT;
-                }
-
-              /* IPMI spec gives the following example:
-               *
-               * "If the starting sensor number was 10, and the share
-               * count was 3, then sensors 10, 11, and 12 would share
-               * the record"
-               */
-              if (share_count > 1
-                  && (sensor_number > sensor_number_current
-                      && sensor_number <= (sensor_number_current + (share_count - 1))))
-                {
-                  found++;
-                  _sdr_set_current_offset (ctx, offset);
-                  break;
-                }
-            }
-        }
-
-      record_length = (uint8_t)((ctx->sdr_cache + offset)[IPMI_SDR_RECORD_LENGTH_INDEX]);
-
-      if ((offset + record_length + IPMI_SDR_RECORD_HEADER_LENGTH) >= ctx->records_end_offset)
-        break;
-
-      offset += IPMI_SDR_RECORD_HEADER_LENGTH;
-      offset += record_length;
+      found++;
+      _sdr_set_current_offset (ctx, offset);
     }
 
   if (!found)
@@ -876,6 +866,8 @@ ipmi_sdr_cache_close (ipmi_sdr_ctx_t ctx)
   /* ignore potential error, cleanup path */
   if (ctx->sdr_cache)
     munmap ((void *)ctx->sdr_cache, ctx->file_size);
+  sdr_cache_index_destroy (ctx);
+  sdr_decoded_destroy (ctx);
   sdr_init_ctx (ctx);
 
   ctx->operation = IPMI_SDR_OPERATION_UNINITIALIZED;
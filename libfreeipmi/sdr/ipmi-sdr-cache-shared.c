@@ -0,0 +1,617 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif /* HAVE_FCNTL_H */
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/sdr/ipmi-sdr.h"
+#include "freeipmi/api/ipmi-device-global-cmds-api.h"
+#include "freeipmi/cmds/ipmi-device-global-cmds.h"
+#include "freeipmi/fiid/fiid.h"
+
+#include "ipmi-sdr-common.h"
+#include "ipmi-sdr-defs.h"
+#include "ipmi-sdr-trace.h"
+#include "ipmi-sdr-util.h"
+
+#include "libcommon/ipmi-crypt.h"
+
+#include "freeipmi-portability.h"
+
+#define IPMI_SDR_CACHE_SHARED_BLOB_PREFIX     "sdr-cache-"
+#define IPMI_SDR_CACHE_SHARED_IDENTITY_PREFIX "sdr-id-"
+#define IPMI_SDR_CACHE_SHARED_TEMP_SUFFIX     ".tmp"
+#define IPMI_SDR_CACHE_SHARED_DIGEST_LENGTH   32
+#define IPMI_SDR_CACHE_SHARED_NAME_LENGTH     128
+
+/* The identity of an SDR repository is the BMC's manufacturer and
+ * product ids and firmware/auxiliary firmware revisions plus the SDR
+ * version, record count, and the most recent addition/erase
+ * timestamps from Get SDR Repository Info.  Identical nodes report
+ * identical identities and can share one cache.  A firmware update
+ * may rewrite the SDR without touching its timestamps, so the
+ * revisions are part of the identity.
+ */
+static int
+_sdr_cache_shared_identity (ipmi_sdr_ctx_t ctx,
+                            ipmi_ctx_t ipmi_ctx,
+                            char *identity,
+                            unsigned int identity_len)
+{
+  fiid_obj_t obj_cmd_rs = NULL;
+  uint32_t manufacturer_id;
+  uint16_t product_id;
+  uint8_t major_firmware_revision;
+  uint8_t minor_firmware_revision;
+  uint32_t auxiliary_firmware_revision = 0;
+  uint8_t sdr_version;
+  uint16_t record_count;
+  uint32_t most_recent_addition_timestamp, most_recent_erase_timestamp;
+  uint64_t val;
+  int len;
+  int ret;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (identity);
+  assert (identity_len);
+
+  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_device_id_rs)))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (ipmi_cmd_get_device_id (ipmi_ctx, obj_cmd_rs) < 0)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_IPMI_ERROR);
+      goto cleanup;
+    }
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "manufacturer_id.id",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  manufacturer_id = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "product_id",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  product_id = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "firmware_revision1.major_revision",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  major_firmware_revision = val;
+
+  if (FIID_OBJ_GET (obj_cmd_rs,
+                    "firmware_revision2.minor_revision",
+                    &val) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  minor_firmware_revision = val;
+
+  /* auxiliary firmware revision is optional */
+  if ((ret = fiid_obj_get (obj_cmd_rs,
+                           "auxiliary_firmware_revision_information",
+                           &val)) < 0)
+    {
+      SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_cmd_rs);
+      goto cleanup;
+    }
+  if (ret)
+    auxiliary_firmware_revision = val;
+
+  if (sdr_info (ctx,
+                ipmi_ctx,
+                &sdr_version,
+                &record_count,
+                &most_recent_addition_timestamp,
+                &most_recent_erase_timestamp) < 0)
+    goto cleanup;
+
+  len = snprintf (identity,
+                  identity_len,
+                  IPMI_SDR_CACHE_SHARED_IDENTITY_PREFIX "%06X-%04X-%02X%02X-%08X-%02X-%04X-%08X-%08X",
+                  manufacturer_id,
+                  product_id,
+                  major_firmware_revision,
+                  minor_firmware_revision,
+                  auxiliary_firmware_revision,
+                  sdr_version,
+                  record_count,
+                  most_recent_addition_timestamp,
+                  most_recent_erase_timestamp);
+  if (len < 0 || len >= identity_len)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
+      goto cleanup;
+    }
+
+  rv = 0;
+ cleanup:
+  fiid_obj_destroy (obj_cmd_rs);
+  return (rv);
+}
+
+/* Name a blob after the SHA-256 of its contents */
+static int
+_sdr_cache_shared_blob_name (ipmi_sdr_ctx_t ctx,
+                             const char *path,
+                             char *blob_name,
+                             unsigned int blob_name_len)
+{
+  uint8_t digest[IPMI_SDR_CACHE_SHARED_DIGEST_LENGTH];
+  void *data = NULL;
+  size_t data_len = 0;
+  struct stat buf;
+  unsigned int i;
+  int len;
+  int fd = -1;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (path);
+  assert (blob_name);
+  assert (blob_name_len > (strlen (IPMI_SDR_CACHE_SHARED_BLOB_PREFIX) + IPMI_SDR_CACHE_SHARED_DIGEST_LENGTH * 2));
+
+  if ((fd = open (path, O_RDONLY)) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (fstat (fd, &buf) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (!buf.st_size
+      || buf.st_size > UINT_MAX)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_INVALID);
+      goto cleanup;
+    }
+
+  data_len = buf.st_size;
+  if ((data = mmap (NULL,
+                    data_len,
+                    PROT_READ,
+                    MAP_PRIVATE,
+                    fd,
+                    0)) == MAP_FAILED)
+    {
+      data = NULL;
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if ((len = crypt_hash (IPMI_CRYPT_HASH_SHA256,
+                         0,
+                         NULL,
+                         0,
+                         data,
+                         data_len,
+                         digest,
+                         IPMI_SDR_CACHE_SHARED_DIGEST_LENGTH)) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (len != IPMI_SDR_CACHE_SHARED_DIGEST_LENGTH)
+    {
+      SDR_SET_INTERNAL_ERRNUM (ctx);
+      goto cleanup;
+    }
+
+  strcpy (blob_name, IPMI_SDR_CACHE_SHARED_BLOB_PREFIX);
+  for (i = 0; i < IPMI_SDR_CACHE_SHARED_DIGEST_LENGTH; i++)
+    sprintf (blob_name + strlen (IPMI_SDR_CACHE_SHARED_BLOB_PREFIX) + i * 2,
+             "%02x",
+             digest[i]);
+
+  rv = 0;
+ cleanup:
+  if (data)
+    /* ignore potential error, cleanup path */
+    munmap (data, data_len);
+  if (fd >= 0)
+    /* ignore potential error, cleanup path */
+    close (fd);
+  return (rv);
+}
+
+/* Atomically point 'linkpath' at 'target' */
+static int
+_sdr_cache_shared_symlink (ipmi_sdr_ctx_t ctx,
+                           const char *target,
+                           const char *linkpath)
+{
+  char tmppath[MAXPATHLEN + IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  int len;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (target);
+  assert (linkpath);
+
+  len = snprintf (tmppath,
+                  sizeof (tmppath),
+                  "%s.%u" IPMI_SDR_CACHE_SHARED_TEMP_SUFFIX,
+                  linkpath,
+                  (unsigned int)getpid ());
+  if (len < 0 || len >= sizeof (tmppath))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      return (-1);
+    }
+
+  /* ignore potential error, may be left over from an earlier run */
+  unlink (tmppath);
+
+  if (symlink (target, tmppath) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (rename (tmppath, linkpath) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      /* ignore potential error, cleanup path */
+      unlink (tmppath);
+      return (-1);
+    }
+
+  return (0);
+}
+
+/* Returns 1 if the identity link points at a blob whose contents
+ * match its name, 0 if not, -1 on error.
+ */
+static int
+_sdr_cache_shared_lookup (ipmi_sdr_ctx_t ctx,
+                          const char *shared_directory,
+                          const char *identity,
+                          char *blob_path,
+                          unsigned int blob_path_len)
+{
+  char identity_path[MAXPATHLEN + IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  char link_name[IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  char blob_name[IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  ssize_t len;
+  int path_len;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (shared_directory);
+  assert (identity);
+  assert (blob_path);
+  assert (blob_path_len);
+
+  path_len = snprintf (identity_path,
+                       sizeof (identity_path),
+                       "%s/%s",
+                       shared_directory,
+                       identity);
+  if (path_len < 0 || path_len >= sizeof (identity_path))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      return (-1);
+    }
+
+  memset (link_name, '\0', sizeof (link_name));
+  if ((len = readlink (identity_path, link_name, IPMI_SDR_CACHE_SHARED_NAME_LENGTH)) < 0)
+    {
+      if (errno == ENOENT)
+        return (0);
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (strncmp (link_name,
+               IPMI_SDR_CACHE_SHARED_BLOB_PREFIX,
+               strlen (IPMI_SDR_CACHE_SHARED_BLOB_PREFIX))
+      || strchr (link_name, '/'))
+    return (0);
+
+  path_len = snprintf (blob_path,
+                       blob_path_len,
+                       "%s/%s",
+                       shared_directory,
+                       link_name);
+  if (path_len < 0 || path_len >= blob_path_len)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      return (-1);
+    }
+
+  if (_sdr_cache_shared_blob_name (ctx,
+                                   blob_path,
+                                   blob_name,
+                                   IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1) < 0)
+    {
+      /* a missing or truncated blob is simply downloaded again */
+      if (ctx->errnum == IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST
+          || ctx->errnum == IPMI_SDR_ERR_CACHE_INVALID)
+        return (0);
+      return (-1);
+    }
+
+  if (strcmp (blob_name, link_name))
+    return (0);
+
+  return (1);
+}
+
+static int
+_sdr_cache_shared_download (ipmi_sdr_ctx_t ctx,
+                            ipmi_ctx_t ipmi_ctx,
+                            const char *shared_directory,
+                            const char *identity,
+                            int cache_create_flags,
+                            Ipmi_Sdr_Cache_Create_Callback create_callback,
+                            void *create_callback_data,
+                            char *blob_path,
+                            unsigned int blob_path_len)
+{
+  char tmppath[MAXPATHLEN + IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  char identity_path[MAXPATHLEN + IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  char blob_name[IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  int tmpfd;
+  int tmppath_created = 0;
+  int len;
+  int rv = -1;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ipmi_ctx);
+  assert (shared_directory);
+  assert (identity);
+  assert (blob_path);
+  assert (blob_path_len);
+
+  /* Download into a private file so concurrent creators of the same
+   * identity never see each other's partial caches.
+   */
+  len = snprintf (tmppath,
+                  sizeof (tmppath),
+                  "%s/.%sXXXXXX",
+                  shared_directory,
+                  IPMI_SDR_CACHE_SHARED_BLOB_PREFIX);
+  if (len < 0 || len >= sizeof (tmppath))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      return (-1);
+    }
+
+  if ((tmpfd = mkstemp (tmppath)) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+  tmppath_created++;
+  /* ignore potential error, file is rewritten below */
+  close (tmpfd);
+
+  if (ipmi_sdr_cache_create (ctx,
+                             ipmi_ctx,
+                             tmppath,
+                             cache_create_flags | IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE,
+                             create_callback,
+                             create_callback_data) < 0)
+    goto cleanup;
+
+  if (chmod (tmppath, 0644) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+
+  if (_sdr_cache_shared_blob_name (ctx,
+                                   tmppath,
+                                   blob_name,
+                                   IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1) < 0)
+    goto cleanup;
+
+  len = snprintf (blob_path,
+                  blob_path_len,
+                  "%s/%s",
+                  shared_directory,
+                  blob_name);
+  if (len < 0 || len >= blob_path_len)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      goto cleanup;
+    }
+
+  /* Identical contents produce the same name, so replacing a blob
+   * someone else just wrote is harmless.
+   */
+  if (rename (tmppath, blob_path) < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      goto cleanup;
+    }
+  tmppath_created = 0;
+
+  len = snprintf (identity_path,
+                  sizeof (identity_path),
+                  "%s/%s",
+                  shared_directory,
+                  identity);
+  if (len < 0 || len >= sizeof (identity_path))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_FILENAME_INVALID);
+      goto cleanup;
+    }
+
+  if (_sdr_cache_shared_symlink (ctx, blob_name, identity_path) < 0)
+    goto cleanup;
+
+  rv = 0;
+ cleanup:
+  if (rv < 0 && tmppath_created)
+    /* ignore potential error, cleanup path */
+    unlink (tmppath);
+  return (rv);
+}
+
+int
+ipmi_sdr_cache_create_shared (ipmi_sdr_ctx_t ctx,
+                              ipmi_ctx_t ipmi_ctx,
+                              const char *filename,
+                              const char *shared_directory,
+                              int cache_create_flags,
+                              Ipmi_Sdr_Cache_Create_Callback create_callback,
+                              void *create_callback_data)
+{
+  char directory[MAXPATHLEN + 1];
+  char identity[IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  char blob_path[MAXPATHLEN + IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1];
+  unsigned int cache_create_flags_mask = (IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_DUPLICATE_RECORD_ID
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT
+                                          | IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED);
+  struct stat buf;
+  int ret;
+
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!ipmi_ctx
+      || !filename
+      || (strlen (filename) > MAXPATHLEN)
+      || !shared_directory
+      || (strlen (shared_directory) > MAXPATHLEN)
+      || (cache_create_flags & ~cache_create_flags_mask))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (ctx->operation != IPMI_SDR_OPERATION_UNINITIALIZED)
+    {
+      if (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE)
+        SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CONTEXT_PERFORMING_OTHER_OPERATION);
+      else
+        SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_INTERNAL_ERROR);
+      return (-1);
+    }
+
+  if (!(cache_create_flags & IPMI_SDR_CACHE_CREATE_FLAGS_OVERWRITE)
+      && !lstat (filename, &buf))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_CACHE_CREATE_CACHE_EXISTS);
+      return (-1);
+    }
+
+  if (crypt_init () < 0)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (mkdir (shared_directory, 0755) < 0
+      && errno != EEXIST)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  /* per-host links must not depend on the caller's working directory */
+  if (!realpath (shared_directory, directory))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (_sdr_cache_shared_identity (ctx,
+                                  ipmi_ctx,
+                                  identity,
+                                  IPMI_SDR_CACHE_SHARED_NAME_LENGTH + 1) < 0)
+    return (-1);
+
+  if ((ret = _sdr_cache_shared_lookup (ctx,
+                                       directory,
+                                       identity,
+                                       blob_path,
+                                       sizeof (blob_path))) < 0)
+    return (-1);
+
+  if (!ret)
+    {
+      if (_sdr_cache_shared_download (ctx,
+                                      ipmi_ctx,
+                                      directory,
+                                      identity,
+                                      cache_create_flags,
+                                      create_callback,
+                                      create_callback_data,
+                                      blob_path,
+                                      sizeof (blob_path)) < 0)
+        return (-1);
+    }
+
+  if (_sdr_cache_shared_symlink (ctx, blob_path, filename) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
@@ -303,3 +303,22 @@ sdr_check_read_status (ipmi_sdr_ctx_t ctx)
       ctx->current_offset.offset_dumped = 1;
     }
 }
+
+void
+sdr_cache_current_record (ipmi_sdr_ctx_t ctx,
+                          const void **sdr_record,
+                          unsigned int *sdr_record_len)
+{
+  unsigned int record_length;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE);
+  assert (sdr_record);
+  assert (sdr_record_len);
+
+  record_length = (uint8_t)((ctx->sdr_cache + ctx->current_offset.offset)[IPMI_SDR_RECORD_LENGTH_INDEX]);
+
+  (*sdr_record) = ctx->sdr_cache + ctx->current_offset.offset;
+  (*sdr_record_len) = record_length + IPMI_SDR_RECORD_HEADER_LENGTH;
+}
@@ -50,4 +50,12 @@ const char *sdr_record_type_str (ipmi_sdr_ctx_t ctx,
 
 void sdr_check_read_status (ipmi_sdr_ctx_t ctx);
 
+/* Returns the record at the current read position of an open cache.
+ * The record points into the mapped cache file and is valid until the
+ * cache is closed.
+ */
+void sdr_cache_current_record (ipmi_sdr_ctx_t ctx,
+                               const void **sdr_record,
+                               unsigned int *sdr_record_len);
+
 #endif /* IPMI_SDR_COMMON_H */
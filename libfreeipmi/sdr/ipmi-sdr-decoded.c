@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef STDC_HEADERS
+#include <string.h>
+#endif /* STDC_HEADERS */
+#include <assert.h>
+#include <errno.h>
+
+#include "freeipmi/sdr/ipmi-sdr.h"
+#include "freeipmi/record-format/ipmi-sdr-record-format.h"
+
+#include "ipmi-sdr-common.h"
+#include "ipmi-sdr-decoded.h"
+#include "ipmi-sdr-defs.h"
+#include "ipmi-sdr-trace.h"
+#include "ipmi-sdr-util.h"
+
+#include "freeipmi-portability.h"
+
+#define SDR_DECODED_ALLOC(__d, __field, __count)                           \
+  do {                                                                     \
+    if (!((__d)->__field = calloc ((__count), sizeof (*(__d)->__field))))  \
+      goto cleanup;                                                        \
+  } while (0)
+
+static void
+_sdr_decoded_free (struct ipmi_sdr_decoded *d)
+{
+  if (!d)
+    return;
+
+  free (d->offset);
+  free (d->valid);
+  free (d->record_id);
+  free (d->record_type);
+  free (d->sensor_owner_id_type);
+  free (d->sensor_owner_id);
+  free (d->sensor_owner_lun);
+  free (d->channel_number);
+  free (d->sensor_number);
+  free (d->entity_id);
+  free (d->entity_instance);
+  free (d->entity_instance_type);
+  free (d->sensor_type);
+  free (d->event_reading_type_code);
+  free (d->sensor_units_percentage);
+  free (d->sensor_units_modifier);
+  free (d->sensor_units_rate);
+  free (d->sensor_base_unit_type);
+  free (d->sensor_modifier_unit_type);
+  free (d->r_exponent);
+  free (d->b_exponent);
+  free (d->m);
+  free (d->b);
+  free (d->linearization);
+  free (d->analog_data_format);
+  free (d->thresholds_raw);
+  free (d->id_string);
+  free (d->id_string_len);
+  free (d);
+}
+
+static struct ipmi_sdr_decoded *
+_sdr_decoded_create (unsigned int count)
+{
+  struct ipmi_sdr_decoded *d = NULL;
+
+  if (!(d = (struct ipmi_sdr_decoded *)malloc (sizeof (struct ipmi_sdr_decoded))))
+    return (NULL);
+  memset (d, '\0', sizeof (struct ipmi_sdr_decoded));
+
+  d->count = count;
+
+  /* calloc (0, ...) may legitimately return NULL */
+  if (!count)
+    return (d);
+
+  SDR_DECODED_ALLOC (d, offset, count);
+  SDR_DECODED_ALLOC (d, valid, count);
+  SDR_DECODED_ALLOC (d, record_id, count);
+  SDR_DECODED_ALLOC (d, record_type, count);
+  SDR_DECODED_ALLOC (d, sensor_owner_id_type, count);
+  SDR_DECODED_ALLOC (d, sensor_owner_id, count);
+  SDR_DECODED_ALLOC (d, sensor_owner_lun, count);
+  SDR_DECODED_ALLOC (d, channel_number, count);
+  SDR_DECODED_ALLOC (d, sensor_number, count);
+  SDR_DECODED_ALLOC (d, entity_id, count);
+  SDR_DECODED_ALLOC (d, entity_instance, count);
+  SDR_DECODED_ALLOC (d, entity_instance_type, count);
+  SDR_DECODED_ALLOC (d, sensor_type, count);
+  SDR_DECODED_ALLOC (d, event_reading_type_code, count);
+  SDR_DECODED_ALLOC (d, sensor_units_percentage, count);
+  SDR_DECODED_ALLOC (d, sensor_units_modifier, count);
+  SDR_DECODED_ALLOC (d, sensor_units_rate, count);
+  SDR_DECODED_ALLOC (d, sensor_base_unit_type, count);
+  SDR_DECODED_ALLOC (d, sensor_modifier_unit_type, count);
+  SDR_DECODED_ALLOC (d, r_exponent, count);
+  SDR_DECODED_ALLOC (d, b_exponent, count);
+  SDR_DECODED_ALLOC (d, m, count);
+  SDR_DECODED_ALLOC (d, b, count);
+  SDR_DECODED_ALLOC (d, linearization, count);
+  SDR_DECODED_ALLOC (d, analog_data_format, count);
+  SDR_DECODED_ALLOC (d, thresholds_raw, count * SDR_DECODED_THRESHOLDS_PER_RECORD);
+  SDR_DECODED_ALLOC (d, id_string, count * IPMI_SDR_MAX_ID_STRING_LENGTH);
+  SDR_DECODED_ALLOC (d, id_string_len, count);
+
+  return (d);
+
+ cleanup:
+  _sdr_decoded_free (d);
+  return (NULL);
+}
+
+/* Length of the fixed portion of a record, i.e. everything before the
+ * id string.  Only records at least this long are decoded, so every
+ * field read while decoding is actually present in the record.
+ * Returns 0 for record types that are not decoded.
+ */
+static int
+_sdr_decoded_fixed_len (uint8_t record_type)
+{
+  fiid_field_t *tmpl;
+  const char *field;
+
+  switch (record_type)
+    {
+    case IPMI_SDR_FORMAT_FULL_SENSOR_RECORD:
+      tmpl = tmpl_sdr_full_sensor_record;
+      field = "id_string";
+      break;
+    case IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD:
+      tmpl = tmpl_sdr_compact_sensor_record;
+      field = "id_string";
+      break;
+    case IPMI_SDR_FORMAT_EVENT_ONLY_RECORD:
+      tmpl = tmpl_sdr_event_only_record;
+      field = "id_string";
+      break;
+    case IPMI_SDR_FORMAT_GENERIC_DEVICE_LOCATOR_RECORD:
+      tmpl = tmpl_sdr_generic_device_locator_record;
+      field = "device_id_string";
+      break;
+    case IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD:
+      tmpl = tmpl_sdr_management_controller_device_locator_record;
+      field = "device_id_string";
+      break;
+    default:
+      return (0);
+    }
+
+  return (fiid_template_field_start_bytes (tmpl, field));
+}
+
+/* Decode with the public accessors themselves, so the table can never
+ * disagree with what parsing the record would have returned.
+ */
+static void
+_sdr_decoded_record (ipmi_sdr_ctx_t ctx,
+                     struct ipmi_sdr_decoded *d,
+                     unsigned int i,
+                     const void *sdr_record,
+                     unsigned int sdr_record_len)
+{
+  uint8_t *thresholds;
+  int fixed_len;
+  int len;
+
+  assert (ctx);
+  assert (d);
+  assert (i < d->count);
+  assert (sdr_record);
+
+  if (ipmi_sdr_parse_record_id_and_type (ctx,
+                                         sdr_record,
+                                         sdr_record_len,
+                                         &d->record_id[i],
+                                         &d->record_type[i]) < 0)
+    return;
+  d->valid[i] |= SDR_DECODED_RECORD_ID_AND_TYPE;
+
+  if ((fixed_len = _sdr_decoded_fixed_len (d->record_type[i])) <= 0
+      || sdr_record_len < fixed_len)
+    return;
+
+  if (!ipmi_sdr_parse_sensor_owner_id (ctx,
+                                       sdr_record,
+                                       sdr_record_len,
+                                       &d->sensor_owner_id_type[i],
+                                       &d->sensor_owner_id[i]))
+    d->valid[i] |= SDR_DECODED_SENSOR_OWNER_ID;
+
+  if (!ipmi_sdr_parse_sensor_owner_lun (ctx,
+                                        sdr_record,
+                                        sdr_record_len,
+                                        &d->sensor_owner_lun[i],
+                                        &d->channel_number[i]))
+    d->valid[i] |= SDR_DECODED_SENSOR_OWNER_LUN;
+
+  if (!ipmi_sdr_parse_sensor_number (ctx,
+                                     sdr_record,
+                                     sdr_record_len,
+                                     &d->sensor_number[i]))
+    d->valid[i] |= SDR_DECODED_SENSOR_NUMBER;
+
+  if (!ipmi_sdr_parse_entity_id_instance_type (ctx,
+                                               sdr_record,
+                                               sdr_record_len,
+                                               &d->entity_id[i],
+                                               &d->entity_instance[i],
+                                               &d->entity_instance_type[i]))
+    d->valid[i] |= SDR_DECODED_ENTITY_ID_INSTANCE_TYPE;
+
+  if (!ipmi_sdr_parse_sensor_type (ctx,
+                                   sdr_record,
+                                   sdr_record_len,
+                                   &d->sensor_type[i]))
+    d->valid[i] |= SDR_DECODED_SENSOR_TYPE;
+
+  if (!ipmi_sdr_parse_event_reading_type_code (ctx,
+                                               sdr_record,
+                                               sdr_record_len,
+                                               &d->event_reading_type_code[i]))
+    d->valid[i] |= SDR_DECODED_EVENT_READING_TYPE_CODE;
+
+  if ((len = ipmi_sdr_parse_id_string (ctx,
+                                       sdr_record,
+                                       sdr_record_len,
+                                       &d->id_string[i * IPMI_SDR_MAX_ID_STRING_LENGTH],
+                                       IPMI_SDR_MAX_ID_STRING_LENGTH)) >= 0)
+    {
+      d->id_string_len[i] = len;
+      d->valid[i] |= SDR_DECODED_ID_STRING;
+    }
+
+  if (!ipmi_sdr_parse_sensor_units (ctx,
+                                    sdr_record,
+                                    sdr_record_len,
+                                    &d->sensor_units_percentage[i],
+                                    &d->sensor_units_modifier[i],
+                                    &d->sensor_units_rate[i],
+                                    &d->sensor_base_unit_type[i],
+                                    &d->sensor_modifier_unit_type[i]))
+    d->valid[i] |= SDR_DECODED_SENSOR_UNITS;
+
+  if (!ipmi_sdr_parse_sensor_decoding_data (ctx,
+                                            sdr_record,
+                                            sdr_record_len,
+                                            &d->r_exponent[i],
+                                            &d->b_exponent[i],
+                                            &d->m[i],
+                                            &d->b[i],
+                                            &d->linearization[i],
+                                            &d->analog_data_format[i]))
+    d->valid[i] |= SDR_DECODED_SENSOR_DECODING_DATA;
+
+  thresholds = &d->thresholds_raw[i * SDR_DECODED_THRESHOLDS_PER_RECORD];
+  if (!ipmi_sdr_parse_thresholds_raw (ctx,
+                                      sdr_record,
+                                      sdr_record_len,
+                                      &thresholds[0],
+                                      &thresholds[1],
+                                      &thresholds[2],
+                                      &thresholds[3],
+                                      &thresholds[4],
+                                      &thresholds[5]))
+    d->valid[i] |= SDR_DECODED_THRESHOLDS_RAW;
+}
+
+int
+sdr_decoded_build (ipmi_sdr_ctx_t ctx)
+{
+  struct ipmi_sdr_decoded *d = NULL;
+  unsigned int count = 0;
+  unsigned int i;
+  off_t offset;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+  assert (ctx->sdr_cache);
+  assert (ctx->operation != IPMI_SDR_OPERATION_READ_CACHE);
+  assert (!ctx->decoded);
+
+  /* Only records that lie entirely within the cache are decoded, any
+   * others are left to the normal parse path.
+   */
+  offset = ctx->records_start_offset;
+  while ((offset + IPMI_SDR_RECORD_HEADER_LENGTH) <= ctx->records_end_offset)
+    {
+      unsigned int record_length;
+
+      record_length = (uint8_t)((ctx->sdr_cache + offset)[IPMI_SDR_RECORD_LENGTH_INDEX]);
+      if ((offset + IPMI_SDR_RECORD_HEADER_LENGTH + record_length) > ctx->records_end_offset)
+        break;
+      offset += IPMI_SDR_RECORD_HEADER_LENGTH + record_length;
+      count++;
+    }
+
+  if (!(d = _sdr_decoded_create (count)))
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+
+  offset = ctx->records_start_offset;
+  for (i = 0; i < count; i++)
+    {
+      unsigned int record_length;
+
+      record_length = (uint8_t)((ctx->sdr_cache + offset)[IPMI_SDR_RECORD_LENGTH_INDEX]);
+
+      d->offset[i] = offset;
+      _sdr_decoded_record (ctx,
+                           d,
+                           i,
+                           ctx->sdr_cache + offset,
+                           record_length + IPMI_SDR_RECORD_HEADER_LENGTH);
+
+      offset += IPMI_SDR_RECORD_HEADER_LENGTH + record_length;
+    }
+
+  ctx->decoded = d;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
+void
+sdr_decoded_destroy (ipmi_sdr_ctx_t ctx)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+
+  _sdr_decoded_free (ctx->decoded);
+  ctx->decoded = NULL;
+}
+
+int
+sdr_decoded_lookup (ipmi_sdr_ctx_t ctx,
+                    const void *sdr_record,
+                    unsigned int sdr_record_len,
+                    uint32_t field,
+                    unsigned int *index)
+{
+  struct ipmi_sdr_decoded *d;
+  off_t offset;
+  unsigned int i;
+
+  assert (index);
+
+  if (!ctx
+      || ctx->magic != IPMI_SDR_CTX_MAGIC
+      || !ctx->decoded
+      || ctx->operation != IPMI_SDR_OPERATION_READ_CACHE
+      || sdr_record
+      || sdr_record_len)
+    return (0);
+
+  d = ctx->decoded;
+  offset = ctx->current_offset.offset;
+
+  if (!d->count)
+    return (0);
+
+  if (d->last_index < d->count && d->offset[d->last_index] == offset)
+    i = d->last_index;
+  else if ((d->last_index + 1) < d->count && d->offset[d->last_index + 1] == offset)
+    i = d->last_index + 1;
+  else
+    {
+      unsigned int lo = 0, hi = d->count;
+
+      while (lo < hi)
+        {
+          unsigned int mid = lo + (hi - lo) / 2;
+
+          if (d->offset[mid] < offset)
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+
+      if (lo >= d->count || d->offset[lo] != offset)
+        return (0);
+      i = lo;
+    }
+
+  d->last_index = i;
+
+  if (!(d->valid[i] & field))
+    return (0);
+
+  sdr_check_read_status (ctx);
+
+  *index = i;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (1);
+}
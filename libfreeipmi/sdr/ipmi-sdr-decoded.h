@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2003-2015 FreeIPMI Core Team
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IPMI_SDR_DECODED_H
+#define IPMI_SDR_DECODED_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "freeipmi/sdr/ipmi-sdr.h"
+#include "freeipmi/record-format/ipmi-sdr-record-format.h"
+
+/* Table of SDR cache records decoded once when the cache is opened
+ * with IPMI_SDR_FLAGS_DECODED_CACHE, stored as one array per field
+ * and indexed by record position in the cache.
+ *
+ * Each record has a mask of the accessors the table can answer for
+ * it.  An accessor is only marked valid if decoding the record with
+ * it succeeded, so anything not in the mask (wrong record type,
+ * truncated records, ...) falls through to the normal parse path and
+ * returns the same errors it always has.
+ */
+
+#define SDR_DECODED_RECORD_ID_AND_TYPE      0x00000001
+#define SDR_DECODED_SENSOR_OWNER_ID         0x00000002
+#define SDR_DECODED_SENSOR_OWNER_LUN        0x00000004
+#define SDR_DECODED_SENSOR_NUMBER           0x00000008
+#define SDR_DECODED_ENTITY_ID_INSTANCE_TYPE 0x00000010
+#define SDR_DECODED_SENSOR_TYPE             0x00000020
+#define SDR_DECODED_EVENT_READING_TYPE_CODE 0x00000040
+#define SDR_DECODED_ID_STRING               0x00000080
+#define SDR_DECODED_SENSOR_UNITS            0x00000100
+#define SDR_DECODED_SENSOR_DECODING_DATA    0x00000200
+#define SDR_DECODED_THRESHOLDS_RAW          0x00000400
+
+#define SDR_DECODED_THRESHOLDS_PER_RECORD   6
+
+struct ipmi_sdr_decoded {
+  unsigned int count;
+  unsigned int last_index;      /* last lookup, records are usually walked in order */
+
+  off_t *offset;
+  uint32_t *valid;
+
+  uint16_t *record_id;
+  uint8_t *record_type;
+  uint8_t *sensor_owner_id_type;
+  uint8_t *sensor_owner_id;
+  uint8_t *sensor_owner_lun;
+  uint8_t *channel_number;
+  uint8_t *sensor_number;
+  uint8_t *entity_id;
+  uint8_t *entity_instance;
+  uint8_t *entity_instance_type;
+  uint8_t *sensor_type;
+  uint8_t *event_reading_type_code;
+  uint8_t *sensor_units_percentage;
+  uint8_t *sensor_units_modifier;
+  uint8_t *sensor_units_rate;
+  uint8_t *sensor_base_unit_type;
+  uint8_t *sensor_modifier_unit_type;
+  int8_t *r_exponent;
+  int8_t *b_exponent;
+  int16_t *m;
+  int16_t *b;
+  uint8_t *linearization;
+  uint8_t *analog_data_format;
+  /* SDR_DECODED_THRESHOLDS_PER_RECORD per record, lower then upper,
+   * each non-critical, critical, non-recoverable
+   */
+  uint8_t *thresholds_raw;
+  /* IPMI_SDR_MAX_ID_STRING_LENGTH per record, not NUL terminated */
+  char *id_string;
+  uint8_t *id_string_len;
+};
+
+/* Decode all records of the cache being opened.  Must be called
+ * before the context is marked as reading the cache.
+ */
+int sdr_decoded_build (ipmi_sdr_ctx_t ctx);
+
+void sdr_decoded_destroy (ipmi_sdr_ctx_t ctx);
+
+/* Returns 1 and the table index of the current cache record if the
+ * accessor identified by field may be answered from the table, 0 if
+ * the caller must parse the record.  Only records read from the
+ * cache (sdr_record NULL, sdr_record_len 0) are served.
+ */
+int sdr_decoded_lookup (ipmi_sdr_ctx_t ctx,
+                        const void *sdr_record,
+                        unsigned int sdr_record_len,
+                        uint32_t field,
+                        unsigned int *index);
+
+#endif /* IPMI_SDR_DECODED_H */
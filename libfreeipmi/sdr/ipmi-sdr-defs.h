@@ -40,6 +40,8 @@
 
 #include "freeipmi/sdr/ipmi-sdr.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
+
 #include "list.h"
 
 #ifndef MAXPATHLEN
@@ -118,6 +120,51 @@
 #define IPMI_SDR_CACHE_FILE_VERSION_1_2_2 0x00
 #define IPMI_SDR_CACHE_FILE_VERSION_1_2_3 0x02
 
+/* Cache Version 1.3 format
+ *
+ * magic bytes (4 bytes)
+ * version bytes (4)
+ * sdr version (1)
+ * record count (2)
+ * most recent addition timestamp (4)
+ * most recent erase timestamp (4)
+ * header checksum (1) [all bytes above]
+ * records (variable)
+ * record id index (variable)
+ *   entry count (4)
+ *   entries sorted by record id
+ *     record id (2)
+ *     record offset (4)
+ * sensor index (variable)
+ *   entry count (4)
+ *   entries sorted by sensor owner id, then sensor number
+ *     sensor owner id (1)
+ *     sensor number (1)
+ *     record offset (4)
+ * name table (variable)
+ *   entry count (4)
+ *   entries in record order
+ *     record offset (4)
+ *     id string offset (4) [into id strings, FFFFFFFFh if none]
+ *     id string length (1)
+ *   id strings (variable) [not NUL terminated]
+ * record id index offset (4)
+ * sensor index offset (4)
+ * name table offset (4)
+ * total bytes of file (4)
+ * trailer checksum (1) [records through total bytes of file]
+ *
+ * All values are little-endian and offsets are from the start of
+ * the file.  Shared sensor records have a sensor index entry for each
+ * sensor number they cover.  When several records have the same key,
+ * only the first in record order is indexed.
+ */
+
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_0 0x00
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_1 0x01
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_2 0x00
+#define IPMI_SDR_CACHE_FILE_VERSION_1_3_3 0x03
+
 #define IPMI_MAX_ENTITY_IDS          256
 #define IPMI_MAX_ENTITY_ID_INSTANCES 256
 
@@ -158,6 +205,15 @@ struct ipmi_sdr_ctx {
   /* Stats */
   int stats_compiled;
   struct ipmi_sdr_entity_count entity_counts[IPMI_MAX_ENTITY_IDS];
+
+  /* reused record objects, see obj_pool_get() */
+  struct obj_pool obj_pool;
+
+  /* search indexes built at cache open, see ipmi-sdr-cache-index.h */
+  struct ipmi_sdr_cache_index *cache_index;
+
+  /* records decoded at cache open, see ipmi-sdr-decoded.h */
+  struct ipmi_sdr_decoded *decoded;
 };
 
 #endif /* IPMI_SDR_DEFS_H */
@@ -43,6 +43,7 @@
 #include "ipmi-sdr-trace.h"
 #include "ipmi-sdr-util.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -63,11 +64,9 @@ ipmi_sdr_oem_parse_intel_node_manager (ipmi_sdr_ctx_t ctx,
                                        uint8_t *nm_operational_capabilities_sensor_number,
                                        uint8_t *nm_alert_threshold_exceeded_sensor_number)
 {
-  uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
-  int sdr_record_buf_len;
   fiid_obj_t obj_oem_record = NULL;
   int expected_record_len;
-  void *sdr_record_to_use;
+  const void *sdr_record_to_use;
   unsigned int sdr_record_len_to_use;
   uint64_t val;
   int rv = -1;
@@ -83,17 +82,9 @@ ipmi_sdr_oem_parse_intel_node_manager (ipmi_sdr_ctx_t ctx,
       if (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE
           && !sdr_record
           && !sdr_record_len)
-        {
-          if ((sdr_record_buf_len = ipmi_sdr_cache_record_read (ctx,
-                                                                sdr_record_buf,
-                                                                IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
-            {
-              SDR_SET_INTERNAL_ERRNUM (ctx);
-              return (-1);
-            }
-          sdr_record_to_use = sdr_record_buf;
-          sdr_record_len_to_use = sdr_record_buf_len;
-        }
+        sdr_cache_current_record (ctx,
+                                  &sdr_record_to_use,
+                                  &sdr_record_len_to_use);
       else
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
@@ -102,7 +93,7 @@ ipmi_sdr_oem_parse_intel_node_manager (ipmi_sdr_ctx_t ctx,
     }
   else
     {
-      sdr_record_to_use = (void *)sdr_record;
+      sdr_record_to_use = sdr_record;
       sdr_record_len_to_use = sdr_record_len;
     }
 
@@ -118,15 +109,15 @@ ipmi_sdr_oem_parse_intel_node_manager (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!(obj_oem_record = fiid_obj_create (tmpl_sdr_oem_intel_node_manager_record)))
+  if (!(obj_oem_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_oem_intel_node_manager_record)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
     }
 
-  if (fiid_obj_set_all (obj_oem_record,
-                        sdr_record_to_use,
-                        expected_record_len) < 0)
+  if (fiid_obj_view_bind (obj_oem_record,
+                          sdr_record_to_use,
+                          expected_record_len) < 0)
     {
       SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_oem_record);
       goto cleanup;
@@ -254,6 +245,6 @@ ipmi_sdr_oem_parse_intel_node_manager (ipmi_sdr_ctx_t ctx,
   rv = 1;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_oem_record);
+  obj_pool_put (&ctx->obj_pool, obj_oem_record);
   return (rv);
 }
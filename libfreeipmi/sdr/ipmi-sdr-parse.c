@@ -30,6 +30,9 @@
 #endif /* HAVE_UNISTD_H */
 #include <assert.h>
 #include <errno.h>
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include "freeipmi/sdr/ipmi-sdr.h"
 
@@ -39,11 +42,14 @@
 #include "freeipmi/spec/ipmi-event-reading-type-code-spec.h"
 #include "freeipmi/util/ipmi-sensor-util.h"
 
+#include "ipmi-sdr-cache-index.h"
 #include "ipmi-sdr-common.h"
+#include "ipmi-sdr-decoded.h"
 #include "ipmi-sdr-defs.h"
 #include "ipmi-sdr-trace.h"
 #include "ipmi-sdr-util.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -60,6 +66,384 @@
 #define IPMI_SDR_PARSE_RECORD_TYPE_BMC_MESSAGE_CHANNEL_INFO_RECORD             0x0200
 #define IPMI_SDR_PARSE_RECORD_TYPE_OEM_RECORD                                  0x0400
 
+/* Fields are accessed through handles resolved once, rather than by
+ * key string on every call.  The keys must be listed in the same
+ * order as enum sdr_parse_field.
+ */
+enum sdr_parse_field
+  {
+    SDR_PARSE_FIELD_RECORD_ID,
+    SDR_PARSE_FIELD_RECORD_TYPE,
+    SDR_PARSE_FIELD_SENSOR_OWNER_ID_TYPE,
+    SDR_PARSE_FIELD_SENSOR_OWNER_ID,
+    SDR_PARSE_FIELD_SENSOR_OWNER_LUN,
+    SDR_PARSE_FIELD_CHANNEL_NUMBER,
+    SDR_PARSE_FIELD_SENSOR_NUMBER,
+    SDR_PARSE_FIELD_ENTITY_ID,
+    SDR_PARSE_FIELD_ENTITY_INSTANCE,
+    SDR_PARSE_FIELD_ENTITY_INSTANCE_TYPE,
+    SDR_PARSE_FIELD_SENSOR_TYPE,
+    SDR_PARSE_FIELD_EVENT_READING_TYPE_CODE,
+    SDR_PARSE_FIELD_ID_STRING,
+    SDR_PARSE_FIELD_SENSOR_UNIT1_PERCENTAGE,
+    SDR_PARSE_FIELD_SENSOR_UNIT1_MODIFIER_UNIT,
+    SDR_PARSE_FIELD_SENSOR_UNIT1_RATE_UNIT,
+    SDR_PARSE_FIELD_SENSOR_UNIT2_BASE_UNIT,
+    SDR_PARSE_FIELD_SENSOR_UNIT3_MODIFIER_UNIT,
+    SDR_PARSE_FIELD_SENSOR_CAPABILITIES_EVENT_MESSAGE_CONTROL_SUPPORT,
+    SDR_PARSE_FIELD_SENSOR_CAPABILITIES_THRESHOLD_ACCESS_SUPPORT,
+    SDR_PARSE_FIELD_SENSOR_CAPABILITIES_HYSTERESIS_SUPPORT,
+    SDR_PARSE_FIELD_SENSOR_CAPABILITIES_AUTO_RE_ARM_SUPPORT,
+    SDR_PARSE_FIELD_SENSOR_CAPABILITIES_ENTITY_IGNORE_SUPPORT,
+    SDR_PARSE_FIELD_SENSOR_DIRECTION,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_0,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_1,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_2,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_3,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_4,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_5,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_6,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_7,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_8,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_9,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_10,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_11,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_12,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_13,
+    SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_14,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_0,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_1,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_2,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_3,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_4,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_5,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_6,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_7,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_8,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_9,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_10,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_11,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_12,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_13,
+    SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_14,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_LOW_SUPPORTED,
+    SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED,
+    SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_LOWER_NON_CRITICAL_THRESHOLD_IS_READABLE,
+    SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_LOWER_CRITICAL_THRESHOLD_IS_READABLE,
+    SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_LOWER_NON_RECOVERABLE_THRESHOLD_IS_READABLE,
+    SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_UPPER_NON_CRITICAL_THRESHOLD_IS_READABLE,
+    SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_UPPER_CRITICAL_THRESHOLD_IS_READABLE,
+    SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_UPPER_NON_RECOVERABLE_THRESHOLD_IS_READABLE,
+    SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_LOWER_NON_CRITICAL_THRESHOLD_IS_SETTABLE,
+    SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_LOWER_CRITICAL_THRESHOLD_IS_SETTABLE,
+    SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_LOWER_NON_RECOVERABLE_THRESHOLD_IS_SETTABLE,
+    SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_UPPER_NON_CRITICAL_THRESHOLD_IS_SETTABLE,
+    SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_UPPER_CRITICAL_THRESHOLD_IS_SETTABLE,
+    SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_UPPER_NON_RECOVERABLE_THRESHOLD_IS_SETTABLE,
+    SDR_PARSE_FIELD_R_EXPONENT,
+    SDR_PARSE_FIELD_B_EXPONENT,
+    SDR_PARSE_FIELD_M_LS,
+    SDR_PARSE_FIELD_M_MS,
+    SDR_PARSE_FIELD_B_LS,
+    SDR_PARSE_FIELD_B_MS,
+    SDR_PARSE_FIELD_LINEARIZATION,
+    SDR_PARSE_FIELD_SENSOR_UNIT1_ANALOG_DATA_FORMAT,
+    SDR_PARSE_FIELD_ANALOG_CHARACTERISTICS_FLAG_NOMINAL_READING,
+    SDR_PARSE_FIELD_ANALOG_CHARACTERISTICS_FLAG_NORMAL_MAX,
+    SDR_PARSE_FIELD_ANALOG_CHARACTERISTICS_FLAG_NORMAL_MIN,
+    SDR_PARSE_FIELD_NOMINAL_READING,
+    SDR_PARSE_FIELD_NORMAL_MAXIMUM,
+    SDR_PARSE_FIELD_NORMAL_MINIMUM,
+    SDR_PARSE_FIELD_SENSOR_MAXIMUM_READING,
+    SDR_PARSE_FIELD_SENSOR_MINIMUM_READING,
+    SDR_PARSE_FIELD_LOWER_NON_CRITICAL_THRESHOLD,
+    SDR_PARSE_FIELD_LOWER_CRITICAL_THRESHOLD,
+    SDR_PARSE_FIELD_LOWER_NON_RECOVERABLE_THRESHOLD,
+    SDR_PARSE_FIELD_UPPER_NON_CRITICAL_THRESHOLD,
+    SDR_PARSE_FIELD_UPPER_CRITICAL_THRESHOLD,
+    SDR_PARSE_FIELD_UPPER_NON_RECOVERABLE_THRESHOLD,
+    SDR_PARSE_FIELD_TOLERANCE,
+    SDR_PARSE_FIELD_ACCURACY_LS,
+    SDR_PARSE_FIELD_ACCURACY_MS,
+    SDR_PARSE_FIELD_ACCURACY_EXP,
+    SDR_PARSE_FIELD_POSITIVE_GOING_THRESHOLD_HYSTERESIS,
+    SDR_PARSE_FIELD_NEGATIVE_GOING_THRESHOLD_HYSTERESIS,
+    SDR_PARSE_FIELD_SHARE_COUNT,
+    SDR_PARSE_FIELD_ID_STRING_INSTANCE_MODIFIER_TYPE,
+    SDR_PARSE_FIELD_ID_STRING_INSTANCE_MODIFIER_OFFSET,
+    SDR_PARSE_FIELD_ENTITY_INSTANCE_SHARING,
+    SDR_PARSE_FIELD_CONTAINER_ENTITY_ID,
+    SDR_PARSE_FIELD_CONTAINER_ENTITY_INSTANCE,
+    SDR_PARSE_FIELD_DEVICE_ID_STRING,
+    SDR_PARSE_FIELD_DEVICE_TYPE,
+    SDR_PARSE_FIELD_DEVICE_TYPE_MODIFIER,
+    SDR_PARSE_FIELD_DEVICE_ACCESS_ADDRESS,
+    SDR_PARSE_FIELD_CHANNEL_NUMBER_LS,
+    SDR_PARSE_FIELD_CHANNEL_NUMBER_MS,
+    SDR_PARSE_FIELD_DEVICE_SLAVE_ADDRESS,
+    SDR_PARSE_FIELD_PRIVATE_BUS_ID,
+    SDR_PARSE_FIELD_LUN_FOR_MASTER_WRITE_READ_COMMAND,
+    SDR_PARSE_FIELD_ADDRESS_SPAN,
+    SDR_PARSE_FIELD_OEM,
+    SDR_PARSE_FIELD_LOGICAL_FRU_DEVICE_DEVICE_SLAVE_ADDRESS,
+    SDR_PARSE_FIELD_LUN_FOR_MASTER_WRITE_READ_FRU_COMMAND,
+    SDR_PARSE_FIELD_LOGICAL_PHYSICAL_FRU_DEVICE,
+    SDR_PARSE_FIELD_FRU_ENTITY_ID,
+    SDR_PARSE_FIELD_FRU_ENTITY_INSTANCE,
+    SDR_PARSE_FIELD_GLOBAL_INITIALIZATION_EVENT_MESSAGE_GENERATION,
+    SDR_PARSE_FIELD_GLOBAL_INITIALIZATION_LOG_INITIALIZATION_AGENT_ERRORS,
+    SDR_PARSE_FIELD_GLOBAL_INITIALIZATION_CONTROLLER_LOGS_INITIALIZATION_AGENT_ERRORS,
+    SDR_PARSE_FIELD_POWER_STATE_NOTIFICATION_CONTROLLER,
+    SDR_PARSE_FIELD_POWER_STATE_NOTIFICATION_ACPI_DEVICE_POWER_STATE_NOTIFICATION,
+    SDR_PARSE_FIELD_POWER_STATE_NOTIFICATION_ACPI_SYSTEM_POWER_STATE_NOTIFICATION,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_SENSOR_DEVICE,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_SDR_REPOSITORY_DEVICE,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_SEL_DEVICE,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_FRU_INVENTORY_DEVICE,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_IPMB_EVENT_RECEIVER,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_IPMB_EVENT_GENERATOR,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_BRIDGE,
+    SDR_PARSE_FIELD_DEVICE_CAPABILITIES_CHASSIS_DEVICE,
+    SDR_PARSE_FIELD_MANUFACTURER_ID,
+    SDR_PARSE_FIELD_PRODUCT_ID,
+    SDR_PARSE_FIELD_OEM_DATA,
+    SDR_PARSE_FIELD_NUM
+  };
+
+static const char *sdr_parse_field_keys[SDR_PARSE_FIELD_NUM] =
+  {
+    "record_id",
+    "record_type",
+    "sensor_owner_id.type",
+    "sensor_owner_id",
+    "sensor_owner_lun",
+    "channel_number",
+    "sensor_number",
+    "entity_id",
+    "entity_instance",
+    "entity_instance.type",
+    "sensor_type",
+    "event_reading_type_code",
+    "id_string",
+    "sensor_unit1.percentage",
+    "sensor_unit1.modifier_unit",
+    "sensor_unit1.rate_unit",
+    "sensor_unit2.base_unit",
+    "sensor_unit3.modifier_unit",
+    "sensor_capabilities.event_message_control_support",
+    "sensor_capabilities.threshold_access_support",
+    "sensor_capabilities.hysteresis_support",
+    "sensor_capabilities.auto_re_arm_support",
+    "sensor_capabilities.entity_ignore_support",
+    "sensor_direction",
+    "assertion_event_mask.event_offset_0",
+    "assertion_event_mask.event_offset_1",
+    "assertion_event_mask.event_offset_2",
+    "assertion_event_mask.event_offset_3",
+    "assertion_event_mask.event_offset_4",
+    "assertion_event_mask.event_offset_5",
+    "assertion_event_mask.event_offset_6",
+    "assertion_event_mask.event_offset_7",
+    "assertion_event_mask.event_offset_8",
+    "assertion_event_mask.event_offset_9",
+    "assertion_event_mask.event_offset_10",
+    "assertion_event_mask.event_offset_11",
+    "assertion_event_mask.event_offset_12",
+    "assertion_event_mask.event_offset_13",
+    "assertion_event_mask.event_offset_14",
+    "deassertion_event_mask.event_offset_0",
+    "deassertion_event_mask.event_offset_1",
+    "deassertion_event_mask.event_offset_2",
+    "deassertion_event_mask.event_offset_3",
+    "deassertion_event_mask.event_offset_4",
+    "deassertion_event_mask.event_offset_5",
+    "deassertion_event_mask.event_offset_6",
+    "deassertion_event_mask.event_offset_7",
+    "deassertion_event_mask.event_offset_8",
+    "deassertion_event_mask.event_offset_9",
+    "deassertion_event_mask.event_offset_10",
+    "deassertion_event_mask.event_offset_11",
+    "deassertion_event_mask.event_offset_12",
+    "deassertion_event_mask.event_offset_13",
+    "deassertion_event_mask.event_offset_14",
+    "threshold_assertion_event_mask.lower_non_critical_going_low_supported",
+    "threshold_assertion_event_mask.lower_non_critical_going_high_supported",
+    "threshold_assertion_event_mask.lower_critical_going_low_supported",
+    "threshold_assertion_event_mask.lower_critical_going_high_supported",
+    "threshold_assertion_event_mask.lower_non_recoverable_going_low_supported",
+    "threshold_assertion_event_mask.lower_non_recoverable_going_high_supported",
+    "threshold_assertion_event_mask.upper_non_critical_going_low_supported",
+    "threshold_assertion_event_mask.upper_non_critical_going_high_supported",
+    "threshold_assertion_event_mask.upper_critical_going_low_supported",
+    "threshold_assertion_event_mask.upper_critical_going_high_supported",
+    "threshold_assertion_event_mask.upper_non_recoverable_going_low_supported",
+    "threshold_assertion_event_mask.upper_non_recoverable_going_high_supported",
+    "threshold_deassertion_event_mask.lower_non_critical_going_low_supported",
+    "threshold_deassertion_event_mask.lower_non_critical_going_high_supported",
+    "threshold_deassertion_event_mask.lower_critical_going_low_supported",
+    "threshold_deassertion_event_mask.lower_critical_going_high_supported",
+    "threshold_deassertion_event_mask.lower_non_recoverable_going_low_supported",
+    "threshold_deassertion_event_mask.lower_non_recoverable_going_high_supported",
+    "threshold_deassertion_event_mask.upper_non_critical_going_low_supported",
+    "threshold_deassertion_event_mask.upper_non_critical_going_high_supported",
+    "threshold_deassertion_event_mask.upper_critical_going_low_supported",
+    "threshold_deassertion_event_mask.upper_critical_going_high_supported",
+    "threshold_deassertion_event_mask.upper_non_recoverable_going_low_supported",
+    "threshold_deassertion_event_mask.upper_non_recoverable_going_high_supported",
+    "readable_threshold_mask.lower_non_critical_threshold_is_readable",
+    "readable_threshold_mask.lower_critical_threshold_is_readable",
+    "readable_threshold_mask.lower_non_recoverable_threshold_is_readable",
+    "readable_threshold_mask.upper_non_critical_threshold_is_readable",
+    "readable_threshold_mask.upper_critical_threshold_is_readable",
+    "readable_threshold_mask.upper_non_recoverable_threshold_is_readable",
+    "settable_threshold_mask.lower_non_critical_threshold_is_settable",
+    "settable_threshold_mask.lower_critical_threshold_is_settable",
+    "settable_threshold_mask.lower_non_recoverable_threshold_is_settable",
+    "settable_threshold_mask.upper_non_critical_threshold_is_settable",
+    "settable_threshold_mask.upper_critical_threshold_is_settable",
+    "settable_threshold_mask.upper_non_recoverable_threshold_is_settable",
+    "r_exponent",
+    "b_exponent",
+    "m_ls",
+    "m_ms",
+    "b_ls",
+    "b_ms",
+    "linearization",
+    "sensor_unit1.analog_data_format",
+    "analog_characteristics_flag.nominal_reading",
+    "analog_characteristics_flag.normal_max",
+    "analog_characteristics_flag.normal_min",
+    "nominal_reading",
+    "normal_maximum",
+    "normal_minimum",
+    "sensor_maximum_reading",
+    "sensor_minimum_reading",
+    "lower_non_critical_threshold",
+    "lower_critical_threshold",
+    "lower_non_recoverable_threshold",
+    "upper_non_critical_threshold",
+    "upper_critical_threshold",
+    "upper_non_recoverable_threshold",
+    "tolerance",
+    "accuracy_ls",
+    "accuracy_ms",
+    "accuracy_exp",
+    "positive_going_threshold_hysteresis",
+    "negative_going_threshold_hysteresis",
+    "share_count",
+    "id_string_instance_modifier_type",
+    "id_string_instance_modifier_offset",
+    "entity_instance_sharing",
+    "container_entity_id",
+    "container_entity_instance",
+    "device_id_string",
+    "device_type",
+    "device_type_modifier",
+    "device_access_address",
+    "channel_number_ls",
+    "channel_number_ms",
+    "device_slave_address",
+    "private_bus_id",
+    "lun_for_master_write_read_command",
+    "address_span",
+    "oem",
+    "logical_fru_device_device_slave_address",
+    "lun_for_master_write_read_fru_command",
+    "logical_physical_fru_device",
+    "fru_entity_id",
+    "fru_entity_instance",
+    "global_initialization.event_message_generation",
+    "global_initialization.log_initialization_agent_errors",
+    "global_initialization.controller_logs_initialization_agent_errors",
+    "power_state_notification.controller",
+    "power_state_notification.acpi_device_power_state_notification",
+    "power_state_notification.acpi_system_power_state_notification",
+    "device_capabilities.sensor_device",
+    "device_capabilities.sdr_repository_device",
+    "device_capabilities.sel_device",
+    "device_capabilities.fru_inventory_device",
+    "device_capabilities.ipmb_event_receiver",
+    "device_capabilities.ipmb_event_generator",
+    "device_capabilities.bridge",
+    "device_capabilities.chassis_device",
+    "manufacturer_id",
+    "product_id",
+    "oem_data",
+  };
+
+static fiid_field_handle_t sdr_parse_field_handles[SDR_PARSE_FIELD_NUM];
+static pthread_once_t sdr_parse_field_handles_once = PTHREAD_ONCE_INIT;
+static int sdr_parse_field_handles_errnum = 0;
+
+static void
+_sdr_parse_field_handles_init_once (void)
+{
+  unsigned int i;
+
+  for (i = 0; i < SDR_PARSE_FIELD_NUM; i++)
+    {
+      if (!(sdr_parse_field_handles[i] = fiid_field_handle (sdr_parse_field_keys[i])))
+        {
+          sdr_parse_field_handles_errnum = errno ? errno : ENOMEM;
+          return;
+        }
+    }
+}
+
+static int
+_sdr_parse_field_handles_init (ipmi_sdr_ctx_t ctx)
+{
+  int perr;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SDR_CTX_MAGIC);
+
+  if ((perr = pthread_once (&sdr_parse_field_handles_once,
+                            _sdr_parse_field_handles_init_once)))
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, perr);
+      return (-1);
+    }
+
+  if (sdr_parse_field_handles_errnum)
+    {
+      SDR_ERRNO_TO_SDR_ERRNUM (ctx, sdr_parse_field_handles_errnum);
+      return (-1);
+    }
+
+  return (0);
+}
+
+/* Objects are only set once ctx has been validated */
+static void
+_sdr_obj_put (ipmi_sdr_ctx_t ctx, fiid_obj_t obj)
+{
+  if (obj)
+    obj_pool_put (&ctx->obj_pool, obj);
+}
+
 int
 ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
                                    const void *sdr_record,
@@ -67,13 +451,12 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
                                    uint16_t *record_id,
                                    uint8_t *record_type)
 {
-  uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
-  int sdr_record_buf_len;
   fiid_obj_t obj_sdr_record_header = NULL;
   int sdr_record_header_len;
-  void *sdr_record_to_use;
+  const void *sdr_record_to_use;
   unsigned int sdr_record_len_to_use;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
   if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
@@ -82,22 +465,34 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
       return (-1);
     }
 
+  if (_sdr_parse_field_handles_init (ctx) < 0)
+    return (-1);
+
+  /* see IPMI_SDR_FLAGS_DECODED_CACHE */
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_RECORD_ID_AND_TYPE,
+                          &decoded_index))
+    {
+      if (record_id)
+        *record_id = ctx->decoded->record_id[decoded_index];
+      if (record_type)
+        *record_type = ctx->decoded->record_type[decoded_index];
+      return (0);
+    }
+
   if (!sdr_record || !sdr_record_len)
     {
+      /* Parse straight out of the mapped cache rather than copying
+       * the record, the views below reference it directly.
+       */
       if (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE
           && !sdr_record
           && !sdr_record_len)
-        {
-          if ((sdr_record_buf_len = ipmi_sdr_cache_record_read (ctx,
-                                                                sdr_record_buf,
-                                                                IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
-            {
-              SDR_SET_INTERNAL_ERRNUM (ctx);
-              return (-1);
-            }
-          sdr_record_to_use = sdr_record_buf;
-          sdr_record_len_to_use = sdr_record_buf_len;
-        }
+        sdr_cache_current_record (ctx,
+                                  &sdr_record_to_use,
+                                  &sdr_record_len_to_use);
       else
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
@@ -106,7 +501,7 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
     }
   else
     {
-      sdr_record_to_use = (void *)sdr_record;
+      sdr_record_to_use = sdr_record;
       sdr_record_len_to_use = sdr_record_len;
     }
 
@@ -122,15 +517,15 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!(obj_sdr_record_header = fiid_obj_create (tmpl_sdr_record_header)))
+  if (!(obj_sdr_record_header = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_record_header)))
     {
       SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
       goto cleanup;
     }
 
-  if (fiid_obj_set_all (obj_sdr_record_header,
-                        sdr_record_to_use,
-                        sdr_record_header_len) < 0)
+  if (fiid_obj_view_bind (obj_sdr_record_header,
+                          sdr_record_to_use,
+                          sdr_record_header_len) < 0)
     {
       SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_header);
       goto cleanup;
@@ -138,9 +533,9 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
 
   if (record_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_header,
-                        "record_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_header,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_RECORD_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_header);
           goto cleanup;
@@ -150,9 +545,9 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
 
   if (record_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_header,
-                        "record_type",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_header,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_RECORD_TYPE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_header);
           goto cleanup;
@@ -165,7 +560,7 @@ ipmi_sdr_parse_record_id_and_type (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record_header);
+  _sdr_obj_put (ctx, obj_sdr_record_header);
   return (rv);
 }
 
@@ -175,9 +570,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
                         unsigned int sdr_record_len,
                         uint32_t acceptable_record_types)
 {
-  uint8_t sdr_record_buf[IPMI_SDR_MAX_RECORD_LENGTH];
-  int sdr_record_buf_len;
-  void *sdr_record_to_use;
+  const void *sdr_record_to_use;
   unsigned int sdr_record_len_to_use;
   fiid_obj_t obj_sdr_record = NULL;
   uint8_t record_type;
@@ -192,20 +585,15 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
 
   if (!sdr_record || !sdr_record_len)
     {
+      /* Parse straight out of the mapped cache rather than copying
+       * the record, the views below reference it directly.
+       */
       if (ctx->operation == IPMI_SDR_OPERATION_READ_CACHE
           && !sdr_record
           && !sdr_record_len)
-        {
-          if ((sdr_record_buf_len = ipmi_sdr_cache_record_read (ctx,
-                                                                sdr_record_buf,
-                                                                IPMI_SDR_MAX_RECORD_LENGTH)) < 0)
-            {
-              SDR_SET_INTERNAL_ERRNUM (ctx);
-              goto cleanup;
-            }
-          sdr_record_to_use = sdr_record_buf;
-          sdr_record_len_to_use = sdr_record_buf_len;
-        }
+        sdr_cache_current_record (ctx,
+                                  &sdr_record_to_use,
+                                  &sdr_record_len_to_use);
       else
         {
           SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
@@ -214,7 +602,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else
     {
-      sdr_record_to_use = (void *)sdr_record;
+      sdr_record_to_use = sdr_record;
       sdr_record_len_to_use = sdr_record_len;
     }
 
@@ -259,7 +647,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
 
   if (record_type == IPMI_SDR_FORMAT_FULL_SENSOR_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_full_sensor_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_full_sensor_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -267,7 +655,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_compact_sensor_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_compact_sensor_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -275,7 +663,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_EVENT_ONLY_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_event_only_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_event_only_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -283,7 +671,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_ENTITY_ASSOCIATION_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_entity_association_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_entity_association_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -291,7 +679,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_DEVICE_RELATIVE_ENTITY_ASSOCIATION_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_device_relative_entity_association_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_device_relative_entity_association_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -299,7 +687,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_GENERIC_DEVICE_LOCATOR_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_generic_device_locator_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_generic_device_locator_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -307,7 +695,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_FRU_DEVICE_LOCATOR_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_fru_device_locator_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_fru_device_locator_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -315,7 +703,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_DEVICE_LOCATOR_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_management_controller_device_locator_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_management_controller_device_locator_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -323,7 +711,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_MANAGEMENT_CONTROLLER_CONFIRMATION_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_management_controller_confirmation_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_management_controller_confirmation_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -331,7 +719,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_BMC_MESSAGE_CHANNEL_INFO_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_bmc_message_channel_info_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_bmc_message_channel_info_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
@@ -339,16 +727,16 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
     }
   else if (record_type == IPMI_SDR_FORMAT_OEM_RECORD)
     {
-      if (!(obj_sdr_record = fiid_obj_create (tmpl_sdr_oem_record)))
+      if (!(obj_sdr_record = obj_pool_get_view (&ctx->obj_pool, tmpl_sdr_oem_record)))
         {
           SDR_ERRNO_TO_SDR_ERRNUM (ctx, errno);
           goto cleanup;
         }
     }
 
-  if (fiid_obj_set_all (obj_sdr_record,
-                        sdr_record_to_use,
-                        sdr_record_len_to_use) < 0)
+  if (fiid_obj_view_bind (obj_sdr_record,
+                          sdr_record_to_use,
+                          sdr_record_len_to_use) < 0)
     {
       SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
       goto cleanup;
@@ -359,7 +747,7 @@ _sdr_record_get_common (ipmi_sdr_ctx_t ctx,
   return (obj_sdr_record);
 
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (NULL);
 }
 
@@ -373,8 +761,22 @@ ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_SENSOR_OWNER_ID,
+                          &decoded_index))
+    {
+      if (sensor_owner_id_type)
+        *sensor_owner_id_type = ctx->decoded->sensor_owner_id_type[decoded_index];
+      if (sensor_owner_id)
+        *sensor_owner_id = ctx->decoded->sensor_owner_id[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -387,9 +789,9 @@ ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
 
   if (sensor_owner_id_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_owner_id.type",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_OWNER_ID_TYPE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -399,9 +801,9 @@ ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
 
   if (sensor_owner_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_owner_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_OWNER_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -412,7 +814,7 @@ ipmi_sdr_parse_sensor_owner_id (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -426,8 +828,22 @@ ipmi_sdr_parse_sensor_owner_lun (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_SENSOR_OWNER_LUN,
+                          &decoded_index))
+    {
+      if (sensor_owner_lun)
+        *sensor_owner_lun = ctx->decoded->sensor_owner_lun[decoded_index];
+      if (channel_number)
+        *channel_number = ctx->decoded->channel_number[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -440,9 +856,9 @@ ipmi_sdr_parse_sensor_owner_lun (ipmi_sdr_ctx_t ctx,
 
   if (sensor_owner_lun)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_owner_lun",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_OWNER_LUN],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -452,9 +868,9 @@ ipmi_sdr_parse_sensor_owner_lun (ipmi_sdr_ctx_t ctx,
 
   if (channel_number)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "channel_number",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CHANNEL_NUMBER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -465,7 +881,7 @@ ipmi_sdr_parse_sensor_owner_lun (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -478,8 +894,20 @@ ipmi_sdr_parse_sensor_number (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_SENSOR_NUMBER,
+                          &decoded_index))
+    {
+      if (sensor_number)
+        *sensor_number = ctx->decoded->sensor_number[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -492,9 +920,9 @@ ipmi_sdr_parse_sensor_number (ipmi_sdr_ctx_t ctx,
 
   if (sensor_number)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_number",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_NUMBER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -505,7 +933,7 @@ ipmi_sdr_parse_sensor_number (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -520,8 +948,24 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_ENTITY_ID_INSTANCE_TYPE,
+                          &decoded_index))
+    {
+      if (entity_id)
+        *entity_id = ctx->decoded->entity_id[decoded_index];
+      if (entity_instance)
+        *entity_instance = ctx->decoded->entity_instance[decoded_index];
+      if (entity_instance_type)
+        *entity_instance_type = ctx->decoded->entity_instance_type[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -536,9 +980,9 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
 
   if (entity_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ENTITY_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -547,9 +991,9 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
     }
   if (entity_instance)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_instance",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ENTITY_INSTANCE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -558,9 +1002,9 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
     }
   if (entity_instance_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_instance.type",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ENTITY_INSTANCE_TYPE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -571,7 +1015,7 @@ ipmi_sdr_parse_entity_id_instance_type (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -584,8 +1028,20 @@ ipmi_sdr_parse_sensor_type (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_SENSOR_TYPE,
+                          &decoded_index))
+    {
+      if (sensor_type)
+        *sensor_type = ctx->decoded->sensor_type[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -598,9 +1054,9 @@ ipmi_sdr_parse_sensor_type (ipmi_sdr_ctx_t ctx,
 
   if (sensor_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_type",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_TYPE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -611,7 +1067,7 @@ ipmi_sdr_parse_sensor_type (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -624,8 +1080,20 @@ ipmi_sdr_parse_event_reading_type_code (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_EVENT_READING_TYPE_CODE,
+                          &decoded_index))
+    {
+      if (event_reading_type_code)
+        *event_reading_type_code = ctx->decoded->event_reading_type_code[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -638,9 +1106,9 @@ ipmi_sdr_parse_event_reading_type_code (ipmi_sdr_ctx_t ctx,
 
   if (event_reading_type_code)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "event_reading_type_code",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_EVENT_READING_TYPE_CODE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -651,7 +1119,7 @@ ipmi_sdr_parse_event_reading_type_code (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -665,8 +1133,44 @@ ipmi_sdr_parse_id_string (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   int len = 0;
+  unsigned int decoded_index;
+  const char *cache_id_string;
+  unsigned int cache_id_string_len;
   int rv = -1;
 
+  /* a buffer too small is an error, leave that to the parse below */
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_ID_STRING,
+                          &decoded_index)
+      && (!id_string
+          || !id_string_len
+          || id_string_len >= ctx->decoded->id_string_len[decoded_index]))
+    {
+      if (!id_string || !id_string_len)
+        return (0);
+      memcpy (id_string,
+              &ctx->decoded->id_string[decoded_index * IPMI_SDR_MAX_ID_STRING_LENGTH],
+              ctx->decoded->id_string_len[decoded_index]);
+      return (ctx->decoded->id_string_len[decoded_index]);
+    }
+
+  if (sdr_cache_index_id_string (ctx,
+                                 sdr_record,
+                                 sdr_record_len,
+                                 &cache_id_string,
+                                 &cache_id_string_len)
+      && (!id_string
+          || !id_string_len
+          || id_string_len >= cache_id_string_len))
+    {
+      if (!id_string || !id_string_len)
+        return (0);
+      memcpy (id_string, cache_id_string, cache_id_string_len);
+      return (cache_id_string_len);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_EVENT_ONLY_RECORD;
@@ -679,10 +1183,10 @@ ipmi_sdr_parse_id_string (ipmi_sdr_ctx_t ctx,
 
   if (id_string && id_string_len)
     {
-      if ((len = fiid_obj_get_data (obj_sdr_record,
-                                    "id_string",
-                                    id_string,
-                                    id_string_len)) < 0)
+      if ((len = fiid_obj_get_data_by_handle (obj_sdr_record,
+                                              sdr_parse_field_handles[SDR_PARSE_FIELD_ID_STRING],
+                                              id_string,
+                                              id_string_len)) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -692,7 +1196,7 @@ ipmi_sdr_parse_id_string (ipmi_sdr_ctx_t ctx,
   rv = len;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -709,8 +1213,28 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_SENSOR_UNITS,
+                          &decoded_index))
+    {
+      if (sensor_units_percentage)
+        *sensor_units_percentage = ctx->decoded->sensor_units_percentage[decoded_index];
+      if (sensor_units_modifier)
+        *sensor_units_modifier = ctx->decoded->sensor_units_modifier[decoded_index];
+      if (sensor_units_rate)
+        *sensor_units_rate = ctx->decoded->sensor_units_rate[decoded_index];
+      if (sensor_base_unit_type)
+        *sensor_base_unit_type = ctx->decoded->sensor_base_unit_type[decoded_index];
+      if (sensor_modifier_unit_type)
+        *sensor_modifier_unit_type = ctx->decoded->sensor_modifier_unit_type[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
   acceptable_record_types |= IPMI_SDR_PARSE_RECORD_TYPE_COMPACT_SENSOR_RECORD;
 
@@ -722,9 +1246,9 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
 
   if (sensor_units_percentage)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.percentage",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_UNIT1_PERCENTAGE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -734,9 +1258,9 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
 
   if (sensor_units_modifier)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.modifier_unit",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_UNIT1_MODIFIER_UNIT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -746,9 +1270,9 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
 
   if (sensor_units_rate)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.rate_unit",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_UNIT1_RATE_UNIT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -759,9 +1283,9 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
 
   if (sensor_base_unit_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit2.base_unit",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_UNIT2_BASE_UNIT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -774,9 +1298,9 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
 
   if (sensor_modifier_unit_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit3.modifier_unit",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_UNIT3_MODIFIER_UNIT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -790,7 +1314,7 @@ ipmi_sdr_parse_sensor_units (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -820,9 +1344,9 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
 
   if (event_message_control_support)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.event_message_control_support",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_CAPABILITIES_EVENT_MESSAGE_CONTROL_SUPPORT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -831,9 +1355,9 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
     }
   if (threshold_access_support)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.threshold_access_support",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_CAPABILITIES_THRESHOLD_ACCESS_SUPPORT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -842,9 +1366,9 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
     }
   if (hysteresis_support)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.hysteresis_support",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_CAPABILITIES_HYSTERESIS_SUPPORT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -853,9 +1377,9 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
     }
   if (auto_re_arm_support)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.auto_re_arm_support",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_CAPABILITIES_AUTO_RE_ARM_SUPPORT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -864,9 +1388,9 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
     }
   if (entity_ignore_support)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_capabilities.entity_ignore_support",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_CAPABILITIES_ENTITY_IGNORE_SUPPORT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -877,7 +1401,7 @@ ipmi_sdr_parse_sensor_capabilities (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -903,9 +1427,9 @@ ipmi_sdr_parse_sensor_direction (ipmi_sdr_ctx_t ctx,
 
   if (sensor_direction)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_direction",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_DIRECTION],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -916,7 +1440,7 @@ ipmi_sdr_parse_sensor_direction (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -999,9 +1523,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_0)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_0",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_0],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1011,9 +1535,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_1)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_1",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_1],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1023,9 +1547,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_2)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_2",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_2],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1035,9 +1559,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_3)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_3",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_3],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1047,9 +1571,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_4)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_4",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_4],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1059,9 +1583,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_5)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_5",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_5],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1071,9 +1595,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_6)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_6",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_6],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1083,9 +1607,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_7)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_7",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_7],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1095,9 +1619,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_8)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_8",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_8],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1107,9 +1631,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_9)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_9",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_9],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1119,9 +1643,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_10)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_10",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_10],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1131,9 +1655,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_11)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_11",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_11],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1143,9 +1667,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_12)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_12",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_12],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1155,9 +1679,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_13)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_13",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_13],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1167,9 +1691,9 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_14)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "assertion_event_mask.event_offset_14",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ASSERTION_EVENT_MASK_EVENT_OFFSET_14],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1180,7 +1704,7 @@ ipmi_sdr_parse_assertion_supported (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_discrete);
   return (rv);
 }
@@ -1264,9 +1788,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_0)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_0",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_0],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1276,9 +1800,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_1)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_1",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_1],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1288,9 +1812,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_2)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_2",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_2],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1300,9 +1824,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_3)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_3",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_3],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1312,9 +1836,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_4)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_4",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_4],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1324,9 +1848,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_5)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_5",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_5],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1336,9 +1860,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_6)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_6",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_6],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1348,9 +1872,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_7)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_7",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_7],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1360,9 +1884,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_8)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_8",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_8],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1372,9 +1896,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_9)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_9",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_9],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1384,9 +1908,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_10)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_10",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_10],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1396,9 +1920,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_11)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_11",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_11],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1408,9 +1932,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_12)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_12",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_12],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1420,9 +1944,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_13)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_13",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_13],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1432,9 +1956,9 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (event_state_14)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_discrete,
-                        "deassertion_event_mask.event_offset_14",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_discrete,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEASSERTION_EVENT_MASK_EVENT_OFFSET_14],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_discrete);
           goto cleanup;
@@ -1445,7 +1969,7 @@ ipmi_sdr_parse_deassertion_supported (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_discrete);
   return (rv);
 }
@@ -1521,9 +2045,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1533,9 +2057,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1545,9 +2069,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1557,9 +2081,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1569,9 +2093,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_recoverable_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1581,9 +2105,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.lower_non_recoverable_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1593,9 +2117,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1605,9 +2129,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1617,9 +2141,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1629,9 +2153,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1641,9 +2165,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_recoverable_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1653,9 +2177,9 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_assertion_event_mask.upper_non_recoverable_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_ASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1666,7 +2190,7 @@ ipmi_sdr_parse_threshold_assertion_supported (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_threshold);
   return (rv);
 }
@@ -1742,9 +2266,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1754,9 +2278,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1766,9 +2290,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1778,9 +2302,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1790,9 +2314,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_recoverable_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1802,9 +2326,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.lower_non_recoverable_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_LOWER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1814,9 +2338,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1826,9 +2350,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1838,9 +2362,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_critical_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1850,9 +2374,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_critical_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_CRITICAL_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1862,9 +2386,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_going_low)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_recoverable_going_low_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_LOW_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1874,9 +2398,9 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_going_high)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "threshold_deassertion_event_mask.upper_non_recoverable_going_high_supported",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_THRESHOLD_DEASSERTION_EVENT_MASK_UPPER_NON_RECOVERABLE_GOING_HIGH_SUPPORTED],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1887,7 +2411,7 @@ ipmi_sdr_parse_threshold_deassertion_supported (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_threshold);
   return (rv);
 }
@@ -1957,9 +2481,9 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.lower_non_critical_threshold_is_readable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_LOWER_NON_CRITICAL_THRESHOLD_IS_READABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1969,9 +2493,9 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.lower_critical_threshold_is_readable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_LOWER_CRITICAL_THRESHOLD_IS_READABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1981,9 +2505,9 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.lower_non_recoverable_threshold_is_readable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_LOWER_NON_RECOVERABLE_THRESHOLD_IS_READABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -1993,9 +2517,9 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.upper_non_critical_threshold_is_readable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_UPPER_NON_CRITICAL_THRESHOLD_IS_READABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2005,9 +2529,9 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.upper_critical_threshold_is_readable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_UPPER_CRITICAL_THRESHOLD_IS_READABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2017,9 +2541,9 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "readable_threshold_mask.upper_non_recoverable_threshold_is_readable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_READABLE_THRESHOLD_MASK_UPPER_NON_RECOVERABLE_THRESHOLD_IS_READABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2030,7 +2554,7 @@ ipmi_sdr_parse_threshold_readable (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_threshold);
   return (rv);
 }
@@ -2100,9 +2624,9 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.lower_non_critical_threshold_is_settable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_LOWER_NON_CRITICAL_THRESHOLD_IS_SETTABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2112,9 +2636,9 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.lower_critical_threshold_is_settable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_LOWER_CRITICAL_THRESHOLD_IS_SETTABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2124,9 +2648,9 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.lower_non_recoverable_threshold_is_settable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_LOWER_NON_RECOVERABLE_THRESHOLD_IS_SETTABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2136,9 +2660,9 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.upper_non_critical_threshold_is_settable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_UPPER_NON_CRITICAL_THRESHOLD_IS_SETTABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2148,9 +2672,9 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.upper_critical_threshold_is_settable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_UPPER_CRITICAL_THRESHOLD_IS_SETTABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2160,9 +2684,9 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "settable_threshold_mask.upper_non_recoverable_threshold_is_settable",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SETTABLE_THRESHOLD_MASK_UPPER_NON_RECOVERABLE_THRESHOLD_IS_SETTABLE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2173,7 +2697,7 @@ ipmi_sdr_parse_threshold_settable (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_threshold);
   return (rv);
 }
@@ -2192,8 +2716,30 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
   fiid_obj_t obj_sdr_record = NULL;
   uint32_t acceptable_record_types;
   uint64_t val, val1, val2;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_SENSOR_DECODING_DATA,
+                          &decoded_index))
+    {
+      if (r_exponent)
+        *r_exponent = ctx->decoded->r_exponent[decoded_index];
+      if (b_exponent)
+        *b_exponent = ctx->decoded->b_exponent[decoded_index];
+      if (m)
+        *m = ctx->decoded->m[decoded_index];
+      if (b)
+        *b = ctx->decoded->b[decoded_index];
+      if (linearization)
+        *linearization = ctx->decoded->linearization[decoded_index];
+      if (analog_data_format)
+        *analog_data_format = ctx->decoded->analog_data_format[decoded_index];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
 
   if (!(obj_sdr_record = _sdr_record_get_common (ctx,
@@ -2204,9 +2750,9 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
 
   if (r_exponent)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "r_exponent",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_R_EXPONENT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2218,9 +2764,9 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
 
   if (b_exponent)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "b_exponent",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_B_EXPONENT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2232,16 +2778,16 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
 
   if (m)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "m_ls",
-                        &val1) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_M_LS],
+                                  &val1) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
         }
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "m_ms",
-                        &val2) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_M_MS],
+                                  &val2) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2254,16 +2800,16 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
 
   if (b)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "b_ls",
-                        &val1) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_B_LS],
+                                  &val1) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
         }
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "b_ms",
-                        &val2) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_B_MS],
+                                  &val2) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2276,9 +2822,9 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
 
   if (linearization)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "linearization",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LINEARIZATION],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2288,9 +2834,9 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
 
   if (analog_data_format)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_unit1.analog_data_format",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_UNIT1_ANALOG_DATA_FORMAT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2301,7 +2847,7 @@ ipmi_sdr_parse_sensor_decoding_data (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -2373,9 +2919,9 @@ ipmi_sdr_parse_sensor_reading_ranges_specified (ipmi_sdr_ctx_t ctx,
 
   if (nominal_reading_specified)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "analog_characteristics_flag.nominal_reading",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ANALOG_CHARACTERISTICS_FLAG_NOMINAL_READING],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2385,9 +2931,9 @@ ipmi_sdr_parse_sensor_reading_ranges_specified (ipmi_sdr_ctx_t ctx,
 
   if (normal_maximum_specified)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "analog_characteristics_flag.normal_max",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ANALOG_CHARACTERISTICS_FLAG_NORMAL_MAX],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2397,9 +2943,9 @@ ipmi_sdr_parse_sensor_reading_ranges_specified (ipmi_sdr_ctx_t ctx,
 
   if (normal_minimum_specified)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "analog_characteristics_flag.normal_min",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ANALOG_CHARACTERISTICS_FLAG_NORMAL_MIN],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2410,7 +2956,7 @@ ipmi_sdr_parse_sensor_reading_ranges_specified (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -2481,9 +3027,9 @@ ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
 
   if (nominal_reading)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "nominal_reading",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_NOMINAL_READING],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2503,9 +3049,9 @@ ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
     }
   if (normal_maximum)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "normal_maximum",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_NORMAL_MAXIMUM],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2525,9 +3071,9 @@ ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
     }
   if (normal_minimum)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "normal_minimum",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_NORMAL_MINIMUM],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2547,9 +3093,9 @@ ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
     }
   if (sensor_maximum_reading)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_maximum_reading",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_MAXIMUM_READING],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2569,9 +3115,9 @@ ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
     }
   if (sensor_minimum_reading)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "sensor_minimum_reading",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SENSOR_MINIMUM_READING],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2604,7 +3150,7 @@ ipmi_sdr_parse_sensor_reading_ranges (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   if (rv < 0)
     {
       free (tmp_nominal_reading);
@@ -2687,9 +3233,9 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lower_non_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOWER_NON_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2709,9 +3255,9 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
     }
   if (lower_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lower_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOWER_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2731,9 +3277,9 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
     }
   if (lower_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lower_non_recoverable_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOWER_NON_RECOVERABLE_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2753,9 +3299,9 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
     }
   if (upper_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "upper_non_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_UPPER_NON_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2775,9 +3321,9 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
     }
   if (upper_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "upper_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_UPPER_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2797,9 +3343,9 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
     }
   if (upper_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "upper_non_recoverable_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_UPPER_NON_RECOVERABLE_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -2834,7 +3380,7 @@ ipmi_sdr_parse_thresholds (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   if (rv < 0)
     {
       free (tmp_lower_non_critical_threshold);
@@ -2863,8 +3409,32 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
   uint32_t acceptable_record_types;
   uint8_t event_reading_type_code;
   uint64_t val;
+  unsigned int decoded_index;
   int rv = -1;
 
+  if (sdr_decoded_lookup (ctx,
+                          sdr_record,
+                          sdr_record_len,
+                          SDR_DECODED_THRESHOLDS_RAW,
+                          &decoded_index))
+    {
+      uint8_t *thresholds = &ctx->decoded->thresholds_raw[decoded_index * SDR_DECODED_THRESHOLDS_PER_RECORD];
+
+      if (lower_non_critical_threshold)
+        *lower_non_critical_threshold = thresholds[0];
+      if (lower_critical_threshold)
+        *lower_critical_threshold = thresholds[1];
+      if (lower_non_recoverable_threshold)
+        *lower_non_recoverable_threshold = thresholds[2];
+      if (upper_non_critical_threshold)
+        *upper_non_critical_threshold = thresholds[3];
+      if (upper_critical_threshold)
+        *upper_critical_threshold = thresholds[4];
+      if (upper_non_recoverable_threshold)
+        *upper_non_recoverable_threshold = thresholds[5];
+      return (0);
+    }
+
   acceptable_record_types = IPMI_SDR_PARSE_RECORD_TYPE_FULL_SENSOR_RECORD;
 
   if (!(obj_sdr_record = _sdr_record_get_common (ctx,
@@ -2898,9 +3468,9 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "lower_non_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOWER_NON_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2910,9 +3480,9 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
 
   if (lower_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "lower_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOWER_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2922,9 +3492,9 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
 
   if (lower_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "lower_non_recoverable_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOWER_NON_RECOVERABLE_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2934,9 +3504,9 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "upper_non_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_UPPER_NON_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2946,9 +3516,9 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
 
   if (upper_critical_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "upper_critical_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_UPPER_CRITICAL_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2958,9 +3528,9 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
 
   if (upper_non_recoverable_threshold)
     {
-      if (FIID_OBJ_GET (obj_sdr_record_threshold,
-                        "upper_non_recoverable_threshold",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record_threshold,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_UPPER_NON_RECOVERABLE_THRESHOLD],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record_threshold);
           goto cleanup;
@@ -2971,7 +3541,7 @@ ipmi_sdr_parse_thresholds_raw (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   fiid_obj_destroy (obj_sdr_record_threshold);
   return (rv);
 }
@@ -3023,9 +3593,9 @@ ipmi_sdr_parse_tolerance (ipmi_sdr_ctx_t ctx,
     {
       double reading;
 
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "tolerance",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_TOLERANCE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3056,7 +3626,7 @@ ipmi_sdr_parse_tolerance (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   if (rv < 0)
     free (tmp_tolerance);
   return (rv);
@@ -3091,18 +3661,18 @@ ipmi_sdr_parse_accuracy (ipmi_sdr_ctx_t ctx,
     {
       double reading;
 
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "accuracy_ls",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ACCURACY_LS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
         }
       accuracy_ls = val;
 
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "accuracy_ms",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ACCURACY_MS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3112,9 +3682,9 @@ ipmi_sdr_parse_accuracy (ipmi_sdr_ctx_t ctx,
       /* accuracy is unsigned, no need to sign extend */
       accuracy_raw = accuracy_ls | (((uint16_t)accuracy_ms) << 6);
 
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "accuracy_exp",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ACCURACY_EXP],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3143,7 +3713,7 @@ ipmi_sdr_parse_accuracy (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   if (rv < 0)
     free (tmp_accuracy);
   return (rv);
@@ -3172,9 +3742,9 @@ ipmi_sdr_parse_hysteresis (ipmi_sdr_ctx_t ctx,
 
   if (positive_going_threshold_hysteresis)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "positive_going_threshold_hysteresis",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_POSITIVE_GOING_THRESHOLD_HYSTERESIS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3183,9 +3753,9 @@ ipmi_sdr_parse_hysteresis (ipmi_sdr_ctx_t ctx,
     }
   if (negative_going_threshold_hysteresis)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "negative_going_threshold_hysteresis",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_NEGATIVE_GOING_THRESHOLD_HYSTERESIS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3195,7 +3765,7 @@ ipmi_sdr_parse_hysteresis (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3224,9 +3794,9 @@ ipmi_sdr_parse_sensor_record_sharing (ipmi_sdr_ctx_t ctx,
 
   if (share_count)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "share_count",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_SHARE_COUNT],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3236,9 +3806,9 @@ ipmi_sdr_parse_sensor_record_sharing (ipmi_sdr_ctx_t ctx,
 
   if (id_string_instance_modifier_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "id_string_instance_modifier_type",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ID_STRING_INSTANCE_MODIFIER_TYPE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3248,9 +3818,9 @@ ipmi_sdr_parse_sensor_record_sharing (ipmi_sdr_ctx_t ctx,
 
   if (id_string_instance_modifier_offset)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "id_string_instance_modifier_offset",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ID_STRING_INSTANCE_MODIFIER_OFFSET],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3260,9 +3830,9 @@ ipmi_sdr_parse_sensor_record_sharing (ipmi_sdr_ctx_t ctx,
 
   if (entity_instance_sharing)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "entity_instance_sharing",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ENTITY_INSTANCE_SHARING],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3273,7 +3843,7 @@ ipmi_sdr_parse_sensor_record_sharing (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3300,9 +3870,9 @@ ipmi_sdr_parse_container_entity (ipmi_sdr_ctx_t ctx,
 
   if (container_entity_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "container_entity_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CONTAINER_ENTITY_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3312,9 +3882,9 @@ ipmi_sdr_parse_container_entity (ipmi_sdr_ctx_t ctx,
 
   if (container_entity_instance)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "container_entity_instance",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CONTAINER_ENTITY_INSTANCE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3325,7 +3895,7 @@ ipmi_sdr_parse_container_entity (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3353,10 +3923,10 @@ ipmi_sdr_parse_device_id_string (ipmi_sdr_ctx_t ctx,
 
   if (device_id_string && device_id_string_len)
     {
-      if ((len = fiid_obj_get_data (obj_sdr_record,
-                                    "device_id_string",
-                                    device_id_string,
-                                    device_id_string_len)) < 0)
+      if ((len = fiid_obj_get_data_by_handle (obj_sdr_record,
+                                              sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_ID_STRING],
+                                              device_id_string,
+                                              device_id_string_len)) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3366,7 +3936,7 @@ ipmi_sdr_parse_device_id_string (ipmi_sdr_ctx_t ctx,
   rv = len;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3393,9 +3963,9 @@ ipmi_sdr_parse_device_type (ipmi_sdr_ctx_t ctx,
 
   if (device_type)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_type",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_TYPE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3404,9 +3974,9 @@ ipmi_sdr_parse_device_type (ipmi_sdr_ctx_t ctx,
     }
   if (device_type_modifier)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_type_modifier",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_TYPE_MODIFIER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3417,7 +3987,7 @@ ipmi_sdr_parse_device_type (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3449,9 +4019,9 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
 
   if (device_access_address)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_access_address",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_ACCESS_ADDRESS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3460,16 +4030,16 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (channel_number)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "channel_number_ls",
-                        &val1) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CHANNEL_NUMBER_LS],
+                                  &val1) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
         }
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "channel_number_ms",
-                        &val2) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CHANNEL_NUMBER_MS],
+                                  &val2) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3478,9 +4048,9 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (device_slave_address)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_slave_address",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_SLAVE_ADDRESS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3489,9 +4059,9 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (private_bus_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "private_bus_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_PRIVATE_BUS_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3500,9 +4070,9 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (lun_for_master_write_read_command)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lun_for_master_write_read_command",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LUN_FOR_MASTER_WRITE_READ_COMMAND],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3511,9 +4081,9 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (address_span)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "address_span",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_ADDRESS_SPAN],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3522,9 +4092,9 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (oem)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "oem",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_OEM],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3535,7 +4105,7 @@ ipmi_sdr_parse_generic_device_locator_parameters (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3565,9 +4135,9 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
 
   if (device_access_address)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_access_address",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_ACCESS_ADDRESS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3576,9 +4146,9 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (logical_fru_device_device_slave_address)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "logical_fru_device_device_slave_address",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOGICAL_FRU_DEVICE_DEVICE_SLAVE_ADDRESS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3587,9 +4157,9 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (private_bus_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "private_bus_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_PRIVATE_BUS_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3598,9 +4168,9 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (lun_for_master_write_read_fru_command)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "lun_for_master_write_read_fru_command",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LUN_FOR_MASTER_WRITE_READ_FRU_COMMAND],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3609,9 +4179,9 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (logical_physical_fru_device)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "logical_physical_fru_device",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_LOGICAL_PHYSICAL_FRU_DEVICE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3620,9 +4190,9 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
     }
   if (channel_number)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "channel_number",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CHANNEL_NUMBER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3633,7 +4203,7 @@ ipmi_sdr_parse_fru_device_locator_parameters (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3659,9 +4229,9 @@ ipmi_sdr_parse_fru_entity_id_and_instance (ipmi_sdr_ctx_t ctx,
 
   if (fru_entity_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "fru_entity_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_FRU_ENTITY_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3670,9 +4240,9 @@ ipmi_sdr_parse_fru_entity_id_and_instance (ipmi_sdr_ctx_t ctx,
     }
   if (fru_entity_instance)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "fru_entity_instance",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_FRU_ENTITY_INSTANCE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3683,7 +4253,7 @@ ipmi_sdr_parse_fru_entity_id_and_instance (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3723,9 +4293,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
 
   if (device_slave_address)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_slave_address",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_SLAVE_ADDRESS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3734,9 +4304,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (channel_number)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "channel_number",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_CHANNEL_NUMBER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3745,9 +4315,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (global_initialization_event_message_generation)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "global_initialization.event_message_generation",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_GLOBAL_INITIALIZATION_EVENT_MESSAGE_GENERATION],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3756,9 +4326,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (global_initialization_log_initialization_agent_errors)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "global_initialization.log_initialization_agent_errors",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_GLOBAL_INITIALIZATION_LOG_INITIALIZATION_AGENT_ERRORS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3767,9 +4337,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (global_initialization_controller_logs_initialization_agent_errors)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "global_initialization.controller_logs_initialization_agent_errors",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_GLOBAL_INITIALIZATION_CONTROLLER_LOGS_INITIALIZATION_AGENT_ERRORS],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3778,9 +4348,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (power_state_notification_controller)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "power_state_notification.controller",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_POWER_STATE_NOTIFICATION_CONTROLLER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3789,9 +4359,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (power_state_notification_acpi_device_power_state_notification)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "power_state_notification.acpi_device_power_state_notification",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_POWER_STATE_NOTIFICATION_ACPI_DEVICE_POWER_STATE_NOTIFICATION],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3800,9 +4370,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (power_state_notification_acpi_system_power_state_notification)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "power_state_notification.acpi_system_power_state_notification",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_POWER_STATE_NOTIFICATION_ACPI_SYSTEM_POWER_STATE_NOTIFICATION],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3811,9 +4381,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_sensor_device)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.sensor_device",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_SENSOR_DEVICE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3822,9 +4392,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_sdr_repository_device)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.sdr_repository_device",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_SDR_REPOSITORY_DEVICE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3833,9 +4403,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_sel_device)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.sel_device",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_SEL_DEVICE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3844,9 +4414,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_fru_inventory_device)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.fru_inventory_device",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_FRU_INVENTORY_DEVICE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3855,9 +4425,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_ipmb_event_receiver)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.ipmb_event_receiver",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_IPMB_EVENT_RECEIVER],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3866,9 +4436,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_ipmb_event_generator)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.ipmb_event_generator",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_IPMB_EVENT_GENERATOR],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3877,9 +4447,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_bridge)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.bridge",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_BRIDGE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3888,9 +4458,9 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
     }
   if (device_capabilities_chassis_device)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "device_capabilities.chassis_device",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_DEVICE_CAPABILITIES_CHASSIS_DEVICE],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3901,7 +4471,7 @@ ipmi_sdr_parse_management_controller_device_locator_parameters (ipmi_sdr_ctx_t c
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3927,9 +4497,9 @@ ipmi_sdr_parse_manufacturer_id (ipmi_sdr_ctx_t ctx,
 
   if (manufacturer_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "manufacturer_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_MANUFACTURER_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3940,7 +4510,7 @@ ipmi_sdr_parse_manufacturer_id (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -3965,9 +4535,9 @@ ipmi_sdr_parse_product_id (ipmi_sdr_ctx_t ctx,
 
   if (product_id)
     {
-      if (FIID_OBJ_GET (obj_sdr_record,
-                        "product_id",
-                        &val) < 0)
+      if (FIID_OBJ_GET_BY_HANDLE (obj_sdr_record,
+                                  sdr_parse_field_handles[SDR_PARSE_FIELD_PRODUCT_ID],
+                                  &val) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -3978,7 +4548,7 @@ ipmi_sdr_parse_product_id (ipmi_sdr_ctx_t ctx,
   rv = 0;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
 
@@ -4004,10 +4574,10 @@ ipmi_sdr_parse_oem_data (ipmi_sdr_ctx_t ctx,
 
   if (oem_data && oem_data_len)
     {
-      if ((len = fiid_obj_get_data (obj_sdr_record,
-                                    "oem_data",
-                                    oem_data,
-                                    oem_data_len)) < 0)
+      if ((len = fiid_obj_get_data_by_handle (obj_sdr_record,
+                                              sdr_parse_field_handles[SDR_PARSE_FIELD_OEM_DATA],
+                                              oem_data,
+                                              oem_data_len)) < 0)
         {
           SDR_FIID_OBJECT_ERROR_TO_SDR_ERRNUM (ctx, obj_sdr_record);
           goto cleanup;
@@ -4017,6 +4587,6 @@ ipmi_sdr_parse_oem_data (ipmi_sdr_ctx_t ctx,
   rv = len;
   ctx->errnum = IPMI_SDR_ERR_SUCCESS;
  cleanup:
-  fiid_obj_destroy (obj_sdr_record);
+  _sdr_obj_put (ctx, obj_sdr_record);
   return (rv);
 }
@@ -42,7 +42,9 @@
 
 #include "freeipmi/sdr/ipmi-sdr.h"
 
+#include "ipmi-sdr-cache-index.h"
 #include "ipmi-sdr-common.h"
+#include "ipmi-sdr-decoded.h"
 #include "ipmi-sdr-defs.h"
 #include "ipmi-sdr-trace.h"
 #include "ipmi-sdr-util.h"
@@ -138,6 +140,11 @@ ipmi_sdr_ctx_destroy (ipmi_sdr_ctx_t ctx)
 
   list_destroy (ctx->saved_offsets);
 
+  sdr_cache_index_destroy (ctx);
+  sdr_decoded_destroy (ctx);
+
+  obj_pool_destroy (&ctx->obj_pool);
+
   ctx->magic = ~IPMI_SDR_CTX_MAGIC;
   ctx->operation = IPMI_SDR_OPERATION_UNINITIALIZED;
   free (ctx->debug_prefix);
@@ -199,7 +206,7 @@ ipmi_sdr_ctx_set_flags (ipmi_sdr_ctx_t ctx, unsigned int flags)
       return (-1);
     }
 
-  if (flags & ~IPMI_SDR_FLAGS_DEBUG_DUMP)
+  if (flags & ~(IPMI_SDR_FLAGS_DEBUG_DUMP | IPMI_SDR_FLAGS_DECODED_CACHE))
     {
       SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
       return (-1);
@@ -210,6 +217,26 @@ ipmi_sdr_ctx_set_flags (ipmi_sdr_ctx_t ctx, unsigned int flags)
   return (0);
 }
 
+int
+ipmi_sdr_ctx_get_allocations_avoided (ipmi_sdr_ctx_t ctx, uint64_t *allocations_avoided)
+{
+  if (!ctx || ctx->magic != IPMI_SDR_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sdr_ctx_errormsg (ctx), ipmi_sdr_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!allocations_avoided)
+    {
+      SDR_SET_ERRNUM (ctx, IPMI_SDR_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  *allocations_avoided = ctx->obj_pool.allocations_avoided;
+  ctx->errnum = IPMI_SDR_ERR_SUCCESS;
+  return (0);
+}
+
 char *
 ipmi_sdr_ctx_get_debug_prefix (ipmi_sdr_ctx_t ctx)
 {
@@ -43,6 +43,7 @@
 #include "ipmi-sel-trace.h"
 #include "ipmi-sel-util.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -140,7 +141,7 @@ sel_get_record_header_info (ipmi_sel_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!(obj_sel_record_header = fiid_obj_create (tmpl_sel_record_header)))
+  if (!(obj_sel_record_header = obj_pool_get (&ctx->obj_pool, tmpl_sel_record_header)))
     {
       SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
       goto cleanup;
@@ -184,7 +185,7 @@ sel_get_record_header_info (ipmi_sel_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_sel_record_header);
+  obj_pool_put (&ctx->obj_pool, obj_sel_record_header);
   return (rv);
 }
 
@@ -226,7 +227,7 @@ sel_get_timestamp (ipmi_sel_ctx_t ctx,
 
   if (record_type_class == IPMI_SEL_RECORD_TYPE_CLASS_SYSTEM_EVENT_RECORD)
     {
-      if (!(obj_sel_record = fiid_obj_create (tmpl_sel_system_event_record)))
+      if (!(obj_sel_record = obj_pool_get (&ctx->obj_pool, tmpl_sel_system_event_record)))
         {
           SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
           goto cleanup;
@@ -234,7 +235,7 @@ sel_get_timestamp (ipmi_sel_ctx_t ctx,
     }
   else
     {
-      if (!(obj_sel_record = fiid_obj_create (tmpl_sel_timestamped_oem_record)))
+      if (!(obj_sel_record = obj_pool_get (&ctx->obj_pool, tmpl_sel_timestamped_oem_record)))
         {
           SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
           goto cleanup;
@@ -263,7 +264,7 @@ sel_get_timestamp (ipmi_sel_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_sel_record);
+  obj_pool_put (&ctx->obj_pool, obj_sel_record);
   return (rv);
 }
 
@@ -302,7 +303,7 @@ sel_get_manufacturer_id (ipmi_sel_ctx_t ctx,
       goto cleanup;
     }
 
-  if (!(obj_sel_record = fiid_obj_create (tmpl_sel_timestamped_oem_record)))
+  if (!(obj_sel_record = obj_pool_get (&ctx->obj_pool, tmpl_sel_timestamped_oem_record)))
     {
       SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
       goto cleanup;
@@ -330,7 +331,7 @@ sel_get_manufacturer_id (ipmi_sel_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_sel_record);
+  obj_pool_put (&ctx->obj_pool, obj_sel_record);
   return (rv);
 }
 
@@ -375,7 +376,7 @@ sel_get_oem (ipmi_sel_ctx_t ctx,
 
   if (record_type_class == IPMI_SEL_RECORD_TYPE_CLASS_TIMESTAMPED_OEM_RECORD)
     {
-      if (!(obj_sel_record = fiid_obj_create (tmpl_sel_timestamped_oem_record)))
+      if (!(obj_sel_record = obj_pool_get (&ctx->obj_pool, tmpl_sel_timestamped_oem_record)))
         {
           SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
           goto cleanup;
@@ -383,7 +384,7 @@ sel_get_oem (ipmi_sel_ctx_t ctx,
     }
   else
     {
-      if (!(obj_sel_record = fiid_obj_create (tmpl_sel_non_timestamped_oem_record)))
+      if (!(obj_sel_record = obj_pool_get (&ctx->obj_pool, tmpl_sel_non_timestamped_oem_record)))
         {
           SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
           goto cleanup;
@@ -409,7 +410,7 @@ sel_get_oem (ipmi_sel_ctx_t ctx,
 
   rv = len;
  cleanup:
-  fiid_obj_destroy (obj_sel_record);
+  obj_pool_put (&ctx->obj_pool, obj_sel_record);
   return (rv);
 }
 
@@ -30,7 +30,8 @@
 #include "freeipmi/sdr/ipmi-sdr.h"
 #include "freeipmi/sel/ipmi-sel.h"
 
-#include "list.h"
+#include "libcommon/ipmi-fiid-pool.h"
+
 
 #ifndef MAXPATHLEN
 #define MAXPATHLEN 4096
@@ -44,9 +45,10 @@
 
 #define IPMI_SEL_RESERVATION_ID_RETRY         4
 
-#define IPMI_SEL_FLAGS_MASK                     \
-  (IPMI_SEL_FLAGS_DEBUG_DUMP                    \
-   | IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS)
+#define IPMI_SEL_FLAGS_MASK                       \
+  (IPMI_SEL_FLAGS_DEBUG_DUMP                      \
+   | IPMI_SEL_FLAGS_ASSUME_SYTEM_EVENT_RECORDS    \
+   | IPMI_SEL_FLAGS_PIPELINED)
 
 #define IPMI_SEL_SEPARATOR_STRING     " | "
 
@@ -67,6 +69,15 @@ struct ipmi_sel_entry {
   unsigned int sel_event_record_len; /* should always be 16, but just in case */
 };
 
+/* first_position is the lowest position of this and all later index
+ * entries, i.e. the first entry in SEL order w/ record id >= this one
+ */
+struct ipmi_sel_record_id_index {
+  uint16_t record_id;
+  unsigned int position;
+  unsigned int first_position;
+};
+
 struct ipmi_sel_oem_intel_node_manager {
   int node_manager_data_parsed;
   int node_manager_data_found;
@@ -96,13 +107,22 @@ struct ipmi_sel_ctx {
   int utc_offset;
 
   int sel_entries_loaded;
-  List sel_entries;
-  ListIterator sel_entries_itr;
-  struct ipmi_sel_entry *current_sel_entry;
+  struct ipmi_sel_entry *sel_entries;
+  unsigned int sel_entries_count;
+  unsigned int sel_entries_allocated;
+  unsigned int sel_entries_current;
+
+  /* built on first seek/search, see _sel_record_id_index_build() */
+  struct ipmi_sel_record_id_index *record_id_index;
+  unsigned int record_id_index_count;
+  int record_id_index_built;
 
   struct ipmi_sel_entry *callback_sel_entry;
 
   struct ipmi_sel_oem_intel_node_manager intel_node_manager;
+
+  /* reused record objects, see obj_pool_get() */
+  struct obj_pool obj_pool;
 };
 
 #endif /* IPMI_SEL_DEFS_H */
@@ -636,7 +636,7 @@ _get_previous_state_or_severity (ipmi_sel_ctx_t ctx,
   assert (previous_offset_from_event_reading_type_code);
   assert (offset_from_severity_event_reading_type_code);
 
-  if (!(obj_sel_system_event_record = fiid_obj_create (tmpl_sel_system_event_record_discrete_previous_state_severity)))
+  if (!(obj_sel_system_event_record = obj_pool_get (&ctx->obj_pool, tmpl_sel_system_event_record_discrete_previous_state_severity)))
     {
       SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
       goto cleanup;
@@ -670,7 +670,7 @@ _get_previous_state_or_severity (ipmi_sel_ctx_t ctx,
 
   rv = 0;
  cleanup:
-  fiid_obj_destroy (obj_sel_system_event_record);
+  obj_pool_put (&ctx->obj_pool, obj_sel_system_event_record);
   return (rv);
 }
 
@@ -41,6 +41,8 @@
 #include "freeipmi/record-format/ipmi-sel-record-format.h"
 #include "freeipmi/sdr/ipmi-sdr.h"
 #include "freeipmi/spec/ipmi-comp-code-spec.h"
+#include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
 #include "freeipmi/util/ipmi-sensor-and-event-code-tables-util.h"
 #include "freeipmi/util/ipmi-timestamp-util.h"
 #include "freeipmi/util/ipmi-util.h"
@@ -51,11 +53,25 @@
 #include "ipmi-sel-trace.h"
 #include "ipmi-sel-util.h"
 
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
 #include "debug-util.h"
 
+/* Get SEL Entry requests outstanding at once with
+ * IPMI_SEL_FLAGS_PIPELINED, must be <= IPMI_CMD_MULTI_MAX
+ */
+#define IPMI_SEL_PIPELINE_DEPTH 8
+
+/* sel_entry.sel_event_record_len == 0 if the entry was not read */
+struct sel_prefetch
+{
+  uint16_t record_id;
+  uint16_t next_record_id;
+  struct ipmi_sel_entry sel_entry;
+};
+
 static char *ipmi_sel_errmsgs[] =
   {
     "success",
@@ -131,48 +147,66 @@ ipmi_sel_ctx_create (ipmi_ctx_t ipmi_ctx, ipmi_sdr_ctx_t sdr_ctx)
   ctx->utc_offset = 0;
 
   ctx->sel_entries_loaded = 0;
+  ctx->sel_entries = NULL;
+  ctx->sel_entries_count = 0;
+  ctx->sel_entries_allocated = 0;
+  ctx->sel_entries_current = 0;
 
-  if (!(ctx->sel_entries = list_create ((ListDelF)free)))
-    {
-      ERRNO_TRACE (errno);
-      goto cleanup;
-    }
+  ctx->record_id_index = NULL;
+  ctx->record_id_index_count = 0;
+  ctx->record_id_index_built = 0;
 
   return (ctx);
-
- cleanup:
-  if (ctx)
-    {
-      if (ctx->sel_entries)
-        list_destroy (ctx->sel_entries);
-      free (ctx);
-    }
-  return (NULL);
-}
-
-static int
-_sel_entries_delete_all (void *x, void *y)
-{
-  return (1);
 }
 
+/* Entries are kept in one array, reused between parses.  It is only
+ * grown before an entry is filled in, so pointers into it (such as
+ * callback_sel_entry) remain valid until the next entry is added.
+ */
 static void
 _sel_entries_clear (ipmi_sel_ctx_t ctx)
 {
   assert (ctx);
   assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
 
-  list_delete_all (ctx->sel_entries, _sel_entries_delete_all, "dummyvalue");
+  ctx->sel_entries_count = 0;
+  ctx->sel_entries_current = 0;
+  ctx->sel_entries_loaded = 0;
+
+  ctx->record_id_index_count = 0;
+  ctx->record_id_index_built = 0;
 
-  if (ctx->sel_entries_itr)
+  ctx->callback_sel_entry = NULL;
+}
+
+/* returns next free entry, not counted until the caller increments
+ * sel_entries_count, NULL on error
+ */
+static struct ipmi_sel_entry *
+_sel_entries_next (ipmi_sel_ctx_t ctx)
+{
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+
+  if (ctx->sel_entries_count == ctx->sel_entries_allocated)
     {
-      list_iterator_destroy (ctx->sel_entries_itr);
-      ctx->sel_entries_itr = NULL;
+      struct ipmi_sel_entry *tmp;
+      unsigned int count;
+
+      count = ctx->sel_entries_allocated ? ctx->sel_entries_allocated * 2 : 64;
+
+      if (!(tmp = (struct ipmi_sel_entry *)realloc (ctx->sel_entries,
+                                                    count * sizeof (struct ipmi_sel_entry))))
+        {
+          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
+          return (NULL);
+        }
+
+      ctx->sel_entries = tmp;
+      ctx->sel_entries_allocated = count;
     }
-  ctx->sel_entries_loaded = 0;
 
-  ctx->current_sel_entry = NULL;
-  ctx->callback_sel_entry = NULL;
+  return (&ctx->sel_entries[ctx->sel_entries_count]);
 }
 
 void
@@ -187,7 +221,9 @@ ipmi_sel_ctx_destroy (ipmi_sel_ctx_t ctx)
   free (ctx->debug_prefix);
   free (ctx->separator);
   _sel_entries_clear (ctx);
-  list_destroy (ctx->sel_entries);
+  free (ctx->sel_entries);
+  free (ctx->record_id_index);
+  obj_pool_destroy (&ctx->obj_pool);
   ctx->magic = ~IPMI_SEL_CTX_MAGIC;
   free (ctx);
 }
@@ -281,6 +317,26 @@ ipmi_sel_ctx_set_flags (ipmi_sel_ctx_t ctx, unsigned int flags)
   return (0);
 }
 
+int
+ipmi_sel_ctx_get_allocations_avoided (ipmi_sel_ctx_t ctx, uint64_t *allocations_avoided)
+{
+  if (!ctx || ctx->magic != IPMI_SEL_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sel_ctx_errormsg (ctx), ipmi_sel_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!allocations_avoided)
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  *allocations_avoided = ctx->obj_pool.allocations_avoided;
+  ctx->errnum = IPMI_SEL_ERR_SUCCESS;
+  return (0);
+}
+
 int
 ipmi_sel_ctx_get_manufacturer_id (ipmi_sel_ctx_t ctx, uint32_t *manufacturer_id)
 {
@@ -901,6 +957,148 @@ _get_sel_entry (ipmi_sel_ctx_t ctx,
   return (rv);
 }
 
+/* Record ids are a linked list, but most BMCs hand them out
+ * sequentially, skipping only the ids of deleted entries.
+ * Speculatively read record_id, record_id + stride, ... with all
+ * requests outstanding at once.  Entries that could not be read, be
+ * it a misprediction or a cancelled reservation, are left for
+ * _get_sel_entry() to handle.
+ */
+static int
+_sel_prefetch_entries (ipmi_sel_ctx_t ctx,
+                       uint16_t record_id,
+                       uint16_t record_id_last,
+                       uint16_t stride,
+                       uint16_t reservation_id,
+                       int *reservation_id_initialized,
+                       fiid_obj_t *obj_cmd_rq,
+                       fiid_obj_t *obj_cmd_rs,
+                       struct sel_prefetch *prefetch)
+{
+  unsigned int count = 0;
+  unsigned int i;
+  uint64_t val;
+  int len;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->ipmi_ctx);
+  assert (stride);
+  assert (reservation_id_initialized);
+  assert (obj_cmd_rq);
+  assert (obj_cmd_rs);
+  assert (prefetch);
+
+  /* let _get_sel_entry() get a new reservation first, entries read
+   * before the cancel are still good
+   */
+  if (!(*reservation_id_initialized))
+    return (0);
+
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    prefetch[i].sel_entry.sel_event_record_len = 0;
+
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    {
+      uint32_t id = record_id + (uint32_t)i * stride;
+
+      if (id > record_id_last
+          || id >= IPMI_SEL_GET_RECORD_ID_LAST_ENTRY)
+        break;
+
+      prefetch[i].record_id = id;
+
+      if (fill_cmd_get_sel_entry (reservation_id,
+                                  prefetch[i].record_id,
+                                  0,
+                                  IPMI_SEL_READ_ENTIRE_RECORD_BYTES_TO_READ,
+                                  obj_cmd_rq[i]) < 0)
+        {
+          SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+          return (-1);
+        }
+      count++;
+    }
+
+  if (!count)
+    return (0);
+
+  if (ipmi_cmd_multi (ctx->ipmi_ctx,
+                      IPMI_BMC_IPMB_LUN_BMC,
+                      IPMI_NET_FN_STORAGE_RQ,
+                      obj_cmd_rq,
+                      obj_cmd_rs,
+                      count) < 0)
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_IPMI_ERROR);
+      return (-1);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      struct sel_prefetch *p = &prefetch[i];
+
+      if (FIID_OBJ_GET (obj_cmd_rs[i],
+                        "comp_code",
+                        &val) < 0)
+        {
+          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs[i]);
+          return (-1);
+        }
+
+      /* The retry, or the error if the reservation id was
+       * registered by the user, is left to _get_sel_entry().
+       */
+      if (val == IPMI_COMP_CODE_RESERVATION_CANCELLED)
+        {
+          (*reservation_id_initialized) = 0;
+          continue;
+        }
+
+      if (val != IPMI_COMP_CODE_COMMAND_SUCCESS)
+        continue;
+
+      if (FIID_OBJ_GET (obj_cmd_rs[i],
+                        "next_record_id",
+                        &val) < 0)
+        {
+          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs[i]);
+          return (-1);
+        }
+      p->next_record_id = val;
+
+      if ((len = fiid_obj_get_data (obj_cmd_rs[i],
+                                    "record_data",
+                                    p->sel_entry.sel_event_record,
+                                    IPMI_SEL_RECORD_LENGTH)) < 0)
+        {
+          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs[i]);
+          return (-1);
+        }
+      p->sel_entry.sel_event_record_len = len;
+    }
+
+  return (0);
+}
+
+static struct sel_prefetch *
+_sel_prefetch_find (struct sel_prefetch *prefetch,
+                    uint16_t record_id)
+{
+  unsigned int i;
+
+  assert (prefetch);
+
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    {
+      if (prefetch[i].sel_entry.sel_event_record_len
+          && prefetch[i].record_id == record_id)
+        return (&prefetch[i]);
+    }
+
+  return (NULL);
+}
+
 int
 ipmi_sel_parse (ipmi_sel_ctx_t ctx,
                 uint16_t record_id_start,
@@ -915,10 +1113,19 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
   uint16_t next_record_id = 0;
   int parsed_atleast_one_entry = 0;
   fiid_obj_t obj_cmd_rs = NULL;
+  struct sel_prefetch *prefetch = NULL;
+  fiid_obj_t prefetch_rq[IPMI_SEL_PIPELINE_DEPTH];
+  fiid_obj_t prefetch_rs[IPMI_SEL_PIPELINE_DEPTH];
+  uint16_t prefetch_stride = 0;
+  uint16_t last_stride = 0;
+  unsigned int i;
   uint64_t val;
   int len;
   int rv = -1;
 
+  memset (prefetch_rq, '\0', sizeof (prefetch_rq));
+  memset (prefetch_rs, '\0', sizeof (prefetch_rs));
+
   if (!ctx || ctx->magic != IPMI_SEL_CTX_MAGIC)
     {
       ERR_TRACE (ipmi_sel_ctx_errormsg (ctx), ipmi_sel_ctx_errnum (ctx));
@@ -939,7 +1146,7 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
 
   _sel_entries_clear (ctx);
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sel_entry_rs)))
+  if (!(obj_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sel_entry_rs)))
     {
       SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
       goto cleanup;
@@ -1009,11 +1216,8 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
           goto cleanup;
         }
 
-      if (!(sel_entry = (struct ipmi_sel_entry *)malloc (sizeof (struct ipmi_sel_entry))))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
-          goto cleanup;
-        }
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
 
       if ((len = fiid_obj_get_data (obj_cmd_rs,
                                     "record_data",
@@ -1028,7 +1232,9 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
 
       _sel_entry_dump (ctx, sel_entry);
 
-      /* achu: should come before list_append to avoid having a freed entry on the list */
+      /* should come before the entry is counted, so an entry the
+       * callback failed on isn't kept
+       */
       if (callback)
         {
           ctx->callback_sel_entry = sel_entry;
@@ -1039,78 +1245,151 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
             }
         }
 
-      if (!list_append (ctx->sel_entries, sel_entry))
+      ctx->sel_entries_count++;
+
+      goto out;
+    }
+
+  if (ctx->flags & IPMI_SEL_FLAGS_PIPELINED)
+    {
+      if (!(prefetch = (struct sel_prefetch *)malloc (IPMI_SEL_PIPELINE_DEPTH * sizeof (struct sel_prefetch))))
         {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
+          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
           goto cleanup;
         }
-      sel_entry = NULL;
 
-      goto out;
+      for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+        {
+          prefetch[i].sel_entry.sel_event_record_len = 0;
+
+          if (!(prefetch_rq[i] = fiid_obj_create (tmpl_cmd_get_sel_entry_rq)))
+            {
+              SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
+
+          if (!(prefetch_rs[i] = fiid_obj_create (tmpl_cmd_get_sel_entry_rs)))
+            {
+              SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
+              goto cleanup;
+            }
+        }
     }
 
   for (record_id = record_id_start;
        record_id <= record_id_last && record_id != IPMI_SEL_GET_RECORD_ID_LAST_ENTRY;
        record_id = next_record_id)
     {
-      if (_get_sel_entry (ctx,
-                          obj_cmd_rs,
-                          &reservation_id,
-                          &reservation_id_initialized,
-                          record_id) < 0)
+      struct sel_prefetch *p = NULL;
+
+      if (prefetch_stride)
         {
-          if (record_id == IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY
-              && ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
-              && ipmi_check_completion_code (obj_cmd_rs,
-                                             IPMI_COMP_CODE_REQUESTED_SENSOR_DATA_OR_RECORD_NOT_PRESENT) == 1)
+          if (!(p = _sel_prefetch_find (prefetch, record_id)))
             {
-              /* If the sel is empty it's not really an error */
-              goto out;
+              if (_sel_prefetch_entries (ctx,
+                                         record_id,
+                                         record_id_last,
+                                         prefetch_stride,
+                                         reservation_id,
+                                         &reservation_id_initialized,
+                                         prefetch_rq,
+                                         prefetch_rs,
+                                         prefetch) < 0)
+                goto cleanup;
+
+              p = _sel_prefetch_find (prefetch, record_id);
             }
-          else if (record_id_start != IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY
-                   && !parsed_atleast_one_entry
-                   && ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
-                   && ipmi_check_completion_code (obj_cmd_rs,
-                                                  IPMI_COMP_CODE_REQUESTED_SENSOR_DATA_OR_RECORD_NOT_PRESENT) == 1)
+        }
+
+      if (!p)
+        {
+          if (_get_sel_entry (ctx,
+                              obj_cmd_rs,
+                              &reservation_id,
+                              &reservation_id_initialized,
+                              record_id) < 0)
             {
-              /* user input a starting record id, we didn't find something yet, so iterate until we do */
-              next_record_id = record_id + 1;
-              continue;
+              if (record_id == IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY
+                  && ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
+                  && ipmi_check_completion_code (obj_cmd_rs,
+                                                 IPMI_COMP_CODE_REQUESTED_SENSOR_DATA_OR_RECORD_NOT_PRESENT) == 1)
+                {
+                  /* If the sel is empty it's not really an error */
+                  goto out;
+                }
+              else if (record_id_start != IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY
+                       && !parsed_atleast_one_entry
+                       && ipmi_ctx_errnum (ctx->ipmi_ctx) == IPMI_ERR_BAD_COMPLETION_CODE
+                       && ipmi_check_completion_code (obj_cmd_rs,
+                                                      IPMI_COMP_CODE_REQUESTED_SENSOR_DATA_OR_RECORD_NOT_PRESENT) == 1)
+                {
+                  /* user input a starting record id, we didn't find something yet, so iterate until we do */
+                  next_record_id = record_id + 1;
+                  continue;
+                }
+              /* else */
+              goto cleanup;
             }
-          /* else */
-          goto cleanup;
         }
 
       if (!parsed_atleast_one_entry)
         parsed_atleast_one_entry++;
 
-      if (FIID_OBJ_GET (obj_cmd_rs, "next_record_id", &val) < 0)
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
+
+      if (p)
         {
-          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
-          goto cleanup;
+          memcpy (sel_entry, &p->sel_entry, sizeof (struct ipmi_sel_entry));
+          next_record_id = p->next_record_id;
         }
-      next_record_id = val;
-
-      if (!(sel_entry = (struct ipmi_sel_entry *)malloc (sizeof (struct ipmi_sel_entry))))
+      else
         {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
-          goto cleanup;
+          if (FIID_OBJ_GET (obj_cmd_rs, "next_record_id", &val) < 0)
+            {
+              SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+              goto cleanup;
+            }
+          next_record_id = val;
+
+          if ((len = fiid_obj_get_data (obj_cmd_rs,
+                                        "record_data",
+                                        sel_entry->sel_event_record,
+                                        IPMI_SEL_RECORD_LENGTH)) < 0)
+            {
+              SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
+              goto cleanup;
+            }
+
+          sel_entry->sel_event_record_len = len;
         }
 
-      if ((len = fiid_obj_get_data (obj_cmd_rs,
-                                    "record_data",
-                                    sel_entry->sel_event_record,
-                                    IPMI_SEL_RECORD_LENGTH)) < 0)
+      /* Speculate only once two links in a row have had the same
+       * stride, a SEL with many deleted entries isn't worth guessing
+       * at.
+       */
+      if (prefetch)
         {
-          SEL_FIID_OBJECT_ERROR_TO_SEL_ERRNUM (ctx, obj_cmd_rs);
-          goto cleanup;
-        }
+          if (next_record_id > record_id
+              && record_id != IPMI_SEL_GET_RECORD_ID_FIRST_ENTRY)
+            {
+              uint16_t stride = next_record_id - record_id;
 
-      sel_entry->sel_event_record_len = len;
+              prefetch_stride = (stride == last_stride) ? stride : 0;
+              last_stride = stride;
+            }
+          else
+            {
+              prefetch_stride = 0;
+              last_stride = 0;
+            }
+        }
 
       _sel_entry_dump (ctx, sel_entry);
 
-      /* achu: should come before list_append to avoid having a freed entry on the list */
+      /* should come before the entry is counted, so an entry the
+       * callback failed on isn't kept
+       */
       if (callback)
         {
           ctx->callback_sel_entry = sel_entry;
@@ -1121,32 +1400,25 @@ ipmi_sel_parse (ipmi_sel_ctx_t ctx,
             }
         }
 
-      if (!list_append (ctx->sel_entries, sel_entry))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      sel_entry = NULL;
+      ctx->sel_entries_count++;
     }
 
  out:
 
-  if ((rv = list_count (ctx->sel_entries)) > 0)
-    {
-      if (!(ctx->sel_entries_itr = list_iterator_create (ctx->sel_entries)))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
-    }
+  rv = ctx->sel_entries_count;
+  ctx->sel_entries_current = 0;
   ctx->sel_entries_loaded = 1;
 
   ctx->errnum = IPMI_SEL_ERR_SUCCESS;
  cleanup:
   ctx->callback_sel_entry = NULL;
-  free (sel_entry);
-  fiid_obj_destroy (obj_cmd_rs);
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rs);
+  for (i = 0; i < IPMI_SEL_PIPELINE_DEPTH; i++)
+    {
+      fiid_obj_destroy (prefetch_rq[i]);
+      fiid_obj_destroy (prefetch_rs[i]);
+    }
+  free (prefetch);
   return (rv);
 }
 
@@ -1185,7 +1457,7 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
 
   _sel_entries_clear (ctx);
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sel_entry_rs)))
+  if (!(obj_cmd_rs = obj_pool_get (&ctx->obj_pool, tmpl_cmd_get_sel_entry_rs)))
     {
       SEL_ERRNO_TO_SEL_ERRNUM (ctx, errno);
       goto cleanup;
@@ -1210,11 +1482,8 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
           goto cleanup;
         }
 
-      if (!(sel_entry = (struct ipmi_sel_entry *)malloc (sizeof (struct ipmi_sel_entry))))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
-          goto cleanup;
-        }
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
 
       if ((len = fiid_obj_get_data (obj_cmd_rs,
                                     "record_data",
@@ -1229,7 +1498,9 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
 
       _sel_entry_dump (ctx, sel_entry);
 
-      /* achu: should come before list_append to avoid having a freed entry on the list */
+      /* should come before the entry is counted, so an entry the
+       * callback failed on isn't kept
+       */
       if (callback)
         {
           ctx->callback_sel_entry = sel_entry;
@@ -1240,30 +1511,81 @@ ipmi_sel_parse_record_ids (ipmi_sel_ctx_t ctx,
             }
         }
 
-      if (!list_append (ctx->sel_entries, sel_entry))
-        {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
-        }
-      sel_entry = NULL;
+      ctx->sel_entries_count++;
     }
 
-  if ((rv = list_count (ctx->sel_entries)) > 0)
+  rv = ctx->sel_entries_count;
+  ctx->sel_entries_current = 0;
+  ctx->sel_entries_loaded = 1;
+
+  ctx->errnum = IPMI_SEL_ERR_SUCCESS;
+ cleanup:
+  ctx->callback_sel_entry = NULL;
+  obj_pool_put (&ctx->obj_pool, obj_cmd_rs);
+  return (rv);
+}
+
+int
+ipmi_sel_parse_buffer (ipmi_sel_ctx_t ctx,
+                       const void *buf,
+                       unsigned int buflen,
+                       Ipmi_Sel_Parse_Callback callback,
+                       void *callback_data)
+{
+  struct ipmi_sel_entry *sel_entry = NULL;
+  const uint8_t *records;
+  unsigned int i;
+  int rv = -1;
+
+  if (!ctx || ctx->magic != IPMI_SEL_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sel_ctx_errormsg (ctx), ipmi_sel_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if ((!buf && buflen)
+      || (buflen % IPMI_SEL_RECORD_LENGTH))
     {
-      if (!(ctx->sel_entries_itr = list_iterator_create (ctx->sel_entries)))
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  _sel_entries_clear (ctx);
+
+  records = (const uint8_t *)buf;
+  for (i = 0; i < buflen; i += IPMI_SEL_RECORD_LENGTH)
+    {
+      if (!(sel_entry = _sel_entries_next (ctx)))
+        goto cleanup;
+
+      memcpy (sel_entry->sel_event_record, records + i, IPMI_SEL_RECORD_LENGTH);
+      sel_entry->sel_event_record_len = IPMI_SEL_RECORD_LENGTH;
+
+      _sel_entry_dump (ctx, sel_entry);
+
+      /* should come before the entry is counted, so an entry the
+       * callback failed on isn't kept
+       */
+      if (callback)
         {
-          SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_INTERNAL_ERROR);
-          goto cleanup;
+          ctx->callback_sel_entry = sel_entry;
+          if ((*callback)(ctx, callback_data) < 0)
+            {
+              SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_CALLBACK_ERROR);
+              goto cleanup;
+            }
         }
-      ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
+
+      ctx->sel_entries_count++;
     }
+
+  rv = ctx->sel_entries_count;
+  ctx->sel_entries_current = 0;
   ctx->sel_entries_loaded = 1;
 
   ctx->errnum = IPMI_SEL_ERR_SUCCESS;
  cleanup:
   ctx->callback_sel_entry = NULL;
-  free (sel_entry);
-  fiid_obj_destroy (obj_cmd_rs);
   return (rv);
 }
 
@@ -1282,14 +1604,13 @@ ipmi_sel_parse_first (ipmi_sel_ctx_t ctx)
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  list_iterator_reset (ctx->sel_entries_itr);
-  ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
+  ctx->sel_entries_current = 0;
   return (0);
 }
 
@@ -1308,14 +1629,15 @@ ipmi_sel_parse_next (ipmi_sel_ctx_t ctx)
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  ctx->current_sel_entry = list_next (ctx->sel_entries_itr);
-  return ((ctx->current_sel_entry) ? 1 : 0);
+  if (ctx->sel_entries_current < ctx->sel_entries_count)
+    ctx->sel_entries_current++;
+  return ((ctx->sel_entries_current < ctx->sel_entries_count) ? 1 : 0);
 }
 
 int
@@ -1333,13 +1655,91 @@ ipmi_sel_parse_sel_entry_count (ipmi_sel_ctx_t ctx)
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  return (list_count (ctx->sel_entries));
+  return (ctx->sel_entries_count);
+}
+
+static int
+_sel_record_id_index_compare (const void *a, const void *b)
+{
+  const struct ipmi_sel_record_id_index *ia = (const struct ipmi_sel_record_id_index *)a;
+  const struct ipmi_sel_record_id_index *ib = (const struct ipmi_sel_record_id_index *)b;
+
+  if (ia->record_id != ib->record_id)
+    return (ia->record_id < ib->record_id ? -1 : 1);
+  if (ia->position != ib->position)
+    return (ia->position < ib->position ? -1 : 1);
+  return (0);
+}
+
+/* Index of record ids sorted by record id, so finding a record id is
+ * a binary search instead of parsing every entry's header.  Entries
+ * w/ invalid headers are not indexed, as before they are never found.
+ */
+static int
+_sel_record_id_index_build (ipmi_sel_ctx_t ctx)
+{
+  struct ipmi_sel_record_id_index *tmp;
+  unsigned int first_position;
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SEL_CTX_MAGIC);
+  assert (ctx->sel_entries_count);
+
+  if (!(tmp = (struct ipmi_sel_record_id_index *)realloc (ctx->record_id_index,
+                                                          ctx->sel_entries_count * sizeof (struct ipmi_sel_record_id_index))))
+    {
+      SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_OUT_OF_MEMORY);
+      return (-1);
+    }
+  ctx->record_id_index = tmp;
+  ctx->record_id_index_count = 0;
+
+  for (i = 0; i < ctx->sel_entries_count; i++)
+    {
+      uint16_t record_id;
+
+      if (sel_get_record_header_info (ctx,
+                                      &ctx->sel_entries[i],
+                                      &record_id,
+                                      NULL) < 0)
+        {
+          /* if it was an invalid SEL entry, continue on */
+          if (ctx->errnum == IPMI_SEL_ERR_INVALID_SEL_ENTRY)
+            continue;
+          return (-1);
+        }
+
+      ctx->record_id_index[ctx->record_id_index_count].record_id = record_id;
+      ctx->record_id_index[ctx->record_id_index_count].position = i;
+      ctx->record_id_index_count++;
+    }
+
+  qsort (ctx->record_id_index,
+         ctx->record_id_index_count,
+         sizeof (struct ipmi_sel_record_id_index),
+         _sel_record_id_index_compare);
+
+  /* record ids need not be increasing in SEL order, so a seek must
+   * find the first entry in SEL order w/ a record id >= the target,
+   * not the smallest such record id.
+   */
+  first_position = ctx->sel_entries_count;
+  for (i = ctx->record_id_index_count; i > 0; i--)
+    {
+      if (ctx->record_id_index[i - 1].position < first_position)
+        first_position = ctx->record_id_index[i - 1].position;
+      ctx->record_id_index[i - 1].first_position = first_position;
+    }
+
+  ctx->record_id_index_built = 1;
+  return (0);
 }
 
 static int
@@ -1347,8 +1747,7 @@ _ipmi_sel_parse_find_record_id (ipmi_sel_ctx_t ctx,
                                 uint16_t record_id,
                                 unsigned int exact_match_flag)
 {
-  struct ipmi_sel_entry *sel_entry;
-  int rv = -1;
+  unsigned int lo, hi;
 
   if (!ctx || ctx->magic != IPMI_SEL_CTX_MAGIC)
     {
@@ -1362,45 +1761,53 @@ _ipmi_sel_parse_find_record_id (ipmi_sel_ctx_t ctx,
       return (-1);
     }
 
-  if (!ctx->sel_entries_itr)
+  if (!ctx->sel_entries_count)
     {
       SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
       return (-1);
     }
 
-  list_iterator_reset (ctx->sel_entries_itr);
+  if (!ctx->record_id_index_built)
+    {
+      if (_sel_record_id_index_build (ctx) < 0)
+        return (-1);
+    }
 
-  while ((sel_entry = list_next (ctx->sel_entries_itr)))
+  /* first index entry w/ record id >= record_id */
+  lo = 0;
+  hi = ctx->record_id_index_count;
+  while (lo < hi)
     {
-      uint16_t current_record_id;
+      unsigned int mid = lo + (hi - lo) / 2;
 
-      if (sel_get_record_header_info (ctx,
-                                      sel_entry,
-                                      &current_record_id,
-                                      NULL) < 0)
+      if (ctx->record_id_index[mid].record_id < record_id)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo < ctx->record_id_index_count)
+    {
+      if (exact_match_flag)
         {
-          /* if it was an invalid SEL entry, continue on */
-          if (ctx->errnum == IPMI_SEL_ERR_INVALID_SEL_ENTRY)
-            continue;
-          goto cleanup;
+          if (ctx->record_id_index[lo].record_id == record_id)
+            {
+              ctx->sel_entries_current = ctx->record_id_index[lo].position;
+              ctx->errnum = IPMI_SEL_ERR_SUCCESS;
+              return (0);
+            }
         }
-
-      if ((exact_match_flag
-           && current_record_id == record_id)
-          || (!exact_match_flag
-              && current_record_id >= record_id))
+      else
         {
-          rv = 0;
+          ctx->sel_entries_current = ctx->record_id_index[lo].first_position;
           ctx->errnum = IPMI_SEL_ERR_SUCCESS;
-          ctx->current_sel_entry = sel_entry;
-          goto cleanup;
+          return (0);
         }
     }
 
   SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NOT_FOUND);
-  list_iterator_reset (ctx->sel_entries_itr);
- cleanup:
-  return (rv);
+  ctx->sel_entries_current = 0;
+  return (-1);
 }
 
 int
@@ -1437,13 +1844,16 @@ _get_parse_sel_entry_common (ipmi_sel_ctx_t ctx,
           return (-1);
         }
 
-      if (!ctx->sel_entries_itr)
+      if (!ctx->sel_entries_count)
         {
           SEL_SET_ERRNUM (ctx, IPMI_SEL_ERR_NO_SEL_ENTRIES);
           return (-1);
         }
 
-      *sel_entry = ctx->current_sel_entry;
+      if (ctx->sel_entries_current < ctx->sel_entries_count)
+        *sel_entry = &ctx->sel_entries[ctx->sel_entries_current];
+      else
+        *sel_entry = NULL;
     }
 
   if (!(*sel_entry))
@@ -26,6 +26,8 @@
 #include <stdint.h>
 #include <sys/param.h>
 
+#include "freeipmi/api/ipmi-multi-api.h"
+#include "freeipmi/fiid/fiid.h"
 #include "freeipmi/sdr/ipmi-sdr.h"
 #include "freeipmi/sensor-read/ipmi-sensor-read.h"
 
@@ -43,6 +45,36 @@
    | IPMI_SENSOR_READ_FLAGS_IGNORE_SCANNING_DISABLED \
    | IPMI_SENSOR_READ_FLAGS_ASSUME_BMC_OWNER)
 
+/* Get Sensor Reading requests kept outstanding by ipmi_sensor_read_prefetch() */
+#define IPMI_SENSOR_READ_PREFETCH_DEPTH 8
+
+/* sensor numbers are 8 bits */
+#define IPMI_SENSOR_READ_PREFETCH_SENSORS 256
+
+/* large enough for a Get Sensor Reading response */
+#define IPMI_SENSOR_READ_PREFETCH_RS_LENGTH 32
+
+struct ipmi_sensor_read_prefetch {
+  uint8_t rs[IPMI_SENSOR_READ_PREFETCH_RS_LENGTH];
+  unsigned int rs_len;          /* 0 if nothing prefetched */
+};
+
+/* State of ipmi_sensor_read_prefetch_submit().  Requests are
+ * submitted one at a time, the next from the completion callback of
+ * the previous one.
+ */
+struct ipmi_sensor_read_prefetch_submit {
+  ipmi_multi_ctx_t mctx;
+  uint8_t sensor_numbers[IPMI_SENSOR_READ_PREFETCH_SENSORS];
+  unsigned int sensor_numbers_len;
+  /* index of the request outstanding */
+  unsigned int current;
+  fiid_obj_t obj_cmd_rq;
+  fiid_obj_t obj_cmd_rs;
+  Ipmi_Sensor_Read_Prefetch_Callback callback;
+  void *callback_data;
+};
+
 struct ipmi_sensor_read_ctx {
   uint32_t magic;
   int errnum;
@@ -50,6 +82,12 @@ struct ipmi_sensor_read_ctx {
 
   ipmi_ctx_t ipmi_ctx;
   ipmi_sdr_ctx_t sdr_ctx;
+
+  /* indexed by sensor number, allocated on first prefetch */
+  struct ipmi_sensor_read_prefetch *prefetch;
+
+  /* allocated on first ipmi_sensor_read_prefetch_submit() */
+  struct ipmi_sensor_read_prefetch_submit *submit;
 };
 
 #endif /* IPMI_SENSOR_READ_DEFS_H */
@@ -41,6 +41,7 @@
 #include "freeipmi/spec/ipmi-channel-spec.h"
 #include "freeipmi/spec/ipmi-comp-code-spec.h"
 #include "freeipmi/spec/ipmi-ipmb-lun-spec.h"
+#include "freeipmi/spec/ipmi-netfn-spec.h"
 #include "freeipmi/spec/ipmi-slave-address-spec.h"
 #include "freeipmi/spec/ipmi-sensor-units-spec.h"
 #include "freeipmi/util/ipmi-sensor-and-event-code-tables-util.h"
@@ -51,6 +52,8 @@
 #include "ipmi-sensor-read-trace.h"
 #include "ipmi-sensor-read-util.h"
 
+#include "api/ipmi-api-defs.h"
+#include "libcommon/ipmi-fiid-pool.h"
 #include "libcommon/ipmi-fiid-util.h"
 
 #include "freeipmi-portability.h"
@@ -111,6 +114,8 @@ ipmi_sensor_read_ctx_create (ipmi_ctx_t ipmi_ctx)
   ctx->flags = IPMI_SENSOR_READ_FLAGS_DEFAULT;
   ctx->ipmi_ctx = ipmi_ctx;
   ctx->sdr_ctx = NULL;
+  ctx->prefetch = NULL;
+  ctx->submit = NULL;
 
   if (!(ctx->sdr_ctx = ipmi_sdr_ctx_create ()))
     {
@@ -137,6 +142,13 @@ ipmi_sensor_read_ctx_destroy (ipmi_sensor_read_ctx_t ctx)
 
   ctx->magic = ~IPMI_SENSOR_READ_CTX_MAGIC;
   ipmi_sdr_ctx_destroy (ctx->sdr_ctx);
+  free (ctx->prefetch);
+  if (ctx->submit)
+    {
+      fiid_obj_destroy (ctx->submit->obj_cmd_rq);
+      fiid_obj_destroy (ctx->submit->obj_cmd_rs);
+      free (ctx->submit);
+    }
   free (ctx);
 }
 
@@ -316,6 +328,29 @@ _get_sensor_reading (ipmi_sensor_read_ctx_t ctx,
   assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
   assert (obj_cmd_rs);
 
+  /* A prefetched response is used once.  Responses with an error
+   * completion code are read again below, so errors are reported
+   * exactly as without prefetching.
+   */
+  if (ctx->prefetch && ctx->prefetch[sensor_number].rs_len)
+    {
+      struct ipmi_sensor_read_prefetch *p = &ctx->prefetch[sensor_number];
+      unsigned int rs_len = p->rs_len;
+
+      p->rs_len = 0;
+      if (fiid_obj_set_all (obj_cmd_rs, p->rs, rs_len) < 0)
+        {
+          SENSOR_READ_FIID_OBJECT_ERROR_TO_SENSOR_READ_ERRNUM (ctx, obj_cmd_rs);
+          goto cleanup;
+        }
+
+      if (ipmi_check_completion_code_success (obj_cmd_rs) == 1)
+        {
+          rv = 0;
+          goto cleanup;
+        }
+    }
+
   if (ipmi_cmd_get_sensor_reading (ctx->ipmi_ctx,
                                    sensor_number,
                                    obj_cmd_rs) < 0)
@@ -387,6 +422,451 @@ _get_sensor_reading_ipmb (ipmi_sensor_read_ctx_t ctx,
   return (rv);
 }
 
+/* returns 1 if the sensor of the current record is read from the BMC
+ * with a plain Get Sensor Reading, 0 if not
+ */
+static int
+_sensor_read_prefetchable (ipmi_sensor_read_ctx_t ctx,
+                           ipmi_sdr_ctx_t sdr_ctx,
+                           uint8_t *sensor_number)
+{
+  uint8_t record_type;
+  uint8_t sensor_owner_id_type;
+  uint8_t sensor_owner_id;
+  uint8_t sensor_owner_lun;
+  uint8_t channel_number;
+  uint8_t slave_address;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (sdr_ctx);
+  assert (sensor_number);
+
+  if (ipmi_sdr_parse_record_id_and_type (sdr_ctx,
+                                         NULL,
+                                         0,
+                                         NULL,
+                                         &record_type) < 0)
+    return (0);
+
+  if (record_type != IPMI_SDR_FORMAT_FULL_SENSOR_RECORD
+      && record_type != IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+    return (0);
+
+  if (ipmi_sdr_parse_sensor_owner_id (sdr_ctx,
+                                      NULL,
+                                      0,
+                                      &sensor_owner_id_type,
+                                      &sensor_owner_id) < 0)
+    return (0);
+
+  if (ipmi_sdr_parse_sensor_owner_lun (sdr_ctx,
+                                       NULL,
+                                       0,
+                                       &sensor_owner_lun,
+                                       &channel_number) < 0)
+    return (0);
+
+  if (ipmi_sdr_parse_sensor_number (sdr_ctx,
+                                    NULL,
+                                    0,
+                                    sensor_number) < 0)
+    return (0);
+
+  if (sensor_owner_id_type == IPMI_SDR_SENSOR_OWNER_ID_TYPE_SYSTEM_SOFTWARE_ID)
+    return (0);
+
+  if (ctx->flags & IPMI_SENSOR_READ_FLAGS_ASSUME_BMC_OWNER)
+    return (1);
+
+  slave_address = (sensor_owner_id << 1) | sensor_owner_id_type;
+
+  return (slave_address == IPMI_SLAVE_ADDRESS_BMC
+          && sensor_owner_lun == IPMI_BMC_IPMB_LUN_BMC);
+}
+
+static int
+_sensor_read_prefetch_window (ipmi_sensor_read_ctx_t ctx,
+                              uint8_t *sensor_numbers,
+                              unsigned int count,
+                              fiid_obj_t *obj_cmd_rq,
+                              fiid_obj_t *obj_cmd_rs)
+{
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (ctx->prefetch);
+  assert (sensor_numbers);
+  assert (count && count <= IPMI_SENSOR_READ_PREFETCH_DEPTH);
+  assert (obj_cmd_rq);
+  assert (obj_cmd_rs);
+
+  for (i = 0; i < count; i++)
+    {
+      if (fill_cmd_get_sensor_reading (sensor_numbers[i], obj_cmd_rq[i]) < 0)
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+
+  if (ipmi_cmd_multi (ctx->ipmi_ctx,
+                      IPMI_BMC_IPMB_LUN_BMC,
+                      IPMI_NET_FN_SENSOR_EVENT_RQ,
+                      obj_cmd_rq,
+                      obj_cmd_rs,
+                      count) < 0)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_IPMI_ERROR);
+      return (-1);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      struct ipmi_sensor_read_prefetch *p = &ctx->prefetch[sensor_numbers[i]];
+      int len;
+
+      /* a response too large to keep is simply read again later */
+      if ((len = fiid_obj_get_all (obj_cmd_rs[i],
+                                   p->rs,
+                                   IPMI_SENSOR_READ_PREFETCH_RS_LENGTH)) > 0)
+        p->rs_len = len;
+    }
+
+  return (0);
+}
+
+/* Clears previously prefetched responses and collects the sensor
+ * numbers of 'record_ids' that can be prefetched.
+ */
+static int
+_sensor_read_prefetch_sensors (ipmi_sensor_read_ctx_t ctx,
+                               ipmi_sdr_ctx_t sdr_ctx,
+                               const unsigned int *record_ids,
+                               unsigned int record_ids_len,
+                               uint8_t *sensor_numbers,
+                               unsigned int *sensor_numbers_len)
+{
+  uint8_t seen[IPMI_SENSOR_READ_PREFETCH_SENSORS];
+  uint16_t record_count = 0;
+  unsigned int i;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (sdr_ctx);
+  assert (sensor_numbers);
+  assert (sensor_numbers_len);
+
+  memset (seen, '\0', sizeof (seen));
+  *sensor_numbers_len = 0;
+
+  if (!ctx->prefetch)
+    {
+      if (!(ctx->prefetch = (struct ipmi_sensor_read_prefetch *)malloc (IPMI_SENSOR_READ_PREFETCH_SENSORS * sizeof (struct ipmi_sensor_read_prefetch))))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          return (-1);
+        }
+    }
+  memset (ctx->prefetch, '\0', IPMI_SENSOR_READ_PREFETCH_SENSORS * sizeof (struct ipmi_sensor_read_prefetch));
+
+  if (!record_ids)
+    {
+      if (ipmi_sdr_cache_record_count (sdr_ctx, &record_count) < 0
+          || ipmi_sdr_cache_first (sdr_ctx) < 0)
+        {
+          SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_SDR_ENTRY_ERROR);
+          return (-1);
+        }
+      record_ids_len = record_count;
+    }
+
+  for (i = 0; i < record_ids_len; i++)
+    {
+      uint8_t sensor_number;
+
+      if (record_ids)
+        {
+          if (ipmi_sdr_cache_search_record_id (sdr_ctx, record_ids[i]) < 0)
+            continue;
+        }
+      else if (i && ipmi_sdr_cache_next (sdr_ctx) <= 0)
+        break;
+
+      if (!_sensor_read_prefetchable (ctx, sdr_ctx, &sensor_number))
+        continue;
+
+      if (seen[sensor_number])
+        continue;
+      seen[sensor_number]++;
+      sensor_numbers[(*sensor_numbers_len)++] = sensor_number;
+    }
+
+  return (0);
+}
+
+int
+ipmi_sensor_read_prefetch (ipmi_sensor_read_ctx_t ctx,
+                           ipmi_sdr_ctx_t sdr_ctx,
+                           const unsigned int *record_ids,
+                           unsigned int record_ids_len)
+{
+  fiid_obj_t obj_cmd_rq[IPMI_SENSOR_READ_PREFETCH_DEPTH];
+  fiid_obj_t obj_cmd_rs[IPMI_SENSOR_READ_PREFETCH_DEPTH];
+  uint8_t sensor_numbers[IPMI_SENSOR_READ_PREFETCH_SENSORS];
+  unsigned int sensor_numbers_len = 0;
+  unsigned int ctx_flags_orig;
+  int ctx_flags_set = 0;
+  unsigned int count;
+  unsigned int i;
+  int rv = -1;
+
+  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!sdr_ctx
+      || (record_ids && !record_ids_len))
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  memset (obj_cmd_rq, '\0', sizeof (obj_cmd_rq));
+  memset (obj_cmd_rs, '\0', sizeof (obj_cmd_rs));
+
+  if (_sensor_read_prefetch_sensors (ctx,
+                                     sdr_ctx,
+                                     record_ids,
+                                     record_ids_len,
+                                     sensor_numbers,
+                                     &sensor_numbers_len) < 0)
+    goto cleanup;
+
+  if (!sensor_numbers_len)
+    {
+      rv = 0;
+      goto cleanup;
+    }
+
+  for (i = 0; i < IPMI_SENSOR_READ_PREFETCH_DEPTH; i++)
+    {
+      if (!(obj_cmd_rq[i] = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq)))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+
+      if (!(obj_cmd_rs[i] = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          goto cleanup;
+        }
+    }
+
+  /* see IPMI Workaround in ipmi_sensor_read() concerning
+   * sensor_event_bitmask
+   */
+  if (ipmi_ctx_get_flags (ctx->ipmi_ctx, &ctx_flags_orig) < 0)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_INTERNAL_ERROR);
+      goto cleanup;
+    }
+
+  if (ipmi_ctx_set_flags (ctx->ipmi_ctx, ctx_flags_orig | IPMI_FLAGS_NO_VALID_CHECK) < 0)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_INTERNAL_ERROR);
+      goto cleanup;
+    }
+  ctx_flags_set++;
+
+  for (i = 0; i < sensor_numbers_len; i += count)
+    {
+      count = sensor_numbers_len - i;
+      if (count > IPMI_SENSOR_READ_PREFETCH_DEPTH)
+        count = IPMI_SENSOR_READ_PREFETCH_DEPTH;
+
+      if (_sensor_read_prefetch_window (ctx,
+                                        &sensor_numbers[i],
+                                        count,
+                                        obj_cmd_rq,
+                                        obj_cmd_rs) < 0)
+        goto cleanup;
+    }
+
+  rv = 0;
+  ctx->errnum = IPMI_SENSOR_READ_ERR_SUCCESS;
+ cleanup:
+  if (ctx_flags_set)
+    ipmi_ctx_set_flags (ctx->ipmi_ctx, ctx_flags_orig);
+  for (i = 0; i < IPMI_SENSOR_READ_PREFETCH_DEPTH; i++)
+    {
+      fiid_obj_destroy (obj_cmd_rq[i]);
+      fiid_obj_destroy (obj_cmd_rs[i]);
+    }
+  return (rv);
+}
+
+
+static int _sensor_read_prefetch_submit_next (ipmi_sensor_read_ctx_t ctx);
+
+static void
+_sensor_read_prefetch_submit_callback (ipmi_ctx_t ipmi_ctx,
+                                       int rv,
+                                       fiid_obj_t obj_cmd_rs,
+                                       void *callback_data)
+{
+  ipmi_sensor_read_ctx_t ctx;
+  struct ipmi_sensor_read_prefetch_submit *submit;
+  int ret;
+
+  assert (ipmi_ctx);
+  assert (obj_cmd_rs);
+  assert (callback_data);
+
+  ctx = (ipmi_sensor_read_ctx_t)callback_data;
+
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (ctx->prefetch);
+  assert (ctx->submit);
+
+  submit = ctx->submit;
+
+  /* after a failure, e.g. a session timeout, the remaining sensors
+   * are left to ipmi_sensor_read() so the error is reported there
+   */
+  if (!rv)
+    {
+      struct ipmi_sensor_read_prefetch *p = &ctx->prefetch[submit->sensor_numbers[submit->current]];
+      int len;
+
+      /* a response too large to keep is simply read again later */
+      if ((len = fiid_obj_get_all (obj_cmd_rs,
+                                   p->rs,
+                                   IPMI_SENSOR_READ_PREFETCH_RS_LENGTH)) > 0)
+        p->rs_len = len;
+
+      submit->current++;
+      ret = _sensor_read_prefetch_submit_next (ctx);
+    }
+  else
+    ret = 0;
+
+  if (ret <= 0)
+    submit->callback (ctx, submit->callback_data);
+}
+
+/* Returns 1 if the next request was submitted, 0 if none are left,
+ * -1 on error
+ */
+static int
+_sensor_read_prefetch_submit_next (ipmi_sensor_read_ctx_t ctx)
+{
+  struct ipmi_sensor_read_prefetch_submit *submit;
+
+  assert (ctx);
+  assert (ctx->magic == IPMI_SENSOR_READ_CTX_MAGIC);
+  assert (ctx->submit);
+
+  submit = ctx->submit;
+
+  if (submit->current >= submit->sensor_numbers_len)
+    return (0);
+
+  if (fill_cmd_get_sensor_reading (submit->sensor_numbers[submit->current],
+                                   submit->obj_cmd_rq) < 0)
+    {
+      SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+      return (-1);
+    }
+
+  if (ipmi_multi_cmd_submit (submit->mctx,
+                             ctx->ipmi_ctx,
+                             IPMI_BMC_IPMB_LUN_BMC,
+                             IPMI_NET_FN_SENSOR_EVENT_RQ,
+                             submit->obj_cmd_rq,
+                             submit->obj_cmd_rs,
+                             _sensor_read_prefetch_submit_callback,
+                             ctx) < 0)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_IPMI_ERROR);
+      return (-1);
+    }
+
+  return (1);
+}
+
+int
+ipmi_sensor_read_prefetch_submit (ipmi_sensor_read_ctx_t ctx,
+                                  ipmi_sdr_ctx_t sdr_ctx,
+                                  const unsigned int *record_ids,
+                                  unsigned int record_ids_len,
+                                  ipmi_multi_ctx_t mctx,
+                                  Ipmi_Sensor_Read_Prefetch_Callback callback,
+                                  void *callback_data)
+{
+  struct ipmi_sensor_read_prefetch_submit *submit;
+  int ret;
+
+  if (!ctx || ctx->magic != IPMI_SENSOR_READ_CTX_MAGIC)
+    {
+      ERR_TRACE (ipmi_sensor_read_ctx_errormsg (ctx), ipmi_sensor_read_ctx_errnum (ctx));
+      return (-1);
+    }
+
+  if (!sdr_ctx
+      || (record_ids && !record_ids_len)
+      || !mctx
+      || !callback)
+    {
+      SENSOR_READ_SET_ERRNUM (ctx, IPMI_SENSOR_READ_ERR_PARAMETERS);
+      return (-1);
+    }
+
+  if (!ctx->submit)
+    {
+      if (!(ctx->submit = (struct ipmi_sensor_read_prefetch_submit *)malloc (sizeof (struct ipmi_sensor_read_prefetch_submit))))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          return (-1);
+        }
+      memset (ctx->submit, '\0', sizeof (struct ipmi_sensor_read_prefetch_submit));
+
+      if (!(ctx->submit->obj_cmd_rq = fiid_obj_create (tmpl_cmd_get_sensor_reading_rq))
+          || !(ctx->submit->obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)))
+        {
+          SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
+          fiid_obj_destroy (ctx->submit->obj_cmd_rq);
+          free (ctx->submit);
+          ctx->submit = NULL;
+          return (-1);
+        }
+    }
+
+  submit = ctx->submit;
+  submit->mctx = mctx;
+  submit->current = 0;
+  submit->callback = callback;
+  submit->callback_data = callback_data;
+
+  if (_sensor_read_prefetch_sensors (ctx,
+                                     sdr_ctx,
+                                     record_ids,
+                                     record_ids_len,
+                                     submit->sensor_numbers,
+                                     &submit->sensor_numbers_len) < 0)
+    return (-1);
+
+  if ((ret = _sensor_read_prefetch_submit_next (ctx)) < 0)
+    return (-1);
+
+  ctx->errnum = IPMI_SENSOR_READ_ERR_SUCCESS;
+  return (ret);
+}
+
 int
 ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
                   const void *sdr_record,
@@ -536,7 +1016,7 @@ ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
 
   slave_address = (sensor_owner_id << 1) | sensor_owner_id_type;
 
-  if (!(obj_cmd_rs = fiid_obj_create (tmpl_cmd_get_sensor_reading_rs)))
+  if (!(obj_cmd_rs = obj_pool_get (&ctx->ipmi_ctx->obj_pool, tmpl_cmd_get_sensor_reading_rs)))
     {
       SENSOR_READ_ERRNO_TO_SENSOR_READ_ERRNUM (ctx, errno);
       goto cleanup;
@@ -904,7 +1384,7 @@ ipmi_sensor_read (ipmi_sensor_read_ctx_t ctx,
     rv = 0;
 
  cleanup:
-  fiid_obj_destroy (obj_cmd_rs);
+  obj_pool_put (&ctx->ipmi_ctx->obj_pool, obj_cmd_rs);
   if (rv <= 0)
     free (tmp_sensor_reading);
   return (rv);
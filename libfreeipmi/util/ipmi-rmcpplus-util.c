@@ -1246,6 +1246,28 @@ ipmi_rmcpplus_check_packet_session_authentication_code (uint8_t integrity_algori
                                                         const void *authentication_code_data,
                                                         unsigned int authentication_code_data_len,
                                                         fiid_obj_t obj_rmcpplus_session_trlr)
+{
+  return (ipmi_rmcpplus_check_packet_session_authentication_code_cached (NULL,
+                                                                         integrity_algorithm,
+                                                                         pkt,
+                                                                         pkt_len,
+                                                                         integrity_key,
+                                                                         integrity_key_len,
+                                                                         authentication_code_data,
+                                                                         authentication_code_data_len,
+                                                                         obj_rmcpplus_session_trlr));
+}
+
+int
+ipmi_rmcpplus_check_packet_session_authentication_code_cached (ipmi_rmcpplus_crypt_cache_t cache,
+                                                               uint8_t integrity_algorithm,
+                                                               const void *pkt,
+                                                               unsigned int pkt_len,
+                                                               const void *integrity_key,
+                                                               unsigned int integrity_key_len,
+                                                               const void *authentication_code_data,
+                                                               unsigned int authentication_code_data_len,
+                                                               fiid_obj_t obj_rmcpplus_session_trlr)
 {
   unsigned int hash_algorithm, hash_flags;
   unsigned int expected_digest_len, compare_digest_len, hash_data_len = 0;
@@ -1375,14 +1397,15 @@ ipmi_rmcpplus_check_packet_session_authentication_code (uint8_t integrity_algori
       hash_data_len += IPMI_2_0_MAX_PASSWORD_LENGTH;
     }
 
-  if ((integrity_digest_len = crypt_hash (hash_algorithm,
-                                          hash_flags,
-                                          integrity_key,
-                                          integrity_key_len,
-                                          hash_data,
-                                          hash_data_len,
-                                          integrity_digest,
-                                          IPMI_MAX_INTEGRITY_DATA_LENGTH)) < 0)
+  if ((integrity_digest_len = crypt_hash_cached (cache,
+                                                 hash_algorithm,
+                                                 hash_flags,
+                                                 integrity_key,
+                                                 integrity_key_len,
+                                                 hash_data,
+                                                 hash_data_len,
+                                                 integrity_digest,
+                                                 IPMI_MAX_INTEGRITY_DATA_LENGTH)) < 0)
     {
       ERRNO_TRACE (errno);
       goto cleanup;
@@ -121,16 +121,17 @@ ipmiconsole_check_authentication_code (ipmiconsole_ctx_t c,
   else
     password = NULL;
 
-  if ((rv = ipmi_rmcpplus_check_packet_session_authentication_code (c->config.integrity_algorithm,
-                                                                    buf,
-                                                                    buflen,
-                                                                    c->session.integrity_key_ptr,
-                                                                    c->session.integrity_key_len,
-                                                                    password,
-                                                                    (password) ? strlen (password) : 0,
-                                                                    c->connection.obj_rmcpplus_session_trlr_rs)) < 0)
+  if ((rv = ipmi_rmcpplus_check_packet_session_authentication_code_cached (c->connection.crypt_cache,
+                                                                           c->config.integrity_algorithm,
+                                                                           buf,
+                                                                           buflen,
+                                                                           c->session.integrity_key_ptr,
+                                                                           c->session.integrity_key_len,
+                                                                           password,
+                                                                           (password) ? strlen (password) : 0,
+                                                                           c->connection.obj_rmcpplus_session_trlr_rs)) < 0)
     {
-      IPMICONSOLE_CTX_DEBUG (c, ("ipmi_rmcpplus_check_packet_session_authentication_code: p = %d; %s", p, strerror (errno)));
+      IPMICONSOLE_CTX_DEBUG (c, ("ipmi_rmcpplus_check_packet_session_authentication_code_cached: p = %d; %s", p, strerror (errno)));
       ipmiconsole_ctx_set_errnum (c, IPMICONSOLE_ERR_INTERNAL_ERROR);
       return (-1);
     }
@@ -875,6 +875,13 @@ ipmiconsole_ctx_connection_setup (ipmiconsole_ctx_t c)
       goto cleanup;
     }
 
+  if (!(c->connection.crypt_cache = ipmi_rmcpplus_crypt_cache_create ()))
+    {
+      IPMICONSOLE_CTX_DEBUG (c, ("ipmi_rmcpplus_crypt_cache_create: %s", strerror (errno)));
+      ipmiconsole_ctx_set_errnum (c, IPMICONSOLE_ERR_OUT_OF_MEMORY);
+      goto cleanup;
+    }
+
   return (0);
 
  cleanup:
@@ -1072,6 +1079,9 @@ __ipmiconsole_ctx_connection_cleanup (ipmiconsole_ctx_t c, int session_submitted
   if (c->connection.obj_close_session_rs)
     fiid_obj_destroy (c->connection.obj_close_session_rs);
 
+  if (c->connection.crypt_cache)
+    ipmi_rmcpplus_crypt_cache_destroy (c->connection.crypt_cache);
+
   /* If the session was never submitted (i.e. error in API land), don't
    * move this around.
    */
@@ -335,6 +335,9 @@ struct ipmiconsole_ctx_connection {
   fiid_obj_t obj_deactivate_payload_rs;
   fiid_obj_t obj_close_session_rq;
   fiid_obj_t obj_close_session_rs;
+
+  /* Keyed integrity/confidentiality handles for the session keys */
+  ipmi_rmcpplus_crypt_cache_t crypt_cache;
 };
 
 /*
@@ -715,25 +715,26 @@ _ipmi_2_0_packet_assemble (ipmiconsole_ctx_t c,
       return (-1);
     }
 
-  if ((pkt_len = assemble_ipmi_rmcpplus_pkt (authentication_algorithm,
-                                             integrity_algorithm,
-                                             confidentiality_algorithm,
-                                             integrity_key,
-                                             integrity_key_len,
-                                             confidentiality_key,
-                                             confidentiality_key_len,
-                                             authentication_code_data,
-                                             authentication_code_data_len,
-                                             c->connection.obj_rmcp_hdr_rq,
-                                             c->connection.obj_rmcpplus_session_hdr_rq,
-                                             c->connection.obj_lan_msg_hdr_rq,
-                                             obj_cmd_rq,
-                                             c->connection.obj_rmcpplus_session_trlr_rq,
-                                             buf,
-                                             buflen,
-                                             IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+  if ((pkt_len = assemble_ipmi_rmcpplus_pkt_cached (c->connection.crypt_cache,
+                                                    authentication_algorithm,
+                                                    integrity_algorithm,
+                                                    confidentiality_algorithm,
+                                                    integrity_key,
+                                                    integrity_key_len,
+                                                    confidentiality_key,
+                                                    confidentiality_key_len,
+                                                    authentication_code_data,
+                                                    authentication_code_data_len,
+                                                    c->connection.obj_rmcp_hdr_rq,
+                                                    c->connection.obj_rmcpplus_session_hdr_rq,
+                                                    c->connection.obj_lan_msg_hdr_rq,
+                                                    obj_cmd_rq,
+                                                    c->connection.obj_rmcpplus_session_trlr_rq,
+                                                    buf,
+                                                    buflen,
+                                                    IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
     {
-      IPMICONSOLE_CTX_DEBUG (c, ("assemble_ipmi_rmcpplus_pkt: p = %d; %s", p, strerror (errno)));
+      IPMICONSOLE_CTX_DEBUG (c, ("assemble_ipmi_rmcpplus_pkt_cached: p = %d; %s", p, strerror (errno)));
       ipmiconsole_ctx_set_errnum (c, IPMICONSOLE_ERR_INTERNAL_ERROR);
       return (-1);
     }
@@ -1500,25 +1501,26 @@ ipmiconsole_packet_unassemble (ipmiconsole_ctx_t c,
           obj_cmd =  ipmiconsole_packet_object (c, pkt);
 
           /* IPMI 2.0 Pre-Session Establishment Packets */
-          if ((pkt_ret = unassemble_ipmi_rmcpplus_pkt (IPMI_AUTHENTICATION_ALGORITHM_RAKP_NONE,
-                                                       IPMI_INTEGRITY_ALGORITHM_NONE,
-                                                       IPMI_CONFIDENTIALITY_ALGORITHM_NONE,
-                                                       NULL,
-                                                       0,
-                                                       NULL,
-                                                       0,
-                                                       buf,
-                                                       buflen,
-                                                       c->connection.obj_rmcp_hdr_rs,
-                                                       c->connection.obj_rmcpplus_session_hdr_rs,
-                                                       c->connection.obj_rmcpplus_payload_rs,
-                                                       c->connection.obj_lan_msg_hdr_rs,
-                                                       obj_cmd,
-                                                       c->connection.obj_lan_msg_trlr_rs,
-                                                       c->connection.obj_rmcpplus_session_trlr_rs,
-                                                       IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+          if ((pkt_ret = unassemble_ipmi_rmcpplus_pkt_cached (c->connection.crypt_cache,
+                                                              IPMI_AUTHENTICATION_ALGORITHM_RAKP_NONE,
+                                                              IPMI_INTEGRITY_ALGORITHM_NONE,
+                                                              IPMI_CONFIDENTIALITY_ALGORITHM_NONE,
+                                                              NULL,
+                                                              0,
+                                                              NULL,
+                                                              0,
+                                                              buf,
+                                                              buflen,
+                                                              c->connection.obj_rmcp_hdr_rs,
+                                                              c->connection.obj_rmcpplus_session_hdr_rs,
+                                                              c->connection.obj_rmcpplus_payload_rs,
+                                                              c->connection.obj_lan_msg_hdr_rs,
+                                                              obj_cmd,
+                                                              c->connection.obj_lan_msg_trlr_rs,
+                                                              c->connection.obj_rmcpplus_session_trlr_rs,
+                                                              IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
             {
-              IPMICONSOLE_CTX_DEBUG (c, ("unassemble_ipmi_rmcpplus_pkt: %s", strerror (errno)));
+              IPMICONSOLE_CTX_DEBUG (c, ("unassemble_ipmi_rmcpplus_pkt_cached: %s", strerror (errno)));
               ipmiconsole_ctx_set_errnum (c, IPMICONSOLE_ERR_INTERNAL_ERROR);
               return (-1);
             }
@@ -1564,25 +1566,26 @@ ipmiconsole_packet_unassemble (ipmiconsole_ctx_t c,
           obj_cmd =  ipmiconsole_packet_object (c, pkt);
 
           /* IPMI 2.0 Session Packets */
-          if ((pkt_ret = unassemble_ipmi_rmcpplus_pkt (c->config.authentication_algorithm,
-                                                       c->config.integrity_algorithm,
-                                                       c->config.confidentiality_algorithm,
-                                                       c->session.integrity_key_ptr,
-                                                       c->session.integrity_key_len,
-                                                       c->session.confidentiality_key_ptr,
-                                                       c->session.confidentiality_key_len,
-                                                       buf,
-                                                       buflen,
-                                                       c->connection.obj_rmcp_hdr_rs,
-                                                       c->connection.obj_rmcpplus_session_hdr_rs,
-                                                       c->connection.obj_rmcpplus_payload_rs,
-                                                       c->connection.obj_lan_msg_hdr_rs,
-                                                       obj_cmd,
-                                                       c->connection.obj_lan_msg_trlr_rs,
-                                                       c->connection.obj_rmcpplus_session_trlr_rs,
-                                                       IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
+          if ((pkt_ret = unassemble_ipmi_rmcpplus_pkt_cached (c->connection.crypt_cache,
+                                                              c->config.authentication_algorithm,
+                                                              c->config.integrity_algorithm,
+                                                              c->config.confidentiality_algorithm,
+                                                              c->session.integrity_key_ptr,
+                                                              c->session.integrity_key_len,
+                                                              c->session.confidentiality_key_ptr,
+                                                              c->session.confidentiality_key_len,
+                                                              buf,
+                                                              buflen,
+                                                              c->connection.obj_rmcp_hdr_rs,
+                                                              c->connection.obj_rmcpplus_session_hdr_rs,
+                                                              c->connection.obj_rmcpplus_payload_rs,
+                                                              c->connection.obj_lan_msg_hdr_rs,
+                                                              obj_cmd,
+                                                              c->connection.obj_lan_msg_trlr_rs,
+                                                              c->connection.obj_rmcpplus_session_trlr_rs,
+                                                              IPMI_INTERFACE_FLAGS_DEFAULT)) < 0)
             {
-              IPMICONSOLE_CTX_DEBUG (c, ("unassemble_ipmi_rmcpplus_pkt: %s", strerror (errno)));
+              IPMICONSOLE_CTX_DEBUG (c, ("unassemble_ipmi_rmcpplus_pkt_cached: %s", strerror (errno)));
               ipmiconsole_ctx_set_errnum (c, IPMICONSOLE_ERR_INTERNAL_ERROR);
               return (-1);
             }
@@ -48,6 +48,7 @@
 #include <time.h>
 #endif /* !HAVE_SYS_TIME_H */
 #endif /* !TIME_WITH_SYS_TIME */
+#include <pthread.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -55,6 +56,7 @@
 #include "ipmi_monitoring_defs.h"
 #include "ipmi_monitoring_debug.h"
 #include "ipmi_monitoring_ipmi_communication.h"
+#include "ipmi_monitoring_parse_common.h"
 #include "ipmi_monitoring_sdr_cache.h"
 #include "ipmi_monitoring_sel.h"
 #include "ipmi_monitoring_sensor_reading.h"
@@ -186,12 +188,47 @@ _destroy_sensor_reading (void *x)
   free (reading);
 }
 
+static void
+_session_free (ipmi_monitoring_ctx_t c)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (c->session_open)
+    {
+      ipmi_monitoring_sdr_cache_unload (c);
+      ipmi_monitoring_ipmi_communication_cleanup (c);
+    }
+
+  free (c->session_hostname);
+  free (c->session_config.driver_device);
+  free (c->session_config.username);
+  if (c->session_config.password)
+    {
+      secure_memset (c->session_config.password, '\0', strlen (c->session_config.password));
+      free (c->session_config.password);
+    }
+  if (c->session_config.k_g)
+    {
+      secure_memset (c->session_config.k_g, '\0', c->session_config.k_g_len);
+      free (c->session_config.k_g);
+    }
+
+  c->session_open = 0;
+  c->session_hostname = NULL;
+  memset (&c->session_config, '\0', sizeof (struct ipmi_monitoring_ipmi_config));
+  c->session_config_set = 0;
+  c->session_sdr_checked = 0;
+}
+
 static void
 _destroy_ctx (ipmi_monitoring_ctx_t c)
 {
   assert (c);
   assert (c->magic == IPMI_MONITORING_MAGIC);
 
+  _session_free (c);
+
   ipmi_interpret_ctx_destroy (c->interpret_ctx);
 
   /* Note: destroy iterator first */
@@ -222,6 +259,11 @@ _destroy_ctx (ipmi_monitoring_ctx_t c)
 
   c->current_sensor_reading = NULL;
 
+  free (c->sensor_names);
+  c->sensor_names = NULL;
+
+  ipmi_monitoring_sensor_reading_deltas_destroy (c);
+
   c->magic = ~IPMI_MONITORING_MAGIC;
   if (_ipmi_monitoring_flags & IPMI_MONITORING_FLAGS_LOCK_MEMORY)
     secure_free (c, sizeof (struct ipmi_monitoring_ctx));
@@ -335,6 +377,11 @@ ipmi_monitoring_ctx_sel_config_file (ipmi_monitoring_ctx_t c,
       return (-1);
     }
 
+  memset (c->sel_config_file, '\0', MAXPATHLEN + 1);
+  if (sel_config_file)
+    strncpy (c->sel_config_file, sel_config_file, MAXPATHLEN);
+  c->sel_config_file_set = 1;
+
   c->errnum = IPMI_MONITORING_ERR_SUCCESS;
   return (0);
 }
@@ -378,6 +425,11 @@ ipmi_monitoring_ctx_sensor_config_file (ipmi_monitoring_ctx_t c,
     }
 
  out:
+  memset (c->sensor_config_file, '\0', MAXPATHLEN + 1);
+  if (sensor_config_file)
+    strncpy (c->sensor_config_file, sensor_config_file, MAXPATHLEN);
+  c->sensor_config_file_set = 1;
+
   c->errnum = IPMI_MONITORING_ERR_SUCCESS;
   return (0);
 }
@@ -455,6 +507,333 @@ ipmi_monitoring_ctx_sdr_cache_filenames (ipmi_monitoring_ctx_t c, const char *fo
   return (0);
 }
 
+int
+ipmi_monitoring_ctx_sdr_cache_shared_directory (ipmi_monitoring_ctx_t c, const char *dir)
+{
+  struct stat buf;
+
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  if (!_ipmi_monitoring_initialized)
+    {
+      c->errnum = IPMI_MONITORING_ERR_LIBRARY_UNINITIALIZED;
+      return (-1);
+    }
+
+  if (!dir || (strlen (dir) > MAXPATHLEN))
+    {
+      c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (stat (dir, &buf) < 0)
+    {
+      if (errno == EACCES || errno == EPERM)
+        c->errnum = IPMI_MONITORING_ERR_PERMISSION;
+      else
+        c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  strncpy (c->sdr_cache_shared_directory, dir, MAXPATHLEN);
+  c->sdr_cache_shared_directory_set = 1;
+
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+  return (0);
+}
+
+static int
+_session_config_copy (ipmi_monitoring_ctx_t c,
+                      struct ipmi_monitoring_ipmi_config *config)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (config);
+
+  c->session_config = *config;
+  c->session_config.driver_device = NULL;
+  c->session_config.username = NULL;
+  c->session_config.password = NULL;
+  c->session_config.k_g = NULL;
+  c->session_config_set = 1;
+
+  if (config->driver_device
+      && !(c->session_config.driver_device = strdup (config->driver_device)))
+    goto cleanup;
+
+  if (config->username
+      && !(c->session_config.username = strdup (config->username)))
+    goto cleanup;
+
+  if (config->password
+      && !(c->session_config.password = strdup (config->password)))
+    goto cleanup;
+
+  if (config->k_g && config->k_g_len)
+    {
+      if (!(c->session_config.k_g = (unsigned char *)malloc (config->k_g_len)))
+        goto cleanup;
+      memcpy (c->session_config.k_g, config->k_g, config->k_g_len);
+    }
+
+  return (0);
+
+ cleanup:
+  IPMI_MONITORING_DEBUG (("malloc: %s", strerror (errno)));
+  c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+  return (-1);
+}
+
+int
+ipmi_monitoring_ctx_session_open (ipmi_monitoring_ctx_t c,
+                                  const char *hostname,
+                                  struct ipmi_monitoring_ipmi_config *config)
+{
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  if (!_ipmi_monitoring_initialized)
+    {
+      c->errnum = IPMI_MONITORING_ERR_LIBRARY_UNINITIALIZED;
+      return (-1);
+    }
+
+  _session_free (c);
+
+  if (hostname
+      && !(c->session_hostname = strdup (hostname)))
+    {
+      IPMI_MONITORING_DEBUG (("strdup: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      goto cleanup;
+    }
+
+  if (config
+      && _session_config_copy (c, config) < 0)
+    goto cleanup;
+
+  if (ipmi_monitoring_ipmi_communication_init (c,
+                                               c->session_hostname,
+                                               c->session_config_set ? &c->session_config : NULL) < 0)
+    goto cleanup;
+
+  c->session_open = 1;
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+  return (0);
+
+ cleanup:
+  _session_free (c);
+  return (-1);
+}
+
+int
+ipmi_monitoring_ctx_session_close (ipmi_monitoring_ctx_t c)
+{
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  _session_free (c);
+
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_monitoring_ctx_sensor_deltas_deadband (ipmi_monitoring_ctx_t c,
+                                            double deadband)
+{
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  if (deadband < 0)
+    {
+      c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  c->sensor_deltas_deadband = deadband;
+
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+  return (0);
+}
+
+int
+ipmi_monitoring_ctx_sensor_deltas_reset (ipmi_monitoring_ctx_t c,
+                                         const char *hostname)
+{
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  if (ipmi_monitoring_sensor_reading_deltas_reset (c, hostname) < 0)
+    return (-1);
+
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+  return (0);
+}
+
+/* returns 1 if the persistent session is for hostname */
+static int
+_session_match (ipmi_monitoring_ctx_t c, const char *hostname)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (!c->session_open)
+    return (0);
+
+  if (!hostname || !c->session_hostname)
+    return (!hostname && !c->session_hostname);
+
+  return (!strcmp (hostname, c->session_hostname));
+}
+
+/* returns 1 if a call for hostname will reuse an established session */
+static int
+_session_established (ipmi_monitoring_ctx_t c, const char *hostname)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  return (_session_match (c, hostname) && c->ipmi_ctx);
+}
+
+/* returns 1 if a call that reused an established session timed out
+ * and should be retried on a new one, at most once per call
+ */
+static int
+_session_retry (ipmi_monitoring_ctx_t c, int *session_reused)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (session_reused);
+
+  if (!*session_reused
+      || c->errnum != IPMI_MONITORING_ERR_SESSION_TIMEOUT)
+    return (0);
+
+  IPMI_MONITORING_DEBUG (("session timed out, re-establishing"));
+  *session_reused = 0;
+  return (1);
+}
+
+static int
+_ipmi_monitoring_connect (ipmi_monitoring_ctx_t c,
+                          const char *hostname,
+                          struct ipmi_monitoring_ipmi_config *config)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (!c->session_open)
+    return (ipmi_monitoring_ipmi_communication_init (c, hostname, config));
+
+  if (!_session_match (c, hostname))
+    {
+      c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  /* re-established after a timeout */
+  if (!c->ipmi_ctx)
+    return (ipmi_monitoring_ipmi_communication_init (c,
+                                                     c->session_hostname,
+                                                     c->session_config_set ? &c->session_config : NULL));
+
+  return (0);
+}
+
+/* returns 1 if IPMI 2.0 commands may be pipelined.  A persistent
+ * session uses the config it was opened with, not the call's.
+ */
+static int
+_ipmi_monitoring_pipelined (ipmi_monitoring_ctx_t c,
+                            const char *hostname,
+                            struct ipmi_monitoring_ipmi_config *config)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (c->session_open)
+    {
+      hostname = c->session_hostname;
+      config = c->session_config_set ? &c->session_config : NULL;
+    }
+
+  return (hostname
+          && config
+          && config->protocol_version == IPMI_MONITORING_PROTOCOL_VERSION_2_0);
+}
+
+/* A persistent session keeps its SDR loaded, but rechecks it against
+ * the BMC's SDR repository info every
+ * IPMI_MONITORING_SESSION_SDR_CHECK_INTERVAL seconds.  Reloading the
+ * cache reruns the out of date check and updates it if needed.
+ */
+static int
+_ipmi_monitoring_sdr_load (ipmi_monitoring_ctx_t c,
+                           const char *hostname,
+                           unsigned int sdr_create_flags)
+{
+  time_t now;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (!c->session_open)
+    return (ipmi_monitoring_sdr_cache_load (c, hostname, sdr_create_flags));
+
+  now = time (NULL);
+
+  if (c->sdr_ctx)
+    {
+      /* handle clock going backwards too */
+      if (now >= c->session_sdr_checked
+          && (now - c->session_sdr_checked) < IPMI_MONITORING_SESSION_SDR_CHECK_INTERVAL)
+        return (0);
+
+      ipmi_monitoring_sdr_cache_unload (c);
+    }
+
+  if (ipmi_monitoring_sdr_cache_load (c, hostname, sdr_create_flags) < 0)
+    return (-1);
+
+  c->session_sdr_checked = now;
+  return (0);
+}
+
+static int
+_ipmi_monitoring_sdr_flush (ipmi_monitoring_ctx_t c,
+                            const char *hostname)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (c->session_open)
+    ipmi_monitoring_sdr_cache_unload (c);
+
+  return (ipmi_monitoring_sdr_cache_flush (c, hostname));
+}
+
+/* A persistent session is kept unless it timed out, in which case it
+ * and its SDR are re-established by the next call.
+ */
+static void
+_ipmi_monitoring_disconnect (ipmi_monitoring_ctx_t c, int error)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (c->session_open
+      && !(error
+           && (c->errnum == IPMI_MONITORING_ERR_SESSION_TIMEOUT
+               || c->errnum == IPMI_MONITORING_ERR_CONNECTION_TIMEOUT)))
+    return;
+
+  ipmi_monitoring_sdr_cache_unload (c);
+  ipmi_monitoring_ipmi_communication_cleanup (c);
+}
+
 static int
 _ipmi_monitoring_interpret_oem_data (ipmi_monitoring_ctx_t c, int enable_interpret_oem_data)
 {
@@ -559,12 +938,12 @@ _ipmi_monitoring_sel (ipmi_monitoring_ctx_t c,
 
   ipmi_monitoring_sel_iterator_destroy (c);
 
-  if (ipmi_monitoring_ipmi_communication_init (c, hostname, config) < 0)
+  if (_ipmi_monitoring_connect (c, hostname, config) < 0)
     goto cleanup;
 
   if (sel_flags & IPMI_MONITORING_SEL_FLAGS_REREAD_SDR_CACHE)
     {
-      if (ipmi_monitoring_sdr_cache_flush (c, hostname) < 0)
+      if (_ipmi_monitoring_sdr_flush (c, hostname) < 0)
         goto cleanup;
     }
 
@@ -582,12 +961,25 @@ _ipmi_monitoring_sel (ipmi_monitoring_ctx_t c,
   if (sel_flags & IPMI_MONITORING_SEL_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT)
     sdr_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT;
 
-  if (ipmi_monitoring_sdr_cache_load (c, hostname, sdr_create_flags) < 0)
+  if (_ipmi_monitoring_pipelined (c, hostname, config))
+    sdr_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED;
+
+  if (_ipmi_monitoring_sdr_load (c, hostname, sdr_create_flags) < 0)
     goto cleanup;
 
   if (ipmi_monitoring_sel_init (c) < 0)
     goto cleanup;
 
+  if (_ipmi_monitoring_pipelined (c, hostname, config))
+    {
+      if (ipmi_sel_ctx_set_flags (c->sel_parse_ctx, IPMI_SEL_FLAGS_PIPELINED) < 0)
+        {
+          IPMI_MONITORING_DEBUG (("ipmi_sel_ctx_set_flags: %s", ipmi_sel_ctx_errormsg (c->sel_parse_ctx)));
+          c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+          goto cleanup;
+        }
+    }
+
   if (ipmi_monitoring_get_sel (c,
                                sel_flags,
                                record_ids,
@@ -609,16 +1001,14 @@ _ipmi_monitoring_sel (ipmi_monitoring_ctx_t c,
       c->current_sel_record = list_next (c->sel_records_itr);
     }
 
-  ipmi_monitoring_sdr_cache_unload (c);
-  ipmi_monitoring_ipmi_communication_cleanup (c);
+  _ipmi_monitoring_disconnect (c, 0);
   ipmi_monitoring_sel_cleanup (c);
   c->errnum = IPMI_MONITORING_ERR_SUCCESS;
   return (rv);
 
  cleanup:
-  ipmi_monitoring_sdr_cache_unload (c);
+  _ipmi_monitoring_disconnect (c, 1);
   ipmi_monitoring_sel_iterator_destroy (c);
-  ipmi_monitoring_ipmi_communication_cleanup (c);
   ipmi_monitoring_sel_cleanup (c);
   return (-1);
 }
@@ -633,6 +1023,7 @@ ipmi_monitoring_sel_by_record_id (ipmi_monitoring_ctx_t c,
                                   Ipmi_Monitoring_Callback callback,
                                   void *callback_data)
 {
+  int session_reused;
   int rv;
 
   if (!c || c->magic != IPMI_MONITORING_MAGIC)
@@ -668,16 +1059,20 @@ ipmi_monitoring_sel_by_record_id (ipmi_monitoring_ctx_t c,
   c->callback = callback;
   c->callback_data = callback_data;
 
-  rv = _ipmi_monitoring_sel (c,
-                             hostname,
-                             config,
-                             sel_flags,
-                             record_ids,
-                             record_ids_len,
-                             NULL,
-                             0,
-                             NULL,
-                             NULL);
+  session_reused = _session_established (c, hostname);
+  do
+    {
+      rv = _ipmi_monitoring_sel (c,
+                                 hostname,
+                                 config,
+                                 sel_flags,
+                                 record_ids,
+                                 record_ids_len,
+                                 NULL,
+                                 0,
+                                 NULL,
+                                 NULL);
+    } while (rv < 0 && _session_retry (c, &session_reused));
 
   c->callback_sel_record = NULL;
 
@@ -694,6 +1089,7 @@ ipmi_monitoring_sel_by_sensor_type (ipmi_monitoring_ctx_t c,
                                     Ipmi_Monitoring_Callback callback,
                                     void *callback_data)
 {
+  int session_reused;
   int rv;
 
   if (!c || c->magic != IPMI_MONITORING_MAGIC)
@@ -715,16 +1111,20 @@ ipmi_monitoring_sel_by_sensor_type (ipmi_monitoring_ctx_t c,
   c->callback = callback;
   c->callback_data = callback_data;
 
-  rv = _ipmi_monitoring_sel (c,
-                             hostname,
-                             config,
-                             sel_flags,
-                             NULL,
-                             0,
-                             sensor_types,
-                             sensor_types_len,
-                             NULL,
-                             NULL);
+  session_reused = _session_established (c, hostname);
+  do
+    {
+      rv = _ipmi_monitoring_sel (c,
+                                 hostname,
+                                 config,
+                                 sel_flags,
+                                 NULL,
+                                 0,
+                                 sensor_types,
+                                 sensor_types_len,
+                                 NULL,
+                                 NULL);
+    } while (rv < 0 && _session_retry (c, &session_reused));
 
   c->callback_sel_record = NULL;
 
@@ -793,6 +1193,7 @@ ipmi_monitoring_sel_by_date_range (ipmi_monitoring_ctx_t c,
 {
   unsigned int date_begin_val;
   unsigned int date_end_val;
+  int session_reused;
   int rv;
 
   if (!c || c->magic != IPMI_MONITORING_MAGIC)
@@ -839,16 +1240,20 @@ ipmi_monitoring_sel_by_date_range (ipmi_monitoring_ctx_t c,
   c->callback = callback;
   c->callback_data = callback_data;
 
-  rv = _ipmi_monitoring_sel (c,
-                             hostname,
-                             config,
-                             sel_flags,
-                             NULL,
-                             0,
-                             NULL,
-                             0,
-                             &date_begin_val,
-                             &date_end_val);
+  session_reused = _session_established (c, hostname);
+  do
+    {
+      rv = _ipmi_monitoring_sel (c,
+                                 hostname,
+                                 config,
+                                 sel_flags,
+                                 NULL,
+                                 0,
+                                 NULL,
+                                 0,
+                                 &date_begin_val,
+                                 &date_end_val);
+    } while (rv < 0 && _session_retry (c, &session_reused));
 
   c->callback_sel_record = NULL;
 
@@ -1246,9 +1651,11 @@ _ipmi_monitoring_sensor_readings_flags_common (ipmi_monitoring_ctx_t c,
   assert (_ipmi_monitoring_initialized);
   assert (!(sensor_reading_flags & ~IPMI_MONITORING_SENSOR_READING_FLAGS_MASK));
 
+  c->sensor_hostname = hostname;
+
   if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_REREAD_SDR_CACHE)
     {
-      if (ipmi_monitoring_sdr_cache_flush (c, hostname) < 0)
+      if (_ipmi_monitoring_sdr_flush (c, hostname) < 0)
         goto cleanup;
     }
 
@@ -1397,6 +1804,30 @@ _ipmi_monitoring_sensor_readings_sdr_callback (ipmi_sdr_ctx_t sdr_ctx,
   return (0);
 }
 
+/* Failure is not fatal, sensors not prefetched are read one at a time */
+static void
+_ipmi_monitoring_sensor_readings_prefetch (ipmi_monitoring_ctx_t c,
+                                           const char *hostname,
+                                           struct ipmi_monitoring_ipmi_config *config,
+                                           unsigned int *record_ids,
+                                           unsigned int record_ids_len)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (c->sensor_read_ctx);
+  assert (c->sdr_ctx);
+
+  /* pipelining only helps on IPMI 2.0 sessions */
+  if (!_ipmi_monitoring_pipelined (c, hostname, config))
+    return;
+
+  if (ipmi_sensor_read_prefetch (c->sensor_read_ctx,
+                                 c->sdr_ctx,
+                                 record_ids,
+                                 record_ids_len) < 0)
+    IPMI_MONITORING_DEBUG (("ipmi_sensor_read_prefetch: %s", ipmi_sensor_read_ctx_errormsg (c->sensor_read_ctx)));
+}
+
 static int
 _ipmi_monitoring_sensor_readings_by_record_id (ipmi_monitoring_ctx_t c,
                                                const char *hostname,
@@ -1415,7 +1846,7 @@ _ipmi_monitoring_sensor_readings_by_record_id (ipmi_monitoring_ctx_t c,
 
   ipmi_monitoring_sensor_iterator_destroy (c);
 
-  if (ipmi_monitoring_ipmi_communication_init (c, hostname, config) < 0)
+  if (_ipmi_monitoring_connect (c, hostname, config) < 0)
     goto cleanup;
 
   if (ipmi_monitoring_sensor_reading_init (c) < 0)
@@ -1430,9 +1861,18 @@ _ipmi_monitoring_sensor_readings_by_record_id (ipmi_monitoring_ctx_t c,
   if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT)
     sdr_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT;
 
-  if (ipmi_monitoring_sdr_cache_load (c, hostname, sdr_create_flags) < 0)
+  if (_ipmi_monitoring_pipelined (c, hostname, config))
+    sdr_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED;
+
+  if (_ipmi_monitoring_sdr_load (c, hostname, sdr_create_flags) < 0)
     goto cleanup;
 
+  _ipmi_monitoring_sensor_readings_prefetch (c,
+                                             hostname,
+                                             config,
+                                             record_ids,
+                                             record_ids_len);
+
   if (!record_ids)
     {
       struct ipmi_monitoring_sdr_callback sdr_callback_arg;
@@ -1503,16 +1943,17 @@ _ipmi_monitoring_sensor_readings_by_record_id (ipmi_monitoring_ctx_t c,
       c->current_sensor_reading = list_next (c->sensor_readings_itr);
     }
 
-  ipmi_monitoring_sdr_cache_unload (c);
-  ipmi_monitoring_ipmi_communication_cleanup (c);
+  _ipmi_monitoring_disconnect (c, 0);
   ipmi_monitoring_sensor_reading_cleanup (c);
   c->errnum = IPMI_MONITORING_ERR_SUCCESS;
   return (rv);
 
  cleanup:
-  ipmi_monitoring_sdr_cache_unload (c);
+  /* readings remembered during this call were never returned */
+  if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
+    ipmi_monitoring_sensor_reading_deltas_reset (c, hostname ? hostname : "");
+  _ipmi_monitoring_disconnect (c, 1);
   ipmi_monitoring_sensor_iterator_destroy (c);
-  ipmi_monitoring_ipmi_communication_cleanup (c);
   ipmi_monitoring_sensor_reading_cleanup (c);
   return (-1);
 }
@@ -1527,6 +1968,7 @@ ipmi_monitoring_sensor_readings_by_record_id (ipmi_monitoring_ctx_t c,
                                               Ipmi_Monitoring_Callback callback,
                                               void *callback_data)
 {
+  int session_reused;
   int rv;
 
   if (!c || c->magic != IPMI_MONITORING_MAGIC)
@@ -1563,55 +2005,76 @@ ipmi_monitoring_sensor_readings_by_record_id (ipmi_monitoring_ctx_t c,
   c->callback_data = callback_data;
   c->callback_sensor_reading = NULL;
 
-  rv = _ipmi_monitoring_sensor_readings_by_record_id (c,
-                                                      hostname,
-                                                      config,
-                                                      sensor_reading_flags,
-                                                      record_ids,
-                                                      record_ids_len);
+  session_reused = _session_established (c, hostname);
+  do
+    {
+      rv = _ipmi_monitoring_sensor_readings_by_record_id (c,
+                                                          hostname,
+                                                          config,
+                                                          sensor_reading_flags,
+                                                          record_ids,
+                                                          record_ids_len);
+    } while (rv < 0 && _session_retry (c, &session_reused));
 
   c->callback_sensor_reading = NULL;
 
   return (rv);
 }
 
+/* Connects and loads the SDR, everything before the sensors are read */
 static int
-_ipmi_monitoring_sensor_readings_by_sensor_type (ipmi_monitoring_ctx_t c,
-                                                 const char *hostname,
-                                                 struct ipmi_monitoring_ipmi_config *config,
-                                                 unsigned int sensor_reading_flags,
-                                                 unsigned int *sensor_types,
-                                                 unsigned int sensor_types_len)
+_ipmi_monitoring_sensor_readings_by_sensor_type_begin (ipmi_monitoring_ctx_t c,
+                                                       const char *hostname,
+                                                       struct ipmi_monitoring_ipmi_config *config,
+                                                       unsigned int sensor_reading_flags)
 {
   unsigned int sdr_create_flags = IPMI_SDR_CACHE_CREATE_FLAGS_DEFAULT;
-  struct ipmi_monitoring_sdr_callback sdr_callback_arg;
-  int rv = -1;
 
   assert (c);
   assert (c->magic == IPMI_MONITORING_MAGIC);
   assert (_ipmi_monitoring_initialized);
   assert (!(sensor_reading_flags & ~IPMI_MONITORING_SENSOR_READING_FLAGS_MASK));
-  assert (!(sensor_types && !sensor_types_len));
 
   ipmi_monitoring_sensor_iterator_destroy (c);
 
-  if (ipmi_monitoring_ipmi_communication_init (c, hostname, config) < 0)
-    goto cleanup;
+  if (_ipmi_monitoring_connect (c, hostname, config) < 0)
+    return (-1);
 
   if (ipmi_monitoring_sensor_reading_init (c) < 0)
-    goto cleanup;
+    return (-1);
 
   if (_ipmi_monitoring_sensor_readings_flags_common (c,
                                                      hostname,
                                                      config,
                                                      sensor_reading_flags) < 0)
-    goto cleanup;
+    return (-1);
 
   if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT)
     sdr_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT;
 
-  if (ipmi_monitoring_sdr_cache_load (c, hostname, sdr_create_flags) < 0)
-    goto cleanup;
+  if (_ipmi_monitoring_pipelined (c, hostname, config))
+    sdr_create_flags |= IPMI_SDR_CACHE_CREATE_FLAGS_PIPELINED;
+
+  if (_ipmi_monitoring_sdr_load (c, hostname, sdr_create_flags) < 0)
+    return (-1);
+
+  return (0);
+}
+
+/* Reads the sensors, using any prefetched responses, and disconnects */
+static int
+_ipmi_monitoring_sensor_readings_by_sensor_type_finish (ipmi_monitoring_ctx_t c,
+                                                        unsigned int sensor_reading_flags,
+                                                        unsigned int *sensor_types,
+                                                        unsigned int sensor_types_len)
+{
+  struct ipmi_monitoring_sdr_callback sdr_callback_arg;
+  int rv;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (c->sdr_ctx);
+  assert (!(sensor_types && !sensor_types_len));
 
   sdr_callback_arg.c = c;
   sdr_callback_arg.sensor_reading_flags = sensor_reading_flags;
@@ -1624,7 +2087,7 @@ _ipmi_monitoring_sensor_readings_by_sensor_type (ipmi_monitoring_ctx_t c,
     {
       IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_iterate: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
       c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
-      goto cleanup;
+      return (-1);
     }
 
   if ((rv = list_count (c->sensor_readings)) > 0)
@@ -1633,22 +2096,76 @@ _ipmi_monitoring_sensor_readings_by_sensor_type (ipmi_monitoring_ctx_t c,
         {
           IPMI_MONITORING_DEBUG (("list_iterator_create: %s", strerror (errno)));
           c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
-          goto cleanup;
+          return (-1);
         }
       c->current_sensor_reading = list_next (c->sensor_readings_itr);
     }
 
-  ipmi_monitoring_sdr_cache_unload (c);
-  ipmi_monitoring_ipmi_communication_cleanup (c);
+  _ipmi_monitoring_disconnect (c, 0);
   ipmi_monitoring_sensor_reading_cleanup (c);
   c->errnum = IPMI_MONITORING_ERR_SUCCESS;
   return (rv);
+}
 
- cleanup:
-  ipmi_monitoring_sdr_cache_unload (c);
+/* Cleans up after a failed begin or finish, keeping c->errnum */
+static void
+_ipmi_monitoring_sensor_readings_by_sensor_type_abort (ipmi_monitoring_ctx_t c,
+                                                       const char *hostname,
+                                                       unsigned int sensor_reading_flags)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  /* readings remembered during this call were never returned */
+  if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
+    ipmi_monitoring_sensor_reading_deltas_reset (c, hostname ? hostname : "");
+  _ipmi_monitoring_disconnect (c, 1);
   ipmi_monitoring_sensor_iterator_destroy (c);
-  ipmi_monitoring_ipmi_communication_cleanup (c);
   ipmi_monitoring_sensor_reading_cleanup (c);
+}
+
+static int
+_ipmi_monitoring_sensor_readings_by_sensor_type (ipmi_monitoring_ctx_t c,
+                                                 const char *hostname,
+                                                 struct ipmi_monitoring_ipmi_config *config,
+                                                 unsigned int sensor_reading_flags,
+                                                 unsigned int *sensor_types,
+                                                 unsigned int sensor_types_len)
+{
+  int rv;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (_ipmi_monitoring_initialized);
+  assert (!(sensor_reading_flags & ~IPMI_MONITORING_SENSOR_READING_FLAGS_MASK));
+  assert (!(sensor_types && !sensor_types_len));
+
+  if (_ipmi_monitoring_sensor_readings_by_sensor_type_begin (c,
+                                                             hostname,
+                                                             config,
+                                                             sensor_reading_flags) < 0)
+    goto cleanup;
+
+  /* with a sensor type filter most sensors may not be read at all */
+  if (!sensor_types)
+    _ipmi_monitoring_sensor_readings_prefetch (c,
+                                               hostname,
+                                               config,
+                                               NULL,
+                                               0);
+
+  if ((rv = _ipmi_monitoring_sensor_readings_by_sensor_type_finish (c,
+                                                                    sensor_reading_flags,
+                                                                    sensor_types,
+                                                                    sensor_types_len)) < 0)
+    goto cleanup;
+
+  return (rv);
+
+ cleanup:
+  _ipmi_monitoring_sensor_readings_by_sensor_type_abort (c,
+                                                         hostname,
+                                                         sensor_reading_flags);
   return (-1);
 }
 
@@ -1662,6 +2179,7 @@ ipmi_monitoring_sensor_readings_by_sensor_type (ipmi_monitoring_ctx_t c,
                                                 Ipmi_Monitoring_Callback callback,
                                                 void *callback_data)
 {
+  int session_reused;
   int rv;
 
   if (!c || c->magic != IPMI_MONITORING_MAGIC)
@@ -1684,18 +2202,743 @@ ipmi_monitoring_sensor_readings_by_sensor_type (ipmi_monitoring_ctx_t c,
   c->callback_data = callback_data;
   c->callback_sensor_reading = NULL;
 
-  rv = _ipmi_monitoring_sensor_readings_by_sensor_type (c,
-                                                        hostname,
-                                                        config,
-                                                        sensor_reading_flags,
-                                                        sensor_types,
-                                                        sensor_types_len);
+  session_reused = _session_established (c, hostname);
+  do
+    {
+      rv = _ipmi_monitoring_sensor_readings_by_sensor_type (c,
+                                                            hostname,
+                                                            config,
+                                                            sensor_reading_flags,
+                                                            sensor_types,
+                                                            sensor_types_len);
+    } while (rv < 0 && _session_retry (c, &session_reused));
 
   c->callback_sensor_reading = NULL;
 
   return (rv);
 }
 
+/* ipmi_monitoring_sensor_readings_by_hosts() reads up to 'fanout'
+ * hosts at a time, each in a slot with its own context.  The parts
+ * that libfreeipmi can only do blocking, establishing the session,
+ * loading the SDR and reading the sensors not prefetched, run on a
+ * pool of threads.  Get Sensor Reading requests for all hosts are
+ * prefetched from the calling thread through one ipmi_multi_ctx,
+ * which also calls the user's callback.
+ *
+ * This is not a single event loop.  libfreeipmi has no nonblocking
+ * RMCP+ session activation or SDR download, so a host still holds a
+ * thread for those, and 'fanout' bounds both the threads and the
+ * hosts in progress.
+ */
+#define IPMI_MONITORING_HOSTS_SLOT_IDLE    0
+/* queued for a thread to establish the session and load the SDR */
+#define IPMI_MONITORING_HOSTS_SLOT_BEGIN   1
+/* returned to the calling thread to prefetch sensor readings */
+#define IPMI_MONITORING_HOSTS_SLOT_READY   2
+#define IPMI_MONITORING_HOSTS_SLOT_READING 3
+/* queued for a thread to read the sensors and disconnect */
+#define IPMI_MONITORING_HOSTS_SLOT_FINISH  4
+/* returned to the calling thread for the callback */
+#define IPMI_MONITORING_HOSTS_SLOT_DONE    5
+
+struct ipmi_monitoring_hosts_data;
+
+struct ipmi_monitoring_hosts_slot
+{
+  struct ipmi_monitoring_hosts_data *hd;
+  ipmi_monitoring_ctx_t wc;
+  unsigned int host;
+  int state;
+  int rv;
+  /* sensor records of the sensor types asked for */
+  unsigned int *record_ids;
+  unsigned int record_ids_len;
+  unsigned int record_ids_size;
+};
+
+/* a fifo of slot indexes, each slot is in at most one queue at a time */
+struct ipmi_monitoring_hosts_queue
+{
+  unsigned int *slots;
+  unsigned int head;
+  unsigned int count;
+  unsigned int size;
+};
+
+struct ipmi_monitoring_hosts_data
+{
+  ipmi_monitoring_ctx_t c;
+  const char **hostnames;
+  unsigned int hostnames_len;
+  struct ipmi_monitoring_ipmi_config **configs;
+  unsigned int sensor_reading_flags;
+  unsigned int *sensor_types;
+  unsigned int sensor_types_len;
+
+  struct ipmi_monitoring_hosts_slot *slots;
+  unsigned int slots_len;
+
+  /* calling thread only */
+  ipmi_multi_ctx_t mctx;
+  struct ipmi_monitoring_hosts_queue idle;
+  struct ipmi_monitoring_hosts_queue prefetched;
+
+  /* protected by mutex */
+  pthread_mutex_t mutex;
+  pthread_cond_t work_cond;
+  pthread_cond_t done_cond;
+  struct ipmi_monitoring_hosts_queue work;
+  struct ipmi_monitoring_hosts_queue done;
+  int threads_exit;
+};
+
+static int
+_hosts_queue_init (struct ipmi_monitoring_hosts_queue *q, unsigned int size)
+{
+  assert (q);
+  assert (size);
+
+  if (!(q->slots = (unsigned int *)malloc (size * sizeof (unsigned int))))
+    return (-1);
+  q->head = 0;
+  q->count = 0;
+  q->size = size;
+  return (0);
+}
+
+static void
+_hosts_queue_push (struct ipmi_monitoring_hosts_queue *q, unsigned int slot)
+{
+  assert (q);
+  assert (q->count < q->size);
+
+  q->slots[(q->head + q->count++) % q->size] = slot;
+}
+
+static unsigned int
+_hosts_queue_pop (struct ipmi_monitoring_hosts_queue *q)
+{
+  unsigned int slot;
+
+  assert (q);
+  assert (q->count);
+
+  slot = q->slots[q->head];
+  q->head = (q->head + 1) % q->size;
+  q->count--;
+  return (slot);
+}
+
+/* A context with the SDR cache and interpretation settings of 'c' */
+static ipmi_monitoring_ctx_t
+_hosts_ctx_create (ipmi_monitoring_ctx_t c)
+{
+  ipmi_monitoring_ctx_t wc;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (!(wc = ipmi_monitoring_ctx_create ()))
+    {
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      return (NULL);
+    }
+
+  memcpy (wc->sdr_cache_directory, c->sdr_cache_directory, MAXPATHLEN + 1);
+  wc->sdr_cache_directory_set = c->sdr_cache_directory_set;
+  memcpy (wc->sdr_cache_filename_format, c->sdr_cache_filename_format, MAXPATHLEN + 1);
+  wc->sdr_cache_filename_format_set = c->sdr_cache_filename_format_set;
+  memcpy (wc->sdr_cache_shared_directory, c->sdr_cache_shared_directory, MAXPATHLEN + 1);
+  wc->sdr_cache_shared_directory_set = c->sdr_cache_shared_directory_set;
+
+  if (c->sel_config_file_set
+      && ipmi_monitoring_ctx_sel_config_file (wc, strlen (c->sel_config_file) ? c->sel_config_file : NULL) < 0)
+    goto cleanup;
+
+  if (c->sensor_config_file_set
+      && ipmi_monitoring_ctx_sensor_config_file (wc, strlen (c->sensor_config_file) ? c->sensor_config_file : NULL) < 0)
+    goto cleanup;
+
+  return (wc);
+
+ cleanup:
+  c->errnum = wc->errnum;
+  ipmi_monitoring_ctx_destroy (wc);
+  return (NULL);
+}
+
+/* Collects the sensor records of the sensor types asked for, so only
+ * their sensors are prefetched.  Records that cannot be parsed are
+ * skipped, they are handled when the sensors are read.
+ */
+static int
+_hosts_record_ids (struct ipmi_monitoring_hosts_data *hd,
+                   struct ipmi_monitoring_hosts_slot *slot)
+{
+  ipmi_monitoring_ctx_t wc;
+  uint16_t record_count;
+  unsigned int i, j;
+
+  assert (hd);
+  assert (hd->sensor_types);
+  assert (slot);
+  assert (slot->wc);
+  assert (slot->wc->sdr_ctx);
+
+  wc = slot->wc;
+  slot->record_ids_len = 0;
+
+  if (ipmi_sdr_cache_record_count (wc->sdr_ctx, &record_count) < 0)
+    {
+      IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_record_count: %s", ipmi_sdr_ctx_errormsg (wc->sdr_ctx)));
+      wc->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      return (-1);
+    }
+
+  if (!record_count)
+    return (0);
+
+  if (slot->record_ids_size < record_count)
+    {
+      unsigned int *record_ids;
+
+      if (!(record_ids = (unsigned int *)realloc (slot->record_ids, record_count * sizeof (unsigned int))))
+        {
+          wc->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+          return (-1);
+        }
+      slot->record_ids = record_ids;
+      slot->record_ids_size = record_count;
+    }
+
+  if (ipmi_sdr_cache_first (wc->sdr_ctx) < 0)
+    {
+      IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_first: %s", ipmi_sdr_ctx_errormsg (wc->sdr_ctx)));
+      wc->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      return (-1);
+    }
+
+  for (i = 0; i < record_count; i++)
+    {
+      uint16_t record_id;
+      uint8_t record_type;
+      uint8_t sdr_sensor_type;
+      int sensor_type;
+
+      if (i && ipmi_sdr_cache_next (wc->sdr_ctx) <= 0)
+        break;
+
+      if (ipmi_sdr_parse_record_id_and_type (wc->sdr_ctx,
+                                             NULL,
+                                             0,
+                                             &record_id,
+                                             &record_type) < 0)
+        continue;
+
+      if (record_type != IPMI_SDR_FORMAT_FULL_SENSOR_RECORD
+          && record_type != IPMI_SDR_FORMAT_COMPACT_SENSOR_RECORD)
+        continue;
+
+      if (ipmi_sdr_parse_sensor_type (wc->sdr_ctx,
+                                      NULL,
+                                      0,
+                                      &sdr_sensor_type) < 0)
+        continue;
+
+      if ((sensor_type = ipmi_monitoring_get_sensor_type (wc, sdr_sensor_type)) < 0)
+        continue;
+
+      for (j = 0; j < hd->sensor_types_len; j++)
+        {
+          if (hd->sensor_types[j] == sensor_type)
+            {
+              slot->record_ids[slot->record_ids_len++] = record_id;
+              break;
+            }
+        }
+    }
+
+  return (0);
+}
+
+/* The blocking part of a slot's current step, run on a thread */
+static void
+_hosts_slot_work (struct ipmi_monitoring_hosts_data *hd,
+                  struct ipmi_monitoring_hosts_slot *slot)
+{
+  const char *hostname;
+
+  assert (hd);
+  assert (slot);
+  assert (slot->state == IPMI_MONITORING_HOSTS_SLOT_BEGIN
+          || slot->state == IPMI_MONITORING_HOSTS_SLOT_FINISH);
+
+  hostname = hd->hostnames[slot->host];
+
+  if (slot->state == IPMI_MONITORING_HOSTS_SLOT_BEGIN)
+    {
+      if (_ipmi_monitoring_sensor_readings_by_sensor_type_begin (slot->wc,
+                                                                 hostname,
+                                                                 hd->configs ? hd->configs[slot->host] : NULL,
+                                                                 hd->sensor_reading_flags) < 0
+          || (hd->sensor_types && _hosts_record_ids (hd, slot) < 0))
+        goto cleanup;
+
+      slot->state = IPMI_MONITORING_HOSTS_SLOT_READY;
+      return;
+    }
+
+  if ((slot->rv = _ipmi_monitoring_sensor_readings_by_sensor_type_finish (slot->wc,
+                                                                          hd->sensor_reading_flags,
+                                                                          hd->sensor_types,
+                                                                          hd->sensor_types_len)) < 0)
+    goto cleanup;
+
+  slot->state = IPMI_MONITORING_HOSTS_SLOT_DONE;
+  return;
+
+ cleanup:
+  _ipmi_monitoring_sensor_readings_by_sensor_type_abort (slot->wc,
+                                                         hostname,
+                                                         hd->sensor_reading_flags);
+  slot->rv = -1;
+  slot->state = IPMI_MONITORING_HOSTS_SLOT_DONE;
+}
+
+static void *
+_hosts_thread (void *arg)
+{
+  struct ipmi_monitoring_hosts_data *hd;
+
+  assert (arg);
+
+  hd = (struct ipmi_monitoring_hosts_data *)arg;
+
+  while (1)
+    {
+      unsigned int i;
+
+      pthread_mutex_lock (&hd->mutex);
+      while (!hd->work.count && !hd->threads_exit)
+        pthread_cond_wait (&hd->work_cond, &hd->mutex);
+      if (!hd->work.count)
+        {
+          pthread_mutex_unlock (&hd->mutex);
+          break;
+        }
+      i = _hosts_queue_pop (&hd->work);
+      pthread_mutex_unlock (&hd->mutex);
+
+      _hosts_slot_work (hd, &hd->slots[i]);
+
+      pthread_mutex_lock (&hd->mutex);
+      _hosts_queue_push (&hd->done, i);
+      pthread_cond_signal (&hd->done_cond);
+      pthread_mutex_unlock (&hd->mutex);
+    }
+
+  return (NULL);
+}
+
+static void
+_hosts_slot_queue (struct ipmi_monitoring_hosts_data *hd,
+                   unsigned int i,
+                   int state)
+{
+  assert (hd);
+  assert (i < hd->slots_len);
+  assert (state == IPMI_MONITORING_HOSTS_SLOT_BEGIN
+          || state == IPMI_MONITORING_HOSTS_SLOT_FINISH);
+
+  hd->slots[i].state = state;
+
+  pthread_mutex_lock (&hd->mutex);
+  _hosts_queue_push (&hd->work, i);
+  pthread_cond_signal (&hd->work_cond);
+  pthread_mutex_unlock (&hd->mutex);
+}
+
+static void
+_hosts_prefetch_callback (ipmi_sensor_read_ctx_t ctx, void *callback_data)
+{
+  struct ipmi_monitoring_hosts_data *hd;
+  struct ipmi_monitoring_hosts_slot *slot;
+
+  assert (ctx);
+  assert (callback_data);
+
+  slot = (struct ipmi_monitoring_hosts_slot *)callback_data;
+  hd = slot->hd;
+
+  /* contexts cannot be removed from within ipmi_multi_ctx_run() */
+  _hosts_queue_push (&hd->prefetched, slot - hd->slots);
+}
+
+/* returns 1 if the slot's sensors are being prefetched, 0 if they are
+ * all to be read by a thread, e.g. for IPMI 1.5 hosts
+ */
+static int
+_hosts_slot_prefetch (struct ipmi_monitoring_hosts_data *hd,
+                      struct ipmi_monitoring_hosts_slot *slot)
+{
+  ipmi_monitoring_ctx_t wc;
+  int ret;
+
+  assert (hd);
+  assert (slot);
+  assert (slot->state == IPMI_MONITORING_HOSTS_SLOT_READY);
+
+  wc = slot->wc;
+
+  if (hd->sensor_types && !slot->record_ids_len)
+    return (0);
+
+  if (ipmi_multi_ctx_add (hd->mctx, wc->ipmi_ctx) < 0)
+    {
+      IPMI_MONITORING_DEBUG (("ipmi_multi_ctx_add: %s", ipmi_multi_ctx_errormsg (hd->mctx)));
+      return (0);
+    }
+
+  if ((ret = ipmi_sensor_read_prefetch_submit (wc->sensor_read_ctx,
+                                               wc->sdr_ctx,
+                                               hd->sensor_types ? slot->record_ids : NULL,
+                                               slot->record_ids_len,
+                                               hd->mctx,
+                                               _hosts_prefetch_callback,
+                                               slot)) <= 0)
+    {
+      if (ret < 0)
+        IPMI_MONITORING_DEBUG (("ipmi_sensor_read_prefetch_submit: %s", ipmi_sensor_read_ctx_errormsg (wc->sensor_read_ctx)));
+      ipmi_multi_ctx_remove (hd->mctx, wc->ipmi_ctx);
+      return (0);
+    }
+
+  slot->state = IPMI_MONITORING_HOSTS_SLOT_READING;
+  return (1);
+}
+
+/* hands prefetched slots back to the threads to read their sensors */
+static void
+_hosts_slots_prefetched (struct ipmi_monitoring_hosts_data *hd)
+{
+  assert (hd);
+
+  while (hd->prefetched.count)
+    {
+      unsigned int i = _hosts_queue_pop (&hd->prefetched);
+
+      assert (hd->slots[i].state == IPMI_MONITORING_HOSTS_SLOT_READING);
+
+      ipmi_multi_ctx_remove (hd->mctx, hd->slots[i].wc->ipmi_ctx);
+      _hosts_slot_queue (hd, i, IPMI_MONITORING_HOSTS_SLOT_FINISH);
+    }
+}
+
+static void
+_hosts_data_cleanup (struct ipmi_monitoring_hosts_data *hd)
+{
+  unsigned int i;
+
+  assert (hd);
+
+  if (hd->slots)
+    {
+      for (i = 0; i < hd->slots_len; i++)
+        {
+          ipmi_monitoring_ctx_t wc = hd->slots[i].wc;
+
+          if (!wc)
+            continue;
+
+          /* owned by hd->c */
+          wc->sensor_deltas = NULL;
+          ipmi_monitoring_ctx_destroy (wc);
+          free (hd->slots[i].record_ids);
+        }
+      free (hd->slots);
+    }
+
+  ipmi_multi_ctx_destroy (hd->mctx);
+  free (hd->idle.slots);
+  free (hd->prefetched.slots);
+  free (hd->work.slots);
+  free (hd->done.slots);
+}
+
+int
+ipmi_monitoring_sensor_readings_by_hosts (ipmi_monitoring_ctx_t c,
+                                          const char **hostnames,
+                                          unsigned int hostnames_len,
+                                          struct ipmi_monitoring_ipmi_config **configs,
+                                          unsigned int sensor_reading_flags,
+                                          unsigned int *sensor_types,
+                                          unsigned int sensor_types_len,
+                                          unsigned int fanout,
+                                          Ipmi_Monitoring_Host_Callback callback,
+                                          void *callback_data)
+{
+  struct ipmi_monitoring_hosts_data hd;
+  unsigned int *done = NULL;
+  pthread_t *tids = NULL;
+  unsigned int tids_len = 0;
+  unsigned int next_host = 0;
+  unsigned int hosts_read = 0;
+  unsigned int active = 0;
+  int mutex_init = 0;
+  int conds_init = 0;
+  int stop = 0;
+  int errnum = IPMI_MONITORING_ERR_SUCCESS;
+  unsigned int i;
+  int rv = -1;
+
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  if (!_ipmi_monitoring_initialized)
+    {
+      c->errnum = IPMI_MONITORING_ERR_LIBRARY_UNINITIALIZED;
+      return (-1);
+    }
+
+  if (!hostnames
+      || !hostnames_len
+      || (sensor_reading_flags & ~IPMI_MONITORING_SENSOR_READING_FLAGS_MASK)
+      || (sensor_types && !sensor_types_len)
+      || fanout > IPMI_MONITORING_FANOUT_MAX)
+    {
+      c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  for (i = 0; i < hostnames_len; i++)
+    {
+      if (!hostnames[i])
+        {
+          c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+          return (-1);
+        }
+    }
+
+  if (!fanout)
+    fanout = IPMI_MONITORING_FANOUT_DEFAULT;
+  if (fanout > hostnames_len)
+    fanout = hostnames_len;
+
+  memset (&hd, '\0', sizeof (struct ipmi_monitoring_hosts_data));
+  hd.c = c;
+  hd.hostnames = hostnames;
+  hd.hostnames_len = hostnames_len;
+  hd.configs = configs;
+  hd.sensor_reading_flags = sensor_reading_flags;
+  hd.sensor_types = sensor_types;
+  hd.sensor_types_len = sensor_types_len;
+
+  if ((sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
+      && ipmi_monitoring_sensor_reading_deltas_init (c, hostnames, hostnames_len) < 0)
+    return (-1);
+
+  if (!(hd.mctx = ipmi_multi_ctx_create ()))
+    {
+      IPMI_MONITORING_DEBUG (("ipmi_multi_ctx_create: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      goto cleanup;
+    }
+
+  if (!(hd.slots = (struct ipmi_monitoring_hosts_slot *)malloc (fanout * sizeof (struct ipmi_monitoring_hosts_slot))))
+    {
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      goto cleanup;
+    }
+  memset (hd.slots, '\0', fanout * sizeof (struct ipmi_monitoring_hosts_slot));
+  hd.slots_len = fanout;
+
+  if (_hosts_queue_init (&hd.idle, fanout) < 0
+      || _hosts_queue_init (&hd.prefetched, fanout) < 0
+      || _hosts_queue_init (&hd.work, fanout) < 0
+      || _hosts_queue_init (&hd.done, fanout) < 0
+      || !(done = (unsigned int *)malloc (fanout * sizeof (unsigned int)))
+      || !(tids = (pthread_t *)malloc (fanout * sizeof (pthread_t))))
+    {
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      goto cleanup;
+    }
+
+  for (i = 0; i < fanout; i++)
+    {
+      ipmi_monitoring_ctx_t wc;
+
+      /* created once per slot, reused for each host it reads */
+      if (!(wc = _hosts_ctx_create (c)))
+        goto cleanup;
+
+      if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
+        {
+          wc->sensor_deltas = c->sensor_deltas;
+          wc->sensor_deltas_deadband = c->sensor_deltas_deadband;
+          wc->sensor_deltas_shared = 1;
+        }
+
+      hd.slots[i].hd = &hd;
+      hd.slots[i].wc = wc;
+      _hosts_queue_push (&hd.idle, i);
+    }
+
+  if (pthread_mutex_init (&hd.mutex, NULL))
+    {
+      c->errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+      goto cleanup;
+    }
+  mutex_init++;
+
+  if (pthread_cond_init (&hd.work_cond, NULL))
+    {
+      c->errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+      goto cleanup;
+    }
+
+  if (pthread_cond_init (&hd.done_cond, NULL))
+    {
+      pthread_cond_destroy (&hd.work_cond);
+      c->errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+      goto cleanup;
+    }
+  conds_init++;
+
+  for (i = 0; i < fanout; i++)
+    {
+      int ret;
+
+      if ((ret = pthread_create (&tids[i], NULL, _hosts_thread, &hd)))
+        {
+          IPMI_MONITORING_DEBUG (("pthread_create: %s", strerror (ret)));
+          /* threads already started serve all slots */
+          if (!tids_len)
+            {
+              c->errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+              goto cleanup;
+            }
+          break;
+        }
+      tids_len++;
+    }
+
+  while (1)
+    {
+      unsigned int done_len = 0;
+      int pending;
+
+      while (!stop && hd.idle.count && next_host < hostnames_len)
+        {
+          i = _hosts_queue_pop (&hd.idle);
+          hd.slots[i].host = next_host++;
+          _hosts_slot_queue (&hd, i, IPMI_MONITORING_HOSTS_SLOT_BEGIN);
+          active++;
+        }
+
+      if (!active)
+        break;
+
+      if ((pending = ipmi_multi_ctx_pending (hd.mctx)) < 0)
+        {
+          IPMI_MONITORING_DEBUG (("ipmi_multi_ctx_pending: %s", ipmi_multi_ctx_errormsg (hd.mctx)));
+          pending = 0;
+        }
+
+      pthread_mutex_lock (&hd.mutex);
+      while (!hd.done.count && !pending)
+        pthread_cond_wait (&hd.done_cond, &hd.mutex);
+      while (hd.done.count)
+        done[done_len++] = _hosts_queue_pop (&hd.done);
+      pthread_mutex_unlock (&hd.mutex);
+
+      /* no lock is held while prefetching or calling back */
+      for (i = 0; i < done_len; i++)
+        {
+          struct ipmi_monitoring_hosts_slot *slot = &hd.slots[done[i]];
+
+          if (slot->state == IPMI_MONITORING_HOSTS_SLOT_READY)
+            {
+              if (!_hosts_slot_prefetch (&hd, slot))
+                _hosts_slot_queue (&hd, done[i], IPMI_MONITORING_HOSTS_SLOT_FINISH);
+              continue;
+            }
+
+          assert (slot->state == IPMI_MONITORING_HOSTS_SLOT_DONE);
+
+          if (slot->rv >= 0)
+            hosts_read++;
+
+          if (!stop
+              && callback
+              && callback (slot->wc, hostnames[slot->host], callback_data) < 0)
+            {
+              errnum = IPMI_MONITORING_ERR_CALLBACK_ERROR;
+              stop++;
+            }
+
+          ipmi_monitoring_sensor_iterator_destroy (slot->wc);
+          slot->state = IPMI_MONITORING_HOSTS_SLOT_IDLE;
+          _hosts_queue_push (&hd.idle, done[i]);
+          active--;
+        }
+
+      if (!ipmi_multi_ctx_pending (hd.mctx))
+        continue;
+
+      if (ipmi_multi_ctx_run (hd.mctx, IPMI_MONITORING_HOSTS_POLL_TIMEOUT) < 0)
+        {
+          IPMI_MONITORING_DEBUG (("ipmi_multi_ctx_run: %s", ipmi_multi_ctx_errormsg (hd.mctx)));
+          errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+          stop++;
+
+          /* remaining sensors are read by the threads */
+          for (i = 0; i < hd.slots_len; i++)
+            {
+              if (hd.slots[i].state == IPMI_MONITORING_HOSTS_SLOT_READING)
+                {
+                  ipmi_multi_ctx_remove (hd.mctx, hd.slots[i].wc->ipmi_ctx);
+                  _hosts_slot_queue (&hd, i, IPMI_MONITORING_HOSTS_SLOT_FINISH);
+                }
+            }
+          hd.prefetched.count = 0;
+        }
+
+      _hosts_slots_prefetched (&hd);
+    }
+
+  if (errnum != IPMI_MONITORING_ERR_SUCCESS)
+    {
+      c->errnum = errnum;
+      goto cleanup;
+    }
+
+  rv = hosts_read;
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+ cleanup:
+  if (tids_len)
+    {
+      pthread_mutex_lock (&hd.mutex);
+      hd.threads_exit++;
+      pthread_cond_broadcast (&hd.work_cond);
+      pthread_mutex_unlock (&hd.mutex);
+
+      for (i = 0; i < tids_len; i++)
+        pthread_join (tids[i], NULL);
+    }
+  if (conds_init)
+    {
+      pthread_cond_destroy (&hd.work_cond);
+      pthread_cond_destroy (&hd.done_cond);
+    }
+  if (mutex_init)
+    pthread_mutex_destroy (&hd.mutex);
+  _hosts_data_cleanup (&hd);
+  free (done);
+  free (tids);
+  return (rv);
+}
+
 int
 ipmi_monitoring_sensor_iterator_first (ipmi_monitoring_ctx_t c)
 {
@@ -1746,6 +2989,9 @@ ipmi_monitoring_sensor_iterator_destroy (ipmi_monitoring_ctx_t c)
     }
 
   c->current_sensor_reading = NULL;
+
+  free (c->sensor_names);
+  c->sensor_names = NULL;
 }
 
 static int
@@ -1931,3 +3177,143 @@ ipmi_monitoring_sensor_read_event_reading_type_code (ipmi_monitoring_ctx_t c)
   c->errnum = IPMI_MONITORING_ERR_SUCCESS;
   return (sensor_reading->event_reading_type_code);
 }
+
+int
+ipmi_monitoring_sensor_readings_export (ipmi_monitoring_ctx_t c,
+                                        struct ipmi_monitoring_sensor_readings_export *readings_export)
+{
+  struct ipmi_monitoring_sensor_reading *sensor_reading;
+  ListIterator itr = NULL;
+  hash_t names_index = NULL;
+  unsigned int count = 0;
+  int rv = -1;
+
+  if (!c || c->magic != IPMI_MONITORING_MAGIC)
+    return (-1);
+
+  if (!readings_export)
+    {
+      c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (c->callback_sensor_reading)
+    {
+      c->errnum = IPMI_MONITORING_ERR_PARAMETERS;
+      return (-1);
+    }
+
+  if (!c->sensor_readings_itr)
+    {
+      c->errnum = IPMI_MONITORING_ERR_NO_SENSOR_READINGS;
+      return (-1);
+    }
+
+  free (c->sensor_names);
+  c->sensor_names = NULL;
+  readings_export->sensor_names = NULL;
+  readings_export->sensor_names_len = 0;
+
+  if (readings_export->sensor_name_indexes && readings_export->len)
+    {
+      unsigned int names_len = list_count (c->sensor_readings);
+
+      if (names_len > readings_export->len)
+        names_len = readings_export->len;
+
+      if (!(c->sensor_names = (const char **)malloc (names_len * sizeof (char *))))
+        {
+          IPMI_MONITORING_DEBUG (("malloc: %s", strerror (errno)));
+          c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+          goto cleanup;
+        }
+
+      if (!(names_index = hash_create (names_len,
+                                       (hash_key_f)hash_key_string,
+                                       (hash_cmp_f)strcmp,
+                                       NULL)))
+        {
+          IPMI_MONITORING_DEBUG (("hash_create: %s", strerror (errno)));
+          c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+          goto cleanup;
+        }
+    }
+
+  /* use a private iterator, the caller's iterator position is untouched */
+  if (!(itr = list_iterator_create (c->sensor_readings)))
+    {
+      IPMI_MONITORING_DEBUG (("list_iterator_create: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      goto cleanup;
+    }
+
+  while (count < readings_export->len
+         && (sensor_reading = list_next (itr)))
+    {
+      if (readings_export->record_ids)
+        readings_export->record_ids[count] = sensor_reading->record_id;
+      if (readings_export->sensor_numbers)
+        readings_export->sensor_numbers[count] = sensor_reading->sensor_number;
+      if (readings_export->sensor_types)
+        readings_export->sensor_types[count] = sensor_reading->sensor_type;
+      if (readings_export->sensor_states)
+        readings_export->sensor_states[count] = sensor_reading->sensor_state;
+      if (readings_export->sensor_units)
+        readings_export->sensor_units[count] = sensor_reading->sensor_units;
+      if (readings_export->sensor_reading_types)
+        readings_export->sensor_reading_types[count] = sensor_reading->sensor_reading_type;
+
+      if (readings_export->sensor_readings)
+        {
+          if (sensor_reading->sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_UNSIGNED_INTEGER8_BOOL)
+            readings_export->sensor_readings[count] = sensor_reading->sensor_reading.bool_val;
+          else if (sensor_reading->sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_UNSIGNED_INTEGER32)
+            readings_export->sensor_readings[count] = sensor_reading->sensor_reading.integer_val;
+          else if (sensor_reading->sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_DOUBLE)
+            readings_export->sensor_readings[count] = sensor_reading->sensor_reading.double_val;
+          else
+            readings_export->sensor_readings[count] = 0;
+        }
+
+      if (readings_export->sensor_name_indexes)
+        {
+          const char **name;
+
+          /* hash data is the table slot holding the name */
+          if (!(name = hash_find (names_index, sensor_reading->sensor_name)))
+            {
+              name = &c->sensor_names[readings_export->sensor_names_len++];
+              (*name) = sensor_reading->sensor_name;
+
+              if (!hash_insert (names_index, *name, name))
+                {
+                  IPMI_MONITORING_DEBUG (("hash_insert: %s", strerror (errno)));
+                  c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+                  goto cleanup;
+                }
+            }
+
+          readings_export->sensor_name_indexes[count] = name - c->sensor_names;
+        }
+
+      count++;
+    }
+
+  if (readings_export->sensor_name_indexes)
+    readings_export->sensor_names = c->sensor_names;
+
+  rv = count;
+  c->errnum = IPMI_MONITORING_ERR_SUCCESS;
+ cleanup:
+  if (itr)
+    list_iterator_destroy (itr);
+  if (names_index)
+    hash_destroy (names_index);
+  if (rv < 0)
+    {
+      free (c->sensor_names);
+      c->sensor_names = NULL;
+      readings_export->sensor_names_len = 0;
+    }
+  return (rv);
+}
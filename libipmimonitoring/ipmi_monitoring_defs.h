@@ -32,6 +32,8 @@
 #endif /* HAVE_CONFIG_H */
 
 #include <stdint.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/param.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -41,6 +43,7 @@
 #endif /* HAVE_NETDB_H */
 #include <freeipmi/freeipmi.h>
 
+#include "hash.h"
 #include "list.h"
 
 #ifndef MAXHOSTNAMELEN
@@ -124,7 +127,8 @@
    | IPMI_MONITORING_SENSOR_READING_FLAGS_IGNORE_SCANNING_DISABLED         \
    | IPMI_MONITORING_SENSOR_READING_FLAGS_ASSUME_BMC_OWNER                 \
    | IPMI_MONITORING_SENSOR_READING_FLAGS_ENTITY_SENSOR_NAMES              \
-   | IPMI_MONITORING_SENSOR_READING_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT)
+   | IPMI_MONITORING_SENSOR_READING_FLAGS_ASSUME_MAX_SDR_RECORD_COUNT      \
+   | IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
 
 #define IPMI_MONITORING_AUTHENTICATION_TYPE_DEFAULT           IPMI_AUTHENTICATION_TYPE_MD5
 #define IPMI_MONITORING_PRIVILEGE_LEVEL_DEFAULT               IPMI_PRIVILEGE_LEVEL_USER
@@ -137,6 +141,20 @@
 
 #define IPMI_MONITORING_MAGIC         0xABCD9876
 
+/* minimum buckets of the sensor deltas host table and of each host's
+ * table, they are otherwise sized from the host and SDR record counts
+ */
+#define IPMI_MONITORING_SENSOR_DELTAS_HOSTS_HASH_SIZE   16
+#define IPMI_MONITORING_SENSOR_DELTAS_RECORDS_HASH_SIZE 64
+
+/* seconds between SDR out of date checks on a persistent session */
+#define IPMI_MONITORING_SESSION_SDR_CHECK_INTERVAL 60
+
+/* longest ipmi_monitoring_sensor_readings_by_hosts() waits for sensor
+ * readings before checking on hosts its threads are done with, in ms
+ */
+#define IPMI_MONITORING_HOSTS_POLL_TIMEOUT 100
+
 #define IPMI_MONITORING_PACKET_BUFLEN 1024
 
 struct ipmi_monitoring_sel_record {
@@ -189,6 +207,32 @@ struct ipmi_monitoring_sensor_reading {
   int event_reading_type_code;
 };
 
+/* last returned reading of a sensor, for
+ * IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY
+ */
+struct ipmi_monitoring_sensor_delta {
+  unsigned int id;              /* record id << 8 | sensor number */
+  int sensor_state;
+  int sensor_reading_type;
+  int sensor_bitmask_type;
+  int sensor_bitmask;
+  union {
+    uint8_t bool_val;
+    uint32_t integer_val;
+    double double_val;
+  } sensor_reading;
+};
+
+/* the sensor deltas of one host.  Hosts are only added or removed
+ * before and after readings, so a host table may be searched by any
+ * number of threads, each host's deltas are protected by its mutex.
+ */
+struct ipmi_monitoring_sensor_deltas_host {
+  char *hostname;               /* "" for inband */
+  pthread_mutex_t mutex;
+  hash_t deltas;                /* keyed by id */
+};
+
 struct ipmi_monitoring_ctx {
   uint32_t magic;
   int errnum;
@@ -199,6 +243,23 @@ struct ipmi_monitoring_ctx {
   int sdr_cache_directory_set;
   char sdr_cache_filename_format[MAXPATHLEN+1];
   int sdr_cache_filename_format_set;
+  char sdr_cache_shared_directory[MAXPATHLEN+1];
+  int sdr_cache_shared_directory_set;
+
+  /* copied to the per-host contexts of
+   * ipmi_monitoring_sensor_readings_by_hosts(), "" for the default
+   */
+  char sel_config_file[MAXPATHLEN+1];
+  int sel_config_file_set;
+  char sensor_config_file[MAXPATHLEN+1];
+  int sensor_config_file_set;
+
+  /* persistent session, see ipmi_monitoring_ctx_session_open() */
+  int session_open;
+  char *session_hostname;
+  struct ipmi_monitoring_ipmi_config session_config;
+  int session_config_set;
+  time_t session_sdr_checked;
 
   /* for use by both sel and sensor codepath */
   uint32_t manufacturer_id;
@@ -223,6 +284,21 @@ struct ipmi_monitoring_ctx {
   ListIterator sensor_readings_itr;
   struct ipmi_monitoring_sensor_reading *current_sensor_reading;
   struct ipmi_monitoring_sensor_reading *callback_sensor_reading;
+  /* for ipmi_monitoring_sensor_readings_export(), strings point into sensor_readings */
+  const char **sensor_names;
+
+  /* for IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY, hosts
+   * keyed by hostname
+   */
+  hash_t sensor_deltas;
+  unsigned int sensor_deltas_size;
+  double sensor_deltas_deadband;
+  /* set if sensor_deltas is owned by another context and shared with
+   * other threads, no hosts may be added then
+   */
+  int sensor_deltas_shared;
+  struct ipmi_monitoring_sensor_deltas_host *sensor_deltas_host;
+  const char *sensor_hostname;
 };
 
 #endif /* IPMI_MONITORING_DEFS_H */
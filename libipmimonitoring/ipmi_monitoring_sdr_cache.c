@@ -203,20 +203,41 @@ static int
 _ipmi_monitoring_sdr_cache_retrieve (ipmi_monitoring_ctx_t c,
                                      const char *hostname,
                                      char *filename,
-                                     unsigned int sdr_create_flags)
+                                     unsigned int sdr_create_flags,
+                                     int out_of_date)
 {
+  int ret;
+
   assert (c);
   assert (c->magic == IPMI_MONITORING_MAGIC);
   assert (c->sdr_ctx);
   assert (c->ipmi_ctx);
   assert (filename && strlen (filename));
 
-  if (ipmi_sdr_cache_create (c->sdr_ctx,
-                             c->ipmi_ctx,
-                             filename,
-                             sdr_create_flags,
-                             NULL,
-                             NULL) < 0)
+  if (c->sdr_cache_shared_directory_set)
+    ret = ipmi_sdr_cache_create_shared (c->sdr_ctx,
+                                        c->ipmi_ctx,
+                                        filename,
+                                        c->sdr_cache_shared_directory,
+                                        sdr_create_flags,
+                                        NULL,
+                                        NULL);
+  else if (out_of_date)
+    ret = ipmi_sdr_cache_update (c->sdr_ctx,
+                                 c->ipmi_ctx,
+                                 filename,
+                                 sdr_create_flags,
+                                 NULL,
+                                 NULL);
+  else
+    ret = ipmi_sdr_cache_create (c->sdr_ctx,
+                                 c->ipmi_ctx,
+                                 filename,
+                                 sdr_create_flags,
+                                 NULL,
+                                 NULL);
+
+  if (ret < 0)
     {
       IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_create: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
       if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_FILESYSTEM)
@@ -266,6 +287,7 @@ ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
                                 unsigned int sdr_create_flags)
 {
   char filename[MAXPATHLEN+1];
+  int cache_valid = 0;
 
   assert (c);
   assert (c->magic == IPMI_MONITORING_MAGIC);
@@ -285,7 +307,13 @@ ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
     {
       if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_CACHE_READ_CACHE_DOES_NOT_EXIST)
         {
-          if (_ipmi_monitoring_sdr_cache_retrieve (c, hostname, filename, sdr_create_flags) < 0)
+          if (_ipmi_monitoring_sdr_cache_retrieve (c, hostname, filename, sdr_create_flags, 0) < 0)
+            goto cleanup;
+        }
+      else if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_CACHE_OUT_OF_DATE
+               && !c->sdr_cache_shared_directory_set)
+        {
+          if (_ipmi_monitoring_sdr_cache_retrieve (c, hostname, filename, sdr_create_flags, 1) < 0)
             goto cleanup;
         }
       else if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_CACHE_INVALID
@@ -294,7 +322,7 @@ ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
           if (_ipmi_monitoring_sdr_cache_delete (c, hostname, filename) < 0)
             goto cleanup;
 
-          if (_ipmi_monitoring_sdr_cache_retrieve (c, hostname, filename, sdr_create_flags) < 0)
+          if (_ipmi_monitoring_sdr_cache_retrieve (c, hostname, filename, sdr_create_flags, 0) < 0)
             goto cleanup;
         }
       else if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_FILESYSTEM)
@@ -307,6 +335,16 @@ ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
           c->errnum = IPMI_MONITORING_ERR_SDR_CACHE_PERMISSION;
           goto cleanup;
         }
+      else if (ipmi_sdr_ctx_errnum (c->sdr_ctx) == IPMI_SDR_ERR_IPMI_ERROR)
+        {
+          /* e.g. session timeout during the out of date check, the
+           * cache itself may be fine and the caller may retry
+           */
+          IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_open: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
+          ipmi_monitoring_ipmi_ctx_error_convert (c);
+          cache_valid++;
+          goto cleanup;
+        }
       else
         {
           IPMI_MONITORING_DEBUG (("ipmi_sdr_cache_open: %s", ipmi_sdr_ctx_errormsg (c->sdr_ctx)));
@@ -341,7 +379,7 @@ ipmi_monitoring_sdr_cache_load (ipmi_monitoring_ctx_t c,
   return (0);
 
  cleanup:
-  if (strlen (filename))
+  if (strlen (filename) && !cache_valid)
     ipmi_sdr_cache_delete (c->sdr_ctx, filename);
   ipmi_sdr_ctx_destroy (c->sdr_ctx);
   c->sdr_ctx = NULL;
@@ -365,6 +403,7 @@ ipmi_monitoring_sdr_cache_flush (ipmi_monitoring_ctx_t c,
                                  const char *hostname)
 {
   char filename[MAXPATHLEN+1];
+  int rv = -1;
 
   assert (c);
   assert (c->magic == IPMI_MONITORING_MAGIC);
@@ -380,10 +419,9 @@ ipmi_monitoring_sdr_cache_flush (ipmi_monitoring_ctx_t c,
   if (_ipmi_monitoring_sdr_cache_delete (c, hostname, filename) < 0)
     goto cleanup;
 
-  return (0);
-
+  rv = 0;
  cleanup:
   ipmi_sdr_ctx_destroy (c->sdr_ctx);
   c->sdr_ctx = NULL;
-  return (-1);
+  return (rv);
 }
@@ -57,6 +57,7 @@ _sensor_reading_cleanup (ipmi_monitoring_ctx_t c)
 
   ipmi_sensor_read_ctx_destroy (c->sensor_read_ctx);
   c->sensor_read_ctx = NULL;
+  c->sensor_hostname = NULL;
 }
 
 int
@@ -109,6 +110,434 @@ _allocate_sensor_reading (ipmi_monitoring_ctx_t c)
   return (s);
 }
 
+static void
+_destroy_sensor_delta (void *x)
+{
+  assert (x);
+
+  free (x);
+}
+
+static unsigned int
+_sensor_delta_hash (const void *key)
+{
+  assert (key);
+
+  return (*((unsigned int *)key));
+}
+
+static int
+_sensor_delta_cmp (const void *key1, const void *key2)
+{
+  assert (key1);
+  assert (key2);
+
+  return (*((unsigned int *)key1) != *((unsigned int *)key2));
+}
+
+static void
+_destroy_sensor_deltas_host (struct ipmi_monitoring_sensor_deltas_host *h)
+{
+  if (!h)
+    return;
+
+  if (h->deltas)
+    hash_destroy (h->deltas);
+  pthread_mutex_destroy (&h->mutex);
+  free (h->hostname);
+  free (h);
+}
+
+static int
+_sensor_deltas_host_destroy (void *data, const void *key, void *arg)
+{
+  _destroy_sensor_deltas_host ((struct ipmi_monitoring_sensor_deltas_host *)data);
+  return (1);
+}
+
+static int
+_sensor_deltas_host_move (void *data, const void *key, void *arg)
+{
+  struct ipmi_monitoring_sensor_deltas_host *h;
+
+  assert (data);
+  assert (arg);
+
+  h = (struct ipmi_monitoring_sensor_deltas_host *)data;
+  if (!hash_insert ((hash_t)arg, h->hostname, h))
+    return (-1);
+  return (1);
+}
+
+/* Host table entries are freed by hand, the host table itself has no
+ * delete function, so it may be rebuilt larger without freeing them.
+ */
+static int
+_sensor_deltas_hosts_resize (ipmi_monitoring_ctx_t c, unsigned int hosts)
+{
+  hash_t sensor_deltas = NULL;
+  unsigned int size;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (!c->sensor_deltas_shared);
+
+  if (c->sensor_deltas && hosts <= c->sensor_deltas_size)
+    return (0);
+
+  size = IPMI_MONITORING_SENSOR_DELTAS_HOSTS_HASH_SIZE;
+  while (size < hosts)
+    size *= 2;
+
+  if (!(sensor_deltas = hash_create (size,
+                                     (hash_key_f)hash_key_string,
+                                     (hash_cmp_f)strcmp,
+                                     NULL)))
+    {
+      IPMI_MONITORING_DEBUG (("hash_create: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      return (-1);
+    }
+
+  if (c->sensor_deltas)
+    {
+      if (hash_for_each (c->sensor_deltas, _sensor_deltas_host_move, sensor_deltas) != hash_count (c->sensor_deltas))
+        {
+          IPMI_MONITORING_DEBUG (("hash_insert: %s", strerror (errno)));
+          c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+          hash_destroy (sensor_deltas);
+          return (-1);
+        }
+      hash_destroy (c->sensor_deltas);
+    }
+
+  c->sensor_deltas = sensor_deltas;
+  c->sensor_deltas_size = size;
+  return (0);
+}
+
+static struct ipmi_monitoring_sensor_deltas_host *
+_sensor_deltas_host_add (ipmi_monitoring_ctx_t c, const char *hostname)
+{
+  struct ipmi_monitoring_sensor_deltas_host *h = NULL;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (c->sensor_deltas);
+  assert (hostname);
+
+  if ((h = hash_find (c->sensor_deltas, hostname)))
+    return (h);
+
+  if (!(h = (struct ipmi_monitoring_sensor_deltas_host *)malloc (sizeof (struct ipmi_monitoring_sensor_deltas_host))))
+    {
+      IPMI_MONITORING_DEBUG (("malloc: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      return (NULL);
+    }
+  memset (h, '\0', sizeof (struct ipmi_monitoring_sensor_deltas_host));
+
+  if (pthread_mutex_init (&h->mutex, NULL))
+    {
+      c->errnum = IPMI_MONITORING_ERR_SYSTEM_ERROR;
+      free (h);
+      return (NULL);
+    }
+
+  if (!(h->hostname = strdup (hostname)))
+    {
+      IPMI_MONITORING_DEBUG (("strdup: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      goto cleanup;
+    }
+
+  if (!hash_insert (c->sensor_deltas, h->hostname, h))
+    {
+      IPMI_MONITORING_DEBUG (("hash_insert: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      goto cleanup;
+    }
+
+  return (h);
+
+ cleanup:
+  _destroy_sensor_deltas_host (h);
+  return (NULL);
+}
+
+int
+ipmi_monitoring_sensor_reading_deltas_init (ipmi_monitoring_ctx_t c,
+                                            const char **hostnames,
+                                            unsigned int hostnames_len)
+{
+  unsigned int i;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+  assert (!c->sensor_deltas_shared);
+
+  if (_sensor_deltas_hosts_resize (c,
+                                   (c->sensor_deltas ? hash_count (c->sensor_deltas) : 0) + hostnames_len) < 0)
+    return (-1);
+
+  for (i = 0; i < hostnames_len; i++)
+    {
+      if (!_sensor_deltas_host_add (c, hostnames[i] ? hostnames[i] : ""))
+        return (-1);
+    }
+
+  return (0);
+}
+
+void
+ipmi_monitoring_sensor_reading_deltas_destroy (ipmi_monitoring_ctx_t c)
+{
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  c->sensor_deltas_host = NULL;
+
+  if (!c->sensor_deltas || c->sensor_deltas_shared)
+    {
+      c->sensor_deltas = NULL;
+      return;
+    }
+
+  hash_for_each (c->sensor_deltas, _sensor_deltas_host_destroy, NULL);
+  hash_destroy (c->sensor_deltas);
+  c->sensor_deltas = NULL;
+  c->sensor_deltas_size = 0;
+}
+
+int
+ipmi_monitoring_sensor_reading_deltas_reset (ipmi_monitoring_ctx_t c,
+                                             const char *hostname)
+{
+  struct ipmi_monitoring_sensor_deltas_host *h;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (!c->sensor_deltas)
+    return (0);
+
+  if (!hostname)
+    {
+      assert (!c->sensor_deltas_shared);
+      ipmi_monitoring_sensor_reading_deltas_destroy (c);
+      return (0);
+    }
+
+  /* the host is kept, the table may be shared */
+  if ((h = hash_find (c->sensor_deltas, hostname)))
+    {
+      pthread_mutex_lock (&h->mutex);
+      if (h->deltas)
+        {
+          hash_destroy (h->deltas);
+          h->deltas = NULL;
+        }
+      pthread_mutex_unlock (&h->mutex);
+    }
+  return (0);
+}
+
+/* The host whose readings are being stored, remembered for the rest
+ * of its readings so the host table is searched once per host.
+ */
+static struct ipmi_monitoring_sensor_deltas_host *
+_sensor_deltas_host (ipmi_monitoring_ctx_t c)
+{
+  const char *hostname;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  hostname = c->sensor_hostname ? c->sensor_hostname : "";
+
+  if (c->sensor_deltas_host
+      && !strcmp (c->sensor_deltas_host->hostname, hostname))
+    return (c->sensor_deltas_host);
+
+  if (c->sensor_deltas_shared)
+    {
+      /* hosts were added before the table was shared */
+      if (!(c->sensor_deltas_host = hash_find (c->sensor_deltas, hostname)))
+        {
+          IPMI_MONITORING_DEBUG (("sensor deltas host '%s' not found", hostname));
+          c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+        }
+      return (c->sensor_deltas_host);
+    }
+
+  if (ipmi_monitoring_sensor_reading_deltas_init (c, &hostname, 1) < 0)
+    return (NULL);
+
+  c->sensor_deltas_host = hash_find (c->sensor_deltas, hostname);
+  assert (c->sensor_deltas_host);
+  return (c->sensor_deltas_host);
+}
+
+static int
+_sensor_delta_reading_changed (ipmi_monitoring_ctx_t c,
+                               double old_reading,
+                               double new_reading)
+{
+  double diff;
+
+  assert (c);
+
+  diff = new_reading - old_reading;
+  if (diff < 0)
+    diff = -diff;
+
+  return (diff > c->sensor_deltas_deadband ? 1 : 0);
+}
+
+static void
+_sensor_delta_set (struct ipmi_monitoring_sensor_delta *d,
+                   int sensor_state,
+                   int sensor_reading_type,
+                   int sensor_bitmask_type,
+                   int sensor_bitmask,
+                   void *sensor_reading)
+{
+  assert (d);
+
+  d->sensor_state = sensor_state;
+  d->sensor_reading_type = sensor_reading_type;
+  d->sensor_bitmask_type = sensor_bitmask_type;
+  d->sensor_bitmask = sensor_bitmask;
+
+  memset (&d->sensor_reading, '\0', sizeof (d->sensor_reading));
+  if (!sensor_reading)
+    return;
+
+  if (sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_UNSIGNED_INTEGER8_BOOL)
+    d->sensor_reading.bool_val = *((uint8_t *)sensor_reading);
+  else if (sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_UNSIGNED_INTEGER32)
+    d->sensor_reading.integer_val = *((uint32_t *)sensor_reading);
+  else if (sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_DOUBLE)
+    d->sensor_reading.double_val = *((double *)sensor_reading);
+}
+
+/* Compare a reading to the one last returned for the sensor and
+ * remember it if it changed.
+ *
+ * return -1 on error, 0 if unchanged, 1 if changed or not seen before
+ */
+static int
+_sensor_delta_update (ipmi_monitoring_ctx_t c,
+                      int record_id,
+                      int sensor_number,
+                      int sensor_state,
+                      int sensor_reading_type,
+                      int sensor_bitmask_type,
+                      int sensor_bitmask,
+                      void *sensor_reading)
+{
+  struct ipmi_monitoring_sensor_deltas_host *h;
+  struct ipmi_monitoring_sensor_delta *d = NULL;
+  unsigned int id;
+  int changed = 0;
+  int rv = -1;
+
+  assert (c);
+  assert (c->magic == IPMI_MONITORING_MAGIC);
+
+  if (!(h = _sensor_deltas_host (c)))
+    return (-1);
+
+  id = ((unsigned int)record_id << 8) | ((unsigned int)sensor_number & 0xFF);
+
+  pthread_mutex_lock (&h->mutex);
+
+  if (!h->deltas)
+    {
+      int size = IPMI_MONITORING_SENSOR_DELTAS_RECORDS_HASH_SIZE;
+      uint16_t record_count;
+
+      /* sized for one delta per SDR record */
+      if (c->sdr_ctx
+          && ipmi_sdr_cache_record_count (c->sdr_ctx, &record_count) >= 0
+          && record_count > size)
+        size = record_count;
+
+      if (!(h->deltas = hash_create (size,
+                                     _sensor_delta_hash,
+                                     _sensor_delta_cmp,
+                                     _destroy_sensor_delta)))
+        {
+          IPMI_MONITORING_DEBUG (("hash_create: %s", strerror (errno)));
+          c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+          goto cleanup;
+        }
+    }
+
+  if ((d = hash_find (h->deltas, &id)))
+    {
+      if (d->sensor_state != sensor_state
+          || d->sensor_reading_type != sensor_reading_type
+          || d->sensor_bitmask_type != sensor_bitmask_type
+          || d->sensor_bitmask != sensor_bitmask)
+        changed = 1;
+      else if (sensor_reading
+               && sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_UNSIGNED_INTEGER8_BOOL)
+        changed = (d->sensor_reading.bool_val != *((uint8_t *)sensor_reading));
+      else if (sensor_reading
+               && sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_UNSIGNED_INTEGER32)
+        changed = _sensor_delta_reading_changed (c,
+                                                 d->sensor_reading.integer_val,
+                                                 *((uint32_t *)sensor_reading));
+      else if (sensor_reading
+               && sensor_reading_type == IPMI_MONITORING_SENSOR_READING_TYPE_DOUBLE)
+        changed = _sensor_delta_reading_changed (c,
+                                                 d->sensor_reading.double_val,
+                                                 *((double *)sensor_reading));
+
+      if (changed)
+        _sensor_delta_set (d,
+                           sensor_state,
+                           sensor_reading_type,
+                           sensor_bitmask_type,
+                           sensor_bitmask,
+                           sensor_reading);
+      rv = changed;
+      goto cleanup;
+    }
+
+  if (!(d = (struct ipmi_monitoring_sensor_delta *)malloc (sizeof (struct ipmi_monitoring_sensor_delta))))
+    {
+      IPMI_MONITORING_DEBUG (("malloc: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_OUT_OF_MEMORY;
+      goto cleanup;
+    }
+  memset (d, '\0', sizeof (struct ipmi_monitoring_sensor_delta));
+  d->id = id;
+
+  _sensor_delta_set (d,
+                     sensor_state,
+                     sensor_reading_type,
+                     sensor_bitmask_type,
+                     sensor_bitmask,
+                     sensor_reading);
+
+  if (!hash_insert (h->deltas, &d->id, d))
+    {
+      IPMI_MONITORING_DEBUG (("hash_insert: %s", strerror (errno)));
+      c->errnum = IPMI_MONITORING_ERR_INTERNAL_ERROR;
+      goto cleanup;
+    }
+  d = NULL;
+
+  rv = 1;
+ cleanup:
+  pthread_mutex_unlock (&h->mutex);
+  if (rv < 0 && d)
+    _destroy_sensor_delta (d);
+  return (rv);
+}
+
 /* return -1 on error, 0 on no append, 1 on append */
 static int
 _store_sensor_reading (ipmi_monitoring_ctx_t c,
@@ -142,6 +571,21 @@ _store_sensor_reading (ipmi_monitoring_ctx_t c,
       && sensor_state == IPMI_MONITORING_STATE_UNKNOWN)
     return (0);
 
+  if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
+    {
+      int ret;
+
+      if ((ret = _sensor_delta_update (c,
+                                       record_id,
+                                       sensor_number,
+                                       sensor_state,
+                                       sensor_reading_type,
+                                       sensor_bitmask_type,
+                                       sensor_bitmask,
+                                       sensor_reading)) <= 0)
+        return (ret);
+    }
+
   if (!(s = _allocate_sensor_reading (c)))
     goto cleanup;
 
@@ -212,6 +656,21 @@ _store_unreadable_sensor_reading (ipmi_monitoring_ctx_t c,
   if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_IGNORE_NON_INTERPRETABLE_SENSORS)
     return (0);
 
+  if (sensor_reading_flags & IPMI_MONITORING_SENSOR_READING_FLAGS_DELTAS_ONLY)
+    {
+      int ret;
+
+      if ((ret = _sensor_delta_update (c,
+                                       record_id,
+                                       sensor_number,
+                                       IPMI_MONITORING_STATE_UNKNOWN,
+                                       IPMI_MONITORING_SENSOR_READING_TYPE_UNKNOWN,
+                                       IPMI_MONITORING_SENSOR_BITMASK_TYPE_UNKNOWN,
+                                       0,
+                                       NULL)) <= 0)
+        return (ret);
+    }
+
   if (!(s = _allocate_sensor_reading (c)))
     goto cleanup;
 
@@ -33,6 +33,17 @@ int ipmi_monitoring_sensor_reading_init (ipmi_monitoring_ctx_t c);
 
 int ipmi_monitoring_sensor_reading_cleanup (ipmi_monitoring_ctx_t c);
 
+/* add hostnames to the sensor deltas, NULL for inband */
+int ipmi_monitoring_sensor_reading_deltas_init (ipmi_monitoring_ctx_t c,
+                                                const char **hostnames,
+                                                unsigned int hostnames_len);
+
+void ipmi_monitoring_sensor_reading_deltas_destroy (ipmi_monitoring_ctx_t c);
+
+/* hostname NULL for all hosts */
+int ipmi_monitoring_sensor_reading_deltas_reset (ipmi_monitoring_ctx_t c,
+                                                 const char *hostname);
+
 int ipmi_monitoring_get_sensor_reading (ipmi_monitoring_ctx_t c,
                                         unsigned int sensor_reading_flags,
                                         unsigned int shared_sensor_number_offset,